@@ -0,0 +1,200 @@
+// ArcCache.cpp - Cache persistant des resultats d'analyse par fichier
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#include "ArcCache.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "ArcText.h"
+
+static constexpr char kMagic[4] = { 'A', 'R', 'C', 'C' };
+static constexpr uint32_t kVersion = 1;
+static constexpr size_t kHeaderSize = 12;
+static constexpr size_t kEntryHeaderSize = 40;
+
+// ======================== Little-endian ========================
+template <typename T>
+static T ReadLe(const char* p) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < sizeof(T); i++) v |= static_cast<uint64_t>(static_cast<uint8_t>(p[i])) << (8 * i);
+    return static_cast<T>(v);
+}
+
+template <typename T>
+static void WriteLe(std::string& out, T value) {
+    uint64_t v = static_cast<uint64_t>(value);
+    for (size_t i = 0; i < sizeof(T); i++) out += static_cast<char>((v >> (8 * i)) & 0xFF);
+}
+
+static void WriteEntry(std::string& out, const ArcFileStamp& stamp, std::string_view key, std::string_view value) {
+    WriteLe<uint64_t>(out, stamp.size);
+    WriteLe<int64_t>(out, stamp.writeTime);
+    WriteLe<uint64_t>(out, stamp.fileId);
+    WriteLe<uint64_t>(out, stamp.volume);
+    WriteLe<uint32_t>(out, static_cast<uint32_t>(key.size()));
+    WriteLe<uint32_t>(out, static_cast<uint32_t>(value.size()));
+    out.append(key);
+    out.append(value);
+}
+
+// ======================== Cache ========================
+std::string ArcResultCache::MakeKey(ArcCacheKind kind, const std::wstring& path) {
+    std::string key(1, static_cast<char>(kind));
+    key += ToUtf8(path);
+    return key;
+}
+
+bool ArcResultCache::Open(IArcPlatform& platform, const std::wstring& path) {
+    platform_ = &platform;
+    path_ = path;
+    mapping_ = platform.MapFile(path);
+    Index();
+    return mapping_ != nullptr;
+}
+
+void ArcResultCache::Index() {
+    entries_.clear();
+    index_.clear();
+    seen_.clear();
+    usedKinds_ = 0;
+    pending_.clear();
+    if (!mapping_) return;
+
+    // Toute incoherence invalide le cache entier: il sera reconstruit a la prochaine sauvegarde
+    std::string_view bytes = mapping_->Bytes();
+    if (bytes.size() < kHeaderSize || memcmp(bytes.data(), kMagic, 4) != 0 || ReadLe<uint32_t>(bytes.data() + 4) != kVersion) {
+        mapping_.reset();
+        return;
+    }
+    const uint32_t count = ReadLe<uint32_t>(bytes.data() + 8);
+    size_t pos = kHeaderSize;
+    entries_.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        if (bytes.size() - pos < kEntryHeaderSize) break;
+        const char* p = bytes.data() + pos;
+        Entry e;
+        e.stamp.size = ReadLe<uint64_t>(p);
+        e.stamp.writeTime = ReadLe<int64_t>(p + 8);
+        e.stamp.fileId = ReadLe<uint64_t>(p + 16);
+        e.stamp.volume = ReadLe<uint64_t>(p + 24);
+        const size_t keyLen = ReadLe<uint32_t>(p + 32);
+        const size_t valueLen = ReadLe<uint32_t>(p + 36);
+        pos += kEntryHeaderSize;
+        if (keyLen == 0 || bytes.size() - pos < keyLen || bytes.size() - pos - keyLen < valueLen) break;
+        e.key = bytes.substr(pos, keyLen);
+        e.value = bytes.substr(pos + keyLen, valueLen);
+        pos += keyLen + valueLen;
+        index_[e.key] = entries_.size();
+        entries_.push_back(e);
+    }
+    if (entries_.size() != count) {
+        entries_.clear();
+        index_.clear();
+        mapping_.reset();
+        return;
+    }
+    seen_.assign(entries_.size(), false);
+}
+
+bool ArcResultCache::Lookup(ArcCacheKind kind, const std::wstring& path, const ArcFileStamp& stamp, std::string_view& value) {
+    const std::string key = MakeKey(kind, path);
+    auto it = index_.find(key);
+    const bool hit = it != index_.end() && entries_[it->second].stamp == stamp;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        usedKinds_ |= 1u << static_cast<uint32_t>(kind);
+        if (hit) seen_[it->second] = true;
+    }
+    if (!hit) {
+        misses_++;
+        return false;
+    }
+    hits_++;
+    value = entries_[it->second].value;
+    return true;
+}
+
+bool ArcResultCache::Find(ArcCacheKind kind, const std::wstring& path, ArcFileStamp& stamp, std::string_view& value) {
+    const std::string key = MakeKey(kind, path);
+    auto it = index_.find(key);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        usedKinds_ |= 1u << static_cast<uint32_t>(kind);
+        if (it != index_.end()) seen_[it->second] = true;
+    }
+    if (it == index_.end()) {
+        misses_++;
+        return false;
+    }
+    hits_++;
+    stamp = entries_[it->second].stamp;
+    value = entries_[it->second].value;
+    return true;
+}
+
+void ArcResultCache::Store(ArcCacheKind kind, const std::wstring& path, const ArcFileStamp& stamp, std::string value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    usedKinds_ |= 1u << static_cast<uint32_t>(kind);
+    pending_[MakeKey(kind, path)] = { stamp, std::move(value) };
+}
+
+bool ArcResultCache::Save() {
+    if (!platform_) return false;
+
+    std::string out;
+    uint32_t count = 0;
+    bool changed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        changed = !pending_.empty();
+        out.append(kMagic, 4);
+        WriteLe<uint32_t>(out, kVersion);
+        WriteLe<uint32_t>(out, 0);      // Complete ci-dessous
+
+        for (size_t i = 0; i < entries_.size(); i++) {
+            const Entry& e = entries_[i];
+            const uint32_t kindBit = 1u << static_cast<uint8_t>(e.key[0]);
+            if (pending_.count(std::string(e.key))) continue;           // Remplacee par une nouvelle analyse
+            if ((usedKinds_ & kindBit) && !seen_[i]) {                   // Fichier disparu ou modifie
+                changed = true;
+                continue;
+            }
+            WriteEntry(out, e.stamp, e.key, e.value);
+            count++;
+        }
+        for (const auto& kv : pending_) {
+            WriteEntry(out, kv.second.first, kv.first, kv.second.second);
+            count++;
+        }
+    }
+    if (!changed) {
+        Index();
+        return true;
+    }
+    for (size_t i = 0; i < 4; i++) out[8 + i] = static_cast<char>((count >> (8 * i)) & 0xFF);
+
+    // La projection doit etre liberee avant de remplacer le fichier (Windows)
+    mapping_.reset();
+    const std::filesystem::path target(path_);
+    std::filesystem::path temp = target;
+    temp += ".tmp";
+    bool written;
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        file.write(out.data(), static_cast<std::streamsize>(out.size()));
+        written = static_cast<bool>(file);
+    }
+    std::error_code ec;
+    bool replaced = false;
+    if (written) {
+        std::filesystem::rename(temp, target, ec);
+        replaced = !ec;
+    }
+    if (!replaced) std::filesystem::remove(temp, ec);
+
+    mapping_ = platform_->MapFile(path_);
+    Index();
+    return replaced;
+}
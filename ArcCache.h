@@ -0,0 +1,131 @@
+// ArcCache.h - Cache persistant des resultats d'analyse par fichier
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Une entree par fichier analyse, cle = (type de sonde, chemin), validee par l'empreinte
+// complete du fichier (taille, date d'ecriture, identifiant, volume). Un fichier inchange
+// n'est ni ouvert ni relu: la sonde reprend directement sa valeur analysee.
+//
+// Le cache est projete en memoire a l'ouverture; les valeurs renvoyees sont des vues sur
+// la projection. Save() reecrit un nouveau fichier (renomme atomiquement) contenant les
+// entrees consultees ou ajoutees pendant la passe, puis le reprojette.
+//
+// Format (entiers petit-boutistes):
+//   "ARCC" u32 version u32 entrees
+//   entree: u64 taille, i64 date, u64 id, u64 volume, u32 taille cle, u32 taille valeur,
+//           cle (u8 type + chemin UTF-8), valeur
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "ArcPlatform.h"
+
+enum class ArcCacheKind : uint8_t {
+    Config = 1,             // agentconfig.json
+    Credential = 2,         // Fichiers des magasins Tokens / Certs
+    ExtensionStatus = 3,    // <N>.status
+    LogScan = 4             // Journaux: compteurs et position de reprise
+};
+
+class ArcResultCache {
+public:
+    // Projette le cache existant; un fichier absent, tronque ou d'une autre version donne un cache vide
+    bool Open(IArcPlatform& platform, const std::wstring& path);
+
+    // Thread-safe. La vue reste valide jusqu'au prochain Save().
+    bool Lookup(ArcCacheKind kind, const std::wstring& path, const ArcFileStamp& stamp, std::string_view& value);
+    void Store(ArcCacheKind kind, const std::wstring& path, const ArcFileStamp& stamp, std::string value);
+
+    // Derniere entree connue quelle que soit l'empreinte, renvoyee dans 'stamp': reprise des
+    // fichiers qui ne font que grandir. L'appelant decide de sa validite.
+    bool Find(ArcCacheKind kind, const std::wstring& path, ArcFileStamp& stamp, std::string_view& value);
+
+    // Les entrees d'un type consulte pendant la passe mais non revues (fichier supprime) sont
+    // abandonnees; les autres types sont conserves tels quels. Sans changement: aucune ecriture.
+    bool Save();
+
+    bool is_open() const { return platform_ != nullptr; }
+    size_t Hits() const { return hits_.load(); }
+    size_t Misses() const { return misses_.load(); }
+
+private:
+    struct Entry {
+        ArcFileStamp stamp;
+        std::string_view key;
+        std::string_view value;
+    };
+
+    static std::string MakeKey(ArcCacheKind kind, const std::wstring& path);
+    void Index();
+
+    IArcPlatform* platform_ = nullptr;
+    std::wstring path_;
+    std::unique_ptr<IArcMappedFile> mapping_;
+    std::vector<Entry> entries_;
+    std::unordered_map<std::string_view, size_t> index_;    // Cle -> entries_ (immuable pendant une passe)
+
+    std::mutex mutex_;
+    std::vector<bool> seen_;
+    uint32_t usedKinds_ = 0;                                  // Bit par ArcCacheKind consulte
+    std::unordered_map<std::string, std::pair<ArcFileStamp, std::string>> pending_;
+
+    std::atomic<size_t> hits_{ 0 };
+    std::atomic<size_t> misses_{ 0 };
+};
+
+// ======================== Record Encoding ========================
+// Serialisation compacte des valeurs: entiers en varint, chaines prefixees par leur taille
+class ArcCacheWriter {
+public:
+    ArcCacheWriter& Int(int64_t v) {
+        uint64_t z = (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+        while (z >= 0x80) { out_ += static_cast<char>((z & 0x7F) | 0x80); z >>= 7; }
+        out_ += static_cast<char>(z);
+        return *this;
+    }
+    ArcCacheWriter& Str(std::string_view s) {
+        Int(static_cast<int64_t>(s.size()));
+        out_.append(s);
+        return *this;
+    }
+    std::string Take() { return std::move(out_); }
+
+private:
+    std::string out_;
+};
+
+class ArcCacheReader {
+public:
+    explicit ArcCacheReader(std::string_view data) : data_(data) {}
+
+    int64_t Int() {
+        uint64_t z = 0;
+        for (int shift = 0; pos_ < data_.size() && shift < 64; shift += 7) {
+            uint8_t b = static_cast<uint8_t>(data_[pos_++]);
+            z |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return static_cast<int64_t>(z >> 1) ^ -static_cast<int64_t>(z & 1);
+        }
+        ok_ = false;
+        return 0;
+    }
+    std::string_view Str() {
+        int64_t n = Int();
+        if (!ok_ || n < 0 || static_cast<uint64_t>(n) > data_.size() - pos_) { ok_ = false; return {}; }
+        std::string_view s = data_.substr(pos_, static_cast<size_t>(n));
+        pos_ += static_cast<size_t>(n);
+        return s;
+    }
+    // Valeur lue en entier et sans erreur
+    bool ok() const { return ok_ && pos_ == data_.size(); }
+
+private:
+    std::string_view data_;
+    size_t pos_ = 0;
+    bool ok_ = true;
+};
@@ -0,0 +1,494 @@
+// ArcCli.cpp - Verificateur d'agent Azure Arc en ligne de commande (Windows / Linux)
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Usage: arccheck [--agent] [--extensions] [--all] [--jobs N] [--timings] [--verbose] [--watch] [--fleet DIR]
+//                 [--report FICHIER [--format csv|jsonl|arcb]] [--warn-days J] [--critical-days J] [--no-cache]
+//                 [--log-signatures FICHIER] [--offline] [--net-timeout MS] [--dns IP[:PORT]] [--trace FICHIER]
+//                 [--history FICHIER [--history-days J]] [--rules FICHIER] [--sample-interval S] [--metrics [IP:]PORT]
+// Code retour: 0 = OK, 1 = avertissement, 2 = erreur, 130 = analyse interrompue (Ctrl+C / SIGTERM, hors --watch)
+
+#ifdef _WIN32
+#ifndef UNICODE
+#define UNICODE
+#endif
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <csignal>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ArcCache.h"
+#include "ArcExport.h"
+#include "ArcFleet.h"
+#include "ArcHistory.h"
+#include "ArcLog.h"
+#include "ArcLogScan.h"
+#include "ArcMetrics.h"
+#include "ArcRules.h"
+#include "ArcSampler.h"
+#include "ArcScan.h"
+#include "ArcText.h"
+#include "ArcTime.h"
+#include "ArcTrace.h"
+#include "ArcWatch.h"
+
+// ======================== Output ========================
+static std::string FormatComponent(const ArcComponentList& list, const ArcComponentInfo& comp) {
+    std::wstring line = std::wstring(L"[") + StatusLevelName(comp.level) + L"] " + ArcStrText(comp.component) + L" - " + ArcStrText(comp.status);
+    if (comp.version) line += L" | " + ArcStrText(comp.version);
+    if (comp.expiresUtc) line += L" | Expiration: " + FormatUtc(comp.expiresUtc);
+    if (!list.Details(comp).empty()) line.append(L" | ").append(list.Details(comp));
+    if (!list.Alerts(comp).empty()) line.append(L" | ALERTE: ").append(list.Alerts(comp));
+    return ToUtf8(line);
+}
+
+static void PrintComponents(const ArcComponentList& components) {
+    for (const auto& comp : components) {
+        printf("%s\n", FormatComponent(components, comp).c_str());
+    }
+}
+
+static int ExitCode(const ArcComponentList& components) {
+    return static_cast<int>(WorstLevel(components));
+}
+
+static void PrintTimings(const ArcScanResult& result) {
+    printf("\nDuree par sonde:\n");
+    for (const auto& t : result.timings) {
+        printf("  %-24s %10.3f ms%s\n", ToUtf8(t.probe).c_str(), t.wallMs, t.cancelled ? "  (annulee)" : t.failed ? "  (echec)" : "");
+    }
+    printf("  %-24s %10.3f ms\n", "Total (mur)", result.wallMs);
+}
+
+// Cumul par intervalle, compteurs d'E/S et appels les plus longs; trace complete dans le fichier
+static int FinishTrace(const std::string& path, int code) {
+    if (path.empty()) return code;
+    EnableTrace(false);
+    if (!WriteChromeTrace(FromUtf8(path))) printf("ERREUR: impossible d'ecrire la trace %s\n", path.c_str());
+
+    printf("\nInstrumentation:\n");
+    printf("  %-6s %-36s %8s %12s %12s\n", "Type", "Nom", "Appels", "Total ms", "Max ms");
+    for (const auto& s : TraceSummary()) {
+        printf("  %-6s %-36s %8llu %12.3f %12.3f\n", s.category.c_str(), s.name.c_str(), static_cast<unsigned long long>(s.calls),
+            s.totalMs, s.maxMs);
+    }
+    printf("\nCompteurs:\n");
+    for (size_t i = 0; i < static_cast<size_t>(ArcCounter::Count); i++) {
+        const ArcCounter counter = static_cast<ArcCounter>(i);
+        printf("  %-24s %14llu\n", TraceCounterName(counter), static_cast<unsigned long long>(TraceCounter(counter)));
+    }
+    printf("\nAppels d'E/S les plus longs:\n");
+    for (const auto& span : TraceSlowest(kTraceIo, 10)) {
+        printf("  %10.3f ms  %-16s %s\n", span.ms, span.name.c_str(), span.detail.c_str());
+    }
+    if (TraceDropped()) printf("  (%llu intervalles abandonnes)\n", static_cast<unsigned long long>(TraceDropped()));
+    printf("Trace: %s (chrome://tracing ou ui.perfetto.dev)\n", path.c_str());
+    return code;
+}
+
+// ======================== Interruption ========================
+// Ctrl+C / SIGTERM: la passe en cours est annulee (resultats partiels non publies), la
+// surveillance s'arrete. Code retour 130 (la surveillance garde celui de la derniere passe).
+static ArcMonitor* g_monitor = nullptr;
+static ArcCancelToken g_cancel;
+
+#ifdef _WIN32
+static BOOL WINAPI OnConsoleCtrl(DWORD) {
+    g_cancel.Cancel();
+    if (g_monitor) g_monitor->Stop();
+    return TRUE;
+}
+#else
+static void OnSignal(int) {
+    g_cancel.Cancel();
+    if (g_monitor) g_monitor->Stop();
+}
+#endif
+
+static void InstallInterruptHandlers() {
+#ifdef _WIN32
+    SetConsoleCtrlHandler(OnConsoleCtrl, TRUE);
+#else
+    signal(SIGINT, OnSignal);
+    signal(SIGTERM, OnSignal);
+#endif
+}
+
+// ======================== Watch Mode ========================
+// Affiche uniquement les lignes apparues (+) ou disparues (-) depuis la derniere evaluation
+// Metriques: instantane rendu a chaque passe; durees = derniere execution de chaque sonde
+static int RunWatch(ArcScanContext& ctx, const ArcScanOptions& options, ArcHistory* history, ArcMetricsServer* metrics) {
+    ArcMonitorOptions monitorOptions;
+    monitorOptions.maxWorkers = options.maxWorkers;
+    monitorOptions.extensions = options.extensions;
+    ArcMonitor monitor(ctx, monitorOptions);
+    g_monitor = &monitor;
+
+    std::vector<std::string> previous;
+    std::vector<ArcProbeTiming> probeTimings;
+    int lastCode = 0;
+    bool ok = monitor.Run([&](const ArcScanResult& result, uint32_t) {
+        if (result.cancelled) return;   // Passe interrompue par l'arret: aucun faux "-"
+        if (history) RecordScan(*history, ctx, options, result);
+        if (metrics) {
+            for (const auto& t : result.timings) {
+                if (t.cancelled) continue;
+                auto it = std::find_if(probeTimings.begin(), probeTimings.end(), [&](const ArcProbeTiming& p) { return p.probe == t.probe; });
+                if (it == probeTimings.end()) probeTimings.push_back(t);
+                else *it = t;
+            }
+            ArcEventDigest digest;
+            const bool events = digest.Load(EventDigestPath(ctx));
+            metrics->Publish(BuildMetricsSnapshot(result.components, probeTimings, result.wallMs, events ? &digest : nullptr, NowUtc()));
+        }
+        std::vector<std::string> current;
+        for (const auto& comp : result.components) current.push_back(FormatComponent(result.components, comp));
+        std::sort(current.begin(), current.end());
+
+        for (const auto& line : previous) {
+            if (!std::binary_search(current.begin(), current.end(), line)) printf("- %s\n", line.c_str());
+        }
+        for (const auto& line : current) {
+            if (!std::binary_search(previous.begin(), previous.end(), line)) printf("+ %s\n", line.c_str());
+        }
+        fflush(stdout);
+        previous.swap(current);
+        lastCode = ExitCode(result.components);
+    });
+
+    g_monitor = nullptr;
+    if (!ok) {
+        printf("ERREUR: surveillance impossible sur cette plateforme\n");
+        return 2;
+    }
+    return lastCode;
+}
+
+// ======================== Report Export ========================
+struct ReportTarget {
+    std::string path;                   // Vide = pas de rapport fichier
+    ArcExportFormat format = ArcExportFormat::Csv;
+    bool formatGiven = false;
+};
+
+static std::unique_ptr<IArcResultWriter> OpenReport(const ReportTarget& target) {
+    std::wstring path = FromUtf8(target.path);
+    auto writer = CreateResultWriter(target.formatGiven ? target.format : ExportFormatFromPath(path), path);
+    if (!writer) printf("ERREUR: impossible de creer %s\n", target.path.c_str());
+    return writer;
+}
+
+// ======================== Fleet Mode ========================
+// Rapport fusionne: sur la sortie standard (trie par hote) ou ecrit en flux a la fin de chaque hote
+static int RunFleet(IArcPlatform& platform, const std::string& fleetDir, const ReportTarget& target, const ArcScanOptions& options,
+    const ArcExpiryThresholds& expiry, const std::shared_ptr<const ArcLogMatcher>& logSignatures, const std::shared_ptr<const ArcRuleSet>& rules) {
+    ArcFleetOptions fleetOptions;
+    fleetOptions.maxWorkers = options.maxWorkers;
+    fleetOptions.expiry = expiry;
+    fleetOptions.logSignatures = logSignatures;
+    fleetOptions.rules = rules;
+    fleetOptions.cancel = &g_cancel;
+
+    std::unique_ptr<IArcResultWriter> writer;
+    int code = 0;
+    if (!target.path.empty()) {
+        writer = OpenReport(target);
+        if (!writer) return 2;
+        fleetOptions.onHost = [&](const ArcHostReport& host) {
+            for (const auto& comp : host.components) writer->Write(host.host, host.components, comp);
+            code = std::max(code, ExitCode(host.components));
+        };
+    }
+
+    ArcFleetReport report = RunFleetScan(platform, FromUtf8(fleetDir), fleetOptions);
+
+    for (const auto& host : report.hosts) {
+        const std::string name = ToUtf8(host.host);
+        for (const auto& comp : host.components) printf("%s | %s\n", name.c_str(), FormatComponent(host.components, comp).c_str());
+        if (!writer) code = std::max(code, ExitCode(host.components));
+    }
+
+    printf("Parc %s - %zu hotes: %zu OK, %zu avertissement(s), %zu erreur(s) en %.0f ms\n", fleetDir.c_str(), report.hosts.size(),
+        report.hostsByLevel[static_cast<int>(StatusLevel::OK)], report.hostsByLevel[static_cast<int>(StatusLevel::WARNING)],
+        report.hostsByLevel[static_cast<int>(StatusLevel::ERROR_LEVEL)], report.wallMs);
+    if (report.dedupLookups) {
+        printf("Deduplication: %llu/%llu fichiers deja analyses sur un autre hote (%.1f %%), %zu contenus distincts, %.1f Mo non reanalyses\n",
+            static_cast<unsigned long long>(report.dedupHits), static_cast<unsigned long long>(report.dedupLookups),
+            100.0 * report.dedupHits / report.dedupLookups, report.dedupDistinct, report.dedupBytes / 1048576.0);
+    }
+    if (report.cancelled) printf("Analyse interrompue: %zu/%zu hotes complets\n", report.completed, report.hosts.size());
+    if (writer) {
+        if (!writer->Finish()) {
+            printf("ERREUR: ecriture incomplete de %s\n", target.path.c_str());
+            return 2;
+        }
+        printf("Rapport fusionne: %s\n", target.path.c_str());
+    }
+    return report.cancelled ? 130 : code;
+}
+
+// ======================== History ========================
+// Consultation sans analyse: changements d'etat, composants instables, latences et evenements
+static int PrintHistory(const ArcHistory& history, const std::string& path, double days) {
+    if (!history.Runs()) {
+        printf("Historique %s: aucune passe enregistree\n", path.c_str());
+        return 0;
+    }
+    const int64_t since = NowUtc() - static_cast<int64_t>(days * 86400);
+    printf("Historique %s: %zu passes du %s au %s, %.1f Ko\n", path.c_str(), history.Runs(), ToUtf8(FormatUtc(history.FirstUtc())).c_str(),
+        ToUtf8(FormatUtc(history.LastUtc())).c_str(), history.FileBytes() / 1024.0);
+
+    const std::vector<ArcStatusChange> changes = history.StatusChanges(since);
+    printf("\nChangements d'etat (%g derniers jours): %zu\n", days, changes.size());
+    const size_t shown = std::min<size_t>(changes.size(), 100);
+    if (shown < changes.size()) printf("  (%zu plus anciens non affiches)\n", changes.size() - shown);
+    std::map<std::wstring, size_t> flips;
+    for (size_t i = 0; i < changes.size(); i++) {
+        const ArcStatusChange& c = changes[i];
+        flips[c.component]++;
+        if (i < changes.size() - shown) continue;
+        printf("  %s  %s: %s [%s] -> %s [%s]\n", ToUtf8(FormatUtc(c.timeUtc)).c_str(), ToUtf8(c.component).c_str(),
+            c.from.empty() ? "(absent)" : ToUtf8(c.from).c_str(), ToUtf8(StatusLevelName(c.fromLevel)).c_str(),
+            c.to.empty() ? "(absent)" : ToUtf8(c.to).c_str(), ToUtf8(StatusLevelName(c.toLevel)).c_str());
+    }
+    std::vector<std::pair<size_t, std::wstring>> unstable;
+    for (const auto& kv : flips) {
+        if (kv.second >= 3) unstable.emplace_back(kv.second, kv.first);
+    }
+    std::sort(unstable.rbegin(), unstable.rend());
+    if (!unstable.empty()) printf("\nComposants instables (3 changements ou plus):\n");
+    for (const auto& u : unstable) printf("  %-32s %zu changements\n", ToUtf8(u.second).c_str(), u.first);
+
+    printf("\nLatence des sondes (ms):\n  %-24s %8s %10s %10s %10s %10s\n", "Sonde", "Passes", "p50", "p90", "p99", "max");
+    for (const auto& l : history.LatencyPercentiles(since)) {
+        printf("  %-24s %8zu %10.1f %10.1f %10.1f %10.1f\n", ToUtf8(l.probe).c_str(), l.samples, l.p50Ms, l.p90Ms, l.p99Ms, l.maxMs);
+    }
+    const ArcHistory::EventCounts events = history.EventsSince(since);
+    printf("\nNouveaux evenements de l'agent: %llu critique(s), %llu erreur(s), %llu avertissement(s)\n",
+        static_cast<unsigned long long>(events[0]), static_cast<unsigned long long>(events[1]), static_cast<unsigned long long>(events[2]));
+    return 0;
+}
+
+// PORT seul: boucle locale
+static bool ParseListenAddress(const std::string& text, ArcNetAddress& out) {
+    ArcEndpoint endpoint;
+    if (strchr(text.c_str(), ':')) {
+        if (!ParseEndpoint(text, 0, endpoint) || !ParseIPv4(endpoint.host, out.ipv4)) return false;
+    } else {
+        const unsigned long port = strtoul(text.c_str(), nullptr, 10);
+        if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos || port > 65535) return false;
+        endpoint.port = static_cast<uint16_t>(port);
+        out.ipv4 = 0x7F000001;
+    }
+    out.port = endpoint.port;
+    return out.port != 0;
+}
+
+static void Usage() {
+    printf("Usage: arccheck [--agent] [--extensions] [--all] [--jobs N] [--timings] [--verbose] [--watch] [--fleet DIR]\n");
+    printf("                [--report FICHIER [--format csv|jsonl|arcb]] [--warn-days J] [--critical-days J] [--no-cache]\n");
+    printf("                [--log-signatures FICHIER] [--offline] [--net-timeout MS] [--dns IP[:PORT]] [--trace FICHIER]\n");
+    printf("                [--history FICHIER [--history-days J]] [--rules FICHIER] [--sample-interval S] [--metrics [IP:]PORT]\n");
+    printf("  --agent       Processus, configuration, connectivite, jetons et certificats, journaux, journal d'evenements (defaut)\n");
+    printf("  --extensions  Extensions installees\n");
+    printf("  --all         Les deux\n");
+    printf("  --jobs N      Nombre maximal de sondes simultanees (defaut 4)\n");
+    printf("  --timings     Affiche la duree de chaque sonde\n");
+    printf("  --verbose     Journal detaille (niveau DEBUG)\n");
+    printf("  --watch       Surveillance continue: reevaluation sur modification (Ctrl+C pour arreter)\n");
+    printf("  --sample-interval S  Surveillance: releve CPU / memoire / handles / E/S des processus de l'agent\n");
+    printf("                     et des gestionnaires toutes les S secondes, alertes de fuite et de CPU (defaut 30, 0 = aucun)\n");
+    printf("  --metrics [IP:]PORT  Surveillance: metriques de la derniere passe sur http://IP:PORT/metrics (Prometheus)\n");
+    printf("                     et /metrics.json (defaut 127.0.0.1; aucune authentification)\n");
+    printf("  --fleet DIR   Analyse hors ligne: un sous-repertoire d'artefacts par hote (--jobs = hotes simultanes)\n");
+    printf("  --report F    Resultats ecrits en flux dans F (parc: rapport fusionne)\n");
+    printf("  --format X    csv (defaut), jsonl ou arcb (binaire en colonnes); deduit de l'extension sinon\n");
+    printf("  --warn-days J      Jeton ou certificat expirant dans moins de J jours: avertissement (defaut 7)\n");
+    printf("  --critical-days J  Jeton ou certificat expirant dans moins de J jours: erreur (defaut 1; 0.25 = 6 h)\n");
+    printf("  --no-cache    Relit tous les fichiers (sinon seuls ceux modifies depuis la derniere execution)\n");
+    printf("  --log-signatures F Signatures d'echec des journaux, une par ligne: niveau|libelle|motif\n");
+    printf("  --offline     Aucune sonde reseau (DNS, TCP, TLS) vers les points de terminaison\n");
+    printf("  --net-timeout MS   Delai de chaque etape DNS / TCP / CONNECT / TLS (defaut 3000)\n");
+    printf("  --dns IP[:PORT]    Serveur DNS a interroger (repetable; defaut: serveurs du systeme)\n");
+    printf("  --trace F     Chronometre sondes et appels d'E/S, compte fichiers et octets lus; trace Chrome/Perfetto dans F\n");
+    printf("  --history F   Ajoute chaque passe terminee a l'historique F (etats, echeances, evenements, latences)\n");
+    printf("  --history-days J   Affiche l'historique F des J derniers jours sans analyser\n");
+    printf("  --rules F     Regles de sante, une par ligne: niveau|alerte|condition (ex: erreur|Extension en echec|component = Extension & value != 0)\n");
+}
+
+// ======================== Main ========================
+int main(int argc, char** argv) {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    ArcScanOptions options;
+    options.agent = false;
+    bool timings = false;
+    bool watch = false;
+    bool verbose = false;
+    bool useCache = true;
+    std::string fleetDir;
+    ReportTarget report;
+    ArcExpiryThresholds expiry;
+    std::string signaturesFile;
+    std::string rulesFile;
+    std::string traceFile;
+    std::string historyFile;
+    double historyDays = 0.0;
+    double sampleSeconds = 30.0;
+    ArcNetworkOptions network;
+    std::string metricsText;
+    ArcNetAddress metricsAddress;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--agent") == 0) options.agent = true;
+        else if (strcmp(argv[i], "--extensions") == 0) options.extensions = true;
+        else if (strcmp(argv[i], "--all") == 0) options.agent = options.extensions = true;
+        else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) options.maxWorkers = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--timings") == 0) timings = true;
+        else if (strcmp(argv[i], "--watch") == 0) watch = true;
+        else if (strcmp(argv[i], "--verbose") == 0) verbose = true;
+        else if (strcmp(argv[i], "--no-cache") == 0) useCache = false;
+        else if (strcmp(argv[i], "--fleet") == 0 && i + 1 < argc) fleetDir = argv[++i];
+        else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc) report.path = argv[++i];
+        else if (strcmp(argv[i], "--log-signatures") == 0 && i + 1 < argc) signaturesFile = argv[++i];
+        else if (strcmp(argv[i], "--rules") == 0 && i + 1 < argc) rulesFile = argv[++i];
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) traceFile = argv[++i];
+        else if (strcmp(argv[i], "--history") == 0 && i + 1 < argc) historyFile = argv[++i];
+        else if (strcmp(argv[i], "--history-days") == 0 && i + 1 < argc) historyDays = strtod(argv[++i], nullptr);
+        else if (strcmp(argv[i], "--sample-interval") == 0 && i + 1 < argc) sampleSeconds = strtod(argv[++i], nullptr);
+        else if (strcmp(argv[i], "--offline") == 0) network.enabled = false;
+        else if (strcmp(argv[i], "--net-timeout") == 0 && i + 1 < argc) network.timeoutMs = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--dns") == 0 && i + 1 < argc) {
+            ArcEndpoint server;
+            uint32_t ipv4 = 0;
+            if (!ParseEndpoint(argv[++i], 53, server) || !ParseIPv4(server.host, ipv4)) { Usage(); return 64; }
+            network.nameservers.push_back({ ipv4, server.port });
+        }
+        else if (strcmp(argv[i], "--metrics") == 0 && i + 1 < argc) {
+            metricsText = argv[++i];
+            if (!ParseListenAddress(metricsText, metricsAddress)) { Usage(); return 64; }
+        }
+        else if (strcmp(argv[i], "--warn-days") == 0 && i + 1 < argc) expiry.warnSeconds = static_cast<int64_t>(strtod(argv[++i], nullptr) * 86400);
+        else if (strcmp(argv[i], "--critical-days") == 0 && i + 1 < argc) expiry.criticalSeconds = static_cast<int64_t>(strtod(argv[++i], nullptr) * 86400);
+        else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc && ParseExportFormat(argv[i + 1], report.format)) {
+            report.formatGiven = true;
+            i++;
+        }
+        else { Usage(); return 64; }
+    }
+    if (!options.agent && !options.extensions) options.agent = true;
+    // Historique propre a un noeud: sans objet pour un parc
+    if ((historyDays > 0 && historyFile.empty()) || (!historyFile.empty() && !fleetDir.empty())) { Usage(); return 64; }
+    // Une passe unique se termine aussitot: rien a servir
+    if (!metricsText.empty() && (!watch || !fleetDir.empty())) { Usage(); return 64; }
+
+    std::unique_ptr<IArcPlatform> platform = CreateNativePlatform();
+    if (!traceFile.empty()) {
+        EnableTrace(true);
+        platform = CreateTracedPlatform(std::move(platform));
+    }
+    InitLog(platform->TempDirectory(), verbose ? ArcLogLevel::Debug : ArcLogLevel::Info);
+    InstallInterruptHandlers();
+
+    std::shared_ptr<const ArcLogMatcher> logSignatures;
+    if (!signaturesFile.empty()) {
+        std::vector<ArcLogSignature> signatures;
+        if (!LoadLogSignatures(*platform, FromUtf8(signaturesFile), signatures)) {
+            printf("ERREUR: aucune signature lisible dans %s\n", signaturesFile.c_str());
+            return 64;
+        }
+        logSignatures = std::make_shared<const ArcLogMatcher>(signatures);
+    }
+    std::shared_ptr<const ArcRuleSet> rules;
+    if (!rulesFile.empty()) {
+        std::vector<ArcRule> definitions;
+        std::wstring error;
+        auto compiled = std::make_shared<ArcRuleSet>();
+        if (!LoadRules(*platform, FromUtf8(rulesFile), definitions, error) || !compiled->Compile(definitions, error)) {
+            printf("ERREUR: regles %s: %s\n", rulesFile.c_str(), ToUtf8(error).c_str());
+            return 64;
+        }
+        Log(L"Regles de sante: " + std::to_wstring(compiled->RuleCount()) + L" regles, " + std::to_wstring(compiled->PredicateCount()) + L" predicats");
+        rules = std::move(compiled);
+    }
+    if (!fleetDir.empty()) return FinishTrace(traceFile, RunFleet(*platform, fleetDir, report, options, expiry, logSignatures, rules));
+
+    ArcHistory history;
+    if (!historyFile.empty() && !history.Open(*platform, FromUtf8(historyFile))) {
+        printf("ERREUR: %s n'est pas un historique lisible\n", historyFile.c_str());
+        return 2;
+    }
+    if (historyDays > 0) return PrintHistory(history, historyFile, historyDays);
+
+    ArcScanContext ctx(*platform);
+    ctx.expiry = expiry;
+    ctx.logSignatures = logSignatures;
+    ctx.rules = rules;
+    ctx.network = network;
+    ctx.cancel = &g_cancel;
+    ArcResultCache cache;
+    if (useCache) {
+        cache.Open(*platform, ctx.stateDir + L"WinTools_AzureArcAgentChecker_results.cache");
+        ctx.cache = &cache;
+    }
+
+    if (watch) {
+        // Echantillonnage des ressources: uniquement en surveillance (une passe n'a qu'un releve)
+        std::unique_ptr<ArcResourceSampler> sampler;
+        if (sampleSeconds > 0) {
+            ArcSamplerOptions samplerOptions;
+            samplerOptions.intervalMs = static_cast<uint32_t>(sampleSeconds * 1000);
+            sampler = std::make_unique<ArcResourceSampler>(*platform, samplerOptions);
+            sampler->Start();
+            ctx.sampler = sampler.get();
+        }
+        std::unique_ptr<ArcMetricsServer> metrics;
+        if (!metricsText.empty()) {
+            metrics = std::make_unique<ArcMetricsServer>(*platform);
+            if (!metrics->Start(metricsAddress)) {
+                printf("ERREUR: impossible d'ecouter sur %s\n", metricsText.c_str());
+                return 2;
+            }
+            const std::string base = "http://" + (metricsText.find(':') == std::string::npos ? "127.0.0.1:" + metricsText : metricsText);
+            printf("Metriques: %s/metrics (Prometheus), %s/metrics.json\n", base.c_str(), base.c_str());
+        }
+        return FinishTrace(traceFile, RunWatch(ctx, options, historyFile.empty() ? nullptr : &history, metrics.get()));
+    }
+
+    ArcScanResult result = RunScan(ctx, options);
+    const ArcComponentList& components = result.components;
+    if (result.cancelled) {
+        // Resultats partiels: ni affichage ni rapport, seules les durees restent utiles
+        printf("Analyse interrompue apres %.0f ms\n", result.wallMs);
+        if (timings) PrintTimings(result);
+        FinishTrace(traceFile, 130);
+        return 130;
+    }
+
+    printf("Azure Arc Agent Checker (%s) - %zu composants\n", ToUtf8(platform->Name()).c_str(), components.size());
+    PrintComponents(components);
+    if (timings) PrintTimings(result);
+    FinishTrace(traceFile, 0);
+    if (!historyFile.empty() && !RecordScan(history, ctx, options, result)) printf("ERREUR: impossible d'enregistrer l'historique %s\n", historyFile.c_str());
+
+    if (!report.path.empty()) {
+        std::unique_ptr<IArcResultWriter> writer = OpenReport(report);
+        if (!writer) return 2;
+        for (const auto& comp : components) writer->Write(L"", components, comp);
+        if (!writer->Finish()) {
+            printf("ERREUR: ecriture incomplete de %s\n", report.path.c_str());
+            return 2;
+        }
+    }
+    Log(L"Verification CLI terminee - " + std::to_wstring(components.size()) + L" composants analyses");
+    return ExitCode(components);
+}
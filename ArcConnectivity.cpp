@@ -0,0 +1,689 @@
+// ArcConnectivity.cpp - Verification de la connectivite vers les points de terminaison de l'agent
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#include "ArcConnectivity.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <unordered_map>
+
+#include "ArcFile.h"
+#include "ArcJson.h"
+#include "ArcScheduler.h"
+#include "ArcText.h"
+
+// ======================== Endpoints ========================
+struct CloudEndpoint {
+    const char* cloud;
+    const char* host;           // "{region}" remplace par la region de la machine
+    const wchar_t* purpose;
+    bool required;
+};
+
+static const CloudEndpoint kCloudEndpoints[] = {
+    { "AzureCloud", "login.microsoftonline.com", L"Entra ID", true },
+    { "AzureCloud", "login.windows.net", L"Entra ID", true },
+    { "AzureCloud", "pas.windows.net", L"Entra ID (PAS)", true },
+    { "AzureCloud", "management.azure.com", L"Azure Resource Manager", true },
+    { "AzureCloud", "gbl.his.arc.azure.com", L"Identite hybride (HIS)", true },
+    { "AzureCloud", "agentserviceapi.guestconfiguration.azure.com", L"Guest Configuration", true },
+    { "AzureCloud", "{region}-gas.guestconfiguration.azure.com", L"Guest Configuration (region)", true },
+    { "AzureCloud", "guestnotificationservice.azure.com", L"Notifications", true },
+    { "AzureCloud", "download.microsoft.com", L"Mises a jour de l'agent", false },
+    { "AzureCloud", "packages.microsoft.com", L"Paquets", false },
+    { "AzureCloud", "dc.services.visualstudio.com", L"Telemetrie", false },
+
+    { "AzureUSGovernment", "login.microsoftonline.us", L"Entra ID", true },
+    { "AzureUSGovernment", "pasff.usgovcloudapi.net", L"Entra ID (PAS)", true },
+    { "AzureUSGovernment", "management.usgovcloudapi.net", L"Azure Resource Manager", true },
+    { "AzureUSGovernment", "gbl.his.arc.azure.us", L"Identite hybride (HIS)", true },
+    { "AzureUSGovernment", "agentserviceapi.guestconfiguration.azure.us", L"Guest Configuration", true },
+    { "AzureUSGovernment", "{region}-gas.guestconfiguration.azure.us", L"Guest Configuration (region)", true },
+    { "AzureUSGovernment", "guestnotificationservice.azure.us", L"Notifications", true },
+    { "AzureUSGovernment", "download.microsoft.com", L"Mises a jour de l'agent", false },
+    { "AzureUSGovernment", "packages.microsoft.com", L"Paquets", false },
+
+    { "AzureChinaCloud", "login.chinacloudapi.cn", L"Entra ID", true },
+    { "AzureChinaCloud", "login.partner.microsoftonline.cn", L"Entra ID", true },
+    { "AzureChinaCloud", "pas.chinacloudapi.cn", L"Entra ID (PAS)", true },
+    { "AzureChinaCloud", "management.chinacloudapi.cn", L"Azure Resource Manager", true },
+    { "AzureChinaCloud", "gbl.his.arc.azure.cn", L"Identite hybride (HIS)", true },
+    { "AzureChinaCloud", "agentserviceapi.guestconfiguration.azure.cn", L"Guest Configuration", true },
+    { "AzureChinaCloud", "{region}-gas.guestconfiguration.azure.cn", L"Guest Configuration (region)", true },
+    { "AzureChinaCloud", "guestnotificationservice.azure.cn", L"Notifications", true },
+    { "AzureChinaCloud", "download.microsoft.com", L"Mises a jour de l'agent", false },
+    { "AzureChinaCloud", "packages.microsoft.com", L"Paquets", false },
+};
+
+static char LowerAscii(char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; }
+
+static bool EqualsNoCaseA(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (LowerAscii(a[i]) != LowerAscii(b[i])) return false;
+    }
+    return true;
+}
+
+bool ParseIPv4(std::string_view text, uint32_t& ipv4) {
+    uint32_t value = 0;
+    size_t parts = 0;
+    size_t i = 0;
+    while (parts < 4) {
+        uint32_t octet = 0;
+        size_t digits = 0;
+        while (i < text.size() && text[i] >= '0' && text[i] <= '9' && digits < 3) {
+            octet = octet * 10 + static_cast<uint32_t>(text[i++] - '0');
+            digits++;
+        }
+        if (!digits || octet > 255) return false;
+        value = (value << 8) | octet;
+        if (++parts < 4) {
+            if (i >= text.size() || text[i] != '.') return false;
+            i++;
+        }
+    }
+    if (i != text.size()) return false;
+    ipv4 = value;
+    return true;
+}
+
+std::wstring FormatAddress(const ArcNetAddress& address) {
+    std::wstring text;
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        if (shift != 24) text += L'.';
+        text += std::to_wstring((address.ipv4 >> shift) & 0xFF);
+    }
+    return text + L":" + std::to_wstring(address.port);
+}
+
+bool ParseEndpoint(std::string_view text, uint16_t defaultPort, ArcEndpoint& out) {
+    const size_t scheme = text.find("://");
+    if (scheme != std::string_view::npos) {
+        if (EqualsNoCaseA(text.substr(0, scheme), "http")) defaultPort = 80;
+        else if (EqualsNoCaseA(text.substr(0, scheme), "https")) defaultPort = 443;
+        text.remove_prefix(scheme + 3);
+    }
+    text = text.substr(0, text.find_first_of("/?#"));
+    const size_t at = text.rfind('@');                  // Identifiants du proxy: ignores
+    if (at != std::string_view::npos) text.remove_prefix(at + 1);
+
+    uint32_t port = defaultPort;
+    const size_t colon = text.rfind(':');
+    if (colon != std::string_view::npos) {
+        port = 0;
+        for (char c : text.substr(colon + 1)) {
+            if (c < '0' || c > '9' || port > 65535) return false;
+            port = port * 10 + static_cast<uint32_t>(c - '0');
+        }
+        text = text.substr(0, colon);
+    }
+    if (text.empty() || port == 0 || port > 65535) return false;
+
+    out.host.clear();
+    for (char c : text) out.host += LowerAscii(c);
+    out.port = static_cast<uint16_t>(port);
+    return true;
+}
+
+std::vector<ArcEndpoint> EndpointsFromConfig(std::string_view agentConfigJson, ArcProxySettings& proxy) {
+    static const std::vector<std::string_view> paths = {
+        "cloud", "properties.cloud",
+        "location", "properties.location",
+        "proxy.url", "config.proxy.url", "proxyUrl",
+        "endpoints.[]"
+    };
+    std::string cloud, location, proxyUrl;
+    std::vector<ArcEndpoint> explicitEndpoints;
+
+    JsonStreamExtractor json(paths);
+    json.Feed(agentConfigJson, [&](size_t path, std::string_view raw, JsonType type, bool) {
+        if (type != JsonType::String) return;
+        const std::string value = JsonUnescape(raw);
+        if (path <= 1) cloud = value;
+        else if (path <= 3) location = value;
+        else if (path <= 6) proxyUrl = value;
+        else {
+            ArcEndpoint e;
+            if (ParseEndpoint(value, 443, e)) {
+                e.purpose = L"Configuration";
+                explicitEndpoints.push_back(std::move(e));
+            }
+        }
+    });
+
+    proxy = ArcProxySettings();
+    ArcEndpoint proxyEndpoint;
+    if (!proxyUrl.empty() && ParseEndpoint(proxyUrl, 80, proxyEndpoint)) {
+        proxy.host = proxyEndpoint.host;
+        proxy.port = proxyEndpoint.port;
+    }
+    if (!explicitEndpoints.empty()) return explicitEndpoints;
+
+    // "West Europe" -> "westeurope"
+    std::string region;
+    for (char c : location) {
+        if (c != ' ') region += LowerAscii(c);
+    }
+    const bool known = std::any_of(std::begin(kCloudEndpoints), std::end(kCloudEndpoints),
+        [&cloud](const CloudEndpoint& e) { return EqualsNoCaseA(cloud, e.cloud); });
+    const std::string_view selected = known ? std::string_view(cloud) : "AzureCloud";
+
+    std::vector<ArcEndpoint> endpoints;
+    for (const auto& entry : kCloudEndpoints) {
+        if (!EqualsNoCaseA(selected, entry.cloud)) continue;
+        std::string host = entry.host;
+        const size_t token = host.find("{region}");
+        if (token != std::string::npos) {
+            if (region.empty()) continue;
+            host.replace(token, 8, region);
+        }
+        ArcEndpoint e;
+        e.host = std::move(host);
+        e.purpose = entry.purpose;
+        e.required = entry.required;
+        endpoints.push_back(std::move(e));
+    }
+    return endpoints;
+}
+
+// ======================== Wire Formats ========================
+static void PutU16(std::string& out, size_t v) {
+    out += static_cast<char>((v >> 8) & 0xFF);
+    out += static_cast<char>(v & 0xFF);
+}
+
+static size_t GetU16(std::string_view s, size_t pos) {
+    return (static_cast<size_t>(static_cast<uint8_t>(s[pos])) << 8) | static_cast<uint8_t>(s[pos + 1]);
+}
+
+// Requete A recursive; vide si le nom est invalide
+static std::string BuildDnsQuery(std::string_view host, uint16_t id) {
+    std::string q;
+    PutU16(q, id);
+    PutU16(q, 0x0100);          // RD
+    PutU16(q, 1);               // QDCOUNT
+    PutU16(q, 0);
+    PutU16(q, 0);
+    PutU16(q, 0);
+    if (host.empty() || host.size() > 253) return {};
+    while (!host.empty()) {
+        const size_t dot = host.find('.');
+        const std::string_view label = host.substr(0, dot);
+        if (label.empty() || label.size() > 63) return {};
+        q += static_cast<char>(label.size());
+        q.append(label);
+        host = dot == std::string_view::npos ? std::string_view() : host.substr(dot + 1);
+    }
+    q += '\0';
+    PutU16(q, 1);               // A
+    PutU16(q, 1);               // IN
+    return q;
+}
+
+static bool SkipDnsName(std::string_view msg, size_t& pos) {
+    while (pos < msg.size()) {
+        const uint8_t len = static_cast<uint8_t>(msg[pos]);
+        if (len == 0) { pos++; return true; }
+        if ((len & 0xC0) == 0xC0) { pos += 2; return pos <= msg.size(); }
+        pos += 1 + len;
+    }
+    return false;
+}
+
+enum class DnsAnswer { Ignore, Address, NoAddress, NameError, Failure };
+
+// Premier enregistrement A de la reponse (les CNAME intermediaires sont sautes)
+static DnsAnswer ParseDnsResponse(std::string_view msg, uint16_t id, uint32_t& ipv4) {
+    if (msg.size() < 12 || GetU16(msg, 0) != id || !(static_cast<uint8_t>(msg[2]) & 0x80)) return DnsAnswer::Ignore;
+    const uint8_t rcode = static_cast<uint8_t>(msg[3]) & 0x0F;
+    if (rcode == 3) return DnsAnswer::NameError;
+    if (rcode != 0) return DnsAnswer::Failure;
+
+    size_t pos = 12;
+    for (size_t q = GetU16(msg, 4); q > 0; q--) {
+        if (!SkipDnsName(msg, pos) || pos + 4 > msg.size()) return DnsAnswer::Failure;
+        pos += 4;
+    }
+    for (size_t a = GetU16(msg, 6); a > 0; a--) {
+        if (!SkipDnsName(msg, pos) || pos + 10 > msg.size()) return DnsAnswer::Failure;
+        const size_t type = GetU16(msg, pos);
+        const size_t length = GetU16(msg, pos + 8);
+        pos += 10;
+        if (pos + length > msg.size()) return DnsAnswer::Failure;
+        if (type == 1 && length == 4) {
+            ipv4 = 0;
+            for (size_t i = 0; i < 4; i++) ipv4 = (ipv4 << 8) | static_cast<uint8_t>(msg[pos + i]);
+            return DnsAnswer::Address;
+        }
+        pos += length;
+    }
+    return DnsAnswer::NoAddress;
+}
+
+// ClientHello TLS 1.2 / 1.3 (SNI, groupes, signatures, key_share X25519 aleatoire).
+// La sonde s'arrete au ServerHello: aucune cle n'est jamais utilisee.
+static std::string BuildClientHello(std::string_view sni, std::mt19937& rng) {
+    auto random = [&rng](std::string& out, size_t n) {
+        for (size_t i = 0; i < n; i++) out += static_cast<char>(rng() & 0xFF);
+    };
+    auto block16 = [](std::string& out, const std::string& body) { PutU16(out, body.size()); out += body; };
+
+    std::string ext;
+    if (!sni.empty()) {
+        std::string name;
+        name += '\0';                                   // host_name
+        PutU16(name, sni.size());
+        name.append(sni);
+        std::string list;
+        block16(list, name);
+        PutU16(ext, 0x0000);
+        block16(ext, list);
+    }
+    PutU16(ext, 0x000A);                                // supported_groups: x25519, P-256, P-384
+    block16(ext, std::string("\x00\x06\x00\x1D\x00\x17\x00\x18", 8));
+    PutU16(ext, 0x000B);                                // ec_point_formats: uncompressed
+    block16(ext, std::string("\x01\x00", 2));
+    PutU16(ext, 0x000D);                                // signature_algorithms
+    block16(ext, std::string("\x00\x10\x04\x03\x08\x04\x04\x01\x05\x03\x08\x05\x05\x01\x08\x06\x06\x01", 18));
+    PutU16(ext, 0x002B);                                // supported_versions: TLS 1.3, 1.2
+    block16(ext, std::string("\x04\x03\x04\x03\x03", 5));
+    PutU16(ext, 0x002D);                                // psk_key_exchange_modes: psk_dhe_ke
+    block16(ext, std::string("\x01\x01", 2));
+    std::string share("\x00\x1D\x00\x20", 4);           // key_share: x25519
+    random(share, 32);
+    std::string shares;
+    block16(shares, share);
+    PutU16(ext, 0x0033);
+    block16(ext, shares);
+
+    std::string hello("\x03\x03", 2);                   // legacy_version TLS 1.2
+    random(hello, 32);
+    hello += static_cast<char>(32);                     // legacy_session_id (compatibilite)
+    random(hello, 32);
+    block16(hello, std::string("\x13\x01\x13\x02\x13\x03\xC0\x2B\xC0\x2F\xC0\x2C\xC0\x30\xCC\xA9\xCC\xA8\xC0\x13\xC0\x14\x00\x9C\x00\x9D\x00\x2F\x00\x35", 30));
+    hello.append("\x01\x00", 2);                        // compression: null
+    block16(hello, ext);
+
+    std::string handshake(1, '\x01');                   // ClientHello
+    handshake += static_cast<char>((hello.size() >> 16) & 0xFF);
+    PutU16(handshake, hello.size() & 0xFFFF);
+    handshake += hello;
+
+    std::string record("\x16\x03\x01", 3);
+    block16(record, handshake);
+    return record;
+}
+
+static std::wstring TlsAlertName(uint8_t code) {
+    switch (code) {
+        case 40: return L"handshake_failure";
+        case 42: return L"bad_certificate";
+        case 47: return L"illegal_parameter";
+        case 70: return L"protocol_version";
+        case 71: return L"insufficient_security";
+        case 80: return L"internal_error";
+        case 112: return L"unrecognized_name";
+        default: return std::to_wstring(code);
+    }
+}
+
+static std::wstring DescribeNetError(ArcNetError error) {
+    switch (error) {
+        case ArcNetError::Refused: return L"Connexion refusee";
+        case ArcNetError::Unreachable: return L"Reseau ou hote injoignable";
+        case ArcNetError::Reset: return L"Connexion reinitialisee";
+        case ArcNetError::TimedOut: return L"Delai de connexion depasse";
+        default: return L"Echec de connexion";
+    }
+}
+
+// ======================== Hosts File ========================
+static void LoadHosts(IArcPlatform& platform, const std::wstring& path, std::unordered_map<std::string, uint32_t>& hosts) {
+    ArcFileBytes file;
+    if (!file.Open(platform, path)) return;
+    std::string_view text = file.Utf8();
+    while (!text.empty()) {
+        const size_t eol = text.find('\n');
+        std::string_view line = text.substr(0, eol);
+        text = eol == std::string_view::npos ? std::string_view() : text.substr(eol + 1);
+        line = line.substr(0, line.find('#'));
+
+        // Adresse IPv4 puis noms, separes par des blancs
+        uint32_t ipv4 = 0;
+        bool first = true;
+        while (!line.empty()) {
+            const size_t start = line.find_first_not_of(" \t\r");
+            if (start == std::string_view::npos) break;
+            line.remove_prefix(start);
+            const size_t end = std::min(line.find_first_of(" \t\r"), line.size());
+            const std::string_view token = line.substr(0, end);
+            line.remove_prefix(end);
+            if (first) {
+                if (!ParseIPv4(token, ipv4)) break;
+                first = false;
+                continue;
+            }
+            std::string name;
+            for (char c : token) name += LowerAscii(c);
+            hosts.emplace(std::move(name), ipv4);    // Premiere occurrence prioritaire
+        }
+    }
+}
+
+// ======================== Probe Loop ========================
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Probe {
+    ArcEndpointStatus* status = nullptr;
+    ArcNetStage stage = ArcNetStage::Dns;
+    bool finished = false;
+    Clock::time_point stageStart;
+    std::string target;                 // Nom resolu: proxy ou point de terminaison
+    uint16_t dnsId = 0;
+    std::vector<int> dnsSockets;        // Une requete par serveur, la premiere reponse l'emporte
+    int socket = -1;
+    std::string out;
+    size_t sent = 0;
+    std::string in;
+};
+
+class PreflightLoop {
+public:
+    PreflightLoop(IArcNetLoop& loop, const ArcProxySettings& proxy, const ArcNetworkOptions& options,
+        std::vector<ArcNetAddress> nameservers, std::unordered_map<std::string, uint32_t> hosts, const ArcCancelToken* cancel)
+        : loop_(loop), proxy_(proxy), options_(options), nameservers_(std::move(nameservers)), hosts_(std::move(hosts)),
+          cancel_(cancel), rng_(std::random_device{}()) {}
+
+    void Run(std::vector<ArcEndpointStatus>& statuses) {
+        probes_.resize(statuses.size());
+        for (size_t i = 0; i < statuses.size(); i++) {
+            probes_[i].status = &statuses[i];
+            Start(i);
+        }
+
+        std::vector<ArcNetEvent> ready;
+        for (;;) {
+            // Delai le plus proche parmi les sondes en cours
+            Clock::time_point next = Clock::time_point::max();
+            for (const auto& p : probes_) {
+                if (!p.finished) next = std::min(next, p.stageStart + std::chrono::milliseconds(options_.timeoutMs));
+            }
+            if (next == Clock::time_point::max()) break;
+            if (IsCancelled(cancel_)) {
+                for (size_t i = 0; i < probes_.size(); i++) Fail(i, L"Annule");
+                break;
+            }
+
+            // Annulable: attente decoupee en tranches de 100 ms au plus
+            auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next - Clock::now()).count();
+            if (cancel_) wait = std::min<long long>(wait, 100);
+            if (!loop_.Wait(static_cast<uint32_t>(std::max<long long>(0, wait) + 1), ready)) {
+                for (size_t i = 0; i < probes_.size(); i++) Fail(i, L"Attente reseau en echec");
+                break;
+            }
+            for (const auto& e : ready) {
+                if (e.socket >= 0 && static_cast<size_t>(e.socket) < owner_.size()) Dispatch(owner_[e.socket], e);
+            }
+
+            const Clock::time_point now = Clock::now();
+            for (size_t i = 0; i < probes_.size(); i++) {
+                Probe& p = probes_[i];
+                if (!p.finished && now - p.stageStart >= std::chrono::milliseconds(options_.timeoutMs)) {
+                    Fail(i, L"Delai depasse (" + std::to_wstring(options_.timeoutMs) + L" ms)");
+                }
+            }
+        }
+    }
+
+private:
+    double ElapsedMs(const Probe& p) const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - p.stageStart).count();
+    }
+
+    void Track(int socket, size_t probe) {
+        if (static_cast<size_t>(socket) >= owner_.size()) owner_.resize(socket + 1, 0);
+        owner_[socket] = probe;
+    }
+
+    void CloseAll(Probe& p) {
+        for (int s : p.dnsSockets) loop_.Close(s);
+        p.dnsSockets.clear();
+        if (p.socket >= 0) loop_.Close(p.socket);
+        p.socket = -1;
+    }
+
+    void Fail(size_t i, std::wstring error) {
+        Probe& p = probes_[i];
+        if (p.finished) return;
+        CloseAll(p);
+        p.status->failedAt = p.stage;
+        p.status->error = std::move(error);
+        p.finished = true;
+    }
+
+    void Succeed(size_t i) {
+        Probe& p = probes_[i];
+        CloseAll(p);
+        p.status->failedAt = ArcNetStage::Done;
+        p.finished = true;
+    }
+
+    // ---- DNS ----
+    void Start(size_t i) {
+        Probe& p = probes_[i];
+        p.stage = ArcNetStage::Dns;
+        p.stageStart = Clock::now();
+        p.status->viaProxy = proxy_.enabled();
+        p.target = proxy_.enabled() ? proxy_.host : p.status->endpoint.host;
+
+        uint32_t ipv4 = 0;
+        if (ParseIPv4(p.target, ipv4)) return Resolved(i, ipv4);
+        auto known = hosts_.find(p.target);
+        if (known != hosts_.end()) return Resolved(i, known->second);
+        if (nameservers_.empty()) return Fail(i, L"Aucun serveur DNS configure");
+
+        p.dnsId = static_cast<uint16_t>(rng_());
+        const std::string query = BuildDnsQuery(p.target, p.dnsId);
+        if (query.empty()) return Fail(i, L"Nom d'hote invalide");
+        for (size_t n = 0; n < nameservers_.size() && n < 3; n++) {
+            const int s = loop_.OpenUdp(nameservers_[n]);
+            if (s < 0 || loop_.Send(s, query) != static_cast<int>(query.size())) {
+                if (s >= 0) loop_.Close(s);
+                continue;
+            }
+            Track(s, i);
+            loop_.Watch(s, true, false);
+            p.dnsSockets.push_back(s);
+        }
+        if (p.dnsSockets.empty()) Fail(i, L"Serveur DNS injoignable");
+    }
+
+    void OnDns(size_t i, int socket) {
+        Probe& p = probes_[i];
+        char buffer[1500];
+        const int n = loop_.Recv(socket, buffer, sizeof(buffer));
+        if (n == kArcNetWouldBlock) return;
+        uint32_t ipv4 = 0;
+        const DnsAnswer answer = n > 0 ? ParseDnsResponse(std::string_view(buffer, static_cast<size_t>(n)), p.dnsId, ipv4) : DnsAnswer::Failure;
+        switch (answer) {
+            case DnsAnswer::Ignore:
+                return;
+            case DnsAnswer::Address:
+                return Resolved(i, ipv4);
+            case DnsAnswer::NameError:
+                return Fail(i, L"Nom inconnu (NXDOMAIN)");
+            case DnsAnswer::NoAddress:
+                return Fail(i, L"Aucune adresse IPv4");
+            case DnsAnswer::Failure:
+                break;
+        }
+        // Serveur en echec: les autres peuvent encore repondre
+        loop_.Close(socket);
+        p.dnsSockets.erase(std::remove(p.dnsSockets.begin(), p.dnsSockets.end(), socket), p.dnsSockets.end());
+        if (p.dnsSockets.empty()) Fail(i, n < 0 ? L"Serveur DNS injoignable" : L"Reponse DNS en erreur");
+    }
+
+    // ---- TCP ----
+    void Resolved(size_t i, uint32_t ipv4) {
+        Probe& p = probes_[i];
+        p.status->dnsMs = ElapsedMs(p);
+        for (int s : p.dnsSockets) loop_.Close(s);
+        p.dnsSockets.clear();
+
+        p.stage = ArcNetStage::Tcp;
+        p.stageStart = Clock::now();
+        p.status->address = { ipv4, proxy_.enabled() ? proxy_.port : p.status->endpoint.port };
+        p.socket = loop_.ConnectTcp(p.status->address);
+        if (p.socket < 0) return Fail(i, L"Socket indisponible");
+        Track(p.socket, i);
+        loop_.Watch(p.socket, false, true);
+    }
+
+    void OnConnected(size_t i) {
+        Probe& p = probes_[i];
+        const ArcNetError error = loop_.SocketError(p.socket);
+        if (error != ArcNetError::None) return Fail(i, DescribeNetError(error));
+        p.status->tcpMs = ElapsedMs(p);
+
+        p.stageStart = Clock::now();
+        p.in.clear();
+        if (proxy_.enabled()) {
+            const ArcEndpoint& e = p.status->endpoint;
+            const std::string authority = e.host + ":" + std::to_string(e.port);
+            p.stage = ArcNetStage::Proxy;
+            p.out = "CONNECT " + authority + " HTTP/1.1\r\nHost: " + authority + "\r\n\r\n";
+        } else {
+            StartTls(p);
+        }
+        p.sent = 0;
+        Flush(i);
+    }
+
+    void StartTls(Probe& p) {
+        uint32_t literal = 0;
+        const std::string& host = p.status->endpoint.host;
+        p.stage = ArcNetStage::Tls;
+        p.out = BuildClientHello(ParseIPv4(host, literal) ? std::string_view() : std::string_view(host), rng_);
+        p.sent = 0;
+        p.in.clear();
+    }
+
+    void Flush(size_t i) {
+        Probe& p = probes_[i];
+        while (p.sent < p.out.size()) {
+            const int n = loop_.Send(p.socket, std::string_view(p.out).substr(p.sent));
+            if (n < 0) return Fail(i, L"Connexion interrompue a l'envoi");
+            if (n == 0) {
+                loop_.Watch(p.socket, true, true);
+                return;
+            }
+            p.sent += static_cast<size_t>(n);
+        }
+        loop_.Watch(p.socket, true, false);
+    }
+
+    // ---- CONNECT / TLS ----
+    void OnReadable(size_t i) {
+        Probe& p = probes_[i];
+        char buffer[4096];
+        const int n = loop_.Recv(p.socket, buffer, sizeof(buffer));
+        if (n == kArcNetWouldBlock) return;
+        if (n <= 0) {
+            return Fail(i, p.stage == ArcNetStage::Proxy ? L"Connexion fermee par le proxy" : L"Connexion fermee pendant la negociation TLS");
+        }
+        if (p.in.size() < 8192) p.in.append(buffer, static_cast<size_t>(n));
+        if (p.stage == ArcNetStage::Proxy) OnProxyResponse(i);
+        else OnServerHello(i);
+    }
+
+    void OnProxyResponse(size_t i) {
+        Probe& p = probes_[i];
+        if (p.in.find("\r\n\r\n") == std::string::npos) {
+            if (p.in.size() >= 8192) Fail(i, L"Reponse du proxy illisible");
+            return;
+        }
+        // "HTTP/1.1 200 Connection established"
+        const size_t space = p.in.find(' ');
+        const int code = space == std::string::npos ? 0 : atoi(p.in.c_str() + space + 1);
+        if (code != 200) return Fail(i, L"Proxy: HTTP " + std::to_wstring(code) + (code == 407 ? L" (authentification requise)" : L""));
+        p.status->proxyMs = ElapsedMs(p);
+        p.stageStart = Clock::now();
+        StartTls(p);
+        Flush(i);
+    }
+
+    void OnServerHello(size_t i) {
+        Probe& p = probes_[i];
+        const uint8_t type = static_cast<uint8_t>(p.in[0]);
+        if (type == 0x15) {                                 // Alerte
+            if (p.in.size() < 7) return;
+            return Fail(i, L"Alerte TLS " + TlsAlertName(static_cast<uint8_t>(p.in[6])));
+        }
+        if (type != 0x16) return Fail(i, L"Reponse non TLS");
+        if (p.in.size() < 6) return;
+        if (static_cast<uint8_t>(p.in[5]) != 0x02) return Fail(i, L"Negociation TLS inattendue");
+        p.status->tlsMs = ElapsedMs(p);
+        Succeed(i);
+    }
+
+    void Dispatch(size_t i, const ArcNetEvent& e) {
+        Probe& p = probes_[i];
+        if (p.finished) return;
+        switch (p.stage) {
+            case ArcNetStage::Dns:
+                if (std::find(p.dnsSockets.begin(), p.dnsSockets.end(), e.socket) != p.dnsSockets.end()) OnDns(i, e.socket);
+                break;
+            case ArcNetStage::Tcp:
+                if (e.socket == p.socket && (e.writable || e.failed)) OnConnected(i);
+                break;
+            case ArcNetStage::Proxy:
+            case ArcNetStage::Tls:
+                if (e.socket != p.socket) break;
+                if (e.writable && p.sent < p.out.size()) Flush(i);
+                if (!p.finished && (e.readable || e.failed)) OnReadable(i);
+                break;
+            case ArcNetStage::Done:
+                break;
+        }
+    }
+
+    IArcNetLoop& loop_;
+    const ArcProxySettings& proxy_;
+    const ArcNetworkOptions& options_;
+    std::vector<ArcNetAddress> nameservers_;
+    std::unordered_map<std::string, uint32_t> hosts_;
+    const ArcCancelToken* cancel_;
+    std::mt19937 rng_;
+    std::vector<Probe> probes_;
+    std::vector<size_t> owner_;         // Socket -> sonde
+};
+
+}  // namespace
+
+std::vector<ArcEndpointStatus> ProbeEndpoints(IArcPlatform& platform, const std::vector<ArcEndpoint>& endpoints,
+    const ArcProxySettings& proxy, const ArcNetworkOptions& options, const ArcCancelToken* cancel) {
+    std::vector<ArcEndpointStatus> statuses(endpoints.size());
+    for (size_t i = 0; i < endpoints.size(); i++) statuses[i].endpoint = endpoints[i];
+    if (endpoints.empty()) return statuses;
+
+    std::unique_ptr<IArcNetLoop> loop = platform.CreateNetLoop();
+    if (!loop) {
+        for (auto& s : statuses) {
+            s.failedAt = ArcNetStage::Dns;
+            s.error = L"Pile reseau indisponible";
+        }
+        return statuses;
+    }
+
+    std::unordered_map<std::string, uint32_t> hosts;
+    LoadHosts(platform, options.hostsFile.empty() ? platform.HostsFile() : options.hostsFile, hosts);
+    PreflightLoop preflight(*loop, proxy, options, options.nameservers.empty() ? platform.DnsServers() : options.nameservers, std::move(hosts),
+        cancel);
+    preflight.Run(statuses);
+    return statuses;
+}
@@ -0,0 +1,68 @@
+// ArcConnectivity.h - Verification de la connectivite vers les points de terminaison de l'agent
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Chaque point de terminaison passe par les etapes DNS (UDP, fichier hosts d'abord), TCP,
+// CONNECT (si proxy) et negociation TLS jusqu'au ServerHello. Toutes les sondes avancent
+// en meme temps sur une seule boucle de sockets non bloquants, avec un delai par etape:
+// la duree totale est celle du point de terminaison le plus lent, pas leur somme.
+// Seules les adresses IPv4 sont resolues et contactees.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ArcPlatform.h"
+
+struct ArcEndpoint {
+    std::string host;           // Nom DNS ou adresse IPv4
+    uint16_t port = 443;
+    std::wstring purpose;       // Service rendu (Entra ID, ARM, ...)
+    bool required = true;       // Echec: erreur (sinon avertissement)
+};
+
+// Proxy HTTP (tunnel CONNECT); l'authentification n'est pas geree
+struct ArcProxySettings {
+    std::string host;
+    uint16_t port = 0;
+    bool enabled() const { return !host.empty(); }
+};
+
+struct ArcNetworkOptions {
+    bool enabled = true;
+    uint32_t timeoutMs = 3000;              // Par etape: DNS, TCP, CONNECT, TLS
+    std::vector<ArcNetAddress> nameservers; // Vide = serveurs du systeme
+    std::wstring hostsFile;                 // Vide = fichier hosts du systeme
+};
+
+enum class ArcNetStage { Dns, Tcp, Proxy, Tls, Done };
+
+struct ArcEndpointStatus {
+    ArcEndpoint endpoint;
+    ArcNetStage failedAt = ArcNetStage::Done;   // Done = joignable
+    std::wstring error;
+    ArcNetAddress address;                      // Adresse contactee (celle du proxy le cas echeant)
+    bool viaProxy = false;
+    double dnsMs = 0.0;                         // Duree de chaque etape franchie
+    double tcpMs = 0.0;
+    double proxyMs = 0.0;
+    double tlsMs = 0.0;
+};
+
+// "hote", "hote:port" ou URL "scheme://hote[:port][/...]"
+bool ParseEndpoint(std::string_view text, uint16_t defaultPort, ArcEndpoint& out);
+bool ParseIPv4(std::string_view text, uint32_t& ipv4);
+std::wstring FormatAddress(const ArcNetAddress& address);
+
+// Liste deduite du cloud (AzureCloud, AzureUSGovernment, AzureChinaCloud) et de la region;
+// un tableau "endpoints" (chaines "hote[:port]" ou URL) la remplace. Proxy: proxy.url,
+// config.proxy.url ou proxyUrl. Document vide: cloud public, sans region.
+std::vector<ArcEndpoint> EndpointsFromConfig(std::string_view agentConfigJson, ArcProxySettings& proxy);
+
+class ArcCancelToken;
+
+// Un resultat par point de terminaison, dans l'ordre de la liste. Annulation: les sondes en
+// cours echouent avec l'erreur "Annule" dans les 100 ms.
+std::vector<ArcEndpointStatus> ProbeEndpoints(IArcPlatform& platform, const std::vector<ArcEndpoint>& endpoints,
+    const ArcProxySettings& proxy, const ArcNetworkOptions& options, const ArcCancelToken* cancel = nullptr);
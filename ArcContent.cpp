@@ -0,0 +1,101 @@
+// ArcContent.cpp - Resultats d'analyse partages par contenu (deduplication des artefacts d'un parc)
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#include "ArcContent.h"
+
+#include <cstring>
+
+// ======================== Hash ========================
+static constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+static constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+static constexpr uint64_t kPrime3 = 0x165667B19E3779F9ull;
+static constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ull;
+static constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ull;
+
+static inline uint64_t Rotl(uint64_t v, int r) { return (v << r) | (v >> (64 - r)); }
+
+static inline uint64_t Load64(const char* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t Load32(const char* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t Round(uint64_t acc, uint64_t input) {
+    return Rotl(acc + input * kPrime2, 31) * kPrime1;
+}
+
+static inline uint64_t MergeRound(uint64_t acc, uint64_t lane) {
+    return (acc ^ Round(0, lane)) * kPrime1 + kPrime4;
+}
+
+// Ordre des octets natif: l'empreinte n'est ni persistee ni echangee
+uint64_t ArcContentHash(std::string_view bytes) {
+    const char* p = bytes.data();
+    const char* const end = p + bytes.size();
+    uint64_t h;
+
+    if (bytes.size() >= 32) {
+        uint64_t v1 = kPrime1 + kPrime2, v2 = kPrime2, v3 = 0, v4 = 0 - kPrime1;
+        for (const char* limit = end - 32; p <= limit; p += 32) {
+            v1 = Round(v1, Load64(p));
+            v2 = Round(v2, Load64(p + 8));
+            v3 = Round(v3, Load64(p + 16));
+            v4 = Round(v4, Load64(p + 24));
+        }
+        h = Rotl(v1, 1) + Rotl(v2, 7) + Rotl(v3, 12) + Rotl(v4, 18);
+        h = MergeRound(MergeRound(MergeRound(MergeRound(h, v1), v2), v3), v4);
+    } else {
+        h = kPrime5;
+    }
+    h += bytes.size();
+
+    for (; p + 8 <= end; p += 8) h = Rotl(h ^ Round(0, Load64(p)), 27) * kPrime1 + kPrime4;
+    if (p + 4 <= end) {
+        h = Rotl(h ^ (Load32(p) * kPrime1), 23) * kPrime2 + kPrime3;
+        p += 4;
+    }
+    for (; p < end; p++) h = Rotl(h ^ (static_cast<uint8_t>(*p) * kPrime5), 11) * kPrime1;
+
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
+
+// ======================== Cache ========================
+bool ArcContentCache::Lookup(const ArcContentKey& key, std::string_view& value) {
+    lookups_.fetch_add(1, std::memory_order_relaxed);
+    Shard& shard = ShardOf(key);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.values.find(key);
+        if (it == shard.values.end()) return false;
+        value = it->second;     // Noeud stable: la vue survit aux insertions
+    }
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    skippedBytes_.fetch_add(key.size, std::memory_order_relaxed);
+    return true;
+}
+
+void ArcContentCache::Store(const ArcContentKey& key, std::string value) {
+    Shard& shard = ShardOf(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.values.try_emplace(key, std::move(value));
+}
+
+size_t ArcContentCache::Entries() const {
+    size_t n = 0;
+    for (const Shard& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        n += shard.values.size();
+    }
+    return n;
+}
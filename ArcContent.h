@@ -0,0 +1,68 @@
+// ArcContent.h - Resultats d'analyse partages par contenu (deduplication des artefacts d'un parc)
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Dans un parc, la plupart des agentconfig.json, fichiers de statut et certificats sont
+// identiques octet pour octet d'un hote a l'autre. Chaque fichier lu est identifie par une
+// empreinte rapide de son contenu (64 bits, non cryptographique) et sa taille; le resultat
+// analyse (meme encodage que ArcResultCache) est conserve en memoire pour la duree de
+// l'analyse, et chaque contenu distinct n'est analyse qu'une fois.
+//
+// Le fichier est toujours lu (l'empreinte porte sur les octets): seule l'analyse est evitee.
+// Collision: deux contenus de meme taille et de meme empreinte 64 bits partageraient leur
+// resultat; probabilite negligeable a l'echelle d'un parc, et rien n'est persiste.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "ArcCache.h"
+
+// Empreinte 64 bits (schema xxHash64: quatre voies de 8 octets, melange final)
+uint64_t ArcContentHash(std::string_view bytes);
+
+struct ArcContentKey {
+    uint64_t hash = 0;
+    uint64_t size = 0;
+    ArcCacheKind kind = ArcCacheKind::Config;
+
+    bool operator==(const ArcContentKey& o) const { return hash == o.hash && size == o.size && kind == o.kind; }
+};
+
+class ArcContentCache {
+public:
+    static ArcContentKey Key(ArcCacheKind kind, std::string_view bytes) {
+        return ArcContentKey{ ArcContentHash(bytes), bytes.size(), kind };
+    }
+
+    // Thread-safe. La vue reste valide pendant toute la vie du cache (entrees jamais retirees).
+    bool Lookup(const ArcContentKey& key, std::string_view& value);
+    // Un contenu analyse en parallele par deux threads: la premiere valeur est conservee
+    void Store(const ArcContentKey& key, std::string value);
+
+    uint64_t Lookups() const { return lookups_.load(std::memory_order_relaxed); }
+    uint64_t Hits() const { return hits_.load(std::memory_order_relaxed); }
+    uint64_t SkippedBytes() const { return skippedBytes_.load(std::memory_order_relaxed); }     // Octets non reanalyses
+    size_t Entries() const;
+
+private:
+    struct KeyHash {
+        size_t operator()(const ArcContentKey& k) const { return static_cast<size_t>(k.hash ^ static_cast<uint64_t>(k.kind)); }
+    };
+    // Partitions independantes: les threads d'analyse des hotes ne se disputent pas un verrou unique
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<ArcContentKey, std::string, KeyHash> values;
+    };
+    static constexpr size_t kShards = 16;
+
+    Shard& ShardOf(const ArcContentKey& key) { return shards_[(key.hash >> 60) % kShards]; }
+
+    Shard shards_[kShards];
+    std::atomic<uint64_t> lookups_{ 0 };
+    std::atomic<uint64_t> hits_{ 0 };
+    std::atomic<uint64_t> skippedBytes_{ 0 };
+};
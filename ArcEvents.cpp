@@ -0,0 +1,85 @@
+// ArcEvents.cpp - Synthese du journal d'evenements de l'agent
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#include "ArcEvents.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "ArcText.h"
+
+void ArcEventDigest::Add(const ArcEventRecord& record) {
+    const size_t level = record.level < levels.size() ? record.level : 0;
+    levels[level]++;
+    eventIds[record.eventId]++;
+    int64_t bucket = record.timeUtc - ((record.timeUtc % kBucketSeconds) + kBucketSeconds) % kBucketSeconds;
+    buckets[bucket][level]++;
+    if (record.timeUtc > lastUtc) lastUtc = record.timeUtc;
+    added++;
+}
+
+void ArcEventDigest::Prune(int64_t now) {
+    const int64_t oldest = now - static_cast<int64_t>(kBucketsKept) * kBucketSeconds;
+    buckets.erase(buckets.begin(), buckets.lower_bound(oldest));
+}
+
+ArcEventDigest::LevelCounts ArcEventDigest::Recent(int64_t now, int64_t seconds) const {
+    LevelCounts sum{};
+    for (auto it = buckets.lower_bound(now - seconds - kBucketSeconds + 1); it != buckets.end(); ++it) {
+        for (size_t l = 0; l < sum.size(); l++) sum[l] += it->second[l];
+    }
+    return sum;
+}
+
+bool ArcEventDigest::Load(const std::wstring& path) {
+    std::ifstream in(std::filesystem::path(path), std::ios::binary);
+    if (!in) return false;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string kind;
+        fields >> kind;
+        if (kind == "bookmark") {
+            size_t start = line.find(' ');
+            bookmark = start == std::string::npos ? L"" : FromUtf8(std::string_view(line).substr(start + 1));
+        } else if (kind == "level") {
+            size_t level = 0;
+            uint64_t count = 0;
+            if (fields >> level >> count && level < levels.size()) levels[level] = count;
+        } else if (kind == "event") {
+            uint32_t id = 0;
+            uint64_t count = 0;
+            if (fields >> id >> count) eventIds[id] = count;
+        } else if (kind == "last") {
+            fields >> lastUtc;
+        } else if (kind == "bucket") {
+            int64_t start = 0;
+            LevelCounts counts{};
+            fields >> start;
+            for (auto& c : counts) fields >> c;
+            if (fields) buckets[start] = counts;
+        }
+    }
+    return true;
+}
+
+bool ArcEventDigest::Save(const std::wstring& path) const {
+    std::ofstream out(std::filesystem::path(path), std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    // Le XML du signet contient des retours a la ligne: ramene sur une seule ligne
+    std::string mark = ToUtf8(bookmark);
+    for (char& c : mark) if (c == '\r' || c == '\n') c = ' ';
+    out << "bookmark " << mark << "\n";
+    out << "last " << lastUtc << "\n";
+    for (size_t l = 0; l < levels.size(); l++) out << "level " << l << " " << levels[l] << "\n";
+    for (const auto& kv : eventIds) out << "event " << kv.first << " " << kv.second << "\n";
+    for (const auto& kv : buckets) {
+        out << "bucket " << kv.first;
+        for (uint64_t c : kv.second) out << " " << c;
+        out << "\n";
+    }
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,40 @@
+// ArcEvents.h - Synthese du journal d'evenements de l'agent
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Compteurs cumules par niveau, ID d'evenement et tranche horaire, persistes avec le
+// signet du canal: chaque passe ne lit que les enregistrements nouveaux.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "ArcPlatform.h"
+
+class ArcEventDigest {
+public:
+    static constexpr int64_t kBucketSeconds = 3600;
+    static constexpr size_t kBucketsKept = 24 * 7;   // Une semaine de tranches horaires
+
+    using LevelCounts = std::array<uint64_t, 5>;     // Index = niveau (0 inutilise)
+
+    void Add(const ArcEventRecord& record);
+
+    // Retire les tranches plus anciennes que kBucketsKept heures avant 'now'
+    void Prune(int64_t now);
+
+    // Somme des tranches couvrant les 'seconds' dernieres secondes
+    LevelCounts Recent(int64_t now, int64_t seconds) const;
+
+    // Etat au format texte (une ligne par compteur); false si absent ou illisible
+    bool Load(const std::wstring& path);
+    bool Save(const std::wstring& path) const;
+
+    std::wstring bookmark;                          // Signet du canal (XML sur une ligne)
+    LevelCounts levels{};
+    std::map<uint32_t, uint64_t> eventIds;
+    std::map<int64_t, LevelCounts> buckets;         // Debut de tranche (UTC) -> compteurs par niveau
+    int64_t lastUtc = 0;                            // Date du plus recent evenement compte
+    uint64_t added = 0;                             // Evenements lus pendant cette passe (non persiste)
+};
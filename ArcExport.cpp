@@ -0,0 +1,386 @@
+// ArcExport.cpp - Export des resultats en flux: CSV, JSON Lines, binaire en colonnes
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#include "ArcExport.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+#include "ArcText.h"
+#include "ArcTime.h"
+
+// ======================== Buffered Output ========================
+class BufferedFile {
+public:
+    static constexpr size_t kBufferSize = 1 << 20;
+
+    explicit BufferedFile(const std::wstring& path)
+        : file_(std::filesystem::path(path), std::ios::binary | std::ios::trunc) {
+        buffer_.reserve(kBufferSize);
+    }
+
+    bool is_open() const { return file_.is_open(); }
+    std::string& buffer() { return buffer_; }
+
+    // Appele apres chaque ligne: ecriture reelle uniquement lorsque le tampon est plein
+    void MaybeFlush() { if (buffer_.size() >= kBufferSize) Flush(); }
+
+    void Flush() {
+        if (!buffer_.empty()) file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+    }
+
+    bool Close() {
+        Flush();
+        file_.close();
+        return !file_.fail();
+    }
+
+private:
+    std::ofstream file_;
+    std::string buffer_;
+};
+
+static std::wstring Expiration(const ArcComponentInfo& row) {
+    return row.expiresUtc ? FormatUtc(row.expiresUtc) : std::wstring();
+}
+
+static const char* LevelText(StatusLevel level) {
+    switch (level) {
+        case StatusLevel::OK: return "OK";
+        case StatusLevel::WARNING: return "AVERTISSEMENT";
+        default: return "ERREUR";
+    }
+}
+
+// ======================== CSV ========================
+// RFC 4180: guillemets uniquement si necessaire, guillemets internes doubles
+class CsvWriter : public IArcResultWriter {
+public:
+    explicit CsvWriter(const std::wstring& path) : out_(path) {}
+    bool is_open() const { return out_.is_open(); }
+
+    void Write(const std::wstring& host, const ArcComponentList& list, const ArcComponentInfo& row) override {
+        WriteHeader();
+        std::string& b = out_.buffer();
+        Field(b, host); b += ',';
+        Field(b, ArcStrText(row.component)); b += ',';
+        Field(b, ArcStrText(row.status)); b += ',';
+        b += LevelText(row.level); b += ',';
+        Field(b, ArcStrText(row.version)); b += ',';
+        Field(b, Expiration(row)); b += ',';
+        Field(b, list.Details(row)); b += ',';
+        Field(b, list.Alerts(row));
+        b += "\r\n";
+        out_.MaybeFlush();
+    }
+
+    bool Finish() override {
+        WriteHeader();  // Fichier sans ligne: en-tete seul
+        return out_.Close();
+    }
+
+private:
+    void WriteHeader() {
+        if (headerWritten_) return;
+        out_.buffer() += "\xEF\xBB\xBF" "Hote,Composant,Etat,Niveau,Version/Chemin,Expiration Token,Details,Alertes\r\n";
+        headerWritten_ = true;
+    }
+
+    static void Field(std::string& b, std::wstring_view value) {
+        std::string text = ToUtf8(value);
+        if (text.find_first_of(",\"\r\n") == std::string::npos) {
+            b += text;
+            return;
+        }
+        b += '"';
+        for (char c : text) {
+            if (c == '"') b += '"';
+            b += c;
+        }
+        b += '"';
+    }
+
+    BufferedFile out_;
+    bool headerWritten_ = false;
+};
+
+// ======================== JSON Lines ========================
+class JsonLinesWriter : public IArcResultWriter {
+public:
+    explicit JsonLinesWriter(const std::wstring& path) : out_(path) {}
+    bool is_open() const { return out_.is_open(); }
+
+    void Write(const std::wstring& host, const ArcComponentList& list, const ArcComponentInfo& row) override {
+        std::string& b = out_.buffer();
+        b += "{\"host\":"; String(b, host);
+        b += ",\"component\":"; String(b, ArcStrText(row.component));
+        b += ",\"status\":"; String(b, ArcStrText(row.status));
+        b += ",\"level\":\""; b += LevelText(row.level);
+        b += "\",\"version\":"; String(b, ArcStrText(row.version));
+        b += ",\"expiration\":"; String(b, Expiration(row));
+        b += ",\"details\":"; String(b, list.Details(row));
+        b += ",\"alerts\":"; String(b, list.Alerts(row));
+        b += "}\n";
+        out_.MaybeFlush();
+    }
+
+    bool Finish() override { return out_.Close(); }
+
+private:
+    static void String(std::string& b, std::wstring_view value) { AppendJsonString(b, ToUtf8(value)); }
+
+    BufferedFile out_;
+};
+
+// ======================== Columnar Binary ========================
+class ColumnarWriter : public IArcResultWriter {
+public:
+    static constexpr size_t kBlockRows = 4096;
+
+    explicit ColumnarWriter(const std::wstring& path) : out_(path) {
+        out_.buffer() += "ARCB";
+        out_.buffer() += static_cast<char>(2);
+        out_.buffer() += static_cast<char>(8);
+    }
+    bool is_open() const { return out_.is_open(); }
+
+    void Write(const std::wstring& host, const ArcComponentList& list, const ArcComponentInfo& row) override {
+        hosts_.Add(ToUtf8(host));
+        components_.Add(ToUtf8(ArcStrText(row.component)));
+        statuses_.Add(ToUtf8(ArcStrText(row.status)));
+        levels_ += static_cast<char>(row.level);
+        Varint(expiries_, ZigZag(row.expiresUtc));
+        const std::wstring_view texts[3] = { ArcStrText(row.version), list.Details(row), list.Alerts(row) };
+        for (size_t c = 0; c < 3; c++) {
+            std::string utf8 = ToUtf8(texts[c]);
+            Varint(plain_[c], utf8.size());
+            plain_[c] += utf8;
+        }
+        if (++rows_ == kBlockRows) FlushBlock();
+    }
+
+    bool Finish() override {
+        FlushBlock();
+        Varint(out_.buffer(), 0);   // Bloc vide = fin du fichier
+        return out_.Close();
+    }
+
+private:
+    static uint64_t ZigZag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+
+    static void Varint(std::string& b, uint64_t v) {
+        while (v >= 0x80) {
+            b += static_cast<char>((v & 0x7F) | 0x80);
+            v >>= 7;
+        }
+        b += static_cast<char>(v);
+    }
+
+    // Dictionnaire cumulatif; seules les entrees apparues dans le bloc courant sont ecrites
+    struct DictionaryColumn {
+        std::unordered_map<std::string, uint32_t> ids;
+        std::vector<std::string> fresh;
+        std::string indices;
+
+        void Add(std::string value) {
+            auto it = ids.find(value);
+            uint32_t id;
+            if (it == ids.end()) {
+                id = static_cast<uint32_t>(ids.size());
+                ids.emplace(value, id);
+                fresh.push_back(std::move(value));
+            } else {
+                id = it->second;
+            }
+            Varint(indices, id);
+        }
+
+        void Emit(std::string& b) {
+            Varint(b, fresh.size());
+            for (const auto& s : fresh) {
+                Varint(b, s.size());
+                b += s;
+            }
+            b += indices;
+            fresh.clear();
+            indices.clear();
+        }
+    };
+
+    void FlushBlock() {
+        if (rows_ == 0) return;
+        std::string& b = out_.buffer();
+        Varint(b, rows_);
+        hosts_.Emit(b);
+        components_.Emit(b);
+        statuses_.Emit(b);
+        b += levels_;
+        b += expiries_;
+        for (auto& column : plain_) {
+            b += column;
+            column.clear();
+        }
+        levels_.clear();
+        expiries_.clear();
+        rows_ = 0;
+        out_.MaybeFlush();
+    }
+
+    BufferedFile out_;
+    DictionaryColumn hosts_, components_, statuses_;
+    std::string levels_;
+    std::string expiries_;
+    std::string plain_[3];
+    size_t rows_ = 0;
+};
+
+// ======================== Columnar Reader ========================
+namespace {
+
+class ColumnarCursor {
+public:
+    explicit ColumnarCursor(std::string_view bytes) : bytes_(bytes) {}
+
+    bool Varint(uint64_t& v) {
+        v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos_ >= bytes_.size()) return false;
+            const uint8_t b = static_cast<uint8_t>(bytes_[pos_++]);
+            v |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+
+    bool Text(std::string_view& out) {
+        uint64_t size = 0;
+        if (!Varint(size) || size > bytes_.size() - pos_) return false;
+        out = bytes_.substr(pos_, static_cast<size_t>(size));
+        pos_ += static_cast<size_t>(size);
+        return true;
+    }
+
+    bool Bytes(size_t n, std::string_view& out) {
+        if (n > bytes_.size() - pos_) return false;
+        out = bytes_.substr(pos_, n);
+        pos_ += n;
+        return true;
+    }
+
+    bool AtEnd() const { return pos_ == bytes_.size(); }
+
+private:
+    std::string_view bytes_;
+    size_t pos_ = 0;
+};
+
+// Nouvelles entrees du bloc ajoutees au dictionnaire cumulatif, puis un indice par ligne
+bool ReadDictionaryColumn(ColumnarCursor& in, size_t rows, std::vector<std::string_view>& dictionary, std::vector<uint32_t>& indices) {
+    uint64_t fresh = 0;
+    if (!in.Varint(fresh)) return false;
+    for (uint64_t i = 0; i < fresh; i++) {
+        std::string_view value;
+        if (!in.Text(value)) return false;
+        dictionary.push_back(value);
+    }
+    indices.resize(rows);
+    for (auto& index : indices) {
+        uint64_t id = 0;
+        if (!in.Varint(id) || id >= dictionary.size()) return false;
+        index = static_cast<uint32_t>(id);
+    }
+    return true;
+}
+
+} // namespace
+
+bool ReadColumnarExport(std::string_view bytes, const std::function<void(const ArcColumnarRow&)>& onRow) {
+    if (bytes.size() < 6 || bytes.substr(0, 4) != "ARCB" || bytes[4] != 2 || bytes[5] != 8) return false;
+    ColumnarCursor in(bytes.substr(6));
+
+    std::vector<std::string_view> dictionaries[3];
+    std::vector<uint32_t> indices[3];
+    std::vector<int64_t> expiries;
+    std::vector<std::string_view> plain[3];
+    for (;;) {
+        uint64_t rows = 0;
+        if (!in.Varint(rows)) return false;
+        if (rows == 0) return in.AtEnd();
+        if (rows > ColumnarWriter::kBlockRows) return false;
+        const size_t n = static_cast<size_t>(rows);
+
+        for (size_t c = 0; c < 3; c++) {
+            if (!ReadDictionaryColumn(in, n, dictionaries[c], indices[c])) return false;
+        }
+        std::string_view levels;
+        if (!in.Bytes(n, levels)) return false;
+        for (char level : levels) {
+            if (static_cast<uint8_t>(level) > static_cast<uint8_t>(StatusLevel::ERROR_LEVEL)) return false;
+        }
+        expiries.resize(n);
+        for (auto& e : expiries) {
+            uint64_t z = 0;
+            if (!in.Varint(z)) return false;
+            e = static_cast<int64_t>(z >> 1) ^ -static_cast<int64_t>(z & 1);
+        }
+        for (auto& column : plain) {
+            column.resize(n);
+            for (auto& text : column) {
+                if (!in.Text(text)) return false;
+            }
+        }
+
+        ArcColumnarRow row;
+        for (size_t r = 0; r < n; r++) {
+            row.host = dictionaries[0][indices[0][r]];
+            row.component = dictionaries[1][indices[1][r]];
+            row.status = dictionaries[2][indices[2][r]];
+            row.level = static_cast<StatusLevel>(levels[r]);
+            row.expiresUtc = expiries[r];
+            row.version = plain[0][r];
+            row.details = plain[1][r];
+            row.alerts = plain[2][r];
+            onRow(row);
+        }
+    }
+}
+
+// ======================== Factory ========================
+std::unique_ptr<IArcResultWriter> CreateResultWriter(ArcExportFormat format, const std::wstring& path) {
+    switch (format) {
+        case ArcExportFormat::Csv: {
+            auto w = std::make_unique<CsvWriter>(path);
+            if (w->is_open()) return w;
+            break;
+        }
+        case ArcExportFormat::JsonLines: {
+            auto w = std::make_unique<JsonLinesWriter>(path);
+            if (w->is_open()) return w;
+            break;
+        }
+        case ArcExportFormat::Columnar: {
+            auto w = std::make_unique<ColumnarWriter>(path);
+            if (w->is_open()) return w;
+            break;
+        }
+    }
+    return nullptr;
+}
+
+bool ParseExportFormat(std::string_view name, ArcExportFormat& format) {
+    if (name == "csv") format = ArcExportFormat::Csv;
+    else if (name == "jsonl") format = ArcExportFormat::JsonLines;
+    else if (name == "arcb") format = ArcExportFormat::Columnar;
+    else return false;
+    return true;
+}
+
+ArcExportFormat ExportFormatFromPath(const std::wstring& path) {
+    if (EndsWithNoCase(path, L".jsonl")) return ArcExportFormat::JsonLines;
+    if (EndsWithNoCase(path, L".arcb")) return ArcExportFormat::Columnar;
+    return ArcExportFormat::Csv;
+}
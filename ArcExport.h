@@ -0,0 +1,65 @@
+// ArcExport.h - Export des resultats en flux: CSV, JSON Lines, binaire en colonnes
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Les lignes sont ecrites au fur et a mesure dans un tampon de 1 Mo, sans copie
+// prealable de l'ensemble des resultats.
+//
+// Format binaire .arcb (entiers en varint LEB128 sauf mention contraire):
+//   "ARCB" u8 version=2 u8 colonnes=8
+//   Blocs de 4096 lignes au plus: varint lignes (0 = fin du fichier), puis par colonne:
+//     Hote, Composant, Etat (dictionnaire): varint nouvelles entrees, (varint taille, UTF-8)*,
+//                                           puis un indice de dictionnaire par ligne
+//     Niveau: un octet par ligne (0 OK, 1 avertissement, 2 erreur)
+//     Expiration: varint zigzag par ligne (secondes UTC, 0 = aucune)
+//     Version, Details, Alertes: (varint taille, UTF-8) par ligne
+//   Les dictionnaires sont cumulatifs sur l'ensemble du fichier.
+//   Version 1 (obsolete): Expiration en texte, entre Version et Details.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "ArcScan.h"
+
+enum class ArcExportFormat { Csv, JsonLines, Columnar };
+
+class IArcResultWriter {
+public:
+    virtual ~IArcResultWriter() = default;
+
+    // host vide pour une analyse locale; row appartient a list (arene des details)
+    virtual void Write(const std::wstring& host, const ArcComponentList& list, const ArcComponentInfo& row) = 0;
+
+    // Vide les tampons et ferme le fichier; false si une ecriture a echoue
+    virtual bool Finish() = 0;
+};
+
+// nullptr si le fichier ne peut pas etre cree
+std::unique_ptr<IArcResultWriter> CreateResultWriter(ArcExportFormat format, const std::wstring& path);
+
+// "csv", "jsonl", "arcb"
+bool ParseExportFormat(std::string_view name, ArcExportFormat& format);
+
+// Deduit de l'extension du fichier (CSV par defaut)
+ArcExportFormat ExportFormatFromPath(const std::wstring& path);
+
+// ======================== Lecture .arcb ========================
+// Ligne decodee: vues UTF-8 sur les octets du fichier, valides pendant le rappel seulement
+struct ArcColumnarRow {
+    std::string_view host;
+    std::string_view component;
+    std::string_view status;
+    StatusLevel level = StatusLevel::OK;
+    int64_t expiresUtc = 0;
+    std::string_view version;
+    std::string_view details;
+    std::string_view alerts;
+};
+
+// Decodage bloc par bloc (version 2 uniquement). false si l'en-tete, un bloc ou un indice de
+// dictionnaire est invalide, ou si le marqueur de fin manque (fichier tronque); les lignes des
+// blocs precedents ont deja ete transmises.
+bool ReadColumnarExport(std::string_view bytes, const std::function<void(const ArcColumnarRow&)>& onRow);
@@ -0,0 +1,243 @@
+// ArcExtensions.cpp - Inventaire des extensions et lecture de leurs fichiers .status
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#include "ArcExtensions.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cwctype>
+#include <map>
+
+#include "ArcFile.h"
+#include "ArcJson.h"
+#include "ArcScheduler.h"
+#include "ArcText.h"
+
+// ======================== Versions ========================
+int CompareVersions(const std::wstring& a, const std::wstring& b) {
+    size_t i = 0, j = 0;
+    while (i < a.size() || j < b.size()) {
+        unsigned long long x = 0, y = 0;
+        while (i < a.size() && iswdigit(a[i])) x = x * 10 + (a[i++] - L'0');
+        while (j < b.size() && iswdigit(b[j])) y = y * 10 + (b[j++] - L'0');
+        if (x != y) return x < y ? -1 : 1;
+        // Separateur ou suffixe non numerique: on avance jusqu'au segment suivant
+        while (i < a.size() && !iswdigit(a[i])) i++;
+        while (j < b.size() && !iswdigit(b[j])) j++;
+    }
+    return 0;
+}
+
+// "Microsoft.Azure.Extensions.CustomScript-2.1.10" -> nom + version (disposition Linux)
+static bool SplitVersionedName(const std::wstring& dirName, std::wstring& name, std::wstring& version) {
+    size_t dash = dirName.rfind(L'-');
+    if (dash == std::wstring::npos || dash + 1 >= dirName.size() || !iswdigit(dirName[dash + 1])) return false;
+    name = dirName.substr(0, dash);
+    version = dirName.substr(dash + 1);
+    return true;
+}
+
+// <N>.status de plus grand N; les fichiers non numeriques sont ignores
+static bool FindLatestStatus(IArcPlatform& platform, const std::wstring& directory, std::wstring& file, uint64_t& sequence) {
+    std::vector<ArcDirEntry> entries;
+    if (!platform.ListDirectory(platform.Join(directory, L"status"), entries)) return false;
+
+    bool found = false;
+    for (const auto& e : entries) {
+        if (e.isDirectory || !EndsWithNoCase(e.name, L".status")) continue;
+        const size_t digits = e.name.size() - 7;
+        if (digits == 0) continue;
+        uint64_t n = 0;
+        size_t k = 0;
+        for (; k < digits && iswdigit(e.name[k]); k++) n = n * 10 + (e.name[k] - L'0');
+        if (k != digits) continue;
+        if (!found || n > sequence) {
+            sequence = n;
+            file = platform.Join(platform.Join(directory, L"status"), e.name);
+            found = true;
+        }
+    }
+    return found;
+}
+
+// ======================== Inventaire ========================
+namespace {
+
+struct Candidate {
+    std::wstring version;
+    std::wstring directory;
+};
+
+struct ExtensionGroup {
+    std::vector<Candidate> candidates;   // Repertoires de version deja connus (Linux)
+    std::vector<std::wstring> roots;     // Repertoires a developper (Windows: sous-dossiers de version)
+};
+
+}
+
+std::vector<ArcExtensionInstall> FindExtensionInstalls(IArcPlatform& platform, const std::wstring& pluginsDir, size_t maxWorkers) {
+    std::vector<ArcDirEntry> entries;
+    if (!platform.ListDirectory(pluginsDir, entries)) return {};
+
+    // std::map: ordre de sortie trie par nom, independant de l'ordonnancement
+    std::map<std::wstring, ExtensionGroup> groups;
+    for (const auto& entry : entries) {
+        if (!entry.isDirectory || !StartsWithNoCase(entry.name, L"Microsoft.Azure.")) continue;
+        std::wstring name, version;
+        if (SplitVersionedName(entry.name, name, version)) {
+            groups[name].candidates.push_back({ version, platform.Join(pluginsDir, entry.name) });
+        } else {
+            groups[entry.name].roots.push_back(platform.Join(pluginsDir, entry.name));
+        }
+    }
+
+    std::vector<ArcExtensionInstall> installs(groups.size());
+    ArcTaskGraph graph;
+    size_t slot = 0;
+    for (auto& kv : groups) {
+        ArcExtensionInstall& install = installs[slot++];
+        install.name = kv.first;
+        ExtensionGroup& group = kv.second;
+
+        graph.Add(kv.first, [&platform, &install, &group] {
+            std::vector<Candidate> candidates = std::move(group.candidates);
+            for (const auto& root : group.roots) {
+                std::vector<ArcDirEntry> versions;
+                platform.ListDirectory(root, versions);
+                for (const auto& v : versions) {
+                    if (v.isDirectory && !v.name.empty() && iswdigit(v.name[0])) {
+                        candidates.push_back({ v.name, platform.Join(root, v.name) });
+                    }
+                }
+                candidates.push_back({ L"", root }); // Ancienne disposition: Plugins\<nom>\status
+            }
+
+            // Plus recente d'abord; l'ancienne disposition (sans version) en dernier
+            std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+                if (a.version.empty() != b.version.empty()) return b.version.empty();
+                return CompareVersions(a.version, b.version) > 0;
+            });
+
+            install.versionsOnDisk = 0;
+            for (const auto& c : candidates) install.versionsOnDisk += !c.version.empty();
+            if (candidates.empty()) return;
+
+            install.version = candidates.front().version;
+            install.directory = candidates.front().directory;
+            for (const auto& c : candidates) {
+                if (FindLatestStatus(platform, c.directory, install.statusFile, install.sequence)) {
+                    install.version = c.version;
+                    install.directory = c.directory;
+                    break;
+                }
+            }
+        });
+    }
+    graph.Run(maxWorkers);
+    return installs;
+}
+
+// ======================== Lecture du statut ========================
+static std::wstring DecodeField(std::string_view raw) {
+    if (raw.find('\\') != std::string_view::npos) return FromUtf8(JsonUnescape(raw));
+    return FromUtf8(raw);
+}
+
+namespace {
+
+// Document parcouru par blocs: l'extracteur ne garde que sa pile et la valeur en cours,
+// le transcodage UTF-16 passe par un tampon fixe. Aucune copie du fichier entier.
+class StatusParser {
+public:
+    explicit StatusParser(ArcExtensionStatus& out)
+        : out_(out), extractor_(Paths()),
+          stream_([this](std::string_view text) { return wellFormed_ = extractor_.Feed(text, *this); }) {
+        out_ = ArcExtensionStatus();
+    }
+
+    bool Feed(std::string_view bytes) {
+        out_.bytesRead += bytes.size();
+        return stream_.Feed(bytes);
+    }
+
+    void Finish() {
+        stream_.Finish();
+        out_.complete = wellFormed_ && extractor_.Complete();
+    }
+
+    void operator()(size_t field, std::string_view raw, JsonType type, bool) {
+        switch (field) {
+            case Handler:   if (out_.handler.empty()) out_.handler = DecodeField(raw); break;
+            case Operation: if (out_.operation.empty()) out_.operation = DecodeField(raw); break;
+            case Status:    if (out_.status.empty()) out_.status = DecodeField(raw); break;
+            case Message:   if (out_.message.empty()) out_.message = DecodeField(raw); break;
+            case Timestamp: if (out_.timestamp.empty()) out_.timestamp = DecodeField(raw); break;
+            case Code:
+                if (!haveCode_ && (type == JsonType::Number || type == JsonType::String)) {
+                    out_.code = strtoll(std::string(raw).c_str(), nullptr, 10);
+                    haveCode_ = true;
+                }
+                break;
+            case SubName:
+                lastSubName_ = DecodeField(raw);
+                break;
+            case SubStatus: {
+                // "name" precede "status" dans les fichiers produits par les gestionnaires
+                out_.substatusCount++;
+                std::wstring s = DecodeField(raw);
+                if (out_.failedSubstatus.empty() && !EqualsNoCase(s, L"success")) {
+                    out_.failedSubstatus = lastSubName_.empty() ? s : lastSubName_ + L" (" + s + L")";
+                }
+                lastSubName_.clear();
+                break;
+            }
+            case SubCode:
+                // Independant de l'ordre des champs dans le sous-statut
+                if (!out_.substatusCode && (type == JsonType::Number || type == JsonType::String)) {
+                    out_.substatusCode = strtoll(std::string(raw).c_str(), nullptr, 10);
+                }
+                break;
+        }
+    }
+
+private:
+    enum Field { Handler, Operation, Status, Code, Message, Timestamp, SubName, SubStatus, SubCode };
+
+    static const std::vector<std::string_view>& Paths() {
+        static const std::vector<std::string_view> paths = {
+            "[].status.name", "[].status.operation", "[].status.status", "[].status.code",
+            "[].status.formattedMessage.message", "[].timestampUTC",
+            "[].status.substatus.[].name", "[].status.substatus.[].status", "[].status.substatus.[].code"
+        };
+        return paths;
+    }
+
+    ArcExtensionStatus& out_;
+    JsonStreamExtractor extractor_;
+    ArcUtf8Stream stream_;
+    bool wellFormed_ = true;
+    bool haveCode_ = false;
+    std::wstring lastSubName_;
+};
+
+} // namespace
+
+bool ReadExtensionStatus(IArcPlatform& platform, const std::wstring& path, ArcExtensionStatus& out) {
+    // Projection: la vue est parcourue sans copie. A defaut, lecture par blocs (fichier special).
+    StatusParser parser(out);
+    if (std::unique_ptr<IArcMappedFile> mapping = platform.MapFile(path)) {
+        parser.Feed(mapping->Bytes());
+    } else if (!platform.ReadFileChunks(path, [&parser](std::string_view chunk) { return parser.Feed(chunk); })) {
+        out = ArcExtensionStatus();
+        return false;
+    }
+    parser.Finish();
+    return true;
+}
+
+void ParseExtensionStatus(const ArcFileBytes& file, ArcExtensionStatus& out) {
+    // Octets bruts: l'UTF-16 est transcode au fil de l'eau, pas par ArcFileBytes::Utf8()
+    StatusParser parser(out);
+    parser.Feed(file.Raw());
+    parser.Finish();
+}
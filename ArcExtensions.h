@@ -0,0 +1,48 @@
+// ArcExtensions.h - Inventaire des extensions et lecture de leurs fichiers .status
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Windows: Plugins\<nom>\<version>\status\<N>.status  (et l'ancien Plugins\<nom>\status)
+// Linux:   /var/lib/waagent/<nom>-<version>/status/<N>.status
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ArcFile.h"
+#include "ArcPlatform.h"
+
+// Une extension installee: version la plus recente disposant d'un statut
+struct ArcExtensionInstall {
+    std::wstring name;            // Microsoft.Azure.Monitor.AzureMonitorWindowsAgent
+    std::wstring version;         // Vide pour l'ancienne disposition sans repertoire de version
+    std::wstring directory;
+    std::wstring statusFile;      // <N>.status de plus grand N (vide si aucun)
+    uint64_t sequence = 0;
+    size_t versionsOnDisk = 0;
+};
+
+// Champs retenus du fichier .status (projete en memoire, UTF-8 ou UTF-16, extrait en une passe)
+struct ArcExtensionStatus {
+    bool complete = false;        // Document lu jusqu'au bout et bien forme
+    std::wstring handler;         // [].status.name
+    std::wstring operation;       // [].status.operation
+    std::wstring status;          // success / transitioning / warning / error
+    long long code = 0;
+    std::wstring message;         // [].status.formattedMessage.message (tronque)
+    std::wstring timestamp;       // [].timestampUTC
+    std::wstring failedSubstatus; // Premier sous-statut en echec ou en avertissement
+    long long substatusCode = 0;  // [].status.substatus.[].code: premier code non nul
+    size_t substatusCount = 0;
+    uint64_t bytesRead = 0;
+};
+
+// Regroupe les repertoires de Plugins par extension et retient, pour chacune, le statut courant.
+// Les extensions sont traitees en parallele (au plus maxWorkers threads); resultat trie par nom.
+std::vector<ArcExtensionInstall> FindExtensionInstalls(IArcPlatform& platform, const std::wstring& pluginsDir, size_t maxWorkers);
+
+bool ReadExtensionStatus(IArcPlatform& platform, const std::wstring& path, ArcExtensionStatus& out);
+void ParseExtensionStatus(const ArcFileBytes& file, ArcExtensionStatus& out);   // Fichier deja ouvert
+
+// Comparaison numerique segment par segment ("1.10.2" > "1.9.7")
+int CompareVersions(const std::wstring& a, const std::wstring& b);
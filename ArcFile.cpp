@@ -0,0 +1,187 @@
+// ArcFile.cpp - Acces aux fichiers d'entree: projection en memoire et detection d'encodage
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#include "ArcFile.h"
+
+#include "ArcText.h"
+
+ArcTextEncoding DetectEncoding(std::string_view bytes, size_t& bomSize) {
+    auto at = [&bytes](size_t i) { return static_cast<uint8_t>(bytes[i]); };
+    bomSize = 0;
+    if (bytes.size() >= 3 && at(0) == 0xEF && at(1) == 0xBB && at(2) == 0xBF) {
+        bomSize = 3;
+        return ArcTextEncoding::Utf8;
+    }
+    if (bytes.size() >= 2 && at(0) == 0xFF && at(1) == 0xFE) {
+        bomSize = 2;
+        return ArcTextEncoding::Utf16LE;
+    }
+    if (bytes.size() >= 2 && at(0) == 0xFE && at(1) == 0xFF) {
+        bomSize = 2;
+        return ArcTextEncoding::Utf16BE;
+    }
+    // JSON, journaux: le premier caractere est ASCII
+    if (bytes.size() >= 2 && at(0) != 0 && at(1) == 0) return ArcTextEncoding::Utf16LE;
+    if (bytes.size() >= 2 && at(0) == 0 && at(1) != 0) return ArcTextEncoding::Utf16BE;
+    return ArcTextEncoding::Utf8;
+}
+
+// Surrogates isoles remplaces par U+FFFD; octet final impair ignore
+static void Utf16ToUtf8(std::string_view bytes, bool bigEndian, std::string& out) {
+    out.clear();
+    out.reserve(bytes.size() / 2 + bytes.size() / 8);
+    const size_t units = bytes.size() / 2;
+    auto unit = [&](size_t i) -> char32_t {
+        const uint8_t a = static_cast<uint8_t>(bytes[2 * i]);
+        const uint8_t b = static_cast<uint8_t>(bytes[2 * i + 1]);
+        return bigEndian ? static_cast<char32_t>((a << 8) | b) : static_cast<char32_t>((b << 8) | a);
+    };
+    for (size_t i = 0; i < units; i++) {
+        char32_t cp = unit(i);
+        if (cp >= 0xD800 && cp <= 0xDBFF && i + 1 < units && unit(i + 1) >= 0xDC00 && unit(i + 1) <= 0xDFFF) {
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (unit(i + 1) - 0xDC00);
+            i++;
+        } else if (cp >= 0xD800 && cp <= 0xDFFF) {
+            cp = 0xFFFD;
+        }
+        AppendUtf8(out, cp);
+    }
+}
+
+bool ArcFileBytes::Open(IArcPlatform& platform, const std::wstring& path) {
+    mapping_ = platform.MapFile(path);
+    owned_.clear();
+    transcoded_.clear();
+    decoded_ = false;
+    if (mapping_) {
+        raw_ = mapping_->Bytes();
+    } else {
+        // Fichier vide ou non projetable: un seul tampon, sans conversion intermediaire
+        if (!platform.ReadFileChunks(path, [this](std::string_view chunk) { owned_.append(chunk); return true; })) {
+            raw_ = std::string_view();
+            bom_ = 0;
+            return false;
+        }
+        raw_ = owned_;
+    }
+
+    encoding_ = DetectEncoding(raw_, bom_);
+    return true;
+}
+
+std::string_view ArcFileBytes::Utf8() const {
+    if (encoding_ == ArcTextEncoding::Utf8) return raw_.substr(bom_);
+    if (!decoded_) {
+        // Les appelants qui n'utilisent que Raw() (empreinte, DER) ne paient pas la conversion
+        Utf16ToUtf8(raw_.substr(bom_), encoding_ == ArcTextEncoding::Utf16BE, transcoded_);
+        decoded_ = true;
+    }
+    return transcoded_;
+}
+
+// ======================== Flux UTF-8 ========================
+bool ArcUtf8Stream::Feed(std::string_view bytes) {
+    if (stopped_) return false;
+    if (!detected_) {
+        // La detection porte sur 3 octets au plus: on n'accumule que ceux-la
+        if (head_.size() + bytes.size() < 3) {
+            head_.append(bytes);
+            return true;
+        }
+        const size_t take = 3 - head_.size();
+        head_.append(bytes.substr(0, take));
+        bytes.remove_prefix(take);
+        size_t bom = 0;
+        encoding_ = DetectEncoding(head_, bom);
+        detected_ = true;
+        const std::string head = head_.substr(bom);
+        head_.clear();
+        if (!Decode(head)) return false;
+    }
+    return Decode(bytes);
+}
+
+bool ArcUtf8Stream::Finish() {
+    if (stopped_) return false;
+    if (!detected_) {
+        size_t bom = 0;
+        encoding_ = DetectEncoding(head_, bom);
+        detected_ = true;
+        const std::string head = head_.substr(bom);
+        head_.clear();
+        if (!Decode(head)) return false;
+    }
+    // Surrogate haut sans suite en fin de texte; octet final impair ignore
+    if (pendingHigh_ && !Put(0xFFFD)) return false;
+    pendingHigh_ = 0;
+    pendingByte_ = -1;
+    return Flush();
+}
+
+bool ArcUtf8Stream::Decode(std::string_view bytes) {
+    if (bytes.empty()) return true;
+    if (encoding_ == ArcTextEncoding::Utf8) {
+        if (!sink_(bytes)) stopped_ = true;
+        return !stopped_;
+    }
+
+    const bool bigEndian = encoding_ == ArcTextEncoding::Utf16BE;
+    auto unit = [bigEndian](uint8_t a, uint8_t b) -> char32_t {
+        return bigEndian ? static_cast<char32_t>((a << 8) | b) : static_cast<char32_t>((b << 8) | a);
+    };
+    auto consume = [this](char32_t u) {
+        if (pendingHigh_) {
+            const char32_t high = pendingHigh_;
+            pendingHigh_ = 0;
+            if (u >= 0xDC00 && u <= 0xDFFF) return Put(0x10000 + ((high - 0xD800) << 10) + (u - 0xDC00));
+            if (!Put(0xFFFD)) return false;
+        }
+        if (u >= 0xD800 && u <= 0xDBFF) {
+            pendingHigh_ = u;
+            return true;
+        }
+        return Put(u >= 0xDC00 && u <= 0xDFFF ? 0xFFFD : u);
+    };
+
+    size_t i = 0;
+    if (pendingByte_ >= 0) {
+        const uint8_t first = static_cast<uint8_t>(pendingByte_);
+        pendingByte_ = -1;
+        i = 1;
+        if (!consume(unit(first, static_cast<uint8_t>(bytes[0])))) return false;
+    }
+    for (; i + 1 < bytes.size(); i += 2) {
+        if (!consume(unit(static_cast<uint8_t>(bytes[i]), static_cast<uint8_t>(bytes[i + 1])))) return false;
+    }
+    if (i < bytes.size()) pendingByte_ = static_cast<uint8_t>(bytes[i]);
+    return true;
+}
+
+bool ArcUtf8Stream::Put(char32_t cp) {
+    // 4 octets au plus par point de code
+    if (used_ + 4 > kBuffer && !Flush()) return false;
+    if (cp < 0x80) {
+        buffer_[used_++] = static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        buffer_[used_++] = static_cast<char>(0xC0 | (cp >> 6));
+        buffer_[used_++] = static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        buffer_[used_++] = static_cast<char>(0xE0 | (cp >> 12));
+        buffer_[used_++] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        buffer_[used_++] = static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        buffer_[used_++] = static_cast<char>(0xF0 | (cp >> 18));
+        buffer_[used_++] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        buffer_[used_++] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        buffer_[used_++] = static_cast<char>(0x80 | (cp & 0x3F));
+    }
+    return true;
+}
+
+bool ArcUtf8Stream::Flush() {
+    if (used_ == 0) return true;
+    const size_t n = used_;
+    used_ = 0;
+    if (!sink_(std::string_view(buffer_, n))) stopped_ = true;
+    return !stopped_;
+}
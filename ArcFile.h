@@ -0,0 +1,80 @@
+// ArcFile.h - Acces aux fichiers d'entree: projection en memoire et detection d'encodage
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Les analyseurs recoivent une vue d'octets UTF-8 sur la projection du fichier, sans copie.
+// Seuls les fichiers UTF-16 (avec ou sans BOM) sont transcodes, une fois, en UTF-8, au premier
+// appel de Utf8(). La conversion en wchar_t est laissee aux quelques champs affiches.
+// Les analyseurs incrementaux passent par ArcUtf8Stream: memoire bornee, y compris en UTF-16.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "ArcPlatform.h"
+
+enum class ArcTextEncoding { Utf8, Utf16LE, Utf16BE };
+
+// BOM UTF-8 / UTF-16, sinon octets nuls alternes en tete (texte ASCII en UTF-16 sans BOM)
+ArcTextEncoding DetectEncoding(std::string_view bytes, size_t& bomSize);
+
+class ArcFileBytes {
+public:
+    // Projection du fichier; a defaut (fichier special, projection refusee) lecture par blocs
+    bool Open(IArcPlatform& platform, const std::wstring& path);
+
+    // Octets bruts (formats binaires: DER, ...)
+    std::string_view Raw() const { return raw_; }
+
+    // Texte UTF-8 sans BOM; vue sur la projection sauf pour l'UTF-16 (transcode a la demande)
+    std::string_view Utf8() const;
+
+    ArcTextEncoding Encoding() const { return encoding_; }
+    bool Mapped() const { return mapping_ != nullptr; }
+
+private:
+    std::unique_ptr<IArcMappedFile> mapping_;
+    std::string owned_;         // Contenu lu par blocs (pas de projection)
+    mutable std::string transcoded_;    // UTF-16 -> UTF-8
+    mutable bool decoded_ = false;
+    std::string_view raw_;
+    size_t bom_ = 0;
+    ArcTextEncoding encoding_ = ArcTextEncoding::Utf8;
+};
+
+// Blocs d'octets quelconques -> blocs UTF-8 sans BOM. L'encodage est detecte sur les premiers
+// octets; l'UTF-8 est transmis tel quel (vues sur les blocs d'entree), l'UTF-16 est transcode
+// dans un tampon de taille fixe. Octet impair et surrogate haut sont reportes au bloc suivant.
+class ArcUtf8Stream {
+public:
+    using Sink = std::function<bool(std::string_view)>;    // false: arret demande
+
+    explicit ArcUtf8Stream(Sink sink) : sink_(std::move(sink)) {}
+
+    ArcUtf8Stream(const ArcUtf8Stream&) = delete;
+    ArcUtf8Stream& operator=(const ArcUtf8Stream&) = delete;
+
+    // false des que le puits a demande l'arret
+    bool Feed(std::string_view bytes);
+    bool Finish();
+
+    ArcTextEncoding Encoding() const { return encoding_; }
+
+private:
+    bool Decode(std::string_view bytes);
+    bool Put(char32_t cp);
+    bool Flush();
+
+    static constexpr size_t kBuffer = 16 * 1024;
+
+    Sink sink_;
+    std::string head_;          // Octets en attente de detection (moins de 3)
+    bool detected_ = false;
+    bool stopped_ = false;
+    ArcTextEncoding encoding_ = ArcTextEncoding::Utf8;
+    int pendingByte_ = -1;      // Octet impair du bloc precedent
+    char32_t pendingHigh_ = 0;  // Surrogate haut du bloc precedent
+    size_t used_ = 0;
+    char buffer_[kBuffer];
+};
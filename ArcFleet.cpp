@@ -0,0 +1,112 @@
+// ArcFleet.cpp - Analyse hors ligne d'un parc: un repertoire d'artefacts par hote
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#include "ArcFleet.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+#include "ArcContent.h"
+#include "ArcLog.h"
+#include "ArcText.h"
+#include "ArcTrace.h"
+
+ArcAgentLayout ArtifactLayout(IArcPlatform& platform, const std::wstring& root) {
+    std::vector<ArcDirEntry> entries;
+    platform.ListDirectory(root, entries);
+
+    // Premier nom present (insensible a la casse), sinon le premier candidat
+    auto locate = [&](std::initializer_list<const wchar_t*> names, bool directory) {
+        for (const wchar_t* name : names) {
+            for (const auto& e : entries) {
+                if (e.isDirectory == directory && EqualsNoCase(e.name, name)) return platform.Join(root, e.name);
+            }
+        }
+        return platform.Join(root, *names.begin());
+    };
+
+    ArcAgentLayout layout;
+    std::wstring configDir = locate({ L"Config" }, true);
+    bool nested = std::any_of(entries.begin(), entries.end(),
+        [](const ArcDirEntry& e) { return e.isDirectory && EqualsNoCase(e.name, L"Config"); });
+    layout.configFile = nested ? platform.Join(configDir, L"agentconfig.json") : locate({ L"agentconfig.json" }, false);
+    layout.tokensDir = locate({ L"Tokens" }, true);
+    layout.certsDir = locate({ L"Certs" }, true);
+    layout.pluginsDir = locate({ L"Plugins", L"waagent" }, true);
+    layout.logDir = locate({ L"Log" }, true);
+    layout.extensionLogDir = locate({ L"extension_logs", L"ExtensionLogs" }, true);
+    return layout;
+}
+
+ArcFleetReport RunFleetScan(IArcPlatform& platform, const std::wstring& fleetDir, const ArcFleetOptions& options) {
+    ArcFleetReport report;
+
+    std::vector<ArcDirEntry> entries;
+    platform.ListDirectory(fleetDir, entries);
+    for (const auto& e : entries) {
+        if (!e.isDirectory) continue;
+        ArcHostReport host;
+        host.host = e.name;
+        report.hosts.push_back(std::move(host));
+    }
+    std::sort(report.hosts.begin(), report.hosts.end(),
+        [](const ArcHostReport& a, const ArcHostReport& b) { return a.host < b.host; });
+
+    uint32_t probes = ArcProbeConfig | ArcProbeCredentials | ArcProbeLogs;
+    if (options.extensions) probes |= ArcProbeExtensions;
+
+    std::mutex streamMutex;
+    ArcContentCache content;    // Partage par tous les hotes de l'analyse
+    auto t0 = std::chrono::steady_clock::now();
+
+    // Parallelisme au niveau des hotes uniquement: chaque hote est evalue sur un seul thread
+    if (options.progress) options.progress->AddTotal(report.hosts.size());
+    ArcParallelFor(report.hosts.size(), options.maxWorkers, [&](size_t i) {
+        ArcHostReport& host = report.hosts[i];
+        ArcTraceScope scope(kTraceHost, host.host);
+        auto h0 = std::chrono::steady_clock::now();
+
+        ArcScanContext ctx(platform);
+        ctx.layout = ArtifactLayout(platform, platform.Join(fleetDir, host.host));
+        ctx.ioWorkers = 1;
+        ctx.expiry = options.expiry;
+        ctx.logSignatures = options.logSignatures;
+        ctx.rules = options.rules;
+        ctx.cancel = options.cancel;
+        ctx.content = options.dedup ? &content : nullptr;
+
+        ArcProbeSlots slots;
+        RunProbes(ctx, probes, slots, 1);
+        if (options.progress) options.progress->Advance();
+        if (ctx.Cancelled()) return;    // Resultat partiel ecarte
+
+        host.components = slots.Merge();
+        ApplyRules(ctx, host.components);
+        host.worst = WorstLevel(host.components);
+        host.wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - h0).count();
+        host.completed = true;
+
+        if (options.onHost) {
+            std::lock_guard<std::mutex> lock(streamMutex);
+            options.onHost(host);
+            host.components = ArcComponentList();
+        }
+    }, options.cancel);
+
+    report.wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    for (const auto& host : report.hosts) {
+        if (!host.completed) continue;
+        report.completed++;
+        report.hostsByLevel[static_cast<int>(host.worst)]++;
+    }
+    report.cancelled = report.completed < report.hosts.size() && IsCancelled(options.cancel);
+    report.dedupLookups = content.Lookups();
+    report.dedupHits = content.Hits();
+    report.dedupBytes = content.SkippedBytes();
+    report.dedupDistinct = content.Entries();
+
+    Log(std::wstring(report.cancelled ? L"Analyse de parc annulee - " : L"Analyse de parc terminee - ") + std::to_wstring(report.completed)
+        + L"/" + std::to_wstring(report.hosts.size()) + L" hotes en " + std::to_wstring(static_cast<long long>(report.wallMs)) + L" ms");
+    return report;
+}
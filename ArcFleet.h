@@ -0,0 +1,57 @@
+// ArcFleet.h - Analyse hors ligne d'un parc: un repertoire d'artefacts par hote
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// <parc>\<hote>\Config\agentconfig.json, Tokens\, Plugins\, Log\  (collecte Windows)
+// <parc>/<hote>/agentconfig.json, tokens/, waagent/, log/          (collecte Linux)
+// Les archives "azcmagent logs" doivent etre decompressees au prealable.
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "ArcScan.h"
+
+struct ArcHostReport {
+    std::wstring host;          // Nom du repertoire de l'hote
+    ArcComponentList components;
+    StatusLevel worst = StatusLevel::OK;
+    double wallMs = 0.0;
+    bool completed = false;     // Faux: hote non analyse ou interrompu (annulation), sans composants
+};
+
+struct ArcFleetOptions {
+    size_t maxWorkers = 8;      // Hotes analyses simultanement
+    bool extensions = true;
+    bool dedup = true;          // Fichiers identiques d'un hote a l'autre analyses une seule fois (ArcContentCache)
+    ArcExpiryThresholds expiry;
+    std::shared_ptr<const ArcLogMatcher> logSignatures;    // nullptr = jeu par defaut
+    std::shared_ptr<const ArcRuleSet> rules;                // Compilees une fois, evaluees pour chaque hote
+    const ArcCancelToken* cancel = nullptr;     // Hotes non demarres sautes, hote en cours abandonne
+    ArcProgress* progress = nullptr;            // Une unite par hote
+
+    // Si defini: appele sous verrou des qu'un hote est termine (ordre de fin), puis les
+    // composants de l'hote sont liberes. La memoire ne croit plus avec la taille du parc.
+    // Jamais appele pour un hote interrompu: le rapport en flux ne contient que des hotes complets.
+    std::function<void(const ArcHostReport&)> onHost;
+};
+
+struct ArcFleetReport {
+    std::vector<ArcHostReport> hosts;   // Trie par nom d'hote
+    size_t hostsByLevel[3] = {};        // Indexe par StatusLevel (hotes completes uniquement)
+    size_t completed = 0;
+    // Deduplication: fichiers lus, dont le contenu avait deja ete analyse (et octets non reanalyses)
+    uint64_t dedupLookups = 0;
+    uint64_t dedupHits = 0;
+    uint64_t dedupBytes = 0;
+    size_t dedupDistinct = 0;   // Contenus distincts analyses
+    double wallMs = 0.0;
+    bool cancelled = false;
+};
+
+// Emplacements de l'agent a l'interieur d'une arborescence d'artefacts (noms insensibles a la casse).
+// Aucun processus surveille: les artefacts ne decrivent pas un systeme en cours d'execution.
+ArcAgentLayout ArtifactLayout(IArcPlatform& platform, const std::wstring& root);
+
+// Configuration, jetons et extensions de chaque hote; un hote par tache, vol de travail entre threads
+ArcFleetReport RunFleetScan(IArcPlatform& platform, const std::wstring& fleetDir, const ArcFleetOptions& options);
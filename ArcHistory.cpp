@@ -0,0 +1,435 @@
+// ArcHistory.cpp - Historique des passes: etats, echeances, evenements et latences par noeud
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#include "ArcHistory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <set>
+
+#include "ArcCache.h"
+#include "ArcEvents.h"
+#include "ArcLog.h"
+#include "ArcScan.h"
+#include "ArcText.h"
+#include "ArcTime.h"
+
+static constexpr char kMagic[4] = { 'A', 'R', 'C', 'H' };
+static constexpr uint32_t kVersion = 1;
+static constexpr size_t kHeaderSize = 16;
+
+// ======================== Framing ========================
+static uint16_t Check(std::string_view payload) {
+    uint32_t h = 2166136261u;
+    for (char c : payload) {
+        h ^= static_cast<uint8_t>(c);
+        h *= 16777619u;
+    }
+    return static_cast<uint16_t>(h ^ (h >> 16));
+}
+
+static void AppendFrame(std::string& out, std::string_view payload) {
+    uint64_t n = payload.size();
+    while (n >= 0x80) { out += static_cast<char>((n & 0x7F) | 0x80); n >>= 7; }
+    out += static_cast<char>(n);
+    const uint16_t check = Check(payload);
+    out += static_cast<char>(check & 0xFF);
+    out += static_cast<char>(check >> 8);
+    out.append(payload);
+}
+
+// false si la trame est incomplete ou alteree
+static bool ReadFrame(std::string_view bytes, size_t& pos, std::string_view& payload) {
+    uint64_t n = 0;
+    for (int shift = 0;; shift += 7) {
+        if (pos >= bytes.size() || shift > 35) return false;
+        const uint8_t b = static_cast<uint8_t>(bytes[pos++]);
+        n |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) break;
+    }
+    if (bytes.size() - pos < 2 || n > bytes.size() - pos - 2) return false;
+    const uint16_t check = static_cast<uint16_t>(static_cast<uint8_t>(bytes[pos]) | (static_cast<uint8_t>(bytes[pos + 1]) << 8));
+    payload = bytes.substr(pos + 2, static_cast<size_t>(n));
+    pos += 2 + static_cast<size_t>(n);
+    return Check(payload) == check;
+}
+
+static std::string Header(int64_t compactedUtc) {
+    std::string out(kMagic, 4);
+    for (size_t i = 0; i < 4; i++) out += static_cast<char>((kVersion >> (8 * i)) & 0xFF);
+    for (size_t i = 0; i < 8; i++) out += static_cast<char>((static_cast<uint64_t>(compactedUtc) >> (8 * i)) & 0xFF);
+    return out;
+}
+
+// ======================== Model ========================
+uint32_t ArcHistory::Model::Intern(const std::string& text) {
+    auto it = ids.find(text);
+    if (it != ids.end()) return it->second;
+    strings.push_back(text);
+    const uint32_t id = static_cast<uint32_t>(strings.size());
+    ids.emplace(text, id);
+    return id;
+}
+
+void ArcHistory::Model::AddRun(int64_t timeUtc, uint32_t scope, const std::map<Key, State>& next,
+    const std::vector<std::pair<std::string, uint32_t>>& probeLatencies, const EventCounts& events, std::string& out) {
+    Run run;
+    run.timeUtc = timeUtc;
+    run.scope = scope;
+    run.events = events;
+    run.firstChange = changes.size();
+    run.firstLatency = latencies.size();
+    for (const auto& lat : probeLatencies) latencies.emplace_back(Intern(lat.first), lat.second);
+    run.latencyCount = latencies.size() - run.firstLatency;
+
+    // Fusion des deux etats de la portee (cles triees): ajouts, modifications, disparitions
+    auto cur = state.lower_bound(Key(scope, 0, 0));
+    const auto curEnd = state.lower_bound(Key(scope + 1, 0, 0));
+    auto nxt = next.begin();
+    std::vector<int64_t> priorExpiry;
+    while (cur != curEnd || nxt != next.end()) {
+        const bool takeCur = nxt == next.end() || (cur != curEnd && cur->first < nxt->first);
+        const bool takeNext = cur == curEnd || (nxt != next.end() && nxt->first < cur->first);
+        const Key& key = takeCur ? cur->first : nxt->first;
+        const State prior = takeNext ? State() : cur->second;
+        const State now = takeCur ? State() : nxt->second;
+        if (prior.status != now.status || prior.level != now.level || prior.expiresUtc != now.expiresUtc) {
+            changes.push_back({ std::get<1>(key), std::get<2>(key), now });
+            priorExpiry.push_back(prior.expiresUtc);
+            if (prior.status != now.status || prior.level != now.level) run.statusChanged = true;
+        }
+        if (!takeNext) ++cur;
+        if (!takeCur) ++nxt;
+    }
+    run.changeCount = changes.size() - run.firstChange;
+
+    ArcCacheWriter w;
+    const Run* previous = runs.empty() ? nullptr : &runs.back();
+    w.Int(scope).Int(timeUtc - (previous ? previous->timeUtc : 0));
+    w.Int(static_cast<int64_t>(strings.size() - emitted));
+    for (; emitted < strings.size(); emitted++) w.Str(strings[emitted]);
+    w.Int(static_cast<int64_t>(run.changeCount));
+    for (size_t i = 0; i < run.changeCount; i++) {
+        const Change& c = changes[run.firstChange + i];
+        w.Int(c.component).Int(c.occurrence).Int(c.state.status);
+        if (c.state.status) w.Int(static_cast<int>(c.state.level)).Int(c.state.expiresUtc - priorExpiry[i]);
+    }
+    for (size_t k = 0; k < events.size(); k++) w.Int(static_cast<int64_t>(events[k] - (previous ? previous->events[k] : 0)));
+    w.Int(static_cast<int64_t>(run.latencyCount));
+    for (size_t i = 0; i < run.latencyCount; i++) w.Int(latencies[run.firstLatency + i].first).Int(latencies[run.firstLatency + i].second);
+    AppendFrame(out, w.Take());
+
+    for (size_t i = 0; i < run.changeCount; i++) {
+        const Change& c = changes[run.firstChange + i];
+        const Key key(scope, c.component, c.occurrence);
+        if (c.state.status) state[key] = c.state;
+        else state.erase(key);
+    }
+    runs.push_back(run);
+}
+
+// ======================== History ========================
+bool ArcHistory::Open(IArcPlatform& platform, const std::wstring& path, const ArcHistoryPolicy& policy) {
+    platform_ = nullptr;
+    path_ = path;
+    policy_ = policy;
+    model_ = Model();
+    compactedUtc_ = 0;
+    fileBytes_ = 0;
+    torn_ = false;
+
+    ArcFileStamp stamp;
+    if (!platform.StatFile(path, stamp)) {
+        platform_ = &platform;      // Absent: cree au premier ajout
+        return true;
+    }
+    std::unique_ptr<IArcMappedFile> mapping = platform.MapFile(path);
+    if (!mapping) {
+        if (stamp.size != 0) return false;
+        torn_ = true;               // Fichier vide: en-tete ecrit au premier ajout
+        platform_ = &platform;
+        return true;
+    }
+    if (!Decode(mapping->Bytes())) return false;
+    platform_ = &platform;
+    return true;
+}
+
+bool ArcHistory::Decode(std::string_view bytes) {
+    if (bytes.size() < kHeaderSize || memcmp(bytes.data(), kMagic, 4) != 0) return false;
+    uint32_t version = 0;
+    uint64_t compacted = 0;
+    for (size_t i = 0; i < 4; i++) version |= static_cast<uint32_t>(static_cast<uint8_t>(bytes[4 + i])) << (8 * i);
+    for (size_t i = 0; i < 8; i++) compacted |= static_cast<uint64_t>(static_cast<uint8_t>(bytes[8 + i])) << (8 * i);
+    if (version != kVersion) return false;
+    compactedUtc_ = static_cast<int64_t>(compacted);
+
+    size_t pos = kHeaderSize;
+    size_t validEnd = pos;
+    std::string_view payload;
+    while (pos < bytes.size() && ReadFrame(bytes, pos, payload) && DecodeRun(payload)) validEnd = pos;
+    fileBytes_ = validEnd;
+    torn_ = validEnd != bytes.size();
+    if (torn_) Log(ArcLogLevel::Warning, L"Historique tronque, reecrit au prochain ajout: " + path_);
+    return true;
+}
+
+// Trame incoherente: aucune trace dans le modele (chaines nouvelles retirees)
+bool ArcHistory::DecodeRun(std::string_view payload) {
+    Model& m = model_;
+    const size_t knownStrings = m.strings.size();
+    auto fail = [&] {
+        for (size_t i = knownStrings; i < m.strings.size(); i++) m.ids.erase(m.strings[i]);
+        m.strings.resize(knownStrings);
+        return false;
+    };
+    const int64_t bound = static_cast<int64_t>(payload.size());
+    ArcCacheReader r(payload);
+    Run run;
+    run.scope = static_cast<uint32_t>(r.Int());
+    run.timeUtc = (m.runs.empty() ? 0 : m.runs.back().timeUtc) + r.Int();
+    const int64_t newStrings = r.Int();
+    for (int64_t i = 0; i < newStrings && newStrings <= bound; i++) m.Intern(std::string(r.Str()));
+
+    std::vector<Change> changes;
+    const int64_t changeCount = r.Int();
+    for (int64_t i = 0; i < changeCount && changeCount <= bound; i++) {
+        Change c;
+        c.component = static_cast<uint32_t>(r.Int());
+        c.occurrence = static_cast<uint32_t>(r.Int());
+        c.state.status = static_cast<uint32_t>(r.Int());
+        if (c.component == 0 || c.component > m.strings.size() || c.state.status > m.strings.size()) return fail();
+        const auto prior = m.state.find(Key(run.scope, c.component, c.occurrence));
+        const State before = prior == m.state.end() ? State() : prior->second;
+        if (c.state.status) {
+            const int64_t level = r.Int();
+            if (level < 0 || level > static_cast<int>(StatusLevel::ERROR_LEVEL)) return fail();
+            c.state.level = static_cast<StatusLevel>(level);
+            c.state.expiresUtc = before.expiresUtc + r.Int();
+        }
+        if (before.status != c.state.status || before.level != c.state.level) run.statusChanged = true;
+        changes.push_back(c);
+    }
+    const EventCounts previous = m.runs.empty() ? EventCounts{} : m.runs.back().events;
+    for (size_t k = 0; k < run.events.size(); k++) run.events[k] = previous[k] + static_cast<uint64_t>(r.Int());
+    std::vector<std::pair<uint32_t, uint32_t>> latencies;
+    const int64_t latencyCount = r.Int();
+    for (int64_t i = 0; i < latencyCount && latencyCount <= bound; i++) {
+        const uint32_t probe = static_cast<uint32_t>(r.Int());
+        if (probe == 0 || probe > m.strings.size()) return fail();
+        latencies.emplace_back(probe, static_cast<uint32_t>(r.Int()));
+    }
+    if (!r.ok()) return fail();
+
+    m.emitted = m.strings.size();
+    run.firstChange = m.changes.size();
+    run.changeCount = changes.size();
+    run.firstLatency = m.latencies.size();
+    run.latencyCount = latencies.size();
+    for (const Change& c : changes) {
+        const Key key(run.scope, c.component, c.occurrence);
+        if (c.state.status) m.state[key] = c.state;
+        else m.state.erase(key);
+        m.changes.push_back(c);
+    }
+    m.latencies.insert(m.latencies.end(), latencies.begin(), latencies.end());
+    m.runs.push_back(run);
+    return true;
+}
+
+bool ArcHistory::Append(int64_t timeUtc, uint32_t scope, const ArcComponentList& components,
+    const std::vector<ArcProbeTiming>& timings, const EventCounts& events) {
+    if (!platform_) return false;
+
+    // Etat de la passe: composant identifie par son nom et son rang parmi les homonymes
+    std::map<Key, State> next;
+    std::unordered_map<uint32_t, uint32_t> occurrences;
+    for (const auto& comp : components) {
+        const uint32_t component = model_.Intern(ToUtf8(ArcStrText(comp.component)));
+        State state;
+        state.status = model_.Intern(ToUtf8(ArcStrText(comp.status)));
+        state.level = comp.level;
+        state.expiresUtc = comp.expiresUtc;
+        next[Key(scope, component, occurrences[component]++)] = state;
+    }
+    std::vector<std::pair<std::string, uint32_t>> latencies;
+    for (const auto& t : timings) {
+        if (!t.cancelled) latencies.emplace_back(ToUtf8(t.probe), static_cast<uint32_t>(std::lround(t.wallMs * 10.0)));
+    }
+
+    std::string frame;
+    model_.AddRun(timeUtc, scope, next, latencies, events, frame);
+    if (torn_ || fileBytes_ == 0 || timeUtc - compactedUtc_ >= policy_.compactSeconds) return Compact(timeUtc);
+
+    std::ofstream file(std::filesystem::path(path_), std::ios::binary | std::ios::app);
+    file.write(frame.data(), static_cast<std::streamsize>(frame.size()));
+    if (!file) {
+        torn_ = true;               // Passe gardee en memoire, fichier reecrit au prochain ajout
+        return false;
+    }
+    fileBytes_ += frame.size();
+    return true;
+}
+
+bool ArcHistory::Compact(int64_t nowUtc) {
+    if (!platform_) return false;
+
+    // Rejoue l'historique et re-encode les passes conservees contre la precedente conservee:
+    // les ecarts des passes oubliees sont reportes sur la suivante
+    Model compacted;
+    std::string out = Header(nowUtc);
+    std::map<Key, State> replay;
+    std::vector<uint32_t> remap(model_.strings.size() + 1, 0);
+    auto id = [&](uint32_t old) {
+        if (!remap[old]) remap[old] = compacted.Intern(model_.strings[old - 1]);
+        return remap[old];
+    };
+    std::map<uint32_t, int64_t> lastBucket;     // Par portee: intervalle de la derniere passe conservee
+
+    for (size_t i = 0; i < model_.runs.size(); i++) {
+        const Run& run = model_.runs[i];
+        for (size_t c = 0; c < run.changeCount; c++) {
+            const Change& change = model_.changes[run.firstChange + c];
+            const Key key(run.scope, change.component, change.occurrence);
+            if (change.state.status) replay[key] = change.state;
+            else replay.erase(key);
+        }
+        const bool last = i + 1 == model_.runs.size();
+        if (!last && run.timeUtc < nowUtc - policy_.retentionSeconds) continue;
+        const int64_t bucket = policy_.thinSeconds > 0 ? run.timeUtc / policy_.thinSeconds : run.timeUtc;
+        if (!last && !run.statusChanged && run.timeUtc < nowUtc - policy_.fullResolutionSeconds) {
+            auto kept = lastBucket.find(run.scope);
+            if (kept != lastBucket.end() && kept->second == bucket) continue;
+        }
+        lastBucket[run.scope] = bucket;
+
+        std::map<Key, State> next;
+        for (auto it = replay.lower_bound(Key(run.scope, 0, 0)); it != replay.end() && std::get<0>(it->first) == run.scope; ++it) {
+            State state = it->second;
+            state.status = id(state.status);
+            next[Key(run.scope, id(std::get<1>(it->first)), std::get<2>(it->first))] = state;
+        }
+        std::vector<std::pair<std::string, uint32_t>> latencies;
+        for (size_t l = 0; l < run.latencyCount; l++) {
+            const auto& lat = model_.latencies[run.firstLatency + l];
+            latencies.emplace_back(model_.strings[lat.first - 1], lat.second);
+        }
+        compacted.AddRun(run.timeUtc, run.scope, next, latencies, run.events, out);
+    }
+
+    if (!WriteAll(out)) {
+        torn_ = true;
+        return false;
+    }
+    if (compacted.runs.size() != model_.runs.size()) {
+        Log(L"Historique compacte: " + std::to_wstring(model_.runs.size()) + L" -> " + std::to_wstring(compacted.runs.size())
+            + L" passes, " + std::to_wstring(out.size()) + L" octets");
+    }
+    model_ = std::move(compacted);
+    compactedUtc_ = nowUtc;
+    fileBytes_ = out.size();
+    torn_ = false;
+    return true;
+}
+
+bool ArcHistory::WriteAll(const std::string& bytes) {
+    const std::filesystem::path target(path_);
+    std::filesystem::path temp = target;
+    temp += ".tmp";
+    bool written;
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        written = static_cast<bool>(file);
+    }
+    std::error_code ec;
+    if (written) std::filesystem::rename(temp, target, ec);
+    if (!written || ec) {
+        std::filesystem::remove(temp, ec);
+        return false;
+    }
+    return true;
+}
+
+// ======================== Queries ========================
+std::vector<ArcStatusChange> ArcHistory::StatusChanges(int64_t sinceUtc) const {
+    std::vector<ArcStatusChange> out;
+    std::map<Key, State> state;
+    std::set<uint32_t> scopes;
+    auto text = [this](uint32_t id) { return id ? FromUtf8(model_.strings[id - 1]) : std::wstring(); };
+
+    for (const Run& run : model_.runs) {
+        const bool baseline = scopes.insert(run.scope).second;
+        for (size_t c = 0; c < run.changeCount; c++) {
+            const Change& change = model_.changes[run.firstChange + c];
+            const Key key(run.scope, change.component, change.occurrence);
+            auto it = state.find(key);
+            const State prior = it == state.end() ? State() : it->second;
+            if (!baseline && run.timeUtc >= sinceUtc && (prior.status != change.state.status || prior.level != change.state.level)) {
+                ArcStatusChange sc;
+                sc.timeUtc = run.timeUtc;
+                sc.component = text(change.component);
+                if (change.occurrence) sc.component += L" #" + std::to_wstring(change.occurrence + 1);
+                sc.from = text(prior.status);
+                sc.to = text(change.state.status);
+                sc.fromLevel = prior.level;
+                sc.toLevel = change.state.level;
+                out.push_back(std::move(sc));
+            }
+            if (change.state.status) state[key] = change.state;
+            else if (it != state.end()) state.erase(it);
+        }
+    }
+    return out;
+}
+
+std::vector<ArcLatencyStats> ArcHistory::LatencyPercentiles(int64_t sinceUtc) const {
+    std::map<std::wstring, std::vector<uint32_t>> samples;
+    for (const Run& run : model_.runs) {
+        if (run.timeUtc < sinceUtc) continue;
+        for (size_t l = 0; l < run.latencyCount; l++) {
+            const auto& lat = model_.latencies[run.firstLatency + l];
+            samples[FromUtf8(model_.strings[lat.first - 1])].push_back(lat.second);
+        }
+    }
+
+    std::vector<ArcLatencyStats> out;
+    for (auto& kv : samples) {
+        std::vector<uint32_t>& v = kv.second;
+        std::sort(v.begin(), v.end());
+        auto rank = [&v](double p) { return v[static_cast<size_t>(std::ceil(p * v.size())) - 1] / 10.0; };
+        ArcLatencyStats stats;
+        stats.probe = kv.first;
+        stats.samples = v.size();
+        stats.p50Ms = rank(0.50);
+        stats.p90Ms = rank(0.90);
+        stats.p99Ms = rank(0.99);
+        stats.maxMs = v.back() / 10.0;
+        out.push_back(std::move(stats));
+    }
+    return out;
+}
+
+ArcHistory::EventCounts ArcHistory::EventsSince(int64_t sinceUtc) const {
+    EventCounts total{};
+    for (size_t i = 1; i < model_.runs.size(); i++) {
+        if (model_.runs[i].timeUtc < sinceUtc) continue;
+        const EventCounts& prev = model_.runs[i - 1].events;
+        const EventCounts& cur = model_.runs[i].events;
+        for (size_t k = 0; k < total.size(); k++) total[k] += cur[k] >= prev[k] ? cur[k] - prev[k] : cur[k];   // Digest reinitialise
+    }
+    return total;
+}
+
+// ======================== Recording ========================
+bool RecordScan(ArcHistory& history, const ArcScanContext& ctx, const ArcScanOptions& options, const ArcScanResult& result) {
+    if (result.cancelled) return false;
+    ArcHistory::EventCounts events{};
+    ArcEventDigest digest;
+    if (digest.Load(EventDigestPath(ctx))) events = { digest.levels[1], digest.levels[2], digest.levels[3] };
+    const uint32_t scope = (options.agent ? 1u : 0u) | (options.extensions ? 2u : 0u);
+    return history.Append(NowUtc(), scope, result.components, result.timings, events);
+}
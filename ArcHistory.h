@@ -0,0 +1,154 @@
+// ArcHistory.h - Historique des passes: etats, echeances, evenements et latences par noeud
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Fichier en ajout seul: chaque passe terminee ajoute un enregistrement qui ne contient que
+// ce qui a change depuis la precedente (composants modifies, deltas de temps, d'echeances et
+// de compteurs d'evenements), encode en varint (ArcCacheWriter). Une passe sans changement
+// coute une trentaine d'octets, latences comprises.
+//
+// Compactage periodique (une fois par jour au plus, a l'ajout): les passes plus anciennes que
+// la retention sont oubliees (l'etat a la coupure devient la reference), et au-dela de la
+// pleine resolution seule une passe sans changement d'etat par heure est conservee. Une
+// passe toutes les 5 minutes pendant 3 ans tient ainsi dans environ 1 Mo.
+//
+// Format (entiers petit-boutistes):
+//   "ARCH" u32 version, i64 date du dernier compactage
+//   enregistrement: varint taille, u16 controle (FNV-1a), charge utile:
+//     portee, delta de date (s), nouvelles chaines (nombre, chaines),
+//     changements (nombre; composant, occurrence, etat [0 = disparu], niveau, delta d'echeance),
+//     deltas des cumuls d'evenements critique / erreur / avertissement,
+//     latences (nombre; sonde, dixiemes de ms)
+// Un enregistrement tronque (arret pendant l'ecriture) et la suite sont ignores; le
+// prochain ajout reecrit le fichier. Un seul processus ecrivain par fichier.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "ArcPlatform.h"
+#include "ArcResult.h"
+#include "ArcScheduler.h"
+
+struct ArcScanContext;
+struct ArcScanOptions;
+struct ArcScanResult;
+
+struct ArcHistoryPolicy {
+    int64_t retentionSeconds = 3 * 365 * 86400;
+    int64_t fullResolutionSeconds = 30 * 86400;   // Au-dela: passes sans changement eclaircies
+    int64_t thinSeconds = 3600;                    // Une passe sans changement conservee par intervalle
+    int64_t compactSeconds = 86400;                // Intervalle minimal entre deux compactages
+};
+
+// Changement d'etat ou de niveau d'un composant (apparition: from vide, disparition: to vide)
+struct ArcStatusChange {
+    int64_t timeUtc = 0;
+    std::wstring component;
+    std::wstring from;
+    std::wstring to;
+    StatusLevel fromLevel = StatusLevel::OK;
+    StatusLevel toLevel = StatusLevel::OK;
+};
+
+struct ArcLatencyStats {
+    std::wstring probe;
+    size_t samples = 0;
+    double p50Ms = 0.0;
+    double p90Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+};
+
+class ArcHistory {
+public:
+    using EventCounts = std::array<uint64_t, 3>;    // Critique, erreur, avertissement
+
+    // Relit tout l'historique en memoire. Fichier absent: historique vide (cree au premier ajout).
+    // false si le fichier existe mais n'est pas un historique.
+    bool Open(IArcPlatform& platform, const std::wstring& path, const ArcHistoryPolicy& policy = ArcHistoryPolicy());
+
+    // 'scope' distingue les passes de perimetres differents (agent, extensions): un composant
+    // absent d'une passe n'est repute disparu que par rapport a la precedente de meme portee.
+    // events: cumuls du journal d'evenements de l'agent.
+    bool Append(int64_t timeUtc, uint32_t scope, const ArcComponentList& components,
+        const std::vector<ArcProbeTiming>& timings, const EventCounts& events);
+
+    // Reecrit le fichier selon la politique (appele par Append lorsque l'intervalle est ecoule)
+    bool Compact(int64_t nowUtc);
+
+    // ======================== Queries ========================
+    // Du plus ancien au plus recent; la premiere passe de chaque portee sert de reference
+    std::vector<ArcStatusChange> StatusChanges(int64_t sinceUtc) const;
+
+    // Par sonde, rang le plus proche; triees par nom
+    std::vector<ArcLatencyStats> LatencyPercentiles(int64_t sinceUtc) const;
+
+    // Nouveaux evenements observes entre les passes de la periode (remise a zero toleree)
+    EventCounts EventsSince(int64_t sinceUtc) const;
+
+    size_t Runs() const { return model_.runs.size(); }
+    int64_t FirstUtc() const { return model_.runs.empty() ? 0 : model_.runs.front().timeUtc; }
+    int64_t LastUtc() const { return model_.runs.empty() ? 0 : model_.runs.back().timeUtc; }
+    uint64_t FileBytes() const { return fileBytes_; }
+
+private:
+    using Key = std::tuple<uint32_t, uint32_t, uint32_t>;      // Portee, composant, occurrence
+
+    struct State {
+        uint32_t status = 0;        // 0 = disparu
+        StatusLevel level = StatusLevel::OK;
+        int64_t expiresUtc = 0;
+    };
+    struct Change {
+        uint32_t component = 0;
+        uint32_t occurrence = 0;
+        State state;
+    };
+    struct Run {
+        int64_t timeUtc = 0;
+        uint32_t scope = 0;
+        size_t firstChange = 0;
+        size_t changeCount = 0;
+        size_t firstLatency = 0;
+        size_t latencyCount = 0;
+        EventCounts events{};
+        bool statusChanged = false; // Etat, niveau ou presence (les echeances seules ne comptent pas)
+    };
+
+    // Historique decode: chaines, passes et etat courant, plus l'encodage en cours
+    struct Model {
+        std::vector<std::string> strings;                       // Identifiant - 1, UTF-8
+        std::unordered_map<std::string, uint32_t> ids;
+        std::vector<Run> runs;
+        std::vector<Change> changes;
+        std::vector<std::pair<uint32_t, uint32_t>> latencies;  // Sonde, dixiemes de ms
+        std::map<Key, State> state;
+        size_t emitted = 0;                                     // Chaines deja ecrites dans le fichier
+
+        uint32_t Intern(const std::string& text);
+        // Ajoute la passe (changements calcules contre l'etat courant) et l'encode dans 'out'
+        void AddRun(int64_t timeUtc, uint32_t scope, const std::map<Key, State>& next,
+            const std::vector<std::pair<std::string, uint32_t>>& latencies, const EventCounts& events, std::string& out);
+    };
+
+    bool Decode(std::string_view bytes);
+    bool DecodeRun(std::string_view payload);
+    bool WriteAll(const std::string& bytes);
+
+    IArcPlatform* platform_ = nullptr;
+    std::wstring path_;
+    ArcHistoryPolicy policy_;
+    int64_t compactedUtc_ = 0;
+    uint64_t fileBytes_ = 0;
+    bool torn_ = false;             // Octets invalides en fin de fichier: reecriture au prochain ajout
+    Model model_;
+};
+
+// Ajoute une passe terminee (ignoree si annulee). Portee: perimetre des options; evenements:
+// cumuls du digest du journal d'evenements de l'agent.
+bool RecordScan(ArcHistory& history, const ArcScanContext& ctx, const ArcScanOptions& options, const ArcScanResult& result);
@@ -0,0 +1,627 @@
+// ArcJson.h - Lecteur JSON zero-copie en une seule passe
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Extrait un ensemble de chemins de cles ("properties.resourceId", "[].status.code")
+// en un seul parcours du document et renvoie des vues sur le tampon source.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ======================== Types ========================
+enum class JsonType { Missing, String, Number, Bool, Null, Object, Array };
+
+template <typename CharT>
+struct BasicJsonValue {
+    std::basic_string_view<CharT> raw;  // Chaine: contenu sans guillemets (echappements conserves). Conteneur: texte complet.
+    JsonType type = JsonType::Missing;
+    bool escaped = false;               // Chaine contenant au moins une sequence '\'
+
+    bool found() const { return type != JsonType::Missing; }
+};
+
+// ======================== Unescape ========================
+namespace jsondetail {
+
+template <typename CharT>
+void AppendCodePoint(std::basic_string<CharT>& out, char32_t cp) {
+    if constexpr (sizeof(CharT) == 1) {
+        if (cp < 0x80) {
+            out += static_cast<CharT>(cp);
+        } else if (cp < 0x800) {
+            out += static_cast<CharT>(0xC0 | (cp >> 6));
+            out += static_cast<CharT>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += static_cast<CharT>(0xE0 | (cp >> 12));
+            out += static_cast<CharT>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<CharT>(0x80 | (cp & 0x3F));
+        } else {
+            out += static_cast<CharT>(0xF0 | (cp >> 18));
+            out += static_cast<CharT>(0x80 | ((cp >> 12) & 0x3F));
+            out += static_cast<CharT>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<CharT>(0x80 | (cp & 0x3F));
+        }
+    } else if constexpr (sizeof(CharT) == 2) {
+        if (cp >= 0x10000) {
+            cp -= 0x10000;
+            out += static_cast<CharT>(0xD800 + (cp >> 10));
+            out += static_cast<CharT>(0xDC00 + (cp & 0x3FF));
+        } else {
+            out += static_cast<CharT>(cp);
+        }
+    } else {
+        out += static_cast<CharT>(cp);
+    }
+}
+
+template <typename CharT>
+int HexDigit(CharT c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+template <typename CharT>
+bool ReadHex4(std::basic_string_view<CharT> s, size_t pos, char32_t& out) {
+    if (pos + 4 > s.size()) return false;
+    out = 0;
+    for (size_t k = 0; k < 4; k++) {
+        int d = HexDigit(s[pos + k]);
+        if (d < 0) return false;
+        out = (out << 4) | static_cast<char32_t>(d);
+    }
+    return true;
+}
+
+} // namespace jsondetail
+
+// Decode les sequences d'echappement d'une chaine JSON brute
+template <typename CharT>
+std::basic_string<CharT> JsonUnescape(std::basic_string_view<CharT> raw) {
+    std::basic_string<CharT> out;
+    out.reserve(raw.size());
+    for (size_t i = 0; i < raw.size(); i++) {
+        CharT c = raw[i];
+        if (c != '\\' || i + 1 >= raw.size()) {
+            out += c;
+            continue;
+        }
+        CharT e = raw[++i];
+        switch (e) {
+            case 'n': out += static_cast<CharT>('\n'); break;
+            case 't': out += static_cast<CharT>('\t'); break;
+            case 'r': out += static_cast<CharT>('\r'); break;
+            case 'b': out += static_cast<CharT>('\b'); break;
+            case 'f': out += static_cast<CharT>('\f'); break;
+            case 'u': {
+                char32_t cp = 0;
+                if (!jsondetail::ReadHex4(raw, i + 1, cp)) { out += e; break; }
+                i += 4;
+                if (cp >= 0xD800 && cp <= 0xDBFF && i + 6 < raw.size() && raw[i + 1] == '\\' && raw[i + 2] == 'u') {
+                    char32_t lo = 0;
+                    if (jsondetail::ReadHex4(raw, i + 3, lo) && lo >= 0xDC00 && lo <= 0xDFFF) {
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                        i += 6;
+                    }
+                }
+                jsondetail::AppendCodePoint(out, cp);
+                break;
+            }
+            default: out += e; break; // \" \\ \/
+        }
+    }
+    return out;
+}
+
+// Valeur d'une chaine decodee si necessaire (copie uniquement a l'affichage)
+template <typename CharT>
+std::basic_string<CharT> JsonString(const BasicJsonValue<CharT>& v) {
+    if (v.escaped) return JsonUnescape(v.raw);
+    return std::basic_string<CharT>(v.raw);
+}
+
+// ======================== Path Set ========================
+// Syntaxe des chemins: segments separes par '.', "[]" = tout element de tableau,
+// "*" = toute cle ou tout element. Au plus 64 chemins par ensemble.
+// Chaque chemin est un bit; les masques precalcules evitent toute comparaison
+// de chemin complet pendant le parcours.
+template <typename CharT>
+class BasicJsonPathSet {
+public:
+    using View = std::basic_string_view<CharT>;
+
+    static constexpr size_t kMaxPaths = 64;
+    static constexpr size_t kMaxDepth = 64;
+
+    explicit BasicJsonPathSet(const std::vector<View>& paths) {
+        for (size_t p = 0; p < paths.size() && p < kMaxPaths; p++) {
+            std::vector<Segment> segs;
+            View rest = paths[p];
+            while (!rest.empty()) {
+                size_t dot = rest.find(static_cast<CharT>('.'));
+                View part = rest.substr(0, dot);
+                Segment seg;
+                if (part.size() == 1 && part[0] == '*') seg.kind = SegKind::Any;
+                else if (part.size() == 2 && part[0] == '[' && part[1] == ']') seg.kind = SegKind::Index;
+                else { seg.kind = SegKind::Key; seg.key.assign(part.data(), part.size()); }
+                segs.push_back(std::move(seg));
+                if (dot == View::npos) break;
+                rest.remove_prefix(dot + 1);
+            }
+            if (segs.empty() || segs.size() >= kMaxDepth) segs.clear(); // chemin ignore
+            paths_.push_back(std::move(segs));
+        }
+
+        for (size_t p = 0; p < paths_.size(); p++) {
+            const uint64_t bit = uint64_t(1) << p;
+            const size_t len = paths_[p].size();
+            if (len == 0) continue;
+            all_ |= bit;
+            lenEq_[len] |= bit;
+            for (size_t d = 0; d < len; d++) {
+                longer_[d] |= bit;
+                if (paths_[p][d].kind != SegKind::Key) indexable_[d] |= bit;
+            }
+        }
+    }
+
+    size_t size() const { return paths_.size(); }
+    uint64_t All() const { return all_; }
+    uint64_t LenEq(size_t k) const { return lenEq_[k]; }          // chemins de longueur exacte k
+    uint64_t Longer(size_t k) const { return longer_[k]; }        // chemins de longueur > k
+    uint64_t Indexable(size_t k) const { return indexable_[k]; }  // segment k accepte un element de tableau
+
+    // Chemins de 'prefix' dont le segment 'seg' accepte la cle
+    uint64_t MatchKey(uint64_t prefix, size_t seg, View key) const {
+        uint64_t out = 0;
+        for (size_t p = 0; p < paths_.size(); p++) {
+            const uint64_t bit = uint64_t(1) << p;
+            if (!(prefix & bit) || seg >= paths_[p].size()) continue;
+            const Segment& s = paths_[p][seg];
+            if (s.kind == SegKind::Any || (s.kind == SegKind::Key && View(s.key) == key)) out |= bit;
+        }
+        return out;
+    }
+
+private:
+    enum class SegKind { Key, Index, Any };
+    struct Segment {
+        SegKind kind = SegKind::Key;
+        std::basic_string<CharT> key;
+    };
+
+    std::vector<std::vector<Segment>> paths_;
+    uint64_t all_ = 0;
+    uint64_t lenEq_[kMaxDepth + 1] = {};
+    uint64_t longer_[kMaxDepth + 1] = {};
+    uint64_t indexable_[kMaxDepth + 1] = {};
+};
+
+// ======================== Path Scanner ========================
+// Document complet en memoire. Le scanner est immuable apres construction
+// et peut etre partage entre threads.
+template <typename CharT>
+class BasicJsonPathScanner {
+public:
+    using View = std::basic_string_view<CharT>;
+    using Value = BasicJsonValue<CharT>;
+
+    static constexpr size_t kMaxPaths = BasicJsonPathSet<CharT>::kMaxPaths;
+    static constexpr size_t kMaxDepth = BasicJsonPathSet<CharT>::kMaxDepth;
+
+    explicit BasicJsonPathScanner(const std::vector<View>& paths) : paths_(paths) {}
+
+    size_t size() const { return paths_.size(); }
+
+    // Un seul parcours. results[i] correspond au chemin i (premiere occurrence).
+    // Renvoie false si le document est malforme; les valeurs deja trouvees restent valides.
+    bool Scan(View doc, std::vector<Value>& results) const {
+        results.assign(paths_.size(), Value{});
+        if (paths_.All() == 0) return true;
+
+        size_t i = SkipWs(doc, SkipBom(doc));
+        if (i >= doc.size()) return false;
+        if (doc[i] != '{' && doc[i] != '[') return true; // racine scalaire: aucun chemin
+
+        Frame stack[kMaxDepth];
+        size_t depth = 0;
+        stack[depth++] = Frame{ paths_.All(), 0, i, doc[i] == '[' };
+        ++i;
+
+        uint64_t pending = paths_.All();
+        size_t openCaptures = 0;
+
+        while (depth > 0) {
+            Frame& f = stack[depth - 1];
+            i = SkipWs(doc, i);
+            if (i >= doc.size()) return false;
+            CharT c = doc[i];
+
+            if (c == ',') { ++i; continue; }
+            if (c == (f.array ? ']' : '}')) {
+                if (f.capture) {
+                    for (size_t p = 0; p < paths_.size(); p++) {
+                        if (f.capture & (uint64_t(1) << p)) results[p].raw = doc.substr(f.start, i + 1 - f.start);
+                    }
+                    --openCaptures;
+                }
+                --depth;
+                ++i;
+                if (pending == 0 && openCaptures == 0) return true;
+                continue;
+            }
+
+            const size_t seg = depth - 1;
+            uint64_t child = 0;
+            if (f.array) {
+                child = f.prefix & paths_.Indexable(seg);
+            } else {
+                if (c != '"') return false;
+                View key;
+                bool esc = false;
+                if (!ReadString(doc, i, key, esc)) return false;
+                i = SkipWs(doc, i);
+                if (i >= doc.size() || doc[i] != ':') return false;
+                i = SkipWs(doc, i + 1);
+                if (f.prefix) child = paths_.MatchKey(f.prefix, seg, key);
+            }
+            if (i >= doc.size()) return false;
+
+            const uint64_t hit = child & paths_.LenEq(seg + 1) & pending;
+            const uint64_t deeper = child & paths_.Longer(seg + 1);
+            c = doc[i];
+
+            if (c == '{' || c == '[') {
+                if ((hit | deeper) == 0 || depth >= kMaxDepth) {
+                    i = SkipContainer(doc, i);
+                    if (i == View::npos) return false;
+                    continue;
+                }
+                const JsonType t = (c == '{') ? JsonType::Object : JsonType::Array;
+                for (size_t p = 0; p < paths_.size(); p++) {
+                    if (hit & (uint64_t(1) << p)) results[p].type = t;
+                }
+                if (hit) { pending &= ~hit; ++openCaptures; }
+                stack[depth++] = Frame{ deeper, hit, i, c == '[' };
+                ++i;
+                continue;
+            }
+
+            Value v;
+            if (!ReadScalar(doc, i, v)) return false;
+            if (hit) {
+                for (size_t p = 0; p < paths_.size(); p++) {
+                    if (hit & (uint64_t(1) << p)) results[p] = v;
+                }
+                pending &= ~hit;
+                if (pending == 0 && openCaptures == 0) return true;
+            }
+        }
+        return true;
+    }
+
+private:
+    struct Frame {
+        uint64_t prefix;   // chemins dont le prefixe correspond jusqu'a ce conteneur
+        uint64_t capture;  // chemins qui capturent ce conteneur entier
+        size_t start;
+        bool array;
+    };
+
+    BasicJsonPathSet<CharT> paths_;
+
+    static size_t SkipBom(View doc) {
+        if constexpr (sizeof(CharT) > 1) {
+            if (!doc.empty() && static_cast<uint32_t>(doc[0]) == 0xFEFF) return 1;
+        }
+        // BOM UTF-8, y compris octets elargis un a un par une lecture binaire
+        if (doc.size() >= 3 && (static_cast<uint32_t>(doc[0]) & 0xFF) == 0xEF &&
+            (static_cast<uint32_t>(doc[1]) & 0xFF) == 0xBB && (static_cast<uint32_t>(doc[2]) & 0xFF) == 0xBF) return 3;
+        return 0;
+    }
+
+    static bool IsWs(CharT c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+    static size_t SkipWs(View doc, size_t i) {
+        while (i < doc.size() && IsWs(doc[i])) i++;
+        return i;
+    }
+
+    // Position du guillemet fermant d'une chaine commencant a 'start' (recherche memchr/wmemchr)
+    static size_t FindStringEnd(View doc, size_t start) {
+        size_t q = start;
+        for (;;) {
+            q = doc.find(static_cast<CharT>('"'), q);
+            if (q == View::npos) return q;
+            size_t bs = 0;
+            while (q - bs > start && doc[q - bs - 1] == '\\') bs++;
+            if ((bs & 1) == 0) return q;
+            ++q;
+        }
+    }
+
+    // i pointe sur le guillemet ouvrant; en sortie, juste apres le guillemet fermant
+    static bool ReadString(View doc, size_t& i, View& out, bool& escaped) {
+        const size_t start = i + 1;
+        const size_t end = FindStringEnd(doc, start);
+        if (end == View::npos) return false;
+        out = doc.substr(start, end - start);
+        escaped = out.find(static_cast<CharT>('\\')) != View::npos;
+        i = end + 1;
+        return true;
+    }
+
+    static bool ReadScalar(View doc, size_t& i, Value& v) {
+        CharT c = doc[i];
+        if (c == '"') {
+            v.type = JsonType::String;
+            return ReadString(doc, i, v.raw, v.escaped);
+        }
+        const size_t start = i;
+        while (i < doc.size()) {
+            CharT d = doc[i];
+            if (d == ',' || d == '}' || d == ']' || IsWs(d)) break;
+            ++i;
+        }
+        if (i == start) return false;
+        v.raw = doc.substr(start, i - start);
+        if (c == 't' || c == 'f') v.type = JsonType::Bool;
+        else if (c == 'n') v.type = JsonType::Null;
+        else v.type = JsonType::Number;
+        return true;
+    }
+
+    // Saute un objet ou tableau complet sans l'analyser; renvoie la position apres la fermeture
+    static size_t SkipContainer(View doc, size_t i) {
+        size_t level = 0;
+        while (i < doc.size()) {
+            CharT c = doc[i];
+            if (c == '"') {
+                i = FindStringEnd(doc, i + 1);
+                if (i == View::npos) return i;
+            } else if (c == '{' || c == '[') {
+                ++level;
+            } else if (c == '}' || c == ']') {
+                if (--level == 0) return i + 1;
+            }
+            ++i;
+        }
+        return View::npos;
+    }
+};
+
+// ======================== Stream Extractor ========================
+// Variante incrementale pour les fichiers lus par blocs (octets UTF-8): memoire fixe
+// quelle que soit la taille du document. Les chaines capturees au-dela de kMaxValue
+// sont tronquees. Chaque valeur scalaire correspondant a un chemin est transmise
+// au gestionnaire: onValue(size_t path, std::string_view raw, JsonType type, bool truncated).
+class JsonStreamExtractor {
+public:
+    static constexpr size_t kMaxDepth = BasicJsonPathSet<char>::kMaxDepth;
+    static constexpr size_t kMaxValue = 512;
+
+    explicit JsonStreamExtractor(const std::vector<std::string_view>& paths) : paths_(paths) { Reset(); }
+
+    void Reset() {
+        state_ = State::Value;
+        depth_ = 0;
+        hit_ = 0;
+        deeper_ = paths_.All();
+        escape_ = false;
+        skipDepth_ = 0;
+        skipInString_ = false;
+        bom_ = 0;
+    }
+
+    // false si le document est malforme (les valeurs deja transmises restent valides)
+    template <typename Handler>
+    bool Feed(std::string_view chunk, Handler&& onValue) {
+        size_t i = 0;
+        while (bom_ < 3 && i < chunk.size()) {
+            static const char kBom[] = "\xEF\xBB\xBF";
+            if (chunk[i] != kBom[bom_]) { bom_ = 3; break; }
+            bom_++;
+            i++;
+        }
+
+        while (i < chunk.size()) {
+            const char c = chunk[i];
+            switch (state_) {
+                case State::Skip: {
+                    // Conteneur sans chemin interessant: comptage des niveaux uniquement
+                    if (skipInString_) {
+                        size_t q = i;
+                        while (q < chunk.size() && (escape_ || (chunk[q] != '"' && chunk[q] != '\\'))) {
+                            escape_ = false;
+                            q++;
+                        }
+                        if (q >= chunk.size()) { i = q; break; }
+                        if (chunk[q] == '\\') escape_ = true;
+                        else skipInString_ = false;
+                        i = q + 1;
+                        break;
+                    }
+                    if (c == '"') skipInString_ = true;
+                    else if (c == '{' || c == '[') skipDepth_++;
+                    else if ((c == '}' || c == ']') && --skipDepth_ == 0) state_ = State::AfterValue;
+                    i++;
+                    break;
+                }
+                case State::String: {
+                    if (escape_) {
+                        escape_ = false;
+                        Append(c);
+                    } else if (c == '\\') {
+                        escape_ = true;
+                        Append(c);
+                    } else if (c == '"') {
+                        if (stringIsKey_) {
+                            state_ = State::Colon;
+                        } else {
+                            Emit(JsonType::String, onValue);
+                            state_ = State::AfterValue;
+                        }
+                    } else {
+                        Append(c);
+                    }
+                    i++;
+                    break;
+                }
+                case State::Scalar: {
+                    if (c == ',' || c == '}' || c == ']' || IsWs(c)) {
+                        const char first = valueLen_ ? value_[0] : '0';
+                        JsonType t = JsonType::Number;
+                        if (first == 't' || first == 'f') t = JsonType::Bool;
+                        else if (first == 'n') t = JsonType::Null;
+                        Emit(t, onValue);
+                        state_ = State::AfterValue;
+                        break; // Delimiteur retraite dans AfterValue
+                    }
+                    Append(c);
+                    i++;
+                    break;
+                }
+                case State::Value: {
+                    if (IsWs(c)) { i++; break; }
+                    if (c == ']' && depth_ > 0 && stack_[depth_ - 1].array && stack_[depth_ - 1].empty) {
+                        Pop();
+                        i++;
+                        break;
+                    }
+                    if (depth_ > 0) stack_[depth_ - 1].empty = false;
+                    BeginValue();
+                    if (c == '"') {
+                        stringIsKey_ = false;
+                        state_ = State::String;
+                    } else if (c == '{' || c == '[') {
+                        if (deeper_ == 0 || depth_ >= kMaxDepth) {
+                            state_ = State::Skip;
+                            skipDepth_ = 1;
+                            skipInString_ = false;
+                        } else {
+                            stack_[depth_++] = Frame{ deeper_, c == '[', true };
+                            if (c == '[') EnterElement();
+                            else state_ = State::Key;
+                        }
+                    } else {
+                        state_ = State::Scalar;
+                        Append(c);
+                    }
+                    i++;
+                    break;
+                }
+                case State::Key: {
+                    if (IsWs(c)) { i++; break; }
+                    if (c == '}' && stack_[depth_ - 1].empty) { Pop(); i++; break; }
+                    if (c != '"') return false;
+                    stack_[depth_ - 1].empty = false;
+                    BeginValue();
+                    stringIsKey_ = true;
+                    state_ = State::String;
+                    i++;
+                    break;
+                }
+                case State::Colon: {
+                    if (IsWs(c)) { i++; break; }
+                    if (c != ':') return false;
+                    const size_t seg = depth_ - 1;
+                    const Frame& f = stack_[seg];
+                    uint64_t child = 0;
+                    if (f.prefix && !truncated_) child = paths_.MatchKey(f.prefix, seg, std::string_view(value_, valueLen_));
+                    hit_ = child & paths_.LenEq(seg + 1);
+                    deeper_ = child & paths_.Longer(seg + 1);
+                    state_ = State::Value;
+                    i++;
+                    break;
+                }
+                case State::AfterValue: {
+                    if (IsWs(c)) { i++; break; }
+                    if (depth_ == 0) { state_ = State::Done; break; }
+                    const Frame& f = stack_[depth_ - 1];
+                    if (c == ',') {
+                        if (f.array) EnterElement();
+                        else state_ = State::Key;
+                    } else if (c == (f.array ? ']' : '}')) {
+                        Pop();
+                    } else {
+                        return false;
+                    }
+                    i++;
+                    break;
+                }
+                case State::Done:
+                    i = chunk.size();
+                    break;
+            }
+        }
+        return true;
+    }
+
+    // A appeler en fin de fichier: true si le document etait complet
+    bool Complete() const { return state_ == State::Done || (state_ == State::AfterValue && depth_ == 0); }
+
+private:
+    enum class State : uint8_t { Value, Key, Colon, String, Scalar, AfterValue, Skip, Done };
+    struct Frame {
+        uint64_t prefix;
+        bool array;
+        bool empty;
+    };
+
+    static bool IsWs(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+    void BeginValue() {
+        valueLen_ = 0;
+        truncated_ = false;
+    }
+
+    void Append(char c) {
+        if (valueLen_ < kMaxValue) value_[valueLen_++] = c;
+        else truncated_ = true;
+    }
+
+    void EnterElement() {
+        const size_t seg = depth_ - 1;
+        const uint64_t child = stack_[seg].prefix & paths_.Indexable(seg);
+        hit_ = child & paths_.LenEq(seg + 1);
+        deeper_ = child & paths_.Longer(seg + 1);
+        state_ = State::Value;
+    }
+
+    void Pop() {
+        --depth_;
+        state_ = depth_ == 0 ? State::Done : State::AfterValue;
+    }
+
+    template <typename Handler>
+    void Emit(JsonType type, Handler& onValue) {
+        if (!hit_) return;
+        for (size_t p = 0; p < paths_.size(); p++) {
+            if (hit_ & (uint64_t(1) << p)) onValue(p, std::string_view(value_, valueLen_), type, truncated_);
+        }
+    }
+
+    BasicJsonPathSet<char> paths_;
+    Frame stack_[kMaxDepth];
+    size_t depth_ = 0;
+    State state_ = State::Value;
+    uint64_t hit_ = 0;          // chemins se terminant sur la valeur courante
+    uint64_t deeper_ = 0;       // chemins se poursuivant dans le conteneur courant
+    bool escape_ = false;
+    bool stringIsKey_ = false;
+    bool truncated_ = false;
+    bool skipInString_ = false;
+    size_t skipDepth_ = 0;
+    size_t bom_ = 0;           // octets de BOM UTF-8 deja reconnus
+    char value_[kMaxValue];
+    size_t valueLen_ = 0;
+};
+
+using JsonPathScannerW = BasicJsonPathScanner<wchar_t>;
+using JsonPathScannerA = BasicJsonPathScanner<char>;
+using JsonValueW = BasicJsonValue<wchar_t>;
+using JsonValueA = BasicJsonValue<char>;
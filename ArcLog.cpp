@@ -0,0 +1,279 @@
+// ArcLog.cpp - Journal texte du verificateur
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#include "ArcLog.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "ArcText.h"
+
+namespace {
+
+// ======================== Ring Buffer ========================
+// File bornee a numeros de sequence: un producteur reserve une case par CAS sur tail_,
+// la remplit puis la publie; le consommateur unique lit dans l'ordre de reservation.
+class LogRing {
+public:
+    static constexpr size_t kCapacity = 8192;   // Puissance de 2
+
+    struct Entry {
+        ArcLogLevel level = ArcLogLevel::Info;
+        std::chrono::system_clock::time_point time;
+        std::string text;
+    };
+
+    LogRing() {
+        for (size_t i = 0; i < kCapacity; i++) slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    bool TryPush(Entry&& entry) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & (kCapacity - 1)];
+            size_t seq = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.entry = std::move(entry);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // Plein
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consommateur unique
+    bool TryPop(Entry& entry) {
+        Slot& slot = slots_[head_ & (kCapacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != head_ + 1) return false;
+        entry = std::move(slot.entry);
+        slot.sequence.store(head_ + kCapacity, std::memory_order_release);
+        head_++;
+        return true;
+    }
+
+    size_t ApproxSize() const {
+        return tail_.load(std::memory_order_relaxed) - headPublished_.load(std::memory_order_relaxed);
+    }
+    void PublishHead() { headPublished_.store(head_, std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{ 0 };
+        Entry entry;
+    };
+
+    std::unique_ptr<Slot[]> slots_{ new Slot[kCapacity] };
+    alignas(64) std::atomic<size_t> tail_{ 0 };
+    alignas(64) size_t head_ = 0;
+    std::atomic<size_t> headPublished_{ 0 };
+};
+
+// ======================== Logger ========================
+class AsyncLogger {
+public:
+    static constexpr uint64_t kMaxFileBytes = 4u << 20;
+
+    ~AsyncLogger() { Shutdown(); }  // Sortie normale du programme: rien n'est perdu
+
+    void Start(const std::wstring& path, ArcLogLevel minLevel) {
+        Shutdown();
+        std::lock_guard<std::mutex> lock(mutex_);
+        path_ = path;
+        minLevel_.store(minLevel);
+        file_.open(std::filesystem::path(path_), std::ios::app | std::ios::binary);
+        std::error_code ec;
+        written_ = std::filesystem::file_size(std::filesystem::path(path_), ec);
+        if (ec) written_ = 0;
+
+        std::string header = "\n========== AzureArcAgentChecker - " + std::to_string(std::chrono::system_clock::now().time_since_epoch().count()) + " ==========\n";
+        file_ << header;
+        file_.flush();
+        written_ += header.size();
+
+        stop_ = false;
+        running_.store(true);
+        flusher_ = std::thread([this] { FlusherLoop(); });
+    }
+
+    void SetLevel(ArcLogLevel level) { minLevel_.store(level); }
+
+    void Submit(ArcLogLevel level, const std::wstring& msg) {
+        if (!running_.load(std::memory_order_acquire) || level < minLevel_.load(std::memory_order_relaxed)) return;
+        LogRing::Entry entry;
+        entry.level = level;
+        entry.time = std::chrono::system_clock::now();
+        entry.text = ToUtf8(msg);
+        if (!ring_.TryPush(std::move(entry))) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // Reveil anticipe uniquement si l'anneau se remplit ou pour une erreur; sinon cadence du thread
+        if (level == ArcLogLevel::Error || ring_.ApproxSize() > LogRing::kCapacity / 2) {
+            urgent_.store(true, std::memory_order_relaxed);
+            wake_.notify_one();
+        }
+    }
+
+    void Flush() {
+        if (!running_.load()) return;
+        std::unique_lock<std::mutex> lock(mutex_);
+        uint64_t target = ++flushRequests_;
+        wake_.notify_one();
+        flushed_.wait(lock, [&] { return flushesDone_ >= target || !running_.load(); });
+    }
+
+    void Shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!flusher_.joinable()) return;
+            stop_ = true;
+        }
+        wake_.notify_one();
+        flusher_.join();
+        running_.store(false);
+        flushed_.notify_all();
+        file_.close();
+    }
+
+    uint64_t Dropped() const { return dropped_.load(); }
+
+private:
+    static const char* LevelTag(ArcLogLevel level) {
+        switch (level) {
+            case ArcLogLevel::Debug: return "DEBUG";
+            case ArcLogLevel::Info: return "INFO ";
+            case ArcLogLevel::Warning: return "AVERT";
+            default: return "ERREUR";
+        }
+    }
+
+    static void AppendLine(std::string& batch, const LogRing::Entry& e) {
+        using namespace std::chrono;
+        std::time_t t = system_clock::to_time_t(e.time);
+        std::tm tm{};
+#ifdef _WIN32
+        localtime_s(&tm, &t);
+#else
+        localtime_r(&t, &tm);
+#endif
+        char prefix[48];
+        long long ms = duration_cast<milliseconds>(e.time.time_since_epoch()).count() % 1000;
+        snprintf(prefix, sizeof(prefix), "%02d:%02d:%02d.%03lld [%s] ", tm.tm_hour, tm.tm_min, tm.tm_sec, ms, LevelTag(e.level));
+        batch += prefix;
+        batch += e.text;
+        batch += '\n';
+    }
+
+    // Un seul fwrite par lot; rotation verifiee entre deux lots
+    void FlusherLoop() {
+        std::string batch;
+        LogRing::Entry entry;
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            wake_.wait_for(lock, std::chrono::milliseconds(200), [&] {
+                return stop_ || flushRequests_ != flushesDone_ || urgent_.load(std::memory_order_relaxed);
+            });
+            urgent_.store(false, std::memory_order_relaxed);
+            bool stopping = stop_;
+            uint64_t requested = flushRequests_;
+            lock.unlock();
+
+            batch.clear();
+            while (ring_.TryPop(entry)) AppendLine(batch, entry);
+            ring_.PublishHead();
+            uint64_t dropped = dropped_.load();
+            if (dropped != reportedDrops_) {
+                batch += "[journal] " + std::to_string(dropped - reportedDrops_) + " ligne(s) perdue(s): anneau plein\n";
+                reportedDrops_ = dropped;
+            }
+
+            if (!batch.empty()) {
+                if (written_ + batch.size() > kMaxFileBytes) Rotate();
+                file_.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+                file_.flush();
+                written_ += batch.size();
+            }
+
+            lock.lock();
+            flushesDone_ = requested;
+            flushed_.notify_all();
+            if (stopping) return;
+        }
+    }
+
+    void Rotate() {
+        file_.close();
+        std::error_code ec;
+        std::filesystem::path current(path_);
+        std::filesystem::path archive(path_ + L".1");
+        std::filesystem::remove(archive, ec);
+        std::filesystem::rename(current, archive, ec);
+        file_.open(current, std::ios::trunc | std::ios::binary);
+        written_ = 0;
+    }
+
+    LogRing ring_;
+    std::atomic<ArcLogLevel> minLevel_{ ArcLogLevel::Info };
+    std::atomic<bool> running_{ false };
+    std::atomic<uint64_t> dropped_{ 0 };
+    std::atomic<bool> urgent_{ false };
+
+    std::mutex mutex_;                  // Protege uniquement la signalisation (jamais pris par Submit)
+    std::condition_variable wake_;
+    std::condition_variable flushed_;
+    bool stop_ = false;
+    uint64_t flushRequests_ = 0;
+    uint64_t flushesDone_ = 0;
+    std::thread flusher_;
+
+    std::wstring path_;                 // Acces reserve au thread d'ecriture apres Start()
+    std::ofstream file_;
+    uint64_t written_ = 0;
+    uint64_t reportedDrops_ = 0;
+};
+
+AsyncLogger g_logger;
+
+}
+
+void InitLog(const std::wstring& directory, ArcLogLevel minLevel) {
+    g_logger.Start(directory + L"WinTools_AzureArcAgentChecker_log.txt", minLevel);
+}
+
+void SetLogLevel(ArcLogLevel minLevel) {
+    g_logger.SetLevel(minLevel);
+}
+
+void Log(const std::wstring& msg) {
+    g_logger.Submit(ArcLogLevel::Info, msg);
+}
+
+void Log(ArcLogLevel level, const std::wstring& msg) {
+    g_logger.Submit(level, msg);
+}
+
+void FlushLog() {
+    g_logger.Flush();
+}
+
+void ShutdownLog() {
+    g_logger.Shutdown();
+}
+
+uint64_t DroppedLogLines() {
+    return g_logger.Dropped();
+}
@@ -0,0 +1,28 @@
+// ArcLog.h - Journal texte du verificateur
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Les appelants ne touchent jamais au disque: les lignes passent par un anneau sans verrou
+// (plusieurs producteurs, un consommateur) vide par lots par un thread d'ecriture dedie.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+enum class ArcLogLevel { Debug, Info, Warning, Error };
+
+// Ouvre (ou cree) le journal dans le repertoire donne, ecrit l'en-tete de session et
+// demarre le thread d'ecriture. Au-dela de 4 Mo le fichier est renomme en .1 (une archive).
+void InitLog(const std::wstring& directory, ArcLogLevel minLevel = ArcLogLevel::Info);
+void SetLogLevel(ArcLogLevel minLevel);
+
+void Log(const std::wstring& msg);  // ArcLogLevel::Info
+void Log(ArcLogLevel level, const std::wstring& msg);
+
+// Attend que toutes les lignes deja soumises soient ecrites
+void FlushLog();
+
+// Vide l'anneau et arrete le thread d'ecriture. Appele automatiquement a la sortie du programme.
+void ShutdownLog();
+
+// Lignes abandonnees parce que l'anneau etait plein (jamais d'attente cote producteur)
+uint64_t DroppedLogLines();
@@ -0,0 +1,436 @@
+// ArcLogScan.cpp - Analyse des journaux de l'agent (himds, azcmagent, gestionnaires d'extensions)
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#include "ArcLogScan.h"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+
+#include "ArcCache.h"
+#include "ArcFile.h"
+#include "ArcScheduler.h"
+#include "ArcText.h"
+#include "ArcTime.h"
+
+static constexpr size_t kMaxDepth = 3;              // extension_logs/<extension>/<version>/fichier
+static constexpr size_t kHeadSize = 64;             // Tete de ligne conservee pour l'horodatage
+static constexpr size_t kMaxStates = 0xFFFF;        // Libelles et etats indexes sur 16 bits
+
+// ======================== Signatures ========================
+const std::vector<ArcLogSignature>& DefaultLogSignatures() {
+    static const std::vector<ArcLogSignature> signatures = {
+        { L"Renouvellement du jeton en echec", "failed to refresh token", StatusLevel::ERROR_LEVEL },
+        { L"Renouvellement du jeton en echec", "token refresh failed", StatusLevel::ERROR_LEVEL },
+        { L"Renouvellement du jeton en echec", "failed to get token", StatusLevel::ERROR_LEVEL },
+        { L"Erreur Entra ID", "AADSTS", StatusLevel::ERROR_LEVEL },
+        { L"Certificat expire", "x509: certificate has expired", StatusLevel::ERROR_LEVEL },
+        { L"Negociation TLS en echec", "tls: handshake failure", StatusLevel::ERROR_LEVEL },
+        { L"Negociation TLS en echec", "TLS handshake timeout", StatusLevel::ERROR_LEVEL },
+        { L"Negociation TLS en echec", "remote error: tls", StatusLevel::ERROR_LEVEL },
+        { L"Certificat non approuve", "x509: certificate signed by unknown authority", StatusLevel::ERROR_LEVEL },
+        { L"Delai de connexion depasse", "context deadline exceeded", StatusLevel::WARNING },
+        { L"Delai de connexion depasse", "i/o timeout", StatusLevel::WARNING },
+        { L"Delai de connexion depasse", "Client.Timeout exceeded", StatusLevel::WARNING },
+        { L"Connexion refusee", "connection refused", StatusLevel::WARNING },
+        { L"Connexion refusee", "connection reset by peer", StatusLevel::WARNING },
+        { L"Resolution DNS en echec", "no such host", StatusLevel::WARNING },
+        { L"Proxy injoignable", "proxyconnect tcp", StatusLevel::WARNING },
+        { L"Acces refuse (401/403)", "StatusCode=401", StatusLevel::WARNING },
+        { L"Acces refuse (401/403)", "StatusCode=403", StatusLevel::WARNING },
+        { L"Acces refuse (401/403)", "401 Unauthorized", StatusLevel::WARNING },
+        { L"Acces refuse (401/403)", "403 Forbidden", StatusLevel::WARNING },
+    };
+    return signatures;
+}
+
+static std::string_view Trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+    return s;
+}
+
+bool LoadLogSignatures(IArcPlatform& platform, const std::wstring& path, std::vector<ArcLogSignature>& out) {
+    ArcFileBytes file;
+    if (!file.Open(platform, path)) return false;
+
+    out.clear();
+    std::string_view text = file.Utf8();
+    while (!text.empty()) {
+        const size_t eol = text.find('\n');
+        std::string_view line = Trim(text.substr(0, eol));
+        text = eol == std::string_view::npos ? std::string_view() : text.substr(eol + 1);
+        if (line.empty() || line[0] == '#') continue;
+
+        const size_t a = line.find('|');
+        const size_t b = a == std::string_view::npos ? a : line.find('|', a + 1);
+        if (b == std::string_view::npos) continue;
+        ArcLogSignature sig;
+        const std::string_view pattern = Trim(line.substr(b + 1));
+        if (!ParseStatusLevel(FromUtf8(Trim(line.substr(0, a))), sig.level) || pattern.empty()) continue;
+        sig.label = FromUtf8(Trim(line.substr(a + 1, b - a - 1)));
+        sig.pattern = std::string(pattern);
+        out.push_back(std::move(sig));
+    }
+    return !out.empty();
+}
+
+// ======================== Matcher ========================
+static uint8_t FoldByte(uint8_t b) {
+    return (b >= 'A' && b <= 'Z') ? static_cast<uint8_t>(b - 'A' + 'a') : b;
+}
+
+ArcLogMatcher::ArcLogMatcher(const std::vector<ArcLogSignature>& signatures) {
+    // Classes d'octets: seuls les octets presents dans les motifs sont distingues (table compacte)
+    for (const auto& sig : signatures) {
+        for (char c : sig.pattern) {
+            const uint8_t b = FoldByte(static_cast<uint8_t>(c));
+            if (class_[b] || classes_ == 256) continue;
+            class_[b] = static_cast<uint8_t>(classes_++);
+            if (b >= 'a' && b <= 'z') class_[b - 'a' + 'A'] = class_[b];
+        }
+    }
+
+    // Trie (transitions absentes = -1), etiquetee par indice de libelle
+    std::vector<int32_t> trie(classes_, -1);
+    outputs_.emplace_back();
+    uint64_t hash = 1469598103934665603ull;
+    auto mix = [&hash](const void* data, size_t size) {
+        for (size_t i = 0; i < size; i++) hash = (hash ^ static_cast<const uint8_t*>(data)[i]) * 1099511628211ull;
+    };
+    for (const auto& sig : signatures) {
+        if (sig.pattern.empty()) continue;
+        size_t label = std::find(labels_.begin(), labels_.end(), sig.label) - labels_.begin();
+        if (label == labels_.size()) {
+            labels_.push_back(sig.label);
+            levels_.push_back(sig.level);
+        } else {
+            levels_[label] = std::max(levels_[label], sig.level);
+        }
+
+        // Motif trop long pour l'automate: ignore en entier
+        if (outputs_.size() + sig.pattern.size() > kMaxStates) continue;
+        size_t state = 0;
+        for (char c : sig.pattern) {
+            int32_t& next = trie[state * classes_ + class_[FoldByte(static_cast<uint8_t>(c))]];
+            if (next < 0) {
+                next = static_cast<int32_t>(outputs_.size());
+                outputs_.emplace_back();
+                trie.resize(outputs_.size() * classes_, -1);
+            }
+            state = static_cast<size_t>(trie[state * classes_ + class_[FoldByte(static_cast<uint8_t>(c))]]);
+        }
+        std::vector<uint16_t>& out = outputs_[state];
+        if (std::find(out.begin(), out.end(), label) == out.end()) out.push_back(static_cast<uint16_t>(label));
+
+        mix(sig.pattern.data(), sig.pattern.size());
+        const std::string label8 = ToUtf8(sig.label);
+        mix(label8.data(), label8.size() + 1);
+        mix(&sig.level, sizeof(sig.level));
+    }
+    fingerprint_ = hash;
+
+    // Determinisation en largeur: chaque transition absente suit le lien de suffixe
+    const size_t states = outputs_.size();
+    std::vector<uint32_t> fail(states, 0);
+    std::vector<uint32_t> next(states * classes_, 0);
+    std::deque<uint32_t> queue;
+    for (size_t c = 0; c < classes_; c++) {
+        if (trie[c] > 0) {
+            next[c] = static_cast<uint32_t>(trie[c]);
+            queue.push_back(next[c]);
+        }
+    }
+    while (!queue.empty()) {
+        const uint32_t s = queue.front();
+        queue.pop_front();
+        for (size_t c = 0; c < classes_; c++) {
+            const int32_t child = trie[s * classes_ + c];
+            if (child < 0) {
+                next[s * classes_ + c] = next[fail[s] * classes_ + c];
+                continue;
+            }
+            next[s * classes_ + c] = static_cast<uint32_t>(child);
+            fail[child] = next[fail[s] * classes_ + c];
+            for (uint16_t label : outputs_[fail[child]]) {
+                std::vector<uint16_t>& out = outputs_[child];
+                if (std::find(out.begin(), out.end(), label) == out.end()) out.push_back(label);
+            }
+            queue.push_back(static_cast<uint32_t>(child));
+        }
+    }
+
+    delta_.resize(next.size());
+    for (size_t i = 0; i < next.size(); i++) {
+        delta_[i] = static_cast<uint32_t>(next[i] * classes_) | (outputs_[next[i]].empty() ? 0 : kMatch);
+    }
+}
+
+// ======================== Timestamps ========================
+static bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+bool LogLineTimestamp(std::string_view head, int64_t& utc) {
+    for (size_t i = 0; i + 10 <= head.size(); i++) {
+        if (!IsDigit(head[i]) || !IsDigit(head[i + 1]) || !IsDigit(head[i + 2]) || !IsDigit(head[i + 3])) continue;
+        if (head[i + 4] != '-' && head[i + 4] != '/') continue;
+
+        // Premiere date trouvee: caracteres d'horodatage uniquement ("," decimale log4net)
+        char buf[40];
+        size_t len = 0;
+        for (size_t j = i; j < head.size() && len < sizeof(buf); j++) {
+            char c = head[j];
+            if (c == '/') c = '-';
+            else if (c == ',') c = '.';
+            if (!IsDigit(c) && c != '-' && c != ':' && c != '.' && c != 'T' && c != 'Z' && c != '+' && c != ' ') break;
+            buf[len++] = c;
+        }
+        // "2025-06-01 12:00:00 +0000 UTC", "2025/06/01 12:00:00 12345": on retire par la fin
+        for (;;) {
+            while (len && buf[len - 1] == ' ') len--;
+            if (len < 10) return false;
+            if (ParseUtcTimestamp(std::string_view(buf, len), utc)) return true;
+            const char* space = static_cast<const char*>(memchr(buf + 10, ' ', len - 10));
+            if (!space) return false;
+            const char* last = space;
+            while ((space = static_cast<const char*>(memchr(space + 1, ' ', buf + len - space - 1)))) last = space;
+            len = static_cast<size_t>(last - buf);
+        }
+    }
+    return false;
+}
+
+// ======================== File Scan ========================
+namespace {
+
+struct LabelCount {
+    uint64_t lines = 0;
+    int64_t lastSeenUtc = 0;
+};
+
+// Etat d'un fichier: compteurs des lignes terminees et position de reprise
+struct LogFileState {
+    std::vector<LabelCount> counts;
+    uint64_t resumeAt = 0;          // Octet suivant la derniere fin de ligne analysee
+};
+
+class LogFileScanner {
+public:
+    LogFileScanner(const ArcLogMatcher& matcher, LogFileState& state)
+        : matcher_(matcher), state_(state), seen_(matcher.LabelCount(), false), start_(state.resumeAt), position_(state.resumeAt) {}
+
+    // Faux si la lecture echoue ou est annulee
+    bool Run(IArcPlatform& platform, const std::wstring& path, const ArcCancelToken* cancel) {
+        const bool ok = platform.ReadFileChunks(path, [this, cancel](std::string_view chunk) {
+            if (IsCancelled(cancel)) return false;
+            Chunk(chunk);
+            return true;
+        }, start_);
+        return ok && !IsCancelled(cancel);
+    }
+
+    // Ligne finale sans retour a la ligne: comptee dans le rapport, relue a la prochaine reprise
+    void PendingTail(std::vector<LabelCount>& counts) const {
+        for (uint16_t label : lineLabels_) Count(counts[label], head_);
+    }
+
+    uint64_t BytesRead() const { return position_ - start_; }
+
+private:
+    void Chunk(std::string_view chunk) {
+        const char* data = chunk.data();
+        const size_t size = chunk.size();
+        if (!atLineStart_ && head_.size() < kHeadSize) {
+            const char* eol = static_cast<const char*>(memchr(data, '\n', size));
+            const size_t n = std::min(kHeadSize - head_.size(), static_cast<size_t>((eol ? eol : data + size) - data));
+            head_.append(data, n);
+        }
+
+        size_t start = 0;
+        while (start < size) {
+            const char* eol = static_cast<const char*>(memchr(data + start, '\n', size - start));
+            const size_t end = eol ? static_cast<size_t>(eol - data) : size;
+            if (atLineStart_) head_.assign(data + start, std::min(kHeadSize, end - start));
+            atLineStart_ = false;
+
+            uint32_t s = state_ac_;
+            for (size_t i = start; i < end; i++) {
+                s = matcher_.Next(s, static_cast<uint8_t>(data[i]));
+                if (s & ArcLogMatcher::kMatch) OnMatch(s);
+            }
+            state_ac_ = s;
+
+            if (!eol) break;
+            EndLine(position_ + end + 1);
+            start = end + 1;
+        }
+        position_ += size;
+    }
+
+    void OnMatch(uint32_t s) {
+        for (uint16_t label : matcher_.Matches(s)) {
+            if (seen_[label]) continue;
+            seen_[label] = true;
+            lineLabels_.push_back(label);
+        }
+    }
+
+    void EndLine(uint64_t next) {
+        for (uint16_t label : lineLabels_) {
+            Count(state_.counts[label], head_);
+            seen_[label] = false;
+        }
+        lineLabels_.clear();
+        state_ac_ = 0;
+        atLineStart_ = true;
+        state_.resumeAt = next;
+    }
+
+    static void Count(LabelCount& count, std::string_view head) {
+        count.lines++;
+        int64_t utc = 0;
+        if (LogLineTimestamp(head, utc)) count.lastSeenUtc = std::max(count.lastSeenUtc, utc);
+    }
+
+    const ArcLogMatcher& matcher_;
+    LogFileState& state_;
+    std::vector<bool> seen_;                // Libelles deja comptes sur la ligne courante
+    std::vector<uint16_t> lineLabels_;
+    std::string head_;
+    uint64_t start_;
+    uint64_t position_;
+    uint32_t state_ac_ = 0;
+    bool atLineStart_ = true;
+};
+
+// Reprise au debut d'une ligne: la position enregistree suit toujours un '\n'
+bool ScanFile(IArcPlatform& platform, const std::wstring& path, const ArcLogMatcher& matcher, LogFileState& state,
+    std::vector<LabelCount>& report, uint64_t& bytesRead, const ArcCancelToken* cancel) {
+    LogFileScanner scanner(matcher, state);
+    const bool ok = scanner.Run(platform, path, cancel);
+    report = state.counts;
+    scanner.PendingTail(report);
+    bytesRead = scanner.BytesRead();
+    return ok;
+}
+
+std::string EncodeState(uint64_t fingerprint, const LogFileState& state) {
+    ArcCacheWriter w;
+    w.Int(static_cast<int64_t>(fingerprint)).Int(static_cast<int64_t>(state.resumeAt)).Int(static_cast<int64_t>(state.counts.size()));
+    for (const auto& c : state.counts) w.Int(static_cast<int64_t>(c.lines)).Int(c.lastSeenUtc);
+    return w.Take();
+}
+
+bool DecodeState(std::string_view data, uint64_t fingerprint, size_t labels, LogFileState& state) {
+    ArcCacheReader r(data);
+    if (static_cast<uint64_t>(r.Int()) != fingerprint) return false;
+    state.resumeAt = static_cast<uint64_t>(r.Int());
+    if (static_cast<size_t>(r.Int()) != labels) return false;
+    state.counts.assign(labels, LabelCount());
+    for (auto& c : state.counts) {
+        c.lines = static_cast<uint64_t>(r.Int());
+        c.lastSeenUtc = r.Int();
+    }
+    return r.ok();
+}
+
+bool IsLogName(const std::wstring& name) {
+    for (const wchar_t* archive : { L".gz", L".zip", L".bz2", L".xz", L".7z" }) {
+        if (EndsWithNoCase(name, archive)) return false;
+    }
+    if (EndsWithNoCase(name, L".log")) return true;
+    // Rotations: himds.log.1, azcmagent.log.20250601
+    std::wstring lower = name;
+    for (auto& c : lower) c = FoldAscii(c);
+    return lower.find(L".log.") != std::wstring::npos;
+}
+
+void CollectLogs(IArcPlatform& platform, const std::wstring& dir, size_t depth, std::vector<std::wstring>& files) {
+    std::vector<ArcDirEntry> entries;
+    if (!platform.ListDirectory(dir, entries)) return;
+    for (const auto& e : entries) {
+        if (e.isDirectory) {
+            if (depth + 1 < kMaxDepth) CollectLogs(platform, platform.Join(dir, e.name), depth + 1, files);
+        } else if (e.size > 0 && IsLogName(e.name)) {
+            files.push_back(platform.Join(dir, e.name));
+        }
+    }
+}
+
+}  // namespace
+
+// ======================== Analysis ========================
+std::vector<std::wstring> FindAgentLogs(IArcPlatform& platform, const ArcAgentLayout& layout) {
+    std::vector<std::wstring> files;
+    if (!layout.logDir.empty()) CollectLogs(platform, layout.logDir, kMaxDepth - 1, files);   // Sans sous-repertoires
+    for (const std::wstring* dir : { &layout.extensionLogDir, &layout.pluginsDir }) {
+        if (!dir->empty()) CollectLogs(platform, *dir, 0, files);
+    }
+    std::sort(files.begin(), files.end());
+    files.erase(std::unique(files.begin(), files.end()), files.end());
+    return files;
+}
+
+ArcLogReport AnalyzeLogs(IArcPlatform& platform, const std::vector<std::wstring>& files, const ArcLogMatcher& matcher,
+    size_t maxWorkers, ArcResultCache* cache, const ArcCancelToken* cancel) {
+    const size_t labels = matcher.LabelCount();
+    std::vector<std::vector<LabelCount>> perFile(files.size());
+    std::vector<uint64_t> sizes(files.size(), 0);
+    std::vector<uint64_t> scanned(files.size(), 0);
+
+    ArcParallelFor(files.size(), maxWorkers, [&](size_t i) {
+        ArcFileStamp stamp;
+        const bool stated = platform.StatFile(files[i], stamp);
+        if (stated) sizes[i] = stamp.size;
+
+        LogFileState state;
+        state.counts.assign(labels, LabelCount());
+        ArcFileStamp previous;
+        std::string_view cached;
+        if (cache && stated && cache->Find(ArcCacheKind::LogScan, files[i], previous, cached)) {
+            LogFileState resumed;
+            // Meme fichier, seulement agrandi: reprise; sinon (rotation, troncature) relecture complete
+            if (DecodeState(cached, matcher.Fingerprint(), labels, resumed) && previous.fileId == stamp.fileId
+                && previous.volume == stamp.volume && stamp.size >= resumed.resumeAt) {
+                if (previous == stamp && resumed.resumeAt == stamp.size) {  // Inchange: entree conservee telle quelle
+                    perFile[i] = std::move(resumed.counts);
+                    return;
+                }
+                state = std::move(resumed);
+            }
+        }
+
+        if (!ScanFile(platform, files[i], matcher, state, perFile[i], scanned[i], cancel)) {
+            perFile[i].assign(labels, LabelCount());
+            return;
+        }
+        if (cache && stated) cache->Store(ArcCacheKind::LogScan, files[i], stamp, EncodeState(matcher.Fingerprint(), state));
+    }, cancel);
+
+    ArcLogReport report;
+    report.files = files.size();
+    std::vector<ArcLogFinding> byLabel(labels);
+    for (size_t l = 0; l < labels; l++) byLabel[l].label = l;
+    for (size_t i = 0; i < files.size(); i++) {
+        report.totalBytes += sizes[i];
+        report.scannedBytes += scanned[i];
+        for (size_t l = 0; l < labels && l < perFile[i].size(); l++) {
+            const LabelCount& c = perFile[i][l];
+            if (!c.lines) continue;
+            ArcLogFinding& f = byLabel[l];
+            f.lines += c.lines;
+            if (f.lastFile.empty() || c.lastSeenUtc > f.lastSeenUtc) {
+                f.lastSeenUtc = std::max(f.lastSeenUtc, c.lastSeenUtc);
+                f.lastFile = files[i];
+            }
+        }
+    }
+    for (auto& f : byLabel) {
+        if (f.lines) report.findings.push_back(std::move(f));
+    }
+    std::sort(report.findings.begin(), report.findings.end(), [&matcher](const ArcLogFinding& a, const ArcLogFinding& b) {
+        if (matcher.Level(a.label) != matcher.Level(b.label)) return matcher.Level(a.label) > matcher.Level(b.label);
+        if (a.lastSeenUtc != b.lastSeenUtc) return a.lastSeenUtc > b.lastSeenUtc;
+        return a.label < b.label;
+    });
+    return report;
+}
@@ -0,0 +1,92 @@
+// ArcLogScan.h - Analyse des journaux de l'agent (himds, azcmagent, gestionnaires d'extensions)
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Recherche d'un jeu de signatures d'echec (renouvellement de jeton, delais de connexion,
+// negociation TLS, ...) dans des journaux de plusieurs centaines de Mo:
+//   - lecture sequentielle par blocs, memoire bornee quelle que soit la taille du fichier;
+//   - decoupage en lignes par memchr, puis un seul passage d'un automate Aho-Corasick
+//     determinise (tous les motifs a la fois, insensible a la casse ASCII);
+//   - une ligne compte une fois par signature; l'horodatage de tete de ligne donne la
+//     derniere occurrence.
+// Avec un cache, seuls les octets ajoutes depuis la passe precedente sont relus.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ArcPlatform.h"
+#include "ArcResult.h"
+
+struct ArcLogSignature {
+    std::wstring label;         // Libelle du resultat; plusieurs motifs peuvent le partager
+    std::string pattern;        // Octets recherches (UTF-8)
+    StatusLevel level = StatusLevel::WARNING;
+};
+
+const std::vector<ArcLogSignature>& DefaultLogSignatures();
+
+// Une signature par ligne: "niveau|libelle|motif", niveau = erreur / avertissement / info.
+// Lignes vides et commentaires ('#') ignores. Faux si aucune signature valide.
+bool LoadLogSignatures(IArcPlatform& platform, const std::wstring& path, std::vector<ArcLogSignature>& out);
+
+// ======================== Matcher ========================
+class ArcLogMatcher {
+public:
+    explicit ArcLogMatcher(const std::vector<ArcLogSignature>& signatures);
+
+    // Libelles distincts (niveau le plus grave des motifs qui le partagent)
+    size_t LabelCount() const { return labels_.size(); }
+    const std::wstring& Label(size_t i) const { return labels_[i]; }
+    StatusLevel Level(size_t i) const { return levels_[i]; }
+
+    // Change avec le jeu de signatures: invalide les analyses incrementales du cache
+    uint64_t Fingerprint() const { return fingerprint_; }
+
+    // Etat initial 0, code par le debut de sa ligne dans la table (etat * classes).
+    // Bit kMatch: l'etat atteint termine au moins un motif.
+    static constexpr uint32_t kMatch = 0x80000000u;
+    uint32_t Next(uint32_t state, uint8_t byte) const { return delta_[(state & ~kMatch) + class_[byte]]; }
+    const std::vector<uint16_t>& Matches(uint32_t state) const { return outputs_[(state & ~kMatch) / classes_]; }
+
+private:
+    std::vector<std::wstring> labels_;
+    std::vector<StatusLevel> levels_;
+    uint8_t class_[256] = {};                   // Octet -> classe (0 = absent de tous les motifs)
+    size_t classes_ = 1;
+    std::vector<uint32_t> delta_;               // [etat * classes_ + classe] -> etat suivant * classes_ | kMatch
+    std::vector<std::vector<uint16_t>> outputs_; // Etat -> libelles termines (liens de suffixe inclus)
+    uint64_t fingerprint_ = 0;
+};
+
+// ======================== Analysis ========================
+struct ArcLogFinding {
+    size_t label = 0;           // Indice ArcLogMatcher::Label
+    uint64_t lines = 0;
+    int64_t lastSeenUtc = 0;    // 0 = aucune ligne horodatee
+    std::wstring lastFile;      // Fichier de la derniere occurrence
+};
+
+struct ArcLogReport {
+    std::vector<ArcLogFinding> findings;        // Du plus grave au moins grave, puis du plus recent
+    size_t files = 0;
+    uint64_t totalBytes = 0;
+    uint64_t scannedBytes = 0;                  // Lus pendant cette passe
+};
+
+class ArcResultCache;
+class ArcCancelToken;
+
+// Journaux de l'agent (logDir) et des extensions (extensionLogDir, pluginsDir), rotations
+// comprises; les archives compressees sont ignorees.
+std::vector<std::wstring> FindAgentLogs(IArcPlatform& platform, const ArcAgentLayout& layout);
+
+// Fichiers analyses en parallele. Un fichier qui n'a fait que grandir (meme identifiant) est
+// repris a la derniere fin de ligne analysee; rotation ou troncature: relecture complete.
+// Annulation testee a chaque bloc lu; un fichier interrompu n'est pas enregistre dans le cache.
+ArcLogReport AnalyzeLogs(IArcPlatform& platform, const std::vector<std::wstring>& files, const ArcLogMatcher& matcher,
+    size_t maxWorkers, ArcResultCache* cache = nullptr, const ArcCancelToken* cancel = nullptr);
+
+// Horodatage en tete de ligne: ISO-8601, "2025/06/01 12:00:00", time="...", [...]
+bool LogLineTimestamp(std::string_view head, int64_t& utc);
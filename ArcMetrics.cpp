@@ -0,0 +1,334 @@
+// ArcMetrics.cpp - Point de terminaison HTTP des metriques (Prometheus, JSON) en surveillance
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#include "ArcMetrics.h"
+
+#include <chrono>
+#include <cstdio>
+#include <set>
+
+#include "ArcText.h"
+#include "ArcTime.h"
+
+static constexpr uint32_t kPollMs = 500;            // Delai de prise en compte de Stop()
+static constexpr int64_t kConnectionMs = 5000;      // Requete lue et reponse envoyee
+static constexpr size_t kMaxRequest = 8192;
+static constexpr size_t kMaxConnections = 32;
+
+static int64_t SteadyMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ======================== Rendering ========================
+static const char* LevelLabel(size_t level) {
+    static const char* const names[] = { "", "critique", "erreur", "avertissement" };
+    return names[level];
+}
+
+// Valeur d'etiquette Prometheus: \, " et saut de ligne echappes
+static void AppendLabel(std::string& out, const char* name, std::string_view utf8) {
+    out += name;
+    out += "=\"";
+    for (char c : utf8) {
+        if (c == '\\') out += "\\\\";
+        else if (c == '"') out += "\\\"";
+        else if (c == '\n') out += "\\n";
+        else if (c != '\r') out += c;
+    }
+    out += '"';
+}
+
+static void AppendNumber(std::string& out, double value) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.6f", value);
+    out += buffer;
+}
+
+static void AppendHelp(std::string& out, const char* name, const char* type, const char* help) {
+    out.append("# HELP ").append(name).append(" ").append(help).append("\n");
+    out.append("# TYPE ").append(name).append(" ").append(type).append("\n");
+}
+
+std::unique_ptr<const ArcMetricsSnapshot> BuildMetricsSnapshot(const ArcComponentList& components,
+    const std::vector<ArcProbeTiming>& timings, double wallMs, const ArcEventDigest* events, int64_t nowUtc) {
+    auto snapshot = std::make_unique<ArcMetricsSnapshot>();
+    snapshot->timeUtc = nowUtc;
+
+    // Etiquettes d'identite par ligne; une serie repetee (meme composant et statut) est distinguee par "row"
+    std::vector<std::string> labels;
+    labels.reserve(components.size());
+    std::set<std::string> seen;
+    for (size_t i = 0; i < components.size(); i++) {
+        const ArcComponentInfo& row = components[i];
+        std::string l;
+        AppendLabel(l, "component", ToUtf8(ArcStrText(row.component)));
+        l += ',';
+        AppendLabel(l, "status", ToUtf8(ArcStrText(row.status)));
+        if (!seen.insert(l).second) l += ",row=\"" + std::to_string(i) + "\"";
+        labels.push_back(std::move(l));
+    }
+
+    std::string& p = snapshot->prometheus;
+    AppendHelp(p, "arc_component_level", "gauge", "Niveau du composant (0 OK, 1 avertissement, 2 erreur)");
+    for (size_t i = 0; i < components.size(); i++) {
+        const ArcComponentInfo& row = components[i];
+        p.append("arc_component_level{").append(labels[i]).append(",");
+        AppendLabel(p, "version", ToUtf8(ArcStrText(row.version)));
+        p.append("} ").append(std::to_string(static_cast<int>(row.level))).append("\n");
+    }
+    AppendHelp(p, "arc_component_value", "gauge", "Mesure propre a la sonde (code d'extension, lignes, evenements, ms, instances)");
+    for (size_t i = 0; i < components.size(); i++) {
+        p.append("arc_component_value{").append(labels[i]).append("} ").append(std::to_string(components[i].value)).append("\n");
+    }
+    AppendHelp(p, "arc_component_expiry_timestamp_seconds", "gauge", "Expiration du jeton ou certificat (secondes depuis 1970)");
+    for (size_t i = 0; i < components.size(); i++) {
+        if (!components[i].expiresUtc) continue;
+        p.append("arc_component_expiry_timestamp_seconds{").append(labels[i]).append("} ").append(std::to_string(components[i].expiresUtc)).append("\n");
+    }
+    AppendHelp(p, "arc_component_remaining_seconds", "gauge", "Secondes restantes avant expiration, a l'instant de la passe (negatif: expire)");
+    for (size_t i = 0; i < components.size(); i++) {
+        if (!components[i].expiresUtc) continue;
+        p.append("arc_component_remaining_seconds{").append(labels[i]).append("} ").append(std::to_string(components[i].expiresUtc - nowUtc)).append("\n");
+    }
+    AppendHelp(p, "arc_components", "gauge", "Lignes de resultat de la derniere passe");
+    p.append("arc_components ").append(std::to_string(components.size())).append("\n");
+    AppendHelp(p, "arc_worst_level", "gauge", "Niveau le plus grave (code retour de arccheck)");
+    p.append("arc_worst_level ").append(std::to_string(static_cast<int>(WorstLevel(components)))).append("\n");
+
+    ArcEventDigest::LevelCounts recent{};
+    if (events) {
+        recent = events->Recent(nowUtc, 86400);
+        AppendHelp(p, "arc_agent_events_total", "counter", "Evenements de l'agent par niveau depuis le debut du resume");
+        for (size_t level = 1; level <= 3; level++) {
+            p.append("arc_agent_events_total{level=\"").append(LevelLabel(level)).append("\"} ").append(std::to_string(events->levels[level])).append("\n");
+        }
+        AppendHelp(p, "arc_agent_events_24h", "gauge", "Evenements de l'agent par niveau sur les dernieres 24 h");
+        for (size_t level = 1; level <= 3; level++) {
+            p.append("arc_agent_events_24h{level=\"").append(LevelLabel(level)).append("\"} ").append(std::to_string(recent[level])).append("\n");
+        }
+    }
+
+    AppendHelp(p, "arc_probe_duration_seconds", "gauge", "Duree de la derniere execution de chaque sonde");
+    for (const auto& t : timings) {
+        p.append("arc_probe_duration_seconds{");
+        AppendLabel(p, "probe", ToUtf8(t.probe));
+        p.append("} ");
+        AppendNumber(p, t.wallMs / 1000.0);
+        p.append("\n");
+    }
+    AppendHelp(p, "arc_scan_duration_seconds", "gauge", "Duree de la derniere evaluation (mur)");
+    p.append("arc_scan_duration_seconds ");
+    AppendNumber(p, wallMs / 1000.0);
+    p.append("\n");
+    AppendHelp(p, "arc_snapshot_timestamp_seconds", "gauge", "Fin de la passe ayant produit ces metriques");
+    p.append("arc_snapshot_timestamp_seconds ").append(std::to_string(nowUtc)).append("\n");
+
+    // JSON: memes noms de champs que l'export JSON Lines
+    std::string& j = snapshot->json;
+    auto string = [&j](std::wstring_view value) { AppendJsonString(j, ToUtf8(value)); };
+    j += "{\"time\":";
+    string(FormatUtc(nowUtc));
+    j += ",\"level\":\"";
+    j += ToUtf8(StatusLevelName(WorstLevel(components)));
+    j += "\",\"components\":[";
+    for (size_t i = 0; i < components.size(); i++) {
+        const ArcComponentInfo& row = components[i];
+        if (i) j += ',';
+        j += "{\"component\":"; string(ArcStrText(row.component));
+        j += ",\"status\":"; string(ArcStrText(row.status));
+        j += ",\"level\":\""; j += ToUtf8(StatusLevelName(row.level));
+        j += "\",\"version\":"; string(ArcStrText(row.version));
+        j += ",\"value\":"; j += std::to_string(row.value);
+        if (row.expiresUtc) {
+            j += ",\"expiration\":"; string(FormatUtc(row.expiresUtc));
+            j += ",\"remainingSeconds\":"; j += std::to_string(row.expiresUtc - nowUtc);
+        }
+        j += ",\"details\":"; string(components.Details(row));
+        j += ",\"alerts\":"; string(components.Alerts(row));
+        j += '}';
+    }
+    j += ']';
+    if (events) {
+        j += ",\"events\":{";
+        for (size_t level = 1; level <= 3; level++) {
+            if (level > 1) j += ',';
+            j.append("\"").append(LevelLabel(level)).append("\":{\"total\":").append(std::to_string(events->levels[level]));
+            j.append(",\"24h\":").append(std::to_string(recent[level])).append("}");
+        }
+        j += '}';
+    }
+    j += ",\"probes\":[";
+    for (size_t i = 0; i < timings.size(); i++) {
+        if (i) j += ',';
+        j += "{\"probe\":"; string(timings[i].probe);
+        j += ",\"ms\":"; AppendNumber(j, timings[i].wallMs);
+        if (timings[i].failed) j += ",\"failed\":true";
+        j += '}';
+    }
+    j += "],\"scanMs\":";
+    AppendNumber(j, wallMs);
+    j += "}\n";
+    return snapshot;
+}
+
+// ======================== Server ========================
+ArcMetricsServer::ArcMetricsServer(IArcPlatform& platform) : platform_(platform) {}
+
+ArcMetricsServer::~ArcMetricsServer() {
+    Stop();
+    delete pending_.exchange(nullptr, std::memory_order_acquire);
+}
+
+bool ArcMetricsServer::Start(const ArcNetAddress& at) {
+    if (thread_.joinable()) return true;
+    loop_ = platform_.CreateNetLoop();
+    if (!loop_) return false;
+    listener_ = loop_->ListenTcp(at);
+    if (listener_ < 0) {
+        loop_.reset();
+        return false;
+    }
+    loop_->Watch(listener_, true, false);
+    stop_.store(false, std::memory_order_relaxed);
+    thread_ = std::thread([this] { Run(); });
+    return true;
+}
+
+void ArcMetricsServer::Stop() {
+    stop_.store(true, std::memory_order_relaxed);
+    if (thread_.joinable()) thread_.join();
+    connections_.clear();
+    loop_.reset();      // Ferme l'ecoute et les connexions restantes
+    listener_ = -1;
+}
+
+void ArcMetricsServer::Publish(std::unique_ptr<const ArcMetricsSnapshot> snapshot) {
+    // L'instantane remplace n'a jamais ete vu par le serveur: il appartient encore a l'editeur
+    delete pending_.exchange(snapshot.release(), std::memory_order_acq_rel);
+}
+
+void ArcMetricsServer::Close(size_t index) {
+    loop_->Close(connections_[index].socket);
+    connections_[index] = std::move(connections_.back());
+    connections_.pop_back();
+}
+
+void ArcMetricsServer::Respond(Connection& c) {
+    requests_.fetch_add(1, std::memory_order_relaxed);
+    if (const ArcMetricsSnapshot* next = pending_.exchange(nullptr, std::memory_order_acq_rel)) current_.reset(next);
+
+    // Ligne de requete: METHODE CIBLE VERSION
+    const std::string_view request(c.request);
+    const std::string_view line = request.substr(0, request.find("\r\n"));
+    const size_t sp1 = line.find(' ');
+    const size_t sp2 = sp1 == std::string_view::npos ? sp1 : line.find(' ', sp1 + 1);
+    const std::string_view method = line.substr(0, sp1);
+    std::string_view target = sp2 == std::string_view::npos ? std::string_view() : line.substr(sp1 + 1, sp2 - sp1 - 1);
+    target = target.substr(0, target.find('?'));
+
+    const char* status = "200 OK";
+    const char* type = "text/plain; charset=utf-8";
+    std::string_view body;
+    if (method != "GET" && method != "HEAD") {
+        status = "405 Method Not Allowed";
+        body = "Methode non prise en charge\n";
+    } else if (target != "/metrics" && target != "/metrics.json" && target != "/json" && target != "/") {
+        status = "404 Not Found";
+        body = "Chemins: /metrics (Prometheus), /metrics.json (JSON)\n";
+    } else if (target == "/") {
+        body = "Azure Arc Agent Checker: /metrics (Prometheus), /metrics.json (JSON)\n";
+    } else if (!current_) {
+        status = "503 Service Unavailable";
+        body = "Premiere passe en cours\n";
+    } else if (target == "/metrics") {
+        type = "text/plain; version=0.0.4; charset=utf-8";
+        body = current_->prometheus;
+        c.snapshot = current_;
+    } else {
+        type = "application/json";
+        body = current_->json;
+        c.snapshot = current_;
+    }
+
+    char header[256];
+    snprintf(header, sizeof(header), "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nCache-Control: no-store\r\nConnection: close\r\n\r\n",
+        status, type, body.size());
+    c.header = header;
+    c.body = method == "HEAD" ? std::string_view() : body;
+    c.responding = true;
+    c.request.clear();
+    c.request.shrink_to_fit();
+}
+
+bool ArcMetricsServer::Flush(Connection& c) {
+    const size_t total = c.header.size() + c.body.size();
+    while (c.sent < total) {
+        const std::string_view piece = c.sent < c.header.size()
+            ? std::string_view(c.header).substr(c.sent) : c.body.substr(c.sent - c.header.size());
+        const int n = loop_->Send(c.socket, piece);
+        if (n < 0) return false;
+        if (n == 0) {
+            loop_->Watch(c.socket, false, true);   // Tampon plein: reprise quand le pair a lu
+            return true;
+        }
+        c.sent += static_cast<size_t>(n);
+    }
+    return false;   // Reponse complete
+}
+
+void ArcMetricsServer::Run() {
+    std::vector<ArcNetEvent> ready;
+    char buffer[4096];
+    while (!stop_.load(std::memory_order_relaxed)) {
+        if (!loop_->Wait(kPollMs, ready)) break;
+        bool incoming = false;
+        for (const ArcNetEvent& e : ready) {
+            if (e.socket == listener_) {
+                incoming = true;
+                continue;
+            }
+            size_t index = 0;
+            while (index < connections_.size() && connections_[index].socket != e.socket) index++;
+            if (index == connections_.size()) continue;
+            Connection& c = connections_[index];
+
+            bool keep = true;
+            if (!c.responding && (e.readable || e.failed)) {
+                const int n = loop_->Recv(c.socket, buffer, sizeof(buffer));
+                if (n == 0 || n == -1) keep = false;
+                else if (n > 0) c.request.append(buffer, static_cast<size_t>(n));
+                if (keep && c.request.find("\r\n\r\n") != std::string::npos) {
+                    Respond(c);
+                    keep = Flush(c);
+                } else if (c.request.size() > kMaxRequest) {
+                    keep = false;
+                }
+            } else if (c.responding && (e.writable || e.failed)) {
+                keep = Flush(c);
+            }
+            if (!keep) Close(index);
+        }
+
+        // Connexions lentes ou abandonnees
+        const int64_t now = SteadyMs();
+        for (size_t i = connections_.size(); i-- > 0; ) {
+            if (now >= connections_[i].deadlineMs) Close(i);
+        }
+
+        // Apres le traitement du lot: Accept peut reattribuer l'identifiant d'un socket ferme
+        while (incoming) {
+            const int socket = loop_->Accept(listener_);
+            if (socket < 0) break;
+            if (connections_.size() >= kMaxConnections) {
+                loop_->Close(socket);
+                continue;
+            }
+            Connection c;
+            c.socket = socket;
+            c.deadlineMs = now + kConnectionMs;
+            connections_.push_back(std::move(c));
+            loop_->Watch(socket, true, false);
+        }
+    }
+    for (size_t i = connections_.size(); i-- > 0; ) Close(i);
+}
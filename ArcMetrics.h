@@ -0,0 +1,85 @@
+// ArcMetrics.h - Point de terminaison HTTP des metriques (Prometheus, JSON) en surveillance
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Chaque passe terminee produit un instantane immuable: les deux corps de reponse (format
+// texte Prometheus 0.0.4 et JSON) sont rendus une fois, dans le thread de la passe. Le
+// serveur ne fait qu'envoyer les octets de l'instantane courant: une collecte ne declenche
+// jamais d'analyse, ne prend aucun verrou et ne reformate rien.
+//
+// Passage d'instantane sans verrou: Publish() depose le nouveau dans un pointeur atomique,
+// le thread du serveur le recupere a la requete suivante. Les reponses en cours d'envoi
+// gardent une reference sur leur instantane (shared_ptr propre au thread du serveur).
+//
+// HTTP/1.1 minimal: GET ou HEAD, une requete par connexion (Connection: close), en-tetes
+// limites a 8 Ko, connexions simultanees et duree bornees. Adresse de boucle locale par
+// defaut: aucune authentification, ne l'exposer qu'a un collecteur de confiance.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ArcEvents.h"
+#include "ArcPlatform.h"
+#include "ArcResult.h"
+#include "ArcScheduler.h"
+
+struct ArcMetricsSnapshot {
+    int64_t timeUtc = 0;
+    std::string prometheus;     // text/plain; version=0.0.4
+    std::string json;
+};
+
+// events: nullptr si le journal d'evenements de l'agent n'a pas de resume (Linux, premiere passe)
+std::unique_ptr<const ArcMetricsSnapshot> BuildMetricsSnapshot(const ArcComponentList& components,
+    const std::vector<ArcProbeTiming>& timings, double wallMs, const ArcEventDigest* events, int64_t nowUtc);
+
+class ArcMetricsServer {
+public:
+    explicit ArcMetricsServer(IArcPlatform& platform);
+    ~ArcMetricsServer();
+
+    ArcMetricsServer(const ArcMetricsServer&) = delete;
+    ArcMetricsServer& operator=(const ArcMetricsServer&) = delete;
+
+    // Ecoute ouverte dans le thread appelant: false si la pile reseau manque ou l'adresse est prise
+    bool Start(const ArcNetAddress& at);
+    void Stop();
+
+    // Depuis le thread de la passe, sans attente. Un instantane non encore servi est remplace.
+    void Publish(std::unique_ptr<const ArcMetricsSnapshot> snapshot);
+
+    uint64_t Requests() const { return requests_.load(std::memory_order_relaxed); }
+
+private:
+    struct Connection {
+        int socket = -1;
+        int64_t deadlineMs = 0;
+        std::string request;
+        std::string header;
+        std::shared_ptr<const ArcMetricsSnapshot> snapshot;    // Garde le corps vivant pendant l'envoi
+        std::string_view body;
+        size_t sent = 0;
+        bool responding = false;
+    };
+
+    void Run();
+    void Respond(Connection& c);
+    bool Flush(Connection& c);      // false: connexion a fermer
+    void Close(size_t index);
+
+    IArcPlatform& platform_;
+    std::unique_ptr<IArcNetLoop> loop_;
+    int listener_ = -1;
+    std::thread thread_;
+    std::atomic<bool> stop_{ false };
+    std::atomic<const ArcMetricsSnapshot*> pending_{ nullptr };
+    std::atomic<uint64_t> requests_{ 0 };
+
+    // Propre au thread du serveur
+    std::shared_ptr<const ArcMetricsSnapshot> current_;
+    std::vector<Connection> connections_;
+};
@@ -0,0 +1,224 @@
+// ArcPlatform.h - Abstraction systeme pour le moteur de verification (Windows / Linux)
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ======================== Types ========================
+struct ArcProcessEntry {
+    uint32_t pid = 0;
+    uint32_t parentPid = 0;
+    std::wstring name;      // Nom d'image ("himds.exe" sous Windows, "himds" sous Linux)
+};
+
+// Compteurs cumules d'un processus a un instant donne (echantillonnage des ressources)
+struct ArcProcessSample {
+    uint64_t cpuTimeUs = 0;     // Temps CPU noyau + utilisateur depuis le demarrage
+    uint64_t workingSet = 0;    // Memoire residente (octets)
+    uint32_t handles = 0;       // Handles (Windows) / descripteurs ouverts (Linux; 0 si /proc/<pid>/fd est refuse)
+    uint64_t ioReadBytes = 0;   // Octets lus / ecrits, toutes E/S confondues
+    uint64_t ioWriteBytes = 0;
+    uint64_t startTime = 0;     // Date de creation, unite propre a la plateforme: change si le PID est reutilise
+};
+
+struct ArcDirEntry {
+    std::wstring name;
+    bool isDirectory = false;
+    uint64_t size = 0;
+};
+
+// Identite d'un fichier: tant qu'elle est identique, le contenu est repute inchange.
+// Un remplacement atomique (nouveau fichier renomme) change fileId meme a taille et date egales.
+struct ArcFileStamp {
+    uint64_t size = 0;
+    int64_t writeTime = 0;  // Unite propre a la plateforme (100 ns sous Windows, ns sous Linux)
+    uint64_t fileId = 0;    // Index NTFS / inode
+    uint64_t volume = 0;    // Numero de serie du volume / st_dev
+
+    bool operator==(const ArcFileStamp& o) const {
+        return size == o.size && writeTime == o.writeTime && fileId == o.fileId && volume == o.volume;
+    }
+    bool operator!=(const ArcFileStamp& o) const { return !(*this == o); }
+};
+
+// Proprietes systeme d'un evenement de l'agent (rendues sans XML)
+struct ArcEventRecord {
+    uint8_t level = 0;      // 1 critique, 2 erreur, 3 avertissement, 4 information
+    uint32_t eventId = 0;
+    int64_t timeUtc = 0;    // Secondes depuis 1970
+};
+
+// Gravite d'un processus surveille absent
+enum class ArcProcessRole {
+    Required,   // Absent = erreur
+    Expected,   // Absent = avertissement
+    Optional    // Absent = information (ex: arcproxy sans proxy configure)
+};
+
+struct ArcWatchedProcess {
+    std::wstring image;         // Nom d'image exact
+    std::wstring component;     // Libelle affiche
+    ArcProcessRole role = ArcProcessRole::Expected;
+    bool hostsHandlers = false; // Ses processus fils sont des gestionnaires d'extensions
+};
+
+// Emplacements de l'agent. Toutes les sondes passent par cette structure:
+// aucun chemin n'est code en dur dans le moteur.
+struct ArcAgentLayout {
+    std::wstring configFile;    // agentconfig.json
+    std::wstring tokensDir;     // metadata.json et jetons
+    std::wstring certsDir;      // Certificats de l'identite managee
+    std::wstring pluginsDir;    // Extensions (Microsoft.Azure.*)
+    std::wstring logDir;        // Journaux himds / azcmagent
+    std::wstring extensionLogDir;   // Journaux des gestionnaires d'extensions
+    std::vector<ArcWatchedProcess> processes;
+};
+
+// ======================== Change Notifications ========================
+// Repertoire surveille; 'tag' est renvoye tel quel par Wait() lorsqu'il change
+struct ArcWatchTarget {
+    std::wstring directory;
+    bool recursive = false;
+    std::wstring mustContain;   // Filtre sur le chemin relatif modifie (vide = tout)
+    uint32_t tag = 0;
+};
+
+constexpr uint32_t kArcWatchStopped = 0x80000000u;
+
+class IArcChangeWatcher {
+public:
+    virtual ~IArcChangeWatcher() = default;
+
+    // Bloque sans consommer de CPU jusqu'a un changement, l'expiration du delai ou Wake().
+    // Renvoie l'union des tags modifies, 0 si delai expire, kArcWatchStopped apres Wake().
+    virtual uint32_t Wait(uint32_t timeoutMs) = 0;
+
+    // Interrompt Wait() definitivement (utilisable depuis un gestionnaire de signal)
+    virtual void Wake() = 0;
+};
+
+// ======================== Mapped Files ========================
+// Projection en lecture seule; la vue reste valide pendant toute la duree de vie de l'objet
+class IArcMappedFile {
+public:
+    virtual ~IArcMappedFile() = default;
+    virtual std::string_view Bytes() const = 0;
+};
+
+// ======================== Network ========================
+// Adresse IPv4 et port, dans l'ordre de l'hote
+struct ArcNetAddress {
+    uint32_t ipv4 = 0;
+    uint16_t port = 0;
+};
+
+enum class ArcNetError { None, Refused, Unreachable, Reset, TimedOut, Other };
+
+struct ArcNetEvent {
+    int socket = -1;
+    bool readable = false;
+    bool writable = false;
+    bool failed = false;        // Erreur ou fermeture signalee par le systeme
+};
+
+constexpr int kArcNetWouldBlock = -2;
+
+// Sockets non bloquants multiplexes sur un seul thread. Les identifiants ne sont pas
+// reutilises pendant la vie de la boucle, sauf par Accept(); tous les sockets sont fermes a
+// sa destruction.
+class IArcNetLoop {
+public:
+    virtual ~IArcNetLoop() = default;
+
+    // -1 en cas d'echec immediat. La connexion TCP se termine en arriere-plan: socket
+    // pret en ecriture, puis SocketError() indique le resultat.
+    virtual int ConnectTcp(const ArcNetAddress& to) = 0;
+    virtual int OpenUdp(const ArcNetAddress& to) = 0;      // Datagrammes vers/depuis 'to' uniquement
+
+    // Socket d'ecoute (-1 si l'adresse est indisponible); pret en lecture: connexion a accepter.
+    // Accept: kArcNetWouldBlock si aucune connexion en attente. Un serveur de longue duree ne
+    // doit pas faire croitre la table: Accept reattribue l'identifiant d'un socket ferme,
+    // a n'appeler qu'une fois traites les evenements deja renvoyes par Wait().
+    virtual int ListenTcp(const ArcNetAddress& at) = 0;
+    virtual int Accept(int listener) = 0;
+
+    // Octets transferes; Send: 0 = tampon plein. Recv: 0 = fermeture par le pair,
+    // kArcNetWouldBlock = rien a lire. -1 = erreur.
+    virtual int Send(int socket, std::string_view data) = 0;
+    virtual int Recv(int socket, char* buffer, size_t size) = 0;
+    virtual ArcNetError SocketError(int socket) = 0;
+    virtual void Close(int socket) = 0;
+
+    // Interet du socket (lecture / ecriture); Wait() ne signale que ceux-ci
+    virtual void Watch(int socket, bool read, bool write) = 0;
+    virtual bool Wait(uint32_t timeoutMs, std::vector<ArcNetEvent>& ready) = 0;
+};
+
+// ======================== Platform Interface ========================
+class IArcPlatform {
+public:
+    virtual ~IArcPlatform() = default;
+
+    virtual const wchar_t* Name() const = 0;
+    virtual wchar_t PathSeparator() const = 0;
+    virtual ArcAgentLayout DefaultLayout() const = 0;
+    virtual std::wstring TempDirectory() const = 0;
+
+    // Instantane de tous les processus
+    virtual bool SnapshotProcesses(std::vector<ArcProcessEntry>& out) = 0;
+    virtual std::wstring GetProcessPath(uint32_t pid) = 0;
+    // Un seul processus, sans enumeration. false si le processus a disparu ou est inaccessible.
+    virtual bool SampleProcess(uint32_t pid, ArcProcessSample& out) = 0;
+
+    // Contenu d'un repertoire (sans "." ni "..")
+    virtual bool ListDirectory(const std::wstring& dir, std::vector<ArcDirEntry>& out) = 0;
+
+    // Lecture sequentielle par blocs de taille fixe (memoire bornee quelle que soit la taille),
+    // a partir de l'octet 'offset'. Le rappel renvoie false pour interrompre la lecture.
+    virtual bool ReadFileChunks(const std::wstring& path, const std::function<bool(std::string_view)>& sink, uint64_t offset = 0) = 0;
+
+    // Taille, date d'ecriture et identifiant sans ouvrir le contenu
+    virtual bool StatFile(const std::wstring& path, ArcFileStamp& out) = 0;
+
+    // nullptr si le fichier est absent, vide ou non projetable
+    virtual std::unique_ptr<IArcMappedFile> MapFile(const std::wstring& path) = 0;
+
+    // Evenements de l'agent (niveaux 1 a 3) dans l'ordre chronologique, a partir du signet
+    // (vide = depuis le debut du canal). bookmark recoit la position du dernier evenement lu.
+    // Signet perime (canal reboucle ou purge): bookmark est vide avant la relecture depuis le debut.
+    // false si le journal n'existe pas sur cette plateforme.
+    virtual bool ReadEvents(std::wstring& bookmark, const std::function<void(const ArcEventRecord&)>& sink) = 0;
+
+    // Abonnement aux modifications des repertoires et, si eventTag != 0, aux nouveaux
+    // evenements de l'agent. Les repertoires absents sont ignores.
+    virtual std::unique_ptr<IArcChangeWatcher> CreateWatcher(const std::vector<ArcWatchTarget>& targets, uint32_t eventTag) = 0;
+
+    // nullptr si la pile reseau est indisponible
+    virtual std::unique_ptr<IArcNetLoop> CreateNetLoop() = 0;
+
+    // Serveurs DNS IPv4 configures (port 53) et fichier hosts du systeme
+    virtual std::vector<ArcNetAddress> DnsServers() = 0;
+    virtual std::wstring HostsFile() const = 0;
+
+    std::wstring Join(const std::wstring& dir, const std::wstring& name) const {
+        if (dir.empty()) return name;
+        wchar_t sep = PathSeparator();
+        if (dir.back() == sep) return dir + name;
+        return dir + sep + name;
+    }
+
+    std::wstring ParentDirectory(const std::wstring& path) const {
+        size_t pos = path.find_last_of(PathSeparator());
+        if (pos == std::wstring::npos) return L"";
+        return path.substr(0, pos == 0 ? 1 : pos);
+    }
+};
+
+// Implementation de la plateforme de compilation (ArcPlatformWin.cpp / ArcPlatformLinux.cpp)
+std::unique_ptr<IArcPlatform> CreateNativePlatform();
@@ -0,0 +1,561 @@
+// ArcPlatformLinux.cpp - Implementation Linux de IArcPlatform
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// /proc pour les processus, opendir/readdir pour les repertoires
+
+#ifdef __linux__
+
+#include <arpa/inet.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+#include "ArcPlatform.h"
+#include "ArcText.h"
+
+// ======================== RAII ========================
+class AutoFd {
+    int fd;
+public:
+    explicit AutoFd(int handle = -1) : fd(handle) {}
+    ~AutoFd() { if (fd >= 0) close(fd); }
+    operator int() const { return fd; }
+    AutoFd(const AutoFd&) = delete;
+    AutoFd& operator=(const AutoFd&) = delete;
+};
+
+class AutoDir {
+    DIR* d;
+public:
+    explicit AutoDir(DIR* dir) : d(dir) {}
+    ~AutoDir() { if (d) closedir(d); }
+    operator DIR*() const { return d; }
+    AutoDir(const AutoDir&) = delete;
+    AutoDir& operator=(const AutoDir&) = delete;
+};
+
+// Lecture d'un petit fichier de /proc (taille inconnue, st_size == 0)
+static bool ReadSmallFile(const std::string& path, std::string& out) {
+    AutoFd fd(open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    if (fd < 0) return false;
+    char buf[4096];
+    out.clear();
+    for (;;) {
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n < 0) return false;
+        if (n == 0) break;
+        out.append(buf, static_cast<size_t>(n));
+    }
+    return true;
+}
+
+// ======================== Mapped File ========================
+class LinuxMappedFile : public IArcMappedFile {
+public:
+    LinuxMappedFile(void* data, size_t size) : data_(data), size_(size) {}
+    ~LinuxMappedFile() override { munmap(data_, size_); }
+    std::string_view Bytes() const override { return std::string_view(static_cast<const char*>(data_), size_); }
+
+    LinuxMappedFile(const LinuxMappedFile&) = delete;
+    LinuxMappedFile& operator=(const LinuxMappedFile&) = delete;
+
+private:
+    void* data_;
+    size_t size_;
+};
+
+// ======================== inotify Watcher ========================
+class LinuxChangeWatcher : public IArcChangeWatcher {
+public:
+    explicit LinuxChangeWatcher(const std::vector<ArcWatchTarget>& targets)
+        : inotify_(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)),
+          wake_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {
+        if (inotify_ < 0 || wake_ < 0) return;
+        for (const auto& t : targets) {
+            Watch w;
+            w.path = ToUtf8(t.directory);
+            w.relative = "";
+            w.mustContain = ToUtf8(t.mustContain);
+            w.tag = t.tag;
+            w.recursive = t.recursive;
+            AddWatch(w, 0);
+        }
+    }
+
+    // false: descripteurs non crees ou limite inotify atteinte (max_user_watches / max_user_instances);
+    // un repertoire cible absent n'est pas une erreur
+    bool ok() const { return inotify_ >= 0 && wake_ >= 0 && !exhausted_; }
+
+    uint32_t Wait(uint32_t timeoutMs) override {
+        pollfd fds[2] = { { wake_, POLLIN, 0 }, { inotify_, POLLIN, 0 } };
+        int r = poll(fds, 2, static_cast<int>(timeoutMs));
+        if (r <= 0) return 0;
+        if (fds[0].revents & POLLIN) return kArcWatchStopped; // eventfd non vide: reste signale
+
+        uint32_t tags = 0;
+        alignas(inotify_event) char buf[16384];
+        for (;;) {
+            ssize_t n = read(inotify_, buf, sizeof(buf));
+            if (n <= 0) break;
+            for (char* p = buf; p < buf + n; ) {
+                const inotify_event* ev = reinterpret_cast<const inotify_event*>(p);
+                p += sizeof(inotify_event) + ev->len;
+
+                if (ev->mask & IN_Q_OVERFLOW) {
+                    for (const auto& kv : watches_) tags |= kv.second.tag;
+                    continue;
+                }
+                auto it = watches_.find(ev->wd);
+                if (it == watches_.end()) continue;
+                Watch w = it->second; // copie: AddWatch peut rehacher la table
+                std::string name = ev->len ? ev->name : "";
+                std::string relative = w.relative.empty() ? name : w.relative + "/" + name;
+
+                if ((ev->mask & IN_ISDIR) && (ev->mask & (IN_CREATE | IN_MOVED_TO)) && w.recursive) {
+                    Watch child = w;
+                    child.path = w.path + "/" + name;
+                    child.relative = relative;
+                    AddWatch(child, Depth(relative));
+                }
+                if (ev->mask & IN_IGNORED) watches_.erase(ev->wd);
+                if (w.mustContain.empty() || ("/" + relative + "/").find(w.mustContain) != std::string::npos) {
+                    tags |= w.tag;
+                }
+            }
+        }
+        return tags;
+    }
+
+    void Wake() override {
+        uint64_t one = 1;
+        ssize_t ignored = write(wake_, &one, sizeof(one));
+        (void)ignored;
+    }
+
+private:
+    struct Watch {
+        std::string path;
+        std::string relative;     // Chemin relatif a la cible
+        std::string mustContain;
+        uint32_t tag = 0;
+        bool recursive = false;
+    };
+
+    static constexpr int kMaxDepth = 3;  // Plugins/<extension>/<version>/status
+
+    static int Depth(const std::string& relative) {
+        int depth = relative.empty() ? 0 : 1;
+        for (char c : relative) depth += (c == '/');
+        return depth;
+    }
+
+    void AddWatch(const Watch& w, int depth) {
+        const uint32_t mask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO
+                            | IN_DELETE_SELF | IN_ONLYDIR;
+        int wd = inotify_add_watch(inotify_, w.path.c_str(), mask);
+        if (wd < 0) {
+            if (errno == ENOSPC || errno == ENOMEM) exhausted_ = true;
+            return;
+        }
+        watches_[wd] = w;
+        if (!w.recursive || depth >= kMaxDepth) return;
+
+        AutoDir d(opendir(w.path.c_str()));
+        if (!d) return;
+        while (dirent* de = readdir(d)) {
+            if (de->d_type != DT_DIR || strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0) continue;
+            Watch child = w;
+            child.path = w.path + "/" + de->d_name;
+            child.relative = w.relative.empty() ? de->d_name : w.relative + "/" + de->d_name;
+            AddWatch(child, depth + 1);
+        }
+    }
+
+    AutoFd inotify_;
+    AutoFd wake_;
+    std::unordered_map<int, Watch> watches_;
+    bool exhausted_ = false;
+};
+
+// ======================== Network Loop ========================
+class LinuxNetLoop : public IArcNetLoop {
+public:
+    ~LinuxNetLoop() override {
+        for (const auto& s : sockets_) if (s.fd >= 0) close(s.fd);
+    }
+
+    int ConnectTcp(const ArcNetAddress& to) override { return Open(SOCK_STREAM, to); }
+    int OpenUdp(const ArcNetAddress& to) override { return Open(SOCK_DGRAM, to); }
+
+    int Send(int socket, std::string_view data) override {
+        ssize_t n = send(sockets_[socket].fd, data.data(), data.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n >= 0) return static_cast<int>(n);
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+    }
+
+    int Recv(int socket, char* buffer, size_t size) override {
+        ssize_t n = recv(sockets_[socket].fd, buffer, size, MSG_DONTWAIT);
+        if (n >= 0) return static_cast<int>(n);
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? kArcNetWouldBlock : -1;
+    }
+
+    ArcNetError SocketError(int socket) override {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        if (getsockopt(sockets_[socket].fd, SOL_SOCKET, SO_ERROR, &err, &len) != 0) err = errno;
+        switch (err) {
+            case 0: return ArcNetError::None;
+            case ECONNREFUSED: return ArcNetError::Refused;
+            case ENETUNREACH: case EHOSTUNREACH: return ArcNetError::Unreachable;
+            case ECONNRESET: return ArcNetError::Reset;
+            case ETIMEDOUT: return ArcNetError::TimedOut;
+            default: return ArcNetError::Other;
+        }
+    }
+
+    int ListenTcp(const ArcNetAddress& at) override {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) return -1;
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));    // Redemarrage sans attendre TIME_WAIT
+        const sockaddr_in addr = SocketAddress(at);
+        if (bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, SOMAXCONN) != 0) {
+            close(fd);
+            return -1;
+        }
+        return Add(fd, false);
+    }
+
+    int Accept(int listener) override {
+        int fd = accept4(sockets_[listener].fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd >= 0) return Add(fd, true);
+        return (errno == EAGAIN || errno == EWOULDBLOCK || errno == ECONNABORTED || errno == EINTR) ? kArcNetWouldBlock : -1;
+    }
+
+    void Close(int socket) override {
+        if (sockets_[socket].fd < 0) return;
+        close(sockets_[socket].fd);
+        sockets_[socket] = Slot();
+        closed_.push_back(socket);
+    }
+
+    void Watch(int socket, bool read, bool write) override {
+        sockets_[socket].events = static_cast<short>((read ? POLLIN : 0) | (write ? POLLOUT : 0));
+    }
+
+    bool Wait(uint32_t timeoutMs, std::vector<ArcNetEvent>& ready) override {
+        ready.clear();
+        polled_.clear();
+        ids_.clear();
+        for (size_t i = 0; i < sockets_.size(); i++) {
+            if (sockets_[i].fd < 0 || !sockets_[i].events) continue;
+            polled_.push_back({ sockets_[i].fd, sockets_[i].events, 0 });
+            ids_.push_back(static_cast<int>(i));
+        }
+        int n = poll(polled_.data(), polled_.size(), static_cast<int>(timeoutMs));
+        if (n < 0) return errno == EINTR;
+        for (size_t i = 0; i < polled_.size() && n > 0; i++) {
+            const short re = polled_[i].revents;
+            if (!re) continue;
+            n--;
+            ArcNetEvent e;
+            e.socket = ids_[i];
+            e.readable = (re & POLLIN) != 0;
+            e.writable = (re & POLLOUT) != 0;
+            e.failed = (re & (POLLERR | POLLHUP | POLLNVAL)) != 0;
+            ready.push_back(e);
+        }
+        return true;
+    }
+
+private:
+    struct Slot {
+        int fd = -1;
+        short events = 0;
+    };
+
+    static sockaddr_in SocketAddress(const ArcNetAddress& at) {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(at.port);
+        addr.sin_addr.s_addr = htonl(at.ipv4);
+        return addr;
+    }
+
+    int Open(int type, const ArcNetAddress& to) {
+        int fd = socket(AF_INET, type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) return -1;
+        const sockaddr_in addr = SocketAddress(to);
+        if (connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 && errno != EINPROGRESS) {
+            close(fd);
+            return -1;
+        }
+        return Add(fd, false);
+    }
+
+    int Add(int fd, bool reuse) {
+        Slot slot;
+        slot.fd = fd;
+        if (reuse && !closed_.empty()) {
+            const int id = closed_.back();
+            closed_.pop_back();
+            sockets_[id] = slot;
+            return id;
+        }
+        sockets_.push_back(slot);
+        return static_cast<int>(sockets_.size() - 1);
+    }
+
+    std::vector<Slot> sockets_;
+    std::vector<int> closed_;       // Identifiants reattribuables par Accept()
+    std::vector<pollfd> polled_;
+    std::vector<int> ids_;
+};
+
+// ======================== Linux Platform ========================
+class LinuxPlatform : public IArcPlatform {
+    static constexpr size_t kChunkSize = 64 * 1024;
+public:
+    const wchar_t* Name() const override { return L"Linux"; }
+    wchar_t PathSeparator() const override { return L'/'; }
+
+    ArcAgentLayout DefaultLayout() const override {
+        ArcAgentLayout layout;
+        layout.configFile = L"/var/opt/azcmagent/agentconfig.json";
+        layout.tokensDir = L"/var/opt/azcmagent/tokens";
+        layout.certsDir = L"/var/opt/azcmagent/certs";
+        layout.pluginsDir = L"/var/lib/waagent";
+        layout.logDir = L"/var/opt/azcmagent/log";
+        layout.extensionLogDir = L"/var/lib/GuestConfig/extension_logs";
+        layout.processes = {
+            { L"himds", L"Service HIMDS", ArcProcessRole::Required, false },
+            { L"azcmagent", L"Agent Azure Arc", ArcProcessRole::Expected, false },
+            { L"gc_linux_service", L"Service Guest Configuration", ArcProcessRole::Expected, false },
+            { L"gc_extension_service", L"Service Extensions", ArcProcessRole::Expected, true },
+            { L"arcproxy", L"Proxy Arc", ArcProcessRole::Optional, false },
+        };
+        return layout;
+    }
+
+    std::wstring TempDirectory() const override {
+        const char* tmp = getenv("TMPDIR");
+        std::string dir = (tmp && *tmp) ? tmp : "/tmp";
+        if (dir.back() != '/') dir += '/';
+        return FromUtf8(dir);
+    }
+
+    // comm est tronque a 15 octets (TASK_COMM_LEN): a cette longueur, nom complet pris dans argv[0]
+    // (cmdline, lisible par tous) ou a defaut dans la cible de exe, s'il prolonge bien comm
+    static std::string FullProcessName(const char* pid, std::string_view comm) {
+        if (comm.size() != 15) return std::string(comm);
+        const std::string base = std::string("/proc/") + pid + "/";
+        auto extends = [comm](std::string_view path) {
+            const size_t slash = path.rfind('/');
+            const std::string_view name = slash == std::string_view::npos ? path : path.substr(slash + 1);
+            return name.size() > comm.size() && name.compare(0, comm.size(), comm) == 0 ? name : std::string_view();
+        };
+        std::string cmdline;
+        if (ReadSmallFile(base + "cmdline", cmdline)) {
+            const std::string_view name = extends(std::string_view(cmdline.c_str()));
+            if (!name.empty()) return std::string(name);
+        }
+        char path[4096];
+        ssize_t n = readlink((base + "exe").c_str(), path, sizeof(path) - 1);
+        if (n > 0) {
+            std::string_view target(path, static_cast<size_t>(n));
+            const std::string_view deleted = " (deleted)";
+            if (target.size() > deleted.size() && target.substr(target.size() - deleted.size()) == deleted) target.remove_suffix(deleted.size());
+            const std::string_view name = extends(target);
+            if (!name.empty()) return std::string(name);
+        }
+        return std::string(comm);
+    }
+
+    bool SnapshotProcesses(std::vector<ArcProcessEntry>& out) override {
+        AutoDir proc(opendir("/proc"));
+        if (!proc) return false;
+
+        std::string stat;
+        while (dirent* de = readdir(proc)) {
+            if (de->d_name[0] < '1' || de->d_name[0] > '9') continue;
+            char* end = nullptr;
+            unsigned long pid = strtoul(de->d_name, &end, 10);
+            if (*end != '\0') continue;
+
+            // /proc/<pid>/stat: "pid (comm) state ppid ..." - comm peut contenir espaces et parentheses
+            if (!ReadSmallFile(std::string("/proc/") + de->d_name + "/stat", stat)) continue;
+            size_t open = stat.find('(');
+            size_t close = stat.rfind(')');
+            if (open == std::string::npos || close == std::string::npos || close < open) continue;
+
+            ArcProcessEntry entry;
+            entry.pid = static_cast<uint32_t>(pid);
+            entry.name = FromUtf8(FullProcessName(de->d_name, std::string_view(stat).substr(open + 1, close - open - 1)));
+            if (close + 4 < stat.size()) {
+                entry.parentPid = static_cast<uint32_t>(strtoul(stat.c_str() + close + 4, nullptr, 10));
+            }
+            out.push_back(std::move(entry));
+        }
+        return true;
+    }
+
+    std::wstring GetProcessPath(uint32_t pid) override {
+        char link[64];
+        snprintf(link, sizeof(link), "/proc/%u/exe", pid);
+        char path[4096];
+        ssize_t n = readlink(link, path, sizeof(path) - 1);
+        if (n <= 0) return L"";
+        return FromUtf8(std::string_view(path, static_cast<size_t>(n)));
+    }
+
+    // stat: temps CPU et date de demarrage (tops d'horloge); status: VmRSS; fd: descripteurs;
+    // io: rchar / wchar (illisible sans droits sur le processus: compteurs a 0)
+    bool SampleProcess(uint32_t pid, ArcProcessSample& out) override {
+        const std::string base = "/proc/" + std::to_string(pid) + "/";
+        std::string text;
+        if (!ReadSmallFile(base + "stat", text)) return false;
+        const size_t close = text.rfind(')');
+        if (close == std::string::npos) return false;
+
+        // Champs apres "(comm)": etat = 3e champ; utime 14, stime 15, starttime 22
+        uint64_t fields[9] = {};     // Champs 14 a 22
+        const char* p = text.c_str() + close + 1;
+        for (int field = 3; field <= 22 && *p; field++) {
+            while (*p == ' ') p++;
+            char* end = nullptr;
+            const unsigned long long v = strtoull(p, &end, 10);
+            if (field >= 14) fields[field - 14] = v;
+            while (*end && *end != ' ') end++;
+            p = end;
+        }
+        static const uint64_t ticks = static_cast<uint64_t>(sysconf(_SC_CLK_TCK));
+        out = ArcProcessSample();
+        out.cpuTimeUs = ticks ? (fields[0] + fields[1]) * 1000000 / ticks : 0;
+        out.startTime = fields[22 - 14];
+
+        if (ReadSmallFile(base + "status", text)) {
+            const size_t rss = text.find("\nVmRSS:");
+            if (rss != std::string::npos) out.workingSet = strtoull(text.c_str() + rss + 7, nullptr, 10) * 1024;
+        }
+        if (ReadSmallFile(base + "io", text)) {
+            const size_t rchar = text.find("rchar:");
+            const size_t wchar = text.find("wchar:");
+            if (rchar != std::string::npos) out.ioReadBytes = strtoull(text.c_str() + rchar + 6, nullptr, 10);
+            if (wchar != std::string::npos) out.ioWriteBytes = strtoull(text.c_str() + wchar + 6, nullptr, 10);
+        }
+        AutoDir fds(opendir((base + "fd").c_str()));
+        if (fds) {
+            while (dirent* de = readdir(fds)) out.handles += de->d_name[0] != '.';
+        }
+        return true;
+    }
+
+    bool ListDirectory(const std::wstring& dir, std::vector<ArcDirEntry>& out) override {
+        std::string base = ToUtf8(dir);
+        AutoDir d(opendir(base.c_str()));
+        if (!d) return false;
+        if (!base.empty() && base.back() != '/') base += '/';
+
+        while (dirent* de = readdir(d)) {
+            if (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0) continue;
+            ArcDirEntry entry;
+            entry.name = FromUtf8(de->d_name);
+
+            struct stat st;
+            if (stat((base + de->d_name).c_str(), &st) == 0) {
+                entry.isDirectory = S_ISDIR(st.st_mode);
+                entry.size = static_cast<uint64_t>(st.st_size);
+            } else {
+                entry.isDirectory = (de->d_type == DT_DIR);
+            }
+            out.push_back(std::move(entry));
+        }
+        return true;
+    }
+
+    bool ReadFileChunks(const std::wstring& path, const std::function<bool(std::string_view)>& sink, uint64_t offset) override {
+        AutoFd fd(open(ToUtf8(path).c_str(), O_RDONLY | O_CLOEXEC));
+        if (fd < 0) return false;
+        if (offset && lseek(fd, static_cast<off_t>(offset), SEEK_SET) < 0) return false;
+        posix_fadvise(fd, static_cast<off_t>(offset), 0, POSIX_FADV_SEQUENTIAL);
+
+        std::vector<char> buf(kChunkSize);
+        for (;;) {
+            ssize_t n = read(fd, buf.data(), buf.size());
+            if (n < 0) return false;
+            if (n == 0 || !sink(std::string_view(buf.data(), static_cast<size_t>(n)))) break;
+        }
+        return true;
+    }
+
+    bool StatFile(const std::wstring& path, ArcFileStamp& out) override {
+        struct stat st;
+        if (stat(ToUtf8(path).c_str(), &st) != 0 || !S_ISREG(st.st_mode)) return false;
+        out.size = static_cast<uint64_t>(st.st_size);
+        out.writeTime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+        out.fileId = static_cast<uint64_t>(st.st_ino);
+        out.volume = static_cast<uint64_t>(st.st_dev);
+        return true;
+    }
+
+    std::unique_ptr<IArcMappedFile> MapFile(const std::wstring& path) override {
+        AutoFd fd(open(ToUtf8(path).c_str(), O_RDONLY | O_CLOEXEC));
+        if (fd < 0) return nullptr;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) return nullptr;
+
+        // La projection survit a la fermeture du descripteur
+        void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) return nullptr;
+        return std::make_unique<LinuxMappedFile>(data, static_cast<size_t>(st.st_size));
+    }
+
+    bool ReadEvents(std::wstring&, const std::function<void(const ArcEventRecord&)>&) override {
+        return false; // Pas de canal Event Log pour l'agent Linux
+    }
+
+    std::unique_ptr<IArcChangeWatcher> CreateWatcher(const std::vector<ArcWatchTarget>& targets, uint32_t) override {
+        auto watcher = std::make_unique<LinuxChangeWatcher>(targets);
+        if (!watcher->ok()) return nullptr;     // ArcMonitor signale l'absence de notification
+        return watcher;
+    }
+
+    std::unique_ptr<IArcNetLoop> CreateNetLoop() override {
+        return std::make_unique<LinuxNetLoop>();
+    }
+
+    std::vector<ArcNetAddress> DnsServers() override {
+        // "nameserver a.b.c.d" (les serveurs IPv6 sont ignores)
+        std::vector<ArcNetAddress> servers;
+        std::ifstream file("/etc/resolv.conf");
+        std::string line;
+        while (std::getline(file, line)) {
+            char host[64];
+            in_addr addr;
+            if (sscanf(line.c_str(), " nameserver %63s", host) == 1 && inet_pton(AF_INET, host, &addr) == 1) {
+                servers.push_back({ ntohl(addr.s_addr), 53 });
+            }
+        }
+        return servers;
+    }
+
+    std::wstring HostsFile() const override { return L"/etc/hosts"; }
+};
+
+std::unique_ptr<IArcPlatform> CreateNativePlatform() {
+    return std::make_unique<LinuxPlatform>();
+}
+
+#endif // __linux__
@@ -0,0 +1,620 @@
+// ArcPlatformWin.cpp - Implementation Windows de IArcPlatform
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Toolhelp32, FindFirstFileW, Event Log (wevtapi)
+
+#ifdef _WIN32
+
+#ifndef UNICODE
+#define UNICODE
+#endif
+#ifndef _UNICODE
+#define _UNICODE
+#endif
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#include <iphlpapi.h>
+#include <psapi.h>
+#include <tlhelp32.h>
+#include <winevt.h>
+#include <memory>
+
+#include "ArcText.h"
+
+#include "ArcPlatform.h"
+
+#pragma comment(lib, "psapi.lib")
+#pragma comment(lib, "wevtapi.lib")
+#pragma comment(lib, "advapi32.lib")
+#pragma comment(lib, "ws2_32.lib")
+#pragma comment(lib, "iphlpapi.lib")
+
+// ======================== RAII AutoHandle ========================
+class AutoHandle {
+    HANDLE h;
+public:
+    explicit AutoHandle(HANDLE handle = INVALID_HANDLE_VALUE) : h(handle) {}
+    ~AutoHandle() { if (h != INVALID_HANDLE_VALUE && h != NULL) CloseHandle(h); }
+    operator HANDLE() const { return h; }
+    HANDLE* operator&() { return &h; }
+    AutoHandle(const AutoHandle&) = delete;
+    AutoHandle& operator=(const AutoHandle&) = delete;
+};
+
+class AutoFindHandle {
+    HANDLE h;
+public:
+    explicit AutoFindHandle(HANDLE handle) : h(handle) {}
+    ~AutoFindHandle() { if (h != INVALID_HANDLE_VALUE) FindClose(h); }
+    operator HANDLE() const { return h; }
+    AutoFindHandle(const AutoFindHandle&) = delete;
+    AutoFindHandle& operator=(const AutoFindHandle&) = delete;
+};
+
+class AutoEvtHandle {
+    EVT_HANDLE h;
+public:
+    explicit AutoEvtHandle(EVT_HANDLE handle = NULL) : h(handle) {}
+    ~AutoEvtHandle() { if (h) EvtClose(h); }
+    operator EVT_HANDLE() const { return h; }
+    AutoEvtHandle(const AutoEvtHandle&) = delete;
+    AutoEvtHandle& operator=(const AutoEvtHandle&) = delete;
+};
+
+// Lot rendu par EvtNext: tous les handles fermes ensemble, apres la mise a jour du signet
+class AutoEvtBatch {
+    EVT_HANDLE* h;
+    DWORD n;
+public:
+    AutoEvtBatch(EVT_HANDLE* handles, DWORD count) : h(handles), n(count) {}
+    ~AutoEvtBatch() { for (DWORD i = 0; i < n; i++) EvtClose(h[i]); }
+    AutoEvtBatch(const AutoEvtBatch&) = delete;
+    AutoEvtBatch& operator=(const AutoEvtBatch&) = delete;
+};
+
+// ======================== Mapped File ========================
+class WindowsMappedFile : public IArcMappedFile {
+public:
+    WindowsMappedFile(const void* view, size_t size) : view_(view), size_(size) {}
+    ~WindowsMappedFile() override { UnmapViewOfFile(view_); }
+    std::string_view Bytes() const override { return std::string_view(static_cast<const char*>(view_), size_); }
+
+    WindowsMappedFile(const WindowsMappedFile&) = delete;
+    WindowsMappedFile& operator=(const WindowsMappedFile&) = delete;
+
+private:
+    const void* view_;
+    size_t size_;
+};
+
+// ======================== Change Watcher ========================
+// ReadDirectoryChangesW en mode overlapped + EvtSubscribe (signal), un seul WaitForMultipleObjects
+class WindowsChangeWatcher : public IArcChangeWatcher {
+public:
+    WindowsChangeWatcher(const std::vector<ArcWatchTarget>& targets, uint32_t eventTag)
+        : stopEvent_(CreateEventW(NULL, TRUE, FALSE, NULL)), eventTag_(eventTag) {
+        for (const auto& t : targets) {
+            if (dirs_.size() + 2 >= MAXIMUM_WAIT_OBJECTS) break;
+            auto w = std::make_unique<DirWatch>();
+            w->target = t;
+            w->dir = CreateFileW(t.directory.c_str(), FILE_LIST_DIRECTORY,
+                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING,
+                FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+            if (w->dir == INVALID_HANDLE_VALUE) continue;
+            w->event = CreateEventW(NULL, TRUE, FALSE, NULL);
+            w->buffer.resize(16384); // DWORD: alignement requis par FILE_NOTIFY_INFORMATION
+            if (Arm(*w)) dirs_.push_back(std::move(w));
+        }
+
+        if (eventTag_) {
+            evtSignal_ = CreateEventW(NULL, TRUE, FALSE, NULL);
+            subscription_ = EvtSubscribe(NULL, evtSignal_, L"Microsoft-AzureArc-Agent/Operational",
+                L"*[System[Provider[@Name='Microsoft-AzureArc-Agent']]]", NULL, NULL, NULL, EvtSubscribeToFutureEvents);
+        }
+    }
+
+    ~WindowsChangeWatcher() override {
+        for (auto& w : dirs_) {
+            CancelIoEx(w->dir, &w->ov);
+            DWORD ignored = 0;
+            GetOverlappedResult(w->dir, &w->ov, &ignored, TRUE);
+            CloseHandle(w->dir);
+            CloseHandle(w->event);
+        }
+        if (subscription_) EvtClose(subscription_);
+        if (evtSignal_) CloseHandle(evtSignal_);
+        if (stopEvent_) CloseHandle(stopEvent_);
+    }
+
+    uint32_t Wait(uint32_t timeoutMs) override {
+        HANDLE handles[MAXIMUM_WAIT_OBJECTS];
+        DWORD count = 0;
+        handles[count++] = stopEvent_;
+        for (auto& w : dirs_) handles[count++] = w->event;
+        if (subscription_) handles[count++] = evtSignal_;
+
+        DWORD r = WaitForMultipleObjects(count, handles, FALSE, timeoutMs);
+        if (r == WAIT_TIMEOUT || r == WAIT_FAILED) return 0;
+        DWORD index = r - WAIT_OBJECT_0;
+        if (index == 0) return kArcWatchStopped;
+
+        if (index <= dirs_.size()) {
+            DirWatch& w = *dirs_[index - 1];
+            DWORD bytes = 0;
+            bool matched = false;
+            if (GetOverlappedResult(w.dir, &w.ov, &bytes, FALSE)) {
+                matched = (bytes == 0) || Matches(w); // 0 octet = debordement du tampon: tout reevaluer
+            }
+            Arm(w);
+            return matched ? w.target.tag : 0;
+        }
+
+        // Nouveaux evenements: rearmer le signal avant de vider l'abonnement, sinon un
+        // evenement arrive entre la fin de la vidange et ResetEvent serait perdu
+        ResetEvent(evtSignal_);
+        EVT_HANDLE events[64];
+        DWORD returned = 0;
+        while (EvtNext(subscription_, 64, events, 0, 0, &returned)) {
+            for (DWORD i = 0; i < returned; i++) EvtClose(events[i]);
+        }
+        return eventTag_;
+    }
+
+    void Wake() override {
+        SetEvent(stopEvent_);
+    }
+
+    bool ok() const { return stopEvent_ != NULL; }
+
+private:
+    struct DirWatch {
+        ArcWatchTarget target;
+        HANDLE dir = INVALID_HANDLE_VALUE;
+        HANDLE event = NULL;
+        OVERLAPPED ov = {};
+        std::vector<DWORD> buffer;
+    };
+
+    static bool Arm(DirWatch& w) {
+        ResetEvent(w.event);
+        ZeroMemory(&w.ov, sizeof(w.ov));
+        w.ov.hEvent = w.event;
+        return ReadDirectoryChangesW(w.dir, w.buffer.data(), static_cast<DWORD>(w.buffer.size() * sizeof(DWORD)),
+            w.target.recursive ? TRUE : FALSE,
+            FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE,
+            NULL, &w.ov, NULL) != FALSE;
+    }
+
+    static bool Matches(const DirWatch& w) {
+        if (w.target.mustContain.empty()) return true;
+        const BYTE* p = reinterpret_cast<const BYTE*>(w.buffer.data());
+        for (;;) {
+            const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(p);
+            std::wstring relative = L"\\" + std::wstring(info->FileName, info->FileNameLength / sizeof(wchar_t)) + L"\\";
+            for (size_t i = 0; i + w.target.mustContain.size() <= relative.size(); i++) {
+                if (EqualsNoCase(std::wstring_view(relative).substr(i, w.target.mustContain.size()), w.target.mustContain)) return true;
+            }
+            if (info->NextEntryOffset == 0) return false;
+            p += info->NextEntryOffset;
+        }
+    }
+
+    HANDLE stopEvent_ = NULL;
+    HANDLE evtSignal_ = NULL;
+    EVT_HANDLE subscription_ = NULL;
+    uint32_t eventTag_ = 0;
+    std::vector<std::unique_ptr<DirWatch>> dirs_;
+};
+
+// ======================== Network Loop ========================
+// WSAPoll: avant Windows 10 2004, un echec de connexion peut n'etre signale qu'a
+// l'expiration du delai de la sonde (pas de POLLERR sur connect refuse).
+class WindowsNetLoop : public IArcNetLoop {
+public:
+    WindowsNetLoop() {
+        WSADATA data;
+        started_ = WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }
+
+    ~WindowsNetLoop() override {
+        for (const auto& s : sockets_) if (s.socket != INVALID_SOCKET) closesocket(s.socket);
+        if (started_) WSACleanup();
+    }
+
+    bool started() const { return started_; }
+
+    int ConnectTcp(const ArcNetAddress& to) override { return Open(SOCK_STREAM, IPPROTO_TCP, to); }
+    int OpenUdp(const ArcNetAddress& to) override { return Open(SOCK_DGRAM, IPPROTO_UDP, to); }
+
+    int Send(int socket, std::string_view data) override {
+        int n = send(sockets_[socket].socket, data.data(), static_cast<int>(data.size()), 0);
+        if (n != SOCKET_ERROR) return n;
+        return WSAGetLastError() == WSAEWOULDBLOCK ? 0 : -1;
+    }
+
+    int Recv(int socket, char* buffer, size_t size) override {
+        int n = recv(sockets_[socket].socket, buffer, static_cast<int>(size), 0);
+        if (n != SOCKET_ERROR) return n;
+        return WSAGetLastError() == WSAEWOULDBLOCK ? kArcNetWouldBlock : -1;
+    }
+
+    ArcNetError SocketError(int socket) override {
+        int err = 0;
+        int len = sizeof(err);
+        if (getsockopt(sockets_[socket].socket, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&err), &len) != 0) err = WSAGetLastError();
+        switch (err) {
+            case 0: return ArcNetError::None;
+            case WSAECONNREFUSED: return ArcNetError::Refused;
+            case WSAENETUNREACH: case WSAEHOSTUNREACH: return ArcNetError::Unreachable;
+            case WSAECONNRESET: return ArcNetError::Reset;
+            case WSAETIMEDOUT: return ArcNetError::TimedOut;
+            default: return ArcNetError::Other;
+        }
+    }
+
+    int ListenTcp(const ArcNetAddress& at) override {
+        SOCKET s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (s == INVALID_SOCKET) return -1;
+        BOOL exclusive = TRUE;      // Aucun autre processus ne peut detourner le port
+        setsockopt(s, SOL_SOCKET, SO_EXCLUSIVEADDRUSE, reinterpret_cast<const char*>(&exclusive), sizeof(exclusive));
+        u_long nonBlocking = 1;
+        const sockaddr_in addr = SocketAddress(at);
+        if (ioctlsocket(s, FIONBIO, &nonBlocking) != 0 || bind(s, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0
+            || listen(s, SOMAXCONN) != 0) {
+            closesocket(s);
+            return -1;
+        }
+        return Add(s, false);
+    }
+
+    // Le socket accepte herite du mode non bloquant du socket d'ecoute
+    int Accept(int listener) override {
+        SOCKET s = accept(sockets_[listener].socket, nullptr, nullptr);
+        if (s != INVALID_SOCKET) return Add(s, true);
+        const int err = WSAGetLastError();
+        return (err == WSAEWOULDBLOCK || err == WSAECONNRESET) ? kArcNetWouldBlock : -1;
+    }
+
+    void Close(int socket) override {
+        if (sockets_[socket].socket == INVALID_SOCKET) return;
+        closesocket(sockets_[socket].socket);
+        sockets_[socket] = Slot();
+        closed_.push_back(socket);
+    }
+
+    void Watch(int socket, bool read, bool write) override {
+        sockets_[socket].events = static_cast<SHORT>((read ? POLLRDNORM : 0) | (write ? POLLWRNORM : 0));
+    }
+
+    bool Wait(uint32_t timeoutMs, std::vector<ArcNetEvent>& ready) override {
+        ready.clear();
+        polled_.clear();
+        ids_.clear();
+        for (size_t i = 0; i < sockets_.size(); i++) {
+            if (sockets_[i].socket == INVALID_SOCKET || !sockets_[i].events) continue;
+            WSAPOLLFD p = {};
+            p.fd = sockets_[i].socket;
+            p.events = sockets_[i].events;
+            polled_.push_back(p);
+            ids_.push_back(static_cast<int>(i));
+        }
+        if (polled_.empty()) {
+            Sleep(timeoutMs);
+            return true;
+        }
+        int n = WSAPoll(polled_.data(), static_cast<ULONG>(polled_.size()), static_cast<INT>(timeoutMs));
+        if (n == SOCKET_ERROR) return false;
+        for (size_t i = 0; i < polled_.size() && n > 0; i++) {
+            const SHORT re = polled_[i].revents;
+            if (!re) continue;
+            n--;
+            ArcNetEvent e;
+            e.socket = ids_[i];
+            e.readable = (re & POLLRDNORM) != 0;
+            e.writable = (re & POLLWRNORM) != 0;
+            e.failed = (re & (POLLERR | POLLHUP | POLLNVAL)) != 0;
+            ready.push_back(e);
+        }
+        return true;
+    }
+
+private:
+    struct Slot {
+        SOCKET socket = INVALID_SOCKET;
+        SHORT events = 0;
+    };
+
+    static sockaddr_in SocketAddress(const ArcNetAddress& at) {
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(at.port);
+        addr.sin_addr.s_addr = htonl(at.ipv4);
+        return addr;
+    }
+
+    int Open(int type, int protocol, const ArcNetAddress& to) {
+        SOCKET s = socket(AF_INET, type, protocol);
+        if (s == INVALID_SOCKET) return -1;
+        u_long nonBlocking = 1;
+        const sockaddr_in addr = SocketAddress(to);
+        if (ioctlsocket(s, FIONBIO, &nonBlocking) != 0
+            || (connect(s, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 && WSAGetLastError() != WSAEWOULDBLOCK)) {
+            closesocket(s);
+            return -1;
+        }
+        return Add(s, false);
+    }
+
+    int Add(SOCKET s, bool reuse) {
+        Slot slot;
+        slot.socket = s;
+        if (reuse && !closed_.empty()) {
+            const int id = closed_.back();
+            closed_.pop_back();
+            sockets_[id] = slot;
+            return id;
+        }
+        sockets_.push_back(slot);
+        return static_cast<int>(sockets_.size() - 1);
+    }
+
+    bool started_ = false;
+    std::vector<Slot> sockets_;
+    std::vector<int> closed_;       // Identifiants reattribuables par Accept()
+    std::vector<WSAPOLLFD> polled_;
+    std::vector<int> ids_;
+};
+
+// ======================== Windows Platform ========================
+class WindowsPlatform : public IArcPlatform {
+    static constexpr size_t kChunkSize = 64 * 1024;
+    static constexpr DWORD kEventBatch = 512;
+public:
+    const wchar_t* Name() const override { return L"Windows"; }
+    wchar_t PathSeparator() const override { return L'\\'; }
+
+    ArcAgentLayout DefaultLayout() const override {
+        ArcAgentLayout layout;
+        layout.configFile = L"C:\\ProgramData\\AzureConnectedMachineAgent\\Config\\agentconfig.json";
+        layout.tokensDir = L"C:\\ProgramData\\AzureConnectedMachineAgent\\Tokens";
+        layout.certsDir = L"C:\\ProgramData\\AzureConnectedMachineAgent\\Certs";
+        layout.pluginsDir = L"C:\\Packages\\Plugins";
+        layout.logDir = L"C:\\ProgramData\\AzureConnectedMachineAgent\\Log";
+        layout.extensionLogDir = L"C:\\ProgramData\\GuestConfig\\extension_logs";
+        layout.processes = {
+            { L"himds.exe", L"Service HIMDS", ArcProcessRole::Required, false },
+            { L"azcmagent.exe", L"Agent Azure Arc", ArcProcessRole::Expected, false },
+            { L"gc_arc_service.exe", L"Service Guest Configuration", ArcProcessRole::Expected, false },
+            { L"gc_extension_service.exe", L"Service Extensions", ArcProcessRole::Expected, true },
+            { L"arcproxy.exe", L"Proxy Arc", ArcProcessRole::Optional, false },
+        };
+        return layout;
+    }
+
+    std::wstring TempDirectory() const override {
+        wchar_t tempPath[MAX_PATH];
+        DWORD len = GetTempPathW(MAX_PATH, tempPath);
+        if (len == 0 || len > MAX_PATH) return L".\\";
+        return tempPath;
+    }
+
+    bool SnapshotProcesses(std::vector<ArcProcessEntry>& out) override {
+        AutoHandle snap(CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0));
+        if (snap == INVALID_HANDLE_VALUE) return false;
+
+        PROCESSENTRY32W pe32;
+        pe32.dwSize = sizeof(pe32);
+
+        if (Process32FirstW(snap, &pe32)) {
+            do {
+                ArcProcessEntry entry;
+                entry.pid = pe32.th32ProcessID;
+                entry.parentPid = pe32.th32ParentProcessID;
+                entry.name = pe32.szExeFile;
+                out.push_back(std::move(entry));
+            } while (Process32NextW(snap, &pe32));
+        }
+        return true;
+    }
+
+    std::wstring GetProcessPath(uint32_t pid) override {
+        AutoHandle hProc(OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid));
+        if (hProc == NULL) return L"";
+
+        wchar_t path[MAX_PATH];
+        DWORD size = MAX_PATH;
+        if (QueryFullProcessImageNameW(hProc, 0, path, &size)) {
+            return path;
+        }
+        return L"";
+    }
+
+    // Acces limite suffisant pour les quatre compteurs (services proteges compris)
+    bool SampleProcess(uint32_t pid, ArcProcessSample& out) override {
+        AutoHandle hProc(OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid));
+        if (hProc == NULL) return false;
+
+        FILETIME created, exited, kernel, user;
+        if (!GetProcessTimes(hProc, &created, &exited, &kernel, &user)) return false;
+        auto ticks = [](const FILETIME& ft) { return (static_cast<uint64_t>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime; };
+        out = ArcProcessSample();
+        out.cpuTimeUs = (ticks(kernel) + ticks(user)) / 10;
+        out.startTime = ticks(created);
+
+        PROCESS_MEMORY_COUNTERS memory{};
+        memory.cb = sizeof(memory);
+        if (GetProcessMemoryInfo(hProc, &memory, sizeof(memory))) out.workingSet = memory.WorkingSetSize;
+        DWORD handles = 0;
+        if (GetProcessHandleCount(hProc, &handles)) out.handles = handles;
+        IO_COUNTERS io{};
+        if (GetProcessIoCounters(hProc, &io)) {
+            out.ioReadBytes = io.ReadTransferCount;
+            out.ioWriteBytes = io.WriteTransferCount;
+        }
+        return true;
+    }
+
+    bool ListDirectory(const std::wstring& dir, std::vector<ArcDirEntry>& out) override {
+        WIN32_FIND_DATAW findData;
+        AutoFindHandle hFind(FindFirstFileW(Join(dir, L"*").c_str(), &findData));
+        if (hFind == INVALID_HANDLE_VALUE) return false;
+
+        do {
+            if (wcscmp(findData.cFileName, L".") == 0 || wcscmp(findData.cFileName, L"..") == 0) continue;
+            ArcDirEntry entry;
+            entry.name = findData.cFileName;
+            entry.isDirectory = (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+            entry.size = (static_cast<uint64_t>(findData.nFileSizeHigh) << 32) | findData.nFileSizeLow;
+            out.push_back(std::move(entry));
+        } while (FindNextFileW(hFind, &findData));
+        return true;
+    }
+
+    bool ReadFileChunks(const std::wstring& path, const std::function<bool(std::string_view)>& sink, uint64_t offset) override {
+        AutoHandle hFile(CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL));
+        if (hFile == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER start;
+        start.QuadPart = static_cast<LONGLONG>(offset);
+        if (offset && !SetFilePointerEx(hFile, start, NULL, FILE_BEGIN)) return false;
+
+        std::vector<char> buf(kChunkSize);
+        for (;;) {
+            DWORD read = 0;
+            if (!ReadFile(hFile, buf.data(), static_cast<DWORD>(buf.size()), &read, NULL)) return false;
+            if (read == 0 || !sink(std::string_view(buf.data(), read))) break;
+        }
+        return true;
+    }
+
+    bool StatFile(const std::wstring& path, ArcFileStamp& out) override {
+        // FILE_READ_ATTRIBUTES: n'entre pas en conflit avec un ecrivain, meme sans partage
+        AutoHandle hFile(CreateFileW(path.c_str(), FILE_READ_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            NULL, OPEN_EXISTING, 0, NULL));
+        if (hFile == INVALID_HANDLE_VALUE) return false;
+
+        BY_HANDLE_FILE_INFORMATION info;
+        if (!GetFileInformationByHandle(hFile, &info) || (info.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) return false;
+        out.size = (static_cast<uint64_t>(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+        out.writeTime = static_cast<int64_t>((static_cast<uint64_t>(info.ftLastWriteTime.dwHighDateTime) << 32) | info.ftLastWriteTime.dwLowDateTime);
+        out.fileId = (static_cast<uint64_t>(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+        out.volume = info.dwVolumeSerialNumber;
+        return true;
+    }
+
+    std::unique_ptr<IArcMappedFile> MapFile(const std::wstring& path) override {
+        AutoHandle hFile(CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL));
+        if (hFile == INVALID_HANDLE_VALUE) return nullptr;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(hFile, &size) || size.QuadPart <= 0 || static_cast<uint64_t>(size.QuadPart) > SIZE_MAX) return nullptr;
+
+        // La vue garde une reference sur la section: les deux handles peuvent etre fermes
+        AutoHandle hMapping(CreateFileMappingW(hFile, NULL, PAGE_READONLY, 0, 0, NULL));
+        if (hMapping == NULL) return nullptr;
+        const void* view = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+        if (!view) return nullptr;
+        return std::make_unique<WindowsMappedFile>(view, static_cast<size_t>(size.QuadPart));
+    }
+
+    bool ReadEvents(std::wstring& bookmark, const std::function<void(const ArcEventRecord&)>& sink) override {
+        const wchar_t* channelPath = L"Microsoft-AzureArc-Agent/Operational";
+        const wchar_t* query = L"*[System[Provider[@Name='Microsoft-AzureArc-Agent'] and (Level=1 or Level=2 or Level=3)]]";
+
+        AutoEvtHandle hResults(EvtQuery(NULL, channelPath, query, EvtQueryChannelPath | EvtQueryForwardDirection));
+        if (!hResults) return false;
+
+        AutoEvtHandle hBookmark(EvtCreateBookmark(bookmark.empty() ? NULL : bookmark.c_str()));
+        if (!hBookmark) return false;
+        // Signet perime (canal reboucle, purge ou recree): EvtSeek echoue et la lecture repart du
+        // debut; le signet vide le signale a l'appelant, qui ecarte les evenements deja comptes
+        if (!bookmark.empty() && !EvtSeek(hResults, 1, hBookmark, 0, EvtSeekRelativeToBookmark | EvtSeekStrict)) bookmark.clear();
+
+        // Proprietes systeme uniquement: niveau, ID et date lus directement dans des EVT_VARIANT
+        AutoEvtHandle hContext(EvtCreateRenderContext(0, NULL, EvtRenderContextSystem));
+        if (!hContext) return false;
+
+        std::vector<BYTE> values(4096);
+        EVT_HANDLE batch[kEventBatch];
+        DWORD returned = 0;
+        bool advanced = false;
+
+        while (EvtNext(hResults, kEventBatch, batch, INFINITE, 0, &returned)) {
+            AutoEvtBatch events(batch, returned);
+            for (DWORD i = 0; i < returned; i++) {
+                const EVT_HANDLE hEvent = batch[i];
+                DWORD used = 0, count = 0;
+                if (!EvtRender(hContext, hEvent, EvtRenderEventValues, static_cast<DWORD>(values.size()), values.data(), &used, &count)) {
+                    if (GetLastError() != ERROR_INSUFFICIENT_BUFFER) continue;
+                    values.resize(used);
+                    if (!EvtRender(hContext, hEvent, EvtRenderEventValues, static_cast<DWORD>(values.size()), values.data(), &used, &count)) continue;
+                }
+
+                const EVT_VARIANT* v = reinterpret_cast<const EVT_VARIANT*>(values.data());
+                ArcEventRecord record;
+                if (v[EvtSystemLevel].Type == EvtVarTypeByte) record.level = v[EvtSystemLevel].ByteVal;
+                if (v[EvtSystemEventID].Type == EvtVarTypeUInt16) record.eventId = v[EvtSystemEventID].UInt16Val;
+                if (v[EvtSystemTimeCreated].Type == EvtVarTypeFileTime) {
+                    // FILETIME (100 ns depuis 1601) -> secondes depuis 1970
+                    record.timeUtc = static_cast<int64_t>((v[EvtSystemTimeCreated].FileTimeVal - 116444736000000000ULL) / 10000000ULL);
+                }
+                sink(record);
+            }
+            // Signet sur le dernier evenement du lot, rendu ou non: sinon la passe suivante
+            // relirait la fin du lot et compterait deux fois les evenements deja remis
+            if (returned && EvtUpdateBookmark(hBookmark, batch[returned - 1])) advanced = true;
+        }
+
+        if (advanced) {
+            DWORD used = 0, count = 0;
+            if (!EvtRender(NULL, hBookmark, EvtRenderBookmark, 0, NULL, &used, &count) && GetLastError() == ERROR_INSUFFICIENT_BUFFER) {
+                std::vector<wchar_t> xml(used / sizeof(wchar_t) + 1);
+                if (EvtRender(NULL, hBookmark, EvtRenderBookmark, used, xml.data(), &used, &count)) bookmark.assign(xml.data());
+            }
+        }
+        return true;
+    }
+
+    std::unique_ptr<IArcChangeWatcher> CreateWatcher(const std::vector<ArcWatchTarget>& targets, uint32_t eventTag) override {
+        auto watcher = std::make_unique<WindowsChangeWatcher>(targets, eventTag);
+        if (!watcher->ok()) return nullptr;
+        return watcher;
+    }
+
+    std::unique_ptr<IArcNetLoop> CreateNetLoop() override {
+        auto loop = std::make_unique<WindowsNetLoop>();
+        if (!loop->started()) return nullptr;
+        return loop;
+    }
+
+    std::vector<ArcNetAddress> DnsServers() override {
+        std::vector<ArcNetAddress> servers;
+        ULONG size = 0;
+        if (GetNetworkParams(NULL, &size) != ERROR_BUFFER_OVERFLOW) return servers;
+        std::vector<BYTE> buffer(size);
+        FIXED_INFO* info = reinterpret_cast<FIXED_INFO*>(buffer.data());
+        if (GetNetworkParams(info, &size) != ERROR_SUCCESS) return servers;
+        for (const IP_ADDR_STRING* a = &info->DnsServerList; a; a = a->Next) {
+            IN_ADDR addr;
+            if (inet_pton(AF_INET, a->IpAddress.String, &addr) == 1) servers.push_back({ ntohl(addr.s_addr), 53 });
+        }
+        return servers;
+    }
+
+    std::wstring HostsFile() const override {
+        wchar_t system[MAX_PATH];
+        UINT n = GetSystemDirectoryW(system, MAX_PATH);
+        if (n == 0 || n >= MAX_PATH) return L"C:\\Windows\\System32\\drivers\\etc\\hosts";
+        return std::wstring(system, n) + L"\\drivers\\etc\\hosts";
+    }
+};
+
+std::unique_ptr<IArcPlatform> CreateNativePlatform() {
+    return std::make_unique<WindowsPlatform>();
+}
+
+#endif // _WIN32
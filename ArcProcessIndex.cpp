@@ -0,0 +1,65 @@
+// ArcProcessIndex.cpp - Index des processus construit une fois par passe
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#include "ArcProcessIndex.h"
+
+#include <algorithm>
+
+#include "ArcText.h"
+
+std::wstring ArcProcessIndex::Fold(const std::wstring& name) {
+    std::wstring folded(name);
+    for (wchar_t& c : folded) c = FoldAscii(c);
+    return folded;
+}
+
+bool ArcProcessIndex::Build(IArcPlatform& platform) {
+    std::vector<ArcProcessEntry> entries;
+    const bool valid = platform.SnapshotProcesses(entries);
+    Build(std::move(entries));
+    valid_ = valid;
+    return valid_;
+}
+
+void ArcProcessIndex::Build(std::vector<ArcProcessEntry> entries) {
+    entries_ = std::move(entries);
+    byPid_.clear();
+    byName_.clear();
+    children_.clear();
+
+    valid_ = true;
+    byPid_.reserve(entries_.size());
+    byName_.reserve(entries_.size());
+
+    for (size_t i = 0; i < entries_.size(); i++) {
+        const ArcProcessEntry& e = entries_[i];
+        byPid_[e.pid] = i;
+        byName_[Fold(e.name)].push_back(e.pid);
+        if (e.parentPid != e.pid) children_[e.parentPid].push_back(e.pid);
+    }
+    for (auto& kv : byName_) std::sort(kv.second.begin(), kv.second.end());
+}
+
+const std::vector<uint32_t>& ArcProcessIndex::Find(const std::wstring& imageName) const {
+    static const std::vector<uint32_t> empty;
+    const std::wstring folded = Fold(imageName);
+    auto it = byName_.find(folded);
+    if (it == byName_.end() && folded.size() > kCommLength) it = byName_.find(folded.substr(0, kCommLength));
+    return it == byName_.end() ? empty : it->second;
+}
+
+const ArcProcessEntry* ArcProcessIndex::Get(uint32_t pid) const {
+    auto it = byPid_.find(pid);
+    return it == byPid_.end() ? nullptr : &entries_[it->second];
+}
+
+uint32_t ArcProcessIndex::ParentOf(uint32_t pid) const {
+    const ArcProcessEntry* e = Get(pid);
+    return e ? e->parentPid : 0;
+}
+
+const std::vector<uint32_t>& ArcProcessIndex::ChildrenOf(uint32_t pid) const {
+    static const std::vector<uint32_t> empty;
+    auto it = children_.find(pid);
+    return it == children_.end() ? empty : it->second;
+}
@@ -0,0 +1,44 @@
+// ArcProcessIndex.h - Index des processus construit une fois par passe
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Une seule enumeration systeme, puis recherche O(1) par nom d'image (insensible a la casse)
+// Linux: le champ comm de /proc/<pid>/stat est tronque a 15 caracteres (TASK_COMM_LEN). La
+// plateforme restitue le nom complet quand elle le peut; sinon Find retombe sur le prefixe.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ArcPlatform.h"
+
+class ArcProcessIndex {
+public:
+    // Remplace le contenu par un nouvel instantane. false si l'enumeration a echoue.
+    bool Build(IArcPlatform& platform);
+    // Instantane deja releve (banc, instantane rejoue)
+    void Build(std::vector<ArcProcessEntry> entries);
+
+    // Toutes les instances d'une image, triees par PID (vide si absente). Un nom d'image de
+    // plus de 15 caracteres absent de l'index est recherche sous sa forme tronquee (comm).
+    const std::vector<uint32_t>& Find(const std::wstring& imageName) const;
+
+    const ArcProcessEntry* Get(uint32_t pid) const;
+    uint32_t ParentOf(uint32_t pid) const;
+    const std::vector<uint32_t>& ChildrenOf(uint32_t pid) const;
+
+    size_t size() const { return entries_.size(); }
+    bool valid() const { return valid_; }
+
+    static constexpr size_t kCommLength = 15;
+
+private:
+    static std::wstring Fold(const std::wstring& name);
+
+    std::vector<ArcProcessEntry> entries_;
+    std::unordered_map<uint32_t, size_t> byPid_;
+    std::unordered_map<std::wstring, std::vector<uint32_t>> byName_;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> children_;
+    bool valid_ = false;
+};
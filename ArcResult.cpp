@@ -0,0 +1,137 @@
+// ArcResult.cpp - Lignes de resultat compactes
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#include "ArcResult.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "ArcText.h"
+
+// ======================== Interned Strings ========================
+// Blocs de taille fixe jamais deplaces: la lecture par identifiant se fait sans verrou
+namespace {
+
+class InternTable {
+public:
+    static constexpr size_t kBlockSize = 4096;
+    static constexpr size_t kMaxBlocks = 4096;
+
+    InternTable() {
+        for (auto& b : blocks_) b.store(nullptr, std::memory_order_relaxed);
+        Insert(std::wstring_view());   // Identifiant 0 = chaine vide
+    }
+
+    ArcStr Intern(std::wstring_view text) {
+        if (text.empty()) return 0;
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = ids_.find(text);
+        if (it != ids_.end()) return it->second;
+        return Insert(text);
+    }
+
+    const std::wstring& Text(ArcStr id) const {
+        const std::wstring* block = blocks_[id / kBlockSize].load(std::memory_order_acquire);
+        return block[id % kBlockSize];
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return count_;
+    }
+
+private:
+    ArcStr Insert(std::wstring_view text) {
+        size_t id = count_;
+        if (id / kBlockSize >= kMaxBlocks) return 0;   // Table pleine: texte perdu plutot que corruption
+        if (id % kBlockSize == 0) owned_.emplace_back(new std::wstring[kBlockSize]);
+        std::wstring* block = owned_.back().get();
+        block[id % kBlockSize].assign(text);
+        blocks_[id / kBlockSize].store(block, std::memory_order_release);
+        ids_.emplace(block[id % kBlockSize], static_cast<ArcStr>(id));
+        count_++;
+        return static_cast<ArcStr>(id);
+    }
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::wstring_view, ArcStr> ids_;   // Vues sur les chaines stockees dans les blocs
+    std::atomic<const std::wstring*> blocks_[kMaxBlocks];
+    std::vector<std::unique_ptr<std::wstring[]>> owned_;
+    size_t count_ = 0;
+};
+
+InternTable& Table() {
+    static InternTable table;
+    return table;
+}
+
+}
+
+ArcStr ArcIntern(std::wstring_view text) {
+    return Table().Intern(text);
+}
+
+const std::wstring& ArcStrText(ArcStr id) {
+    return Table().Text(id);
+}
+
+size_t ArcInternedCount() {
+    return Table().size();
+}
+
+// ======================== Result Rows ========================
+ArcComponentInfo& ArcComponentList::Add(std::wstring_view component, std::wstring_view status, StatusLevel level) {
+    ArcComponentInfo& row = rows_.emplace_back();
+    row.component = ArcIntern(component);
+    row.status = ArcIntern(status);
+    row.level = level;
+    return row;
+}
+
+ArcTextRef ArcComponentList::Store(std::wstring_view text) {
+    if (text.empty()) return ArcTextRef();
+    ArcTextRef ref;
+    ref.offset = static_cast<uint32_t>(arena_.size());
+    ref.length = static_cast<uint32_t>(text.size());
+    arena_.append(text);
+    arena_.push_back(L'\0');
+    return ref;
+}
+
+void ArcComponentList::Append(const ArcComponentList& other) {
+    rows_.reserve(rows_.size() + other.rows_.size());
+    const uint32_t base = static_cast<uint32_t>(arena_.size()) - 1;   // L'\0' initial de l'autre arene non recopie
+    arena_.append(other.arena_, 1, std::wstring::npos);
+    for (ArcComponentInfo row : other.rows_) {
+        if (row.details.length) row.details.offset += base;
+        if (row.alerts.length) row.alerts.offset += base;
+        rows_.push_back(row);
+    }
+}
+
+const wchar_t* StatusLevelName(StatusLevel level) {
+    switch (level) {
+        case StatusLevel::OK: return L"OK";
+        case StatusLevel::WARNING: return L"AVERTISSEMENT";
+        default: return L"ERREUR";
+    }
+}
+
+bool ParseStatusLevel(std::wstring_view name, StatusLevel& level) {
+    if (EqualsNoCase(name, L"erreur") || EqualsNoCase(name, L"error")) level = StatusLevel::ERROR_LEVEL;
+    else if (EqualsNoCase(name, L"avertissement") || EqualsNoCase(name, L"warning")) level = StatusLevel::WARNING;
+    else if (EqualsNoCase(name, L"info") || EqualsNoCase(name, L"ok")) level = StatusLevel::OK;
+    else return false;
+    return true;
+}
+
+StatusLevel WorstLevel(const ArcComponentList& list) {
+    StatusLevel worst = StatusLevel::OK;
+    for (const auto& row : list) {
+        if (row.level == StatusLevel::ERROR_LEVEL) return StatusLevel::ERROR_LEVEL;
+        if (row.level == StatusLevel::WARNING) worst = StatusLevel::WARNING;
+    }
+    return worst;
+}
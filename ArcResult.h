@@ -0,0 +1,82 @@
+// ArcResult.h - Lignes de resultat compactes
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Composant, etat et version appartiennent a un vocabulaire limite: ils sont internes
+// une fois pour tout le processus et codes sur 32 bits. Details et alertes (texte libre)
+// sont places dans une arene unique par liste. Une ligne occupe 48 octets, sans allocation.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class StatusLevel { OK, WARNING, ERROR_LEVEL };
+
+// ======================== Interned Strings ========================
+using ArcStr = uint32_t;        // 0 = chaine vide
+
+// Thread-safe; les references renvoyees restent valides jusqu'a la fin du programme
+ArcStr ArcIntern(std::wstring_view text);
+const std::wstring& ArcStrText(ArcStr id);
+size_t ArcInternedCount();
+
+// ======================== Result Rows ========================
+struct ArcTextRef {
+    uint32_t offset = 0;        // Dans l'arene de la liste proprietaire (texte termine par L'\0')
+    uint32_t length = 0;
+};
+
+struct ArcComponentInfo {
+    ArcStr component = 0;
+    ArcStr status = 0;
+    ArcStr version = 0;         // Version ou chemin de l'executable
+    StatusLevel level = StatusLevel::OK;
+    int64_t expiresUtc = 0;     // Secondes depuis 1970; 0 = pas d'expiration connue
+    int64_t value = 0;          // Mesure propre a la sonde (code d'extension, lignes, evenements sur 24 h, ms, instances)
+    int64_t subcode = 0;        // Code secondaire (extension: premier code de sous-statut non nul)
+    ArcTextRef details;
+    ArcTextRef alerts;
+};
+
+class ArcComponentList {
+public:
+    // Construction en place. La reference est invalidee par l'ajout suivant.
+    ArcComponentInfo& Add(std::wstring_view component, std::wstring_view status, StatusLevel level);
+    void SetDetails(ArcComponentInfo& row, std::wstring_view text) { row.details = Store(text); }
+    void SetAlerts(ArcComponentInfo& row, std::wstring_view text) { row.alerts = Store(text); }
+
+    std::wstring_view Details(const ArcComponentInfo& row) const { return View(row.details); }
+    std::wstring_view Alerts(const ArcComponentInfo& row) const { return View(row.alerts); }
+    const wchar_t* DetailsCStr(const ArcComponentInfo& row) const { return arena_.c_str() + row.details.offset; }
+    const wchar_t* AlertsCStr(const ArcComponentInfo& row) const { return arena_.c_str() + row.alerts.offset; }
+
+    // Copie les lignes d'une autre liste (texte recopie dans cette arene)
+    void Append(const ArcComponentList& other);
+
+    size_t size() const { return rows_.size(); }
+    bool empty() const { return rows_.empty(); }
+    void clear() { rows_.clear(); arena_.assign(1, L'\0'); }
+    void reserve(size_t rows) { rows_.reserve(rows); }
+    size_t ArenaBytes() const { return arena_.capacity() * sizeof(wchar_t); }
+
+    const ArcComponentInfo& operator[](size_t i) const { return rows_[i]; }
+    ArcComponentInfo& operator[](size_t i) { return rows_[i]; }
+    std::vector<ArcComponentInfo>::const_iterator begin() const { return rows_.begin(); }
+    std::vector<ArcComponentInfo>::const_iterator end() const { return rows_.end(); }
+
+private:
+    ArcTextRef Store(std::wstring_view text);
+    std::wstring_view View(ArcTextRef ref) const { return std::wstring_view(arena_).substr(ref.offset, ref.length); }
+
+    std::vector<ArcComponentInfo> rows_;
+    std::wstring arena_ = std::wstring(1, L'\0');   // Offset 0 = chaine vide
+};
+
+const wchar_t* StatusLevelName(StatusLevel level);
+
+// "erreur" / "error", "avertissement" / "warning", "ok" / "info" (insensible a la casse)
+bool ParseStatusLevel(std::wstring_view name, StatusLevel& level);
+
+// Pire niveau d'une liste (0 OK, 1 avertissement, 2 erreur)
+StatusLevel WorstLevel(const ArcComponentList& list);
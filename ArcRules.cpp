@@ -0,0 +1,302 @@
+// ArcRules.cpp - Regles de sante declaratives appliquees aux resultats des sondes
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#include "ArcRules.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+#include "ArcFile.h"
+#include "ArcText.h"
+
+static constexpr uint8_t kLess = 1;
+static constexpr uint8_t kEqual = 2;
+static constexpr uint8_t kGreater = 4;
+static constexpr uint32_t kNoRule = 0xFFFFFFFFu;
+
+// ======================== Parsing ========================
+static std::string_view Trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+    return s;
+}
+
+static std::string_view Unquote(std::string_view s) {
+    if (s.size() >= 2 && s.front() == '"' && s.back() == '"') return s.substr(1, s.size() - 2);
+    return s;
+}
+
+// Position du prochain '&' hors guillemets (npos si aucun); false si un guillemet n'est pas ferme
+static bool FindConjunction(std::string_view condition, size_t& at) {
+    bool quoted = false;
+    for (size_t i = 0; i < condition.size(); i++) {
+        if (condition[i] == '"') quoted = !quoted;
+        else if (condition[i] == '&' && !quoted) {
+            at = i;
+            return true;
+        }
+    }
+    at = std::string_view::npos;
+    return !quoted;
+}
+
+// Nombre decimal, suffixe de duree facultatif (s, m, h, d / j) converti en secondes
+static bool ParseNumber(std::string_view text, bool duration, int64_t& out) {
+    const std::string buffer(text);
+    char* end = nullptr;
+    const double number = strtod(buffer.c_str(), &end);
+    if (end == buffer.c_str()) return false;
+    std::string_view suffix = Trim(std::string_view(end));
+    double scale = 1.0;
+    if (!suffix.empty()) {
+        if (!duration || suffix.size() != 1) return false;
+        switch (suffix[0]) {
+            case 's': break;
+            case 'm': scale = 60.0; break;
+            case 'h': scale = 3600.0; break;
+            case 'd': case 'j': scale = 86400.0; break;
+            default: return false;
+        }
+    }
+    // nan / inf (acceptes par strtod) et valeurs hors de la plage des colonnes refuses
+    const double value = number * scale;
+    if (!std::isfinite(value) || std::fabs(value) >= 9.2e18) return false;
+    out = static_cast<int64_t>(std::llround(value));
+    return true;
+}
+
+static bool ContainsNoCase(std::wstring_view text, std::wstring_view needle) {
+    if (needle.empty()) return true;
+    for (size_t i = 0; i + needle.size() <= text.size(); i++) {
+        size_t k = 0;
+        while (k < needle.size() && FoldAscii(text[i + k]) == FoldAscii(needle[k])) k++;
+        if (k == needle.size()) return true;
+    }
+    return false;
+}
+
+bool LoadRules(IArcPlatform& platform, const std::wstring& path, std::vector<ArcRule>& out, std::wstring& error) {
+    ArcFileBytes file;
+    if (!file.Open(platform, path)) {
+        error = L"fichier illisible";
+        return false;
+    }
+
+    out.clear();
+    std::string_view text = file.Utf8();
+    for (size_t number = 1; !text.empty(); number++) {
+        const size_t eol = text.find('\n');
+        std::string_view line = Trim(text.substr(0, eol));
+        text = eol == std::string_view::npos ? std::string_view() : text.substr(eol + 1);
+        if (line.empty() || line[0] == '#') continue;
+
+        const size_t a = line.find('|');
+        const size_t b = a == std::string_view::npos ? a : line.find('|', a + 1);
+        ArcRule rule;
+        rule.line = number;
+        if (b == std::string_view::npos || !ParseStatusLevel(FromUtf8(Trim(line.substr(0, a))), rule.level)) {
+            error = L"ligne " + std::to_wstring(number) + L": \"niveau|alerte|condition\" attendu";
+            return false;
+        }
+        rule.alert = FromUtf8(Trim(line.substr(a + 1, b - a - 1)));
+        rule.condition = std::string(Trim(line.substr(b + 1)));
+        out.push_back(std::move(rule));
+    }
+    return true;
+}
+
+// ======================== Compilation ========================
+bool ArcRuleSet::Compile(const std::vector<ArcRule>& rules, std::wstring& error) {
+    rules_.clear();
+    column_.clear();
+    operand_.clear();
+    accept_.clear();
+    texts_.clear();
+
+    for (const ArcRule& rule : rules) {
+        CompiledRule compiled{ rule.level, rule.alert, static_cast<uint32_t>(column_.size()), 0 };
+        std::string_view condition = rule.condition;
+        std::wstring termError;
+        // Un '&' final attend encore un terme: "a &" est refuse comme "a & & b"
+        for (bool more = !Trim(condition).empty(); more;) {
+            // Les guillemets protegent un '&' dans une valeur ("Proxy & DNS")
+            size_t amp = 0;
+            if (!FindConjunction(condition, amp)) {
+                error = L"ligne " + std::to_wstring(rule.line) + L": guillemet non ferme";
+                return false;
+            }
+            const std::string_view term = Trim(condition.substr(0, amp));
+            more = amp != std::string_view::npos;
+            condition = more ? condition.substr(amp + 1) : std::string_view();
+            if (!CompileTerm(term, termError)) {
+                error = L"ligne " + std::to_wstring(rule.line) + L": " + termError;
+                return false;
+            }
+        }
+        compiled.count = static_cast<uint32_t>(column_.size()) - compiled.first;
+        if (!compiled.count) {
+            error = L"ligne " + std::to_wstring(rule.line) + L": condition vide";
+            return false;
+        }
+        rules_.push_back(std::move(compiled));
+    }
+    return true;
+}
+
+bool ArcRuleSet::CompileTerm(std::string_view term, std::wstring& error) {
+    const size_t at = term.find_first_of("!=<>~");
+    if (at == std::string_view::npos || at == 0) {
+        error = L"comparaison attendue: " + FromUtf8(term);
+        return false;
+    }
+    const char c = term[at];
+    const char next = at + 1 < term.size() ? term[at + 1] : '\0';
+    std::string_view op = term.substr(at, (next == '=' || (c == '!' && next == '~')) ? 2 : 1);
+    if (c == '!' && op.size() == 1) {
+        error = L"operateur inconnu: " + FromUtf8(term);
+        return false;
+    }
+    std::wstring field = FromUtf8(Trim(term.substr(0, at)));
+    for (auto& ch : field) ch = FoldAscii(ch);
+    const std::string_view value = Unquote(Trim(term.substr(at + op.size())));
+    if (op == "==") op = "=";
+
+    uint8_t accept = 0;
+    if (op == "<") accept = kLess;
+    else if (op == "<=") accept = kLess | kEqual;
+    else if (op == "=") accept = kEqual;
+    else if (op == "!=") accept = kLess | kGreater;
+    else if (op == ">") accept = kGreater;
+    else if (op == ">=") accept = kGreater | kEqual;
+    const bool textOp = op == "~" || op == "!~";
+    const bool ordered = accept != kEqual && accept != (kLess | kGreater);
+
+    auto push = [this](size_t column, int64_t operand, uint8_t mask) {
+        column_.push_back(static_cast<uint16_t>(column));
+        operand_.push_back(operand);
+        accept_.push_back(mask);
+    };
+    // Test de texte: colonne 0/1, satisfaite si 1 (ou 0 pour la negation)
+    auto pushText = [&](TextField f, bool contains, bool negate) {
+        TextTest test{ f, contains, FromUtf8(value) };
+        size_t i = 0;
+        while (i < texts_.size() && !(texts_[i].field == f && texts_[i].contains == contains && texts_[i].needle == test.needle)) i++;
+        if (i == texts_.size()) texts_.push_back(std::move(test));
+        push(NumericColumns + i, 1, negate ? kLess : kEqual);
+    };
+
+    static const struct { const wchar_t* name; TextField text; Column column; } kTextFields[] = {
+        { L"component", TextField::Component, Component },
+        { L"status", TextField::Status, Status },
+        { L"version", TextField::Version, Version },
+        { L"details", TextField::Details, NumericColumns },
+        { L"alerts", TextField::Alerts, NumericColumns },
+    };
+    for (const auto& f : kTextFields) {
+        if (field != f.name) continue;
+        if (textOp) pushText(f.text, true, op == "!~");
+        else if (ordered) {
+            error = L"operateur non applicable a un texte: " + FromUtf8(term);
+            return false;
+        }
+        else if (f.column != NumericColumns) push(f.column, ArcIntern(FromUtf8(value)), accept);     // Identifiant interne
+        else pushText(f.text, false, op == "!=");
+        return true;
+    }
+
+    int64_t operand = 0;
+    bool parsed = false;
+    Column column = NumericColumns;
+    if (field == L"level") {
+        StatusLevel level;
+        parsed = ParseStatusLevel(FromUtf8(value), level);
+        operand = static_cast<int64_t>(level);
+        column = Level;
+    } else if (field == L"value") {
+        parsed = ParseNumber(value, false, operand);
+        column = Value;
+    } else if (field == L"substatus.code") {
+        parsed = ParseNumber(value, false, operand);
+        column = Subcode;
+    } else if (field == L"lifetime") {
+        parsed = ParseNumber(value, true, operand);
+        column = Lifetime;
+    } else {
+        error = L"champ inconnu: " + field;
+        return false;
+    }
+    if (textOp || !parsed) {
+        const bool number = !textOp && column != Level;
+        error = (number ? L"nombre invalide: " : L"comparaison invalide: ") + FromUtf8(term);
+        return false;
+    }
+    push(column, operand, accept);
+    return true;
+}
+
+// ======================== Evaluation ========================
+size_t ArcRuleSet::Apply(ArcComponentList& list, int64_t nowUtc) const {
+    const size_t rows = list.size();
+    if (!rows || rules_.empty()) return 0;
+
+    // Faits en colonnes: [colonne * rows + ligne]
+    std::vector<int64_t> facts((NumericColumns + texts_.size()) * rows);
+    for (size_t i = 0; i < rows; i++) {
+        const ArcComponentInfo& row = list[i];
+        facts[Component * rows + i] = row.component;
+        facts[Status * rows + i] = row.status;
+        facts[Version * rows + i] = row.version;
+        facts[Level * rows + i] = static_cast<int64_t>(row.level);
+        facts[Value * rows + i] = row.value;
+        facts[Subcode * rows + i] = row.subcode;
+        facts[Lifetime * rows + i] = row.expiresUtc ? row.expiresUtc - nowUtc : std::numeric_limits<int64_t>::max();
+    }
+    for (size_t t = 0; t < texts_.size(); t++) {
+        const TextTest& test = texts_[t];
+        int64_t* column = facts.data() + (NumericColumns + t) * rows;
+        for (size_t i = 0; i < rows; i++) {
+            const ArcComponentInfo& row = list[i];
+            std::wstring_view text;
+            switch (test.field) {
+                case TextField::Component: text = ArcStrText(row.component); break;
+                case TextField::Status: text = ArcStrText(row.status); break;
+                case TextField::Version: text = ArcStrText(row.version); break;
+                case TextField::Details: text = list.Details(row); break;
+                case TextField::Alerts: text = list.Alerts(row); break;
+            }
+            column[i] = test.contains ? ContainsNoCase(text, test.needle) : text == test.needle;
+        }
+    }
+
+    // Un predicat a la fois sur toutes les lignes; verdict = premiere regle satisfaite
+    std::vector<uint8_t> hit(rows);
+    std::vector<uint32_t> verdict(rows, kNoRule);
+    for (uint32_t r = 0; r < rules_.size(); r++) {
+        std::fill(hit.begin(), hit.end(), uint8_t(1));
+        const CompiledRule& rule = rules_[r];
+        for (uint32_t p = rule.first; p < rule.first + rule.count; p++) {
+            const int64_t* column = facts.data() + column_[p] * rows;
+            const int64_t k = operand_[p];
+            const uint8_t accept = accept_[p];
+            for (size_t i = 0; i < rows; i++) {
+                const int64_t v = column[i];
+                const uint8_t m = static_cast<uint8_t>((v < k) | ((v == k) << 1) | ((v > k) << 2));
+                hit[i] &= static_cast<uint8_t>((m & accept) != 0);
+            }
+        }
+        for (size_t i = 0; i < rows; i++) verdict[i] = (verdict[i] == kNoRule && hit[i]) ? r : verdict[i];
+    }
+
+    size_t applied = 0;
+    for (size_t i = 0; i < rows; i++) {
+        if (verdict[i] == kNoRule) continue;
+        const CompiledRule& rule = rules_[verdict[i]];
+        ArcComponentInfo& row = list[i];
+        row.level = rule.level;
+        if (!rule.alert.empty()) list.SetAlerts(row, rule.alert);
+        applied++;
+    }
+    return applied;
+}
@@ -0,0 +1,85 @@
+// ArcRules.h - Regles de sante declaratives appliquees aux resultats des sondes
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Une regle par ligne: "niveau|alerte|condition" (meme disposition que les signatures de
+// journaux), niveau = erreur / avertissement / ok. La condition est une conjonction de
+// comparaisons "champ operateur valeur" separees par '&':
+//   component, status, version    texte interne (= et != compares par identifiant)
+//   details, alerts               texte libre
+//   level                         ok / avertissement / erreur
+//   value                         mesure de la sonde (ArcComponentInfo::value)
+//   substatus.code                code secondaire (extension: premier code de sous-statut non nul)
+//   lifetime                      secondes avant expiration (aucune echeance: valeur maximale)
+// Operateurs: = != < <= > >= sur les nombres et niveaux; = != (exacts) et ~ !~ (contient,
+// sans casse ASCII) sur les textes. Les durees acceptent les suffixes s, m, h, d / j; nan, inf
+// et les nombres hors de la plage 64 bits sont refuses. Une valeur entre guillemets peut
+// contenir '&'. Exemples:
+//   erreur|Extension en echec|component = Extension & value != 0
+//   avertissement|Jeton expirant sous 72 h|component = Token & lifetime < 72h
+//   ok||component = "Proxy Arc" & status = "Non actif"
+//
+// Pour chaque ligne de resultat, la premiere regle satisfaite (ordre du fichier) fixe le
+// niveau et, si elle en a une, l'alerte; sans regle satisfaite le verdict de la sonde reste.
+//
+// Compilation: chaque comparaison devient une entree d'une table plate (colonne, constante,
+// masque d'acceptation <,=,>). Les faits d'une liste sont ranges en colonnes d'entiers; une
+// comparaison est evaluee sur toutes les lignes en une boucle sans branchement. Les tests de
+// texte libre sont calcules une fois par liste en colonnes 0/1.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ArcPlatform.h"
+#include "ArcResult.h"
+
+struct ArcRule {
+    StatusLevel level = StatusLevel::WARNING;
+    std::wstring alert;         // Vide: alerte de la sonde conservee
+    std::string condition;      // UTF-8
+    size_t line = 0;            // Ligne du fichier (messages d'erreur)
+};
+
+// Lignes vides et commentaires ('#') ignores. Faux si le fichier est illisible; une ligne
+// mal formee est signalee dans 'error' et la lecture echoue (une regle ignoree en silence
+// changerait la politique).
+bool LoadRules(IArcPlatform& platform, const std::wstring& path, std::vector<ArcRule>& out, std::wstring& error);
+
+class ArcRuleSet {
+public:
+    // Faux et 'error' renseigne si une condition est invalide
+    bool Compile(const std::vector<ArcRule>& rules, std::wstring& error);
+
+    size_t RuleCount() const { return rules_.size(); }
+    size_t PredicateCount() const { return column_.size(); }
+
+    // Thread-safe (etat de travail local). Renvoie le nombre de lignes dont une regle a fixe le verdict.
+    size_t Apply(ArcComponentList& list, int64_t nowUtc) const;
+
+private:
+    // Colonnes numeriques des faits, puis une colonne par test de texte
+    enum Column : uint8_t { Component, Status, Version, Level, Value, Subcode, Lifetime, NumericColumns };
+    enum class TextField : uint8_t { Component, Status, Version, Details, Alerts };
+
+    struct TextTest {
+        TextField field;
+        bool contains;              // Faux: egalite exacte
+        std::wstring needle;
+    };
+    struct CompiledRule {
+        StatusLevel level;
+        std::wstring alert;
+        uint32_t first;             // Predicats [first, first + count)
+        uint32_t count;
+    };
+
+    bool CompileTerm(std::string_view term, std::wstring& error);
+
+    std::vector<CompiledRule> rules_;
+    // Table plate des predicats
+    std::vector<uint16_t> column_;
+    std::vector<int64_t> operand_;
+    std::vector<uint8_t> accept_;   // Bit 0: inferieur, bit 1: egal, bit 2: superieur
+    std::vector<TextTest> texts_;   // Colonne NumericColumns + i
+};
@@ -0,0 +1,227 @@
+// ArcSampler.cpp - Echantillonnage des ressources des processus de l'agent (fuites, CPU emballe)
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#include "ArcSampler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+static int64_t SteadyMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Pourcentage d'un coeur entre deux echantillons
+static double CpuPercent(uint64_t fromUs, uint64_t toUs, int64_t fromMs, int64_t toMs) {
+    if (toMs <= fromMs || toUs < fromUs) return 0.0;
+    return static_cast<double>(toUs - fromUs) / (static_cast<double>(toMs - fromMs) * 10.0);
+}
+
+ArcResourceSampler::ArcResourceSampler(IArcPlatform& platform, const ArcSamplerOptions& options)
+    : platform_(platform), options_(options) {
+    options_.intervalMs = std::max<uint32_t>(options_.intervalMs, 100);
+    options_.maxProcesses = std::max<size_t>(options_.maxProcesses, 1);
+    // L'anneau doit couvrir la fenetre du CPU emballe et fournir quatre quarts exploitables
+    const size_t runawaySamples = static_cast<size_t>(uint64_t(options_.runawaySeconds) * 1000 / options_.intervalMs) + 1;
+    options_.capacity = std::max<size_t>({ options_.capacity, runawaySamples, 8 });
+
+    slots_.reset(new Slot[options_.maxProcesses]);
+    for (size_t i = 0; i < options_.maxProcesses; i++) slots_[i].cells.reset(new Cell[options_.capacity]);
+}
+
+ArcResourceSampler::~ArcResourceSampler() {
+    Stop();
+}
+
+// ======================== Thread ========================
+void ArcResourceSampler::Track(const std::vector<uint32_t>& pids) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    requested_ = pids;
+    changed_ = true;
+}
+
+void ArcResourceSampler::Start() {
+    if (thread_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = false;
+    }
+    thread_ = std::thread([this] { Run(); });
+}
+
+void ArcResourceSampler::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) thread_.join();
+}
+
+void ArcResourceSampler::Run() {
+    for (;;) {
+        SampleNow();
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (wake_.wait_for(lock, std::chrono::milliseconds(options_.intervalMs), [this] { return stop_; })) break;
+    }
+}
+
+// ======================== Writer ========================
+void ArcResourceSampler::Assign(Slot& slot, uint32_t pid, uint64_t startTime) {
+    slot.generation++;
+    slot.startTime = startTime;
+    slot.first.store(slot.head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    slot.minWorkingSet.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    slot.minHandles.store(std::numeric_limits<uint32_t>::max(), std::memory_order_relaxed);
+    slot.identity.store((static_cast<uint64_t>(slot.generation) << 32) | pid, std::memory_order_release);
+}
+
+void ArcResourceSampler::Push(Slot& slot, int64_t timeMs, const ArcProcessSample& sample) {
+    const uint64_t n = slot.head.load(std::memory_order_relaxed);
+    Cell& cell = slot.cells[n % options_.capacity];
+    cell.seq.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    cell.timeMs.store(timeMs, std::memory_order_relaxed);
+    cell.cpuTimeUs.store(sample.cpuTimeUs, std::memory_order_relaxed);
+    cell.workingSet.store(sample.workingSet, std::memory_order_relaxed);
+    cell.ioReadBytes.store(sample.ioReadBytes, std::memory_order_relaxed);
+    cell.ioWriteBytes.store(sample.ioWriteBytes, std::memory_order_relaxed);
+    cell.handles.store(sample.handles, std::memory_order_relaxed);
+    cell.seq.store(2 * n + 2, std::memory_order_release);
+    slot.head.store(n + 1, std::memory_order_release);
+
+    if (sample.workingSet < slot.minWorkingSet.load(std::memory_order_relaxed)) slot.minWorkingSet.store(sample.workingSet, std::memory_order_relaxed);
+    if (sample.handles < slot.minHandles.load(std::memory_order_relaxed)) slot.minHandles.store(sample.handles, std::memory_order_relaxed);
+}
+
+void ArcResourceSampler::SampleNow() {
+    std::vector<uint32_t> requested;
+    bool changed = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (changed_) {
+            requested = requested_;
+            changed_ = false;
+            changed = true;
+        }
+    }
+    const size_t count = options_.maxProcesses;
+    if (changed) {
+        std::sort(requested.begin(), requested.end());
+        for (size_t i = 0; i < count; i++) {
+            const uint64_t id = slots_[i].identity.load(std::memory_order_relaxed);
+            if (id && !std::binary_search(requested.begin(), requested.end(), static_cast<uint32_t>(id))) {
+                slots_[i].identity.store(0, std::memory_order_release);
+            }
+        }
+        tracked_.swap(requested);
+    }
+
+    const int64_t now = SteadyMs();
+    ArcProcessSample sample;
+    for (size_t i = 0; i < count; i++) {
+        Slot& slot = slots_[i];
+        const uint64_t id = slot.identity.load(std::memory_order_relaxed);
+        if (!id) continue;
+        const uint32_t pid = static_cast<uint32_t>(id);
+        if (!platform_.SampleProcess(pid, sample)) {
+            slot.identity.store(0, std::memory_order_release);      // Disparu: repris si la sonde le retrouve
+            continue;
+        }
+        if (sample.startTime != slot.startTime) Assign(slot, pid, sample.startTime);     // PID reutilise
+        Push(slot, now, sample);
+    }
+
+    // PID demandes sans emplacement (nouveaux, ou disparus puis revenus)
+    for (uint32_t pid : tracked_) {
+        size_t free = count;
+        bool present = false;
+        for (size_t i = 0; i < count && !present; i++) {
+            const uint64_t id = slots_[i].identity.load(std::memory_order_relaxed);
+            present = id && static_cast<uint32_t>(id) == pid;
+            if (!id && free == count) free = i;
+        }
+        if (present || free == count || !platform_.SampleProcess(pid, sample)) continue;
+        Assign(slots_[free], pid, sample.startTime);
+        Push(slots_[free], now, sample);
+    }
+}
+
+// ======================== Readers ========================
+bool ArcResourceSampler::Read(const Slot& slot, uint32_t pid, std::vector<Sample>& out, uint64_t& minWorkingSet, uint32_t& minHandles) const {
+    const uint64_t identity = slot.identity.load(std::memory_order_acquire);
+    if (!identity || static_cast<uint32_t>(identity) != pid) return false;
+    const uint64_t first = slot.first.load(std::memory_order_acquire);
+    const uint64_t head = slot.head.load(std::memory_order_acquire);
+    minWorkingSet = slot.minWorkingSet.load(std::memory_order_relaxed);
+    minHandles = slot.minHandles.load(std::memory_order_relaxed);
+
+    out.clear();
+    const uint64_t begin = std::max(first, head > options_.capacity ? head - options_.capacity : 0);
+    for (uint64_t n = begin; n < head; n++) {
+        const Cell& cell = slot.cells[n % options_.capacity];
+        const uint64_t seq = cell.seq.load(std::memory_order_acquire);
+        if (seq != 2 * n + 2) continue;
+        Sample s;
+        s.timeMs = cell.timeMs.load(std::memory_order_relaxed);
+        s.values.cpuTimeUs = cell.cpuTimeUs.load(std::memory_order_relaxed);
+        s.values.workingSet = cell.workingSet.load(std::memory_order_relaxed);
+        s.values.ioReadBytes = cell.ioReadBytes.load(std::memory_order_relaxed);
+        s.values.ioWriteBytes = cell.ioWriteBytes.load(std::memory_order_relaxed);
+        s.values.handles = cell.handles.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (cell.seq.load(std::memory_order_relaxed) != seq) continue;     // Reecrite pendant la lecture
+        out.push_back(s);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.identity.load(std::memory_order_relaxed) == identity;
+}
+
+bool ArcResourceSampler::Status(uint32_t pid, ArcResourceStatus& out) const {
+    std::vector<Sample> samples;
+    uint64_t minWorkingSet = 0;
+    uint32_t minHandles = 0;
+    bool found = false;
+    for (size_t i = 0; i < options_.maxProcesses && !found; i++) found = Read(slots_[i], pid, samples, minWorkingSet, minHandles);
+    if (!found || samples.size() < 2) return false;
+
+    out = ArcResourceStatus();
+    const Sample& last = samples.back();
+    const Sample& previous = samples[samples.size() - 2];
+    out.latest = last.values;
+    out.samples = samples.size();
+    out.windowSeconds = (last.timeMs - samples.front().timeMs) / 1000.0;
+    out.cpuPercent = CpuPercent(previous.values.cpuTimeUs, last.values.cpuTimeUs, previous.timeMs, last.timeMs);
+
+    // CPU emballe: echantillon le plus recent couvrant au moins runawaySeconds
+    const int64_t span = int64_t(options_.runawaySeconds) * 1000;
+    for (size_t i = samples.size() - 1; i-- > 0; ) {
+        if (last.timeMs - samples[i].timeMs < span) continue;
+        out.runawayPercent = CpuPercent(samples[i].values.cpuTimeUs, last.values.cpuTimeUs, samples[i].timeMs, last.timeMs);
+        out.runaway = out.runawayPercent >= options_.runawayCpuPercent;
+        break;
+    }
+
+    // Fuite: planchers des quarts de la fenetre jamais decroissants, dernier au-dessus du minimum
+    if (samples.size() >= 8) {
+        const size_t quarter = samples.size() / 4;
+        uint64_t memory[4];
+        uint32_t handles[4];
+        for (size_t q = 0; q < 4; q++) {
+            const size_t end = q == 3 ? samples.size() : (q + 1) * quarter;
+            memory[q] = std::numeric_limits<uint64_t>::max();
+            handles[q] = std::numeric_limits<uint32_t>::max();
+            for (size_t i = q * quarter; i < end; i++) {
+                memory[q] = std::min(memory[q], samples[i].values.workingSet);
+                handles[q] = std::min(handles[q], samples[i].values.handles);
+            }
+        }
+        const bool memoryRising = memory[0] <= memory[1] && memory[1] <= memory[2] && memory[2] <= memory[3] && memory[3] > memory[0];
+        const bool handlesRising = handles[0] <= handles[1] && handles[1] <= handles[2] && handles[2] <= handles[3] && handles[3] > handles[0];
+        out.memoryGrowth = memory[3] > minWorkingSet ? memory[3] - minWorkingSet : 0;
+        out.handleGrowth = handles[3] > minHandles ? handles[3] - minHandles : 0;
+        out.memoryLeak = memoryRising && out.memoryGrowth >= options_.leakBytes;
+        out.handleLeak = handlesRising && out.handleGrowth >= options_.leakHandles;
+    }
+    return true;
+}
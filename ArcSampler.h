@@ -0,0 +1,123 @@
+// ArcSampler.h - Echantillonnage des ressources des processus de l'agent (fuites, CPU emballe)
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Un thread releve a intervalle fixe le temps CPU, la memoire residente, les handles et les
+// octets d'E/S des processus suivis (himds, azcmagent, gc_service, gestionnaires d'extensions:
+// PID fournis par la sonde des processus). Un releve = un appel SampleProcess par PID, sans
+// enumeration du systeme.
+//
+// Chaque processus suivi occupe un emplacement alloue a la construction, avec un anneau de
+// taille fixe: aucune allocation apres le demarrage, memoire bornee quelle que soit la duree.
+// Ecrivain unique (le thread d'echantillonnage), lecteurs sans verrou: chaque case porte un
+// numero de sequence (seqlock); une case reecrite pendant la lecture est simplement ignoree.
+//
+// Alertes, evaluees par le lecteur sur le contenu de l'anneau:
+//   fuite       le plancher (minimum) de chaque quart de la fenetre ne descend jamais et le
+//               dernier depasse le minimum observe depuis le debut du suivi de leakBytes
+//               (memoire) ou leakHandles (handles): une croissance ponctuelle puis stable
+//               (chargement) ne declenche rien
+//   CPU emballe moyenne sur les runawaySeconds dernieres secondes >= runawayCpuPercent d'un coeur
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ArcPlatform.h"
+
+struct ArcSamplerOptions {
+    uint32_t intervalMs = 30000;
+    size_t capacity = 240;              // Echantillons par processus (2 h a 30 s)
+    size_t maxProcesses = 16;           // Emplacements; les processus en surnombre ne sont pas suivis
+    uint64_t leakBytes = 512ull << 20;
+    uint32_t leakHandles = 5000;
+    double runawayCpuPercent = 90.0;    // Pourcentage d'un coeur
+    uint32_t runawaySeconds = 300;
+};
+
+// Etat d'un processus suivi, calcule a la lecture
+struct ArcResourceStatus {
+    ArcProcessSample latest;
+    size_t samples = 0;
+    double windowSeconds = 0.0;         // Duree couverte par l'anneau
+    double cpuPercent = 0.0;            // Dernier intervalle, pourcentage d'un coeur
+    uint64_t memoryGrowth = 0;          // Plancher recent - minimum depuis le debut du suivi
+    uint32_t handleGrowth = 0;
+    bool memoryLeak = false;
+    bool handleLeak = false;
+    bool runaway = false;
+    double runawayPercent = 0.0;        // Moyenne sur runawaySeconds
+};
+
+class ArcResourceSampler {
+public:
+    ArcResourceSampler(IArcPlatform& platform, const ArcSamplerOptions& options = ArcSamplerOptions());
+    ~ArcResourceSampler();
+
+    ArcResourceSampler(const ArcResourceSampler&) = delete;
+    ArcResourceSampler& operator=(const ArcResourceSampler&) = delete;
+
+    // Remplace l'ensemble des PID suivis (pris en compte au releve suivant). Les PID retires
+    // liberent leur emplacement; les PID conserves gardent leur historique.
+    void Track(const std::vector<uint32_t>& pids);
+
+    void Start();   // Premier releve immediat
+    void Stop();
+
+    // Un releve (thread d'echantillonnage; ou directement si Start() n'a pas ete appele)
+    void SampleNow();
+
+    // Sans verrou, depuis n'importe quel thread. false si le PID n'est pas suivi ou n'a pas
+    // encore deux echantillons.
+    bool Status(uint32_t pid, ArcResourceStatus& out) const;
+
+    const ArcSamplerOptions& Options() const { return options_; }
+
+private:
+    struct Cell {
+        std::atomic<uint64_t> seq{ 0 };     // 2n + 1 pendant l'ecriture de l'echantillon n, 2n + 2 ensuite
+        std::atomic<int64_t> timeMs{ 0 };
+        std::atomic<uint64_t> cpuTimeUs{ 0 };
+        std::atomic<uint64_t> workingSet{ 0 };
+        std::atomic<uint64_t> ioReadBytes{ 0 };
+        std::atomic<uint64_t> ioWriteBytes{ 0 };
+        std::atomic<uint32_t> handles{ 0 };
+    };
+    struct Slot {
+        std::atomic<uint64_t> identity{ 0 };    // Generation << 32 | PID; 0 = libre
+        std::atomic<uint64_t> first{ 0 };       // Premier echantillon de la generation
+        std::atomic<uint64_t> head{ 0 };        // Echantillons ecrits (jamais remis a zero)
+        std::atomic<uint64_t> minWorkingSet{ 0 };
+        std::atomic<uint32_t> minHandles{ 0 };
+        std::unique_ptr<Cell[]> cells;
+        // Propre a l'ecrivain
+        uint64_t startTime = 0;
+        uint32_t generation = 0;
+    };
+    struct Sample {
+        int64_t timeMs;
+        ArcProcessSample values;
+    };
+
+    void Assign(Slot& slot, uint32_t pid, uint64_t startTime);
+    void Push(Slot& slot, int64_t timeMs, const ArcProcessSample& sample);
+    bool Read(const Slot& slot, uint32_t pid, std::vector<Sample>& out, uint64_t& minWorkingSet, uint32_t& minHandles) const;
+    void Run();
+
+    IArcPlatform& platform_;
+    ArcSamplerOptions options_;
+    std::unique_ptr<Slot[]> slots_;
+    std::vector<uint32_t> tracked_;     // Ensemble en vigueur, propre a l'ecrivain
+
+    std::mutex mutex_;                  // Ensemble demande et arret uniquement, jamais les anneaux
+    std::condition_variable wake_;
+    std::vector<uint32_t> requested_;
+    bool changed_ = false;
+    bool stop_ = false;
+    std::thread thread_;
+};
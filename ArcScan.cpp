@@ -0,0 +1,639 @@
+// ArcScan.cpp - Moteur de verification Azure Arc, independant de l'interface
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Verifie etat agent Azure Arc, expiration tokens, extensions installees
+
+#include "ArcScan.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "ArcCache.h"
+#include "ArcContent.h"
+#include "ArcEvents.h"
+#include "ArcFile.h"
+#include "ArcExtensions.h"
+#include "ArcJson.h"
+#include "ArcLog.h"
+#include "ArcLogScan.h"
+#include "ArcRules.h"
+#include "ArcSampler.h"
+#include "ArcText.h"
+#include "ArcTime.h"
+#include "ArcTrace.h"
+
+// ======================== Azure Arc Configuration ========================
+static std::wstring DescribeConfig(std::string_view jsonContent) {
+    // Extract key values (un seul parcours du document, sur les octets UTF-8)
+    static const JsonPathScannerA configScanner({
+        "resourceId", "properties.resourceId",
+        "location", "properties.location",
+        "tenantId", "properties.tenantId"
+    });
+    std::vector<JsonValueA> fields;
+    configScanner.Scan(jsonContent, fields);
+
+    // Seuls les champs affiches sont convertis en wchar_t
+    auto pick = [&fields](size_t flat, size_t nested) {
+        return FromUtf8(JsonString(fields[flat].found() ? fields[flat] : fields[nested]));
+    };
+    std::wstring resourceId = pick(0, 1);
+    std::wstring location = pick(2, 3);
+    std::wstring tenantId = pick(4, 5);
+
+    std::wstring details;
+    if (!resourceId.empty()) {
+        details = L"Resource: " + resourceId;
+        if (!location.empty()) details += L" | Region: " + location;
+        if (!tenantId.empty()) details += L" | Tenant: " + tenantId.substr(0, 8) + L"...";
+    }
+    return details;
+}
+
+void ReadArcConfig(ArcScanContext& ctx, ArcComponentList& out) {
+    const std::wstring& path = ctx.layout.configFile;
+    ArcFileStamp stamp;
+    const bool cacheable = ctx.cache && ctx.platform.StatFile(path, stamp);
+
+    std::wstring details;
+    std::string_view cached;
+    if (cacheable && ctx.cache->Lookup(ArcCacheKind::Config, path, stamp, cached)) {
+        details = FromUtf8(cached);
+    } else {
+        ArcFileBytes file;
+        if (!file.Open(ctx.platform, path) || file.Utf8().empty()) {
+            ArcComponentInfo& info = out.Add(L"Configuration Agent", L"Non trouve", StatusLevel::ERROR_LEVEL);
+            out.SetAlerts(info, L"Fichier config manquant");
+            return;
+        }
+        // Meme contenu deja analyse (autre hote du parc)
+        const ArcContentKey key = ctx.content ? ArcContentCache::Key(ArcCacheKind::Config, file.Raw()) : ArcContentKey();
+        std::string_view shared;
+        if (ctx.content && ctx.content->Lookup(key, shared)) {
+            details = FromUtf8(shared);
+        } else {
+            details = DescribeConfig(file.Utf8());
+            if (ctx.content) ctx.content->Store(key, ToUtf8(details));
+        }
+        if (cacheable) ctx.cache->Store(ArcCacheKind::Config, path, stamp, ToUtf8(details));
+    }
+
+    ArcComponentInfo& info = out.Add(L"Configuration Agent", L"Configuration trouvee", StatusLevel::OK);
+    out.SetDetails(info, details);
+}
+
+// ======================== Connectivity ========================
+static std::wstring FormatMs(double ms) {
+    return std::to_wstring(static_cast<long long>(ms + 0.5)) + L" ms";
+}
+
+void CheckConnectivity(ArcScanContext& ctx, ArcComponentList& out) {
+    // Configuration absente: points de terminaison du cloud public, sans proxy
+    ArcProxySettings proxy;
+    ArcFileBytes config;
+    const std::vector<ArcEndpoint> endpoints =
+        EndpointsFromConfig(config.Open(ctx.platform, ctx.layout.configFile) ? config.Utf8() : std::string_view(), proxy);
+
+    const std::vector<ArcEndpointStatus> statuses = ProbeEndpoints(ctx.platform, endpoints, proxy, ctx.network, ctx.cancel);
+    out.reserve(statuses.size());
+    for (const auto& s : statuses) {
+        const wchar_t* status = L"Joignable";
+        switch (s.failedAt) {
+            case ArcNetStage::Dns: status = L"Echec DNS"; break;
+            case ArcNetStage::Tcp: status = L"Echec TCP"; break;
+            case ArcNetStage::Proxy: status = L"Echec proxy"; break;
+            case ArcNetStage::Tls: status = L"Echec TLS"; break;
+            case ArcNetStage::Done: break;
+        }
+        const bool ok = s.failedAt == ArcNetStage::Done;
+        const StatusLevel level = ok ? StatusLevel::OK : (s.endpoint.required ? StatusLevel::ERROR_LEVEL : StatusLevel::WARNING);
+        ArcComponentInfo& info = out.Add(FromUtf8(s.endpoint.host), status, level);
+        info.value = static_cast<int64_t>(s.dnsMs + s.tcpMs + s.proxyMs + s.tlsMs + 0.5);
+
+        // Latence de chaque etape franchie
+        std::wstring details = std::to_wstring(s.endpoint.port) + L" | " + s.endpoint.purpose;
+        if (s.failedAt != ArcNetStage::Dns) {
+            details += L" | " + FormatAddress(s.address) + L" | DNS " + FormatMs(s.dnsMs);
+            if (s.failedAt > ArcNetStage::Tcp) details += L", TCP " + FormatMs(s.tcpMs);
+            if (s.viaProxy && s.failedAt > ArcNetStage::Proxy) details += L", CONNECT " + FormatMs(s.proxyMs);
+            if (ok) details += L", TLS " + FormatMs(s.tlsMs);
+        }
+        if (s.viaProxy) details += L" | via proxy " + FromUtf8(proxy.host) + L":" + std::to_wstring(proxy.port);
+        out.SetDetails(info, details);
+        out.SetAlerts(info, s.error);
+    }
+}
+
+// ======================== Token & Certificate Expiry ========================
+void CheckCredentialExpiry(ArcScanContext& ctx, ArcComponentList& out) {
+    std::vector<ArcCredentialExpiry> credentials =
+        FindCredentialExpiries(ctx.platform, { ctx.layout.tokensDir, ctx.layout.certsDir }, ctx.ioWorkers, ctx.cache, ctx.content);
+
+    if (credentials.empty()) {
+        ArcComponentInfo& info = out.Add(L"Jetons et certificats", L"Aucun trouve", StatusLevel::WARNING);
+        out.SetAlerts(info, L"Aucune date d'expiration lisible dans les magasins de l'agent");
+        return;
+    }
+
+    const int64_t now = NowUtc();
+    SortByUrgency(credentials, now, ctx.expiry);
+    out.reserve(credentials.size());
+
+    for (const auto& c : credentials) {
+        const bool token = c.kind == ArcCredentialKind::Token;
+        const wchar_t* status = L"Valide";
+        const wchar_t* alert = L"";
+        StatusLevel level = StatusLevel::OK;
+        switch (ClassifyExpiry(c, now, ctx.expiry)) {
+            case ArcExpiryState::Expired:
+                status = L"Expire";
+                alert = token ? L"TOKEN EXPIRE!" : L"CERTIFICAT EXPIRE!";
+                level = StatusLevel::ERROR_LEVEL;
+                break;
+            case ArcExpiryState::Critical:
+                status = L"Expiration critique";
+                alert = token ? L"Token expire tres bientot" : L"Certificat expire tres bientot";
+                level = StatusLevel::ERROR_LEVEL;
+                break;
+            case ArcExpiryState::Unknown:
+                status = L"Date illisible";
+                alert = L"Expiration non verifiable";
+                level = StatusLevel::WARNING;
+                break;
+            case ArcExpiryState::Expiring:
+                status = L"Expire bientot";
+                alert = token ? L"Token expire bientot" : L"Certificat expire bientot";
+                level = StatusLevel::WARNING;
+                break;
+            case ArcExpiryState::Valid:
+                break;
+            case ArcExpiryState::Encrypted:
+                status = L"Conteneur chiffre";
+                break;
+        }
+
+        ArcComponentInfo& info = out.Add(token ? L"Token" : L"Certificat", status, level);
+        info.expiresUtc = c.expiresUtc;
+        std::wstring details = c.path;
+        if (c.expiresUtc) {
+            details += L" | ";
+            details += c.source;
+            details += (c.expiresUtc > now ? L" | Reste " : L" | Expire depuis ") + FormatLifetime(c.expiresUtc - now);
+        } else if (c.encrypted) {
+            details += L" | Conteneur chiffre, non inspecte";
+        }
+        out.SetDetails(info, details);
+        out.SetAlerts(info, alert);
+    }
+}
+
+// ======================== Process Checks ========================
+static std::wstring FormatMegabytes(uint64_t bytes) {
+    const uint64_t tenths = (bytes * 10 + (1u << 19)) >> 20;
+    return std::to_wstring(tenths / 10) + L"." + std::to_wstring(tenths % 10) + L" Mo";
+}
+
+static std::wstring JoinPids(const std::vector<uint32_t>& pids, size_t maxShown) {
+    std::wstring text;
+    for (size_t i = 0; i < pids.size() && i < maxShown; i++) {
+        if (i) text += L", ";
+        text += std::to_wstring(pids[i]);
+    }
+    if (pids.size() > maxShown) text += L", ...";
+    return text;
+}
+
+// Releve ponctuel (passe unique, sans echantillonneur)
+static std::wstring DescribeSample(const ArcProcessSample& sample) {
+    std::wstring text = L" | Memoire: " + FormatMegabytes(sample.workingSet);
+    if (sample.handles) text += L" | Handles: " + std::to_wstring(sample.handles);
+    return text + L" | CPU: " + std::to_wstring(sample.cpuTimeUs / 1000000) + L" s";
+}
+
+// Alertes de l'echantillonneur pour un PID. Valeurs arrondies (100 Mo, 1000 handles, seuils
+// pour le CPU): le texte ne change pas a chaque releve (mode surveillance: lignes +/-).
+static void AppendResourceAlerts(const ArcResourceSampler& sampler, uint32_t pid, std::wstring& alerts) {
+    ArcResourceStatus status;
+    if (!sampler.Status(pid, status)) return;
+    const std::wstring who = L" (PID " + std::to_wstring(pid) + L")";
+    auto add = [&alerts](const std::wstring& text) {
+        if (!alerts.empty()) alerts += L"; ";
+        alerts += text;
+    };
+    if (status.memoryLeak) {
+        add(L"Fuite memoire probable" + who + L": +" + std::to_wstring(status.memoryGrowth / (100ull << 20) * 100) + L" Mo et en hausse");
+    }
+    if (status.handleLeak) {
+        add(L"Fuite de handles probable" + who + L": +" + std::to_wstring(status.handleGrowth / 1000 * 1000) + L" et en hausse");
+    }
+    if (status.runaway) {
+        const ArcSamplerOptions& o = sampler.Options();
+        add(L"CPU emballe" + who + L": plus de " + std::to_wstring(static_cast<int>(o.runawayCpuPercent)) + L" % d'un coeur depuis "
+            + std::to_wstring(o.runawaySeconds / 60) + L" min");
+    }
+}
+
+void CheckArcProcesses(ArcScanContext& ctx, const ArcProcessIndex& processes, ArcComponentList& out) {
+    // Enumeration en echec: l'etat des services est inconnu, pas arrete
+    if (!processes.valid()) {
+        out.SetAlerts(out.Add(L"Processus de l'agent", L"Instantane des processus indisponible", StatusLevel::WARNING),
+            L"Enumeration des processus impossible: etat des services non verifie");
+        return;
+    }
+    std::vector<uint32_t> sampled;      // Processus de l'agent et gestionnaires remis a l'echantillonneur
+    for (const auto& watched : ctx.layout.processes) {
+        const std::vector<uint32_t>& pids = processes.Find(watched.image);
+        if (!pids.empty()) {
+            uint32_t pid = pids.front();
+            std::wstring details = L"PID: " + JoinPids(pids, 8);
+            if (pids.size() > 1) details += L" (" + std::to_wstring(pids.size()) + L" instances)";
+            details += L" | PPID: " + std::to_wstring(processes.ParentOf(pid));
+
+            std::vector<uint32_t> handlers;
+            if (watched.hostsHandlers) {
+                for (uint32_t p : pids) handlers.insert(handlers.end(), processes.ChildrenOf(p).begin(), processes.ChildrenOf(p).end());
+                details += L" | Gestionnaires d'extensions: " + std::to_wstring(handlers.size());
+            }
+
+            std::wstring alerts;
+            ArcProcessSample sample;
+            if (ctx.sampler) {
+                for (uint32_t p : pids) AppendResourceAlerts(*ctx.sampler, p, alerts);
+                sampled.insert(sampled.end(), pids.begin(), pids.end());
+            } else if (ctx.platform.SampleProcess(pid, sample)) {
+                details += DescribeSample(sample);
+            }
+
+            ArcComponentInfo& info = out.Add(watched.component, L"En cours d'execution", alerts.empty() ? StatusLevel::OK : StatusLevel::WARNING);
+            info.version = ArcIntern(ctx.platform.GetProcessPath(pid));
+            info.value = static_cast<int64_t>(pids.size());
+            out.SetDetails(info, details);
+            if (!alerts.empty()) out.SetAlerts(info, alerts);
+
+            // Gestionnaires d'extensions: une ligne seulement en cas d'alerte
+            if (!ctx.sampler) continue;
+            for (uint32_t child : handlers) {
+                sampled.push_back(child);
+                std::wstring handlerAlerts;
+                AppendResourceAlerts(*ctx.sampler, child, handlerAlerts);
+                if (handlerAlerts.empty()) continue;
+                const ArcProcessEntry* entry = processes.Get(child);
+                ArcComponentInfo& handler = out.Add(L"Gestionnaire " + (entry ? entry->name : std::wstring()), L"En cours d'execution", StatusLevel::WARNING);
+                handler.version = ArcIntern(ctx.platform.GetProcessPath(child));
+                out.SetDetails(handler, L"PID: " + std::to_wstring(child) + L" | PPID: " + std::to_wstring(processes.ParentOf(child)));
+                out.SetAlerts(handler, handlerAlerts);
+            }
+        } else {
+            switch (watched.role) {
+                case ArcProcessRole::Required:
+                    out.SetAlerts(out.Add(watched.component, L"Non actif", StatusLevel::ERROR_LEVEL), L"Processus non demarre");
+                    break;
+                case ArcProcessRole::Expected:
+                    out.SetAlerts(out.Add(watched.component, L"Non actif", StatusLevel::WARNING), L"Processus non demarre");
+                    break;
+                case ArcProcessRole::Optional:
+                    out.SetDetails(out.Add(watched.component, L"Non actif", StatusLevel::OK), L"Optionnel");
+                    break;
+            }
+        }
+    }
+    if (ctx.sampler) ctx.sampler->Track(sampled);
+}
+
+void CheckArcProcesses(ArcScanContext& ctx, ArcComponentList& out) {
+    ArcProcessIndex processes;
+    processes.Build(ctx.platform);
+    CheckArcProcesses(ctx, processes, out);
+}
+
+// ======================== Extensions Enumeration ========================
+static const wchar_t* ExtensionStatusText(const std::wstring& status) {
+    if (EqualsNoCase(status, L"success")) return L"Succes";
+    if (EqualsNoCase(status, L"transitioning")) return L"En transition";
+    if (EqualsNoCase(status, L"warning")) return L"Avertissement";
+    if (EqualsNoCase(status, L"error") || EqualsNoCase(status, L"failed")) return L"Erreur";
+    return nullptr;
+}
+
+static std::string EncodeExtensionStatus(const ArcExtensionStatus& st) {
+    ArcCacheWriter w;
+    w.Int(st.complete).Str(ToUtf8(st.handler)).Str(ToUtf8(st.operation)).Str(ToUtf8(st.status)).Int(st.code)
+        .Str(ToUtf8(st.message)).Str(ToUtf8(st.timestamp)).Str(ToUtf8(st.failedSubstatus))
+        .Int(static_cast<int64_t>(st.substatusCount)).Int(static_cast<int64_t>(st.bytesRead)).Int(st.substatusCode);
+    return w.Take();
+}
+
+static bool DecodeExtensionStatus(std::string_view data, ArcExtensionStatus& st) {
+    ArcCacheReader r(data);
+    st.complete = r.Int() != 0;
+    st.handler = FromUtf8(r.Str());
+    st.operation = FromUtf8(r.Str());
+    st.status = FromUtf8(r.Str());
+    st.code = r.Int();
+    st.message = FromUtf8(r.Str());
+    st.timestamp = FromUtf8(r.Str());
+    st.failedSubstatus = FromUtf8(r.Str());
+    st.substatusCount = static_cast<size_t>(r.Int());
+    st.bytesRead = static_cast<uint64_t>(r.Int());
+    st.substatusCode = r.Int();
+    return r.ok();
+}
+
+// Le fichier de statut n'est relu que si son empreinte a change depuis la passe precedente
+static bool LoadExtensionStatus(ArcScanContext& ctx, const std::wstring& path, ArcExtensionStatus& st) {
+    ArcFileStamp stamp;
+    const bool cacheable = ctx.cache && ctx.platform.StatFile(path, stamp);
+    std::string_view cached;
+    if (cacheable && ctx.cache->Lookup(ArcCacheKind::ExtensionStatus, path, stamp, cached) && DecodeExtensionStatus(cached, st)) {
+        return true;
+    }
+    if (ctx.content) {
+        // Statut identique a celui d'un autre hote du parc: lu, mais pas reanalyse
+        ArcFileBytes file;
+        if (!file.Open(ctx.platform, path)) return false;
+        const ArcContentKey key = ArcContentCache::Key(ArcCacheKind::ExtensionStatus, file.Raw());
+        std::string_view shared;
+        if (!ctx.content->Lookup(key, shared) || !DecodeExtensionStatus(shared, st)) {
+            ParseExtensionStatus(file, st);
+            ctx.content->Store(key, EncodeExtensionStatus(st));
+        }
+    } else if (!ReadExtensionStatus(ctx.platform, path, st)) {
+        return false;
+    }
+    if (cacheable) ctx.cache->Store(ArcCacheKind::ExtensionStatus, path, stamp, EncodeExtensionStatus(st));
+    return true;
+}
+
+static void DescribeExtension(ArcScanContext& ctx, const ArcExtensionInstall& install, ArcComponentList& out) {
+    std::wstring details = install.name;
+    if (install.versionsOnDisk > 1) {
+        details += L" | " + std::to_wstring(install.versionsOnDisk - 1) + L" ancienne(s) version(s) sur disque";
+    }
+
+    ArcExtensionStatus st;
+    if (install.statusFile.empty() || !LoadExtensionStatus(ctx, install.statusFile, st)) {
+        bool unreadable = !install.statusFile.empty();
+        ArcComponentInfo& info = out.Add(L"Extension", L"Installee", unreadable ? StatusLevel::WARNING : StatusLevel::OK);
+        info.version = ArcIntern(install.version);
+        out.SetDetails(info, details);
+        if (unreadable) out.SetAlerts(info, L"Fichier de statut illisible");
+        return;
+    }
+
+    if (!st.handler.empty()) details += L" | Gestionnaire: " + st.handler;
+    if (!st.operation.empty()) details += L" | Operation: " + st.operation;
+    details += L" | Sequence: " + std::to_wstring(install.sequence) + L" | Code: " + std::to_wstring(st.code);
+    if (st.substatusCode) details += L" | Code sous-statut: " + std::to_wstring(st.substatusCode);
+    if (!st.timestamp.empty()) details += L" | Rapport: " + st.timestamp;
+
+    const wchar_t* text = ExtensionStatusText(st.status);
+    std::wstring status = text ? text : (st.status.empty() ? L"Statut inconnu" : st.status);
+    StatusLevel level = StatusLevel::OK;
+    std::wstring alerts;
+    if (EqualsNoCase(st.status, L"error") || EqualsNoCase(st.status, L"failed")) {
+        level = StatusLevel::ERROR_LEVEL;
+        alerts = st.message.empty() ? L"Extension en erreur" : st.message.substr(0, 160);
+    } else if (EqualsNoCase(st.status, L"transitioning") || EqualsNoCase(st.status, L"warning")) {
+        level = StatusLevel::WARNING;
+        alerts = L"Extension " + status;
+    } else if (!st.failedSubstatus.empty()) {
+        level = StatusLevel::WARNING;
+        alerts = L"Sous-statut: " + st.failedSubstatus;
+    } else if (!st.complete) {
+        level = StatusLevel::WARNING;
+        alerts = L"Fichier de statut incomplet";
+    }
+
+    ArcComponentInfo& info = out.Add(L"Extension", status, level);
+    info.version = ArcIntern(install.version);
+    info.value = st.code;
+    info.subcode = st.substatusCode;
+    out.SetDetails(info, details);
+    out.SetAlerts(info, alerts);
+}
+
+void EnumerateExtensions(ArcScanContext& ctx, ArcComponentList& out) {
+    std::vector<ArcExtensionInstall> installs = FindExtensionInstalls(ctx.platform, ctx.layout.pluginsDir, ctx.ioWorkers);
+
+    if (installs.empty()) {
+        out.SetAlerts(out.Add(L"Extensions Azure", L"Aucune trouvee", StatusLevel::WARNING), L"Dossier Plugins vide ou absent");
+        return;
+    }
+
+    // Une tache par extension: lecture des statuts en parallele, ordre de sortie = ordre des noms
+    std::vector<ArcComponentList> rows(installs.size());
+    ArcTaskGraph graph;
+    for (size_t i = 0; i < installs.size(); i++) {
+        graph.Add(installs[i].name, [&ctx, &installs, &rows, i] { DescribeExtension(ctx, installs[i], rows[i]); });
+    }
+    graph.Run(ctx.ioWorkers, ctx.cancel, ctx.progress);
+    out.reserve(out.size() + rows.size());
+    for (const auto& row : rows) out.Append(row);
+}
+
+// ======================== Event Log Query ========================
+static std::wstring TopEventIds(const std::map<uint32_t, uint64_t>& ids, size_t maxShown) {
+    std::vector<std::pair<uint64_t, uint32_t>> ranked;
+    ranked.reserve(ids.size());
+    for (const auto& kv : ids) ranked.emplace_back(kv.second, kv.first);
+    size_t shown = std::min(maxShown, ranked.size());
+    std::partial_sort(ranked.begin(), ranked.begin() + shown, ranked.end(),
+        [](const auto& a, const auto& b) { return a.first != b.first ? a.first > b.first : a.second < b.second; });
+
+    std::wstring text;
+    for (size_t i = 0; i < shown; i++) {
+        if (i) text += L", ";
+        text += std::to_wstring(ranked[i].second) + L" x" + std::to_wstring(ranked[i].first);
+    }
+    return text;
+}
+
+std::wstring EventDigestPath(const ArcScanContext& ctx) {
+    return ctx.stateDir + L"WinTools_AzureArcAgentChecker_events.state";
+}
+
+void QueryArcEventLog(ArcScanContext& ctx, ArcComponentList& out) {
+    const std::wstring statePath = EventDigestPath(ctx);
+
+    // Digest cumule + signet: seuls les enregistrements posterieurs au signet sont lus
+    ArcEventDigest digest;
+    digest.Load(statePath);
+    const std::wstring previousBookmark = digest.bookmark;
+    const int64_t lastUtc = digest.lastUtc;
+    // Signet perime: la plateforme le vide et relit le canal depuis le debut. Les evenements
+    // jusqu'au dernier compte sont ecartes, sinon chaque rebouclage les compterait de nouveau.
+    auto sink = [&](const ArcEventRecord& r) {
+        if (!previousBookmark.empty() && digest.bookmark.empty() && r.timeUtc <= lastUtc) return;
+        digest.Add(r);
+    };
+    if (!ctx.platform.ReadEvents(digest.bookmark, sink)) {
+        Log(ArcLogLevel::Warning, L"Impossible d'interroger Event Log Azure Arc (peut ne pas exister)");
+        return;
+    }
+
+    const int64_t now = NowUtc();
+    digest.Prune(now);
+    if ((digest.added || digest.bookmark != previousBookmark) && !digest.Save(statePath)) Log(ArcLogLevel::Warning, L"Impossible d'enregistrer le signet du journal: " + statePath);
+
+    uint64_t total = digest.levels[1] + digest.levels[2] + digest.levels[3];
+    if (total == 0) return;
+
+    const ArcEventDigest::LevelCounts day = digest.Recent(now, 86400);
+    const ArcEventDigest::LevelCounts hour = digest.Recent(now, 3600);
+
+    // Etat a vocabulaire fixe (interne); les compteurs vont dans les details
+    std::wstring details = L"Total: " + std::to_wstring(total) + L" (" + std::to_wstring(digest.added) + L" nouveaux)"
+        + L" | Critique: " + std::to_wstring(digest.levels[1])
+        + L" | Erreur: " + std::to_wstring(digest.levels[2])
+        + L" | Avertissement: " + std::to_wstring(digest.levels[3])
+        + L" | 24h: " + std::to_wstring(day[1] + day[2] + day[3])
+        + L" | 1h: " + std::to_wstring(hour[1] + hour[2] + hour[3])
+        + L" | IDs: " + TopEventIds(digest.eventIds, 5);
+
+    // Gravite fondee sur les dernieres 24 heures: un incident ancien deja resorbe ne declenche plus d'alerte
+    StatusLevel level = StatusLevel::OK;
+    const wchar_t* alerts = L"";
+    if (day[1]) {
+        alerts = L"Erreur critique detectee";
+        level = StatusLevel::ERROR_LEVEL;
+    } else if (day[2]) {
+        alerts = L"Erreur detectee";
+        level = StatusLevel::WARNING;
+    } else if (day[3]) {
+        alerts = L"Avertissement detecte";
+        level = StatusLevel::WARNING;
+    }
+    ArcComponentInfo& info = out.Add(L"Event Log", day[1] + day[2] + day[3] ? L"Evenements recents" : L"Aucun evenement recent", level);
+    info.value = static_cast<int64_t>(day[1] + day[2] + day[3]);
+    out.SetDetails(info, details);
+    out.SetAlerts(info, alerts);
+}
+
+// ======================== Agent Logs ========================
+void AnalyzeAgentLogs(ArcScanContext& ctx, ArcComponentList& out) {
+    static const ArcLogMatcher defaultMatcher(DefaultLogSignatures());
+    const ArcLogMatcher& matcher = ctx.logSignatures ? *ctx.logSignatures : defaultMatcher;
+
+    const std::vector<std::wstring> files = FindAgentLogs(ctx.platform, ctx.layout);
+    if (files.empty()) {
+        ArcComponentInfo& info = out.Add(L"Journaux agent", L"Aucun journal", StatusLevel::OK);
+        out.SetDetails(info, ctx.layout.logDir);
+        return;
+    }
+
+    const ArcLogReport report = AnalyzeLogs(ctx.platform, files, matcher, ctx.ioWorkers, ctx.cache, ctx.cancel);
+    const std::wstring volume = std::to_wstring(report.files) + L" fichier(s), " + FormatMegabytes(report.totalBytes)
+        + L" (" + FormatMegabytes(report.scannedBytes) + L" relus)";
+    if (report.findings.empty()) {
+        ArcComponentInfo& info = out.Add(L"Journaux agent", L"Aucune signature d'echec", StatusLevel::OK);
+        out.SetDetails(info, volume);
+        return;
+    }
+
+    // Occurrence ancienne: signalee sans degrader l'etat global
+    const int64_t now = NowUtc();
+    out.reserve(report.findings.size());
+    for (const auto& f : report.findings) {
+        const bool stale = f.lastSeenUtc && now - f.lastSeenUtc > 86400;
+        ArcComponentInfo& info = out.Add(L"Journaux agent", matcher.Label(f.label), stale ? StatusLevel::OK : matcher.Level(f.label));
+        info.value = static_cast<int64_t>(f.lines);
+        std::wstring details = std::to_wstring(f.lines) + L" ligne(s)";
+        if (f.lastSeenUtc) details += L" | Derniere " + FormatUtc(f.lastSeenUtc);
+        details += L" | " + f.lastFile;
+        out.SetDetails(info, details);
+        if (stale) out.SetAlerts(info, L"Derniere occurrence il y a " + FormatLifetime(now - f.lastSeenUtc));
+        else out.SetAlerts(info, matcher.Level(f.label) == StatusLevel::ERROR_LEVEL ? L"Echec recent dans les journaux" : L"Incident recent dans les journaux");
+    }
+}
+
+// ======================== Scans ========================
+ArcComponentList ArcProbeSlots::Merge() const {
+    ArcComponentList merged;
+    merged.reserve(processes.size() + config.size() + connectivity.size() + credentials.size() + events.size() + logs.size() + extensions.size());
+    for (const auto* slot : { &processes, &config, &connectivity, &credentials, &events, &logs, &extensions }) merged.Append(*slot);
+    return merged;
+}
+
+void ApplyRules(const ArcScanContext& ctx, ArcComponentList& list) {
+    if (ctx.rules) ctx.rules->Apply(list, NowUtc());
+}
+
+std::vector<ArcProbeTiming> RunProbes(ArcScanContext& ctx, uint32_t probes, ArcProbeSlots& slots, size_t maxWorkers) {
+    ArcTraceScope pass(kTracePass, L"RunProbes");
+
+    // Un seul instantane des processus par passe, partage par toutes les verifications de processus
+    ArcProcessIndex processes;
+
+    // Chaque sonde remplit son propre emplacement: aucune synchronisation entre sondes
+    ArcTaskGraph graph;
+    if (probes & ArcProbeProcesses) {
+        slots.processes.clear();
+        ArcTaskGraph::TaskId snapshot = graph.Add(L"Instantane processus", [&] { processes.Build(ctx.platform); });
+        graph.Add(L"Processus", [&] { CheckArcProcesses(ctx, processes, slots.processes); }, { snapshot });
+    }
+    if (probes & ArcProbeConfig) {
+        slots.config.clear();
+        graph.Add(L"Configuration", [&] { ReadArcConfig(ctx, slots.config); });
+    }
+    if (probes & ArcProbeConnectivity) {
+        slots.connectivity.clear();
+        graph.Add(L"Connectivite", [&] { CheckConnectivity(ctx, slots.connectivity); });
+    }
+    if (probes & ArcProbeCredentials) {
+        slots.credentials.clear();
+        graph.Add(L"Jetons et certificats", [&] { CheckCredentialExpiry(ctx, slots.credentials); });
+    }
+    if (probes & ArcProbeEvents) {
+        slots.events.clear();
+        graph.Add(L"Journal d'evenements", [&] { QueryArcEventLog(ctx, slots.events); });
+    }
+    if (probes & ArcProbeLogs) {
+        slots.logs.clear();
+        graph.Add(L"Journaux agent", [&] { AnalyzeAgentLogs(ctx, slots.logs); });
+    }
+    if (probes & ArcProbeExtensions) {
+        slots.extensions.clear();
+        graph.Add(L"Extensions", [&] { EnumerateExtensions(ctx, slots.extensions); });
+    }
+
+    graph.Run(maxWorkers, ctx.cancel, ctx.progress);
+    if (ctx.cache && !ctx.Cancelled() && !ctx.cache->Save()) Log(ArcLogLevel::Warning, L"Impossible d'enregistrer le cache des resultats");
+
+    std::vector<ArcProbeTiming> timings = graph.Timings();
+    for (const auto& t : timings) {
+        Log(ArcLogLevel::Debug, L"Sonde " + t.probe + L": " + std::to_wstring(static_cast<long long>(t.wallMs * 1000)) + L" us"
+            + (t.failed ? L" (echec)" : L""));
+    }
+    return timings;
+}
+
+ArcScanResult RunScan(ArcScanContext& ctx, const ArcScanOptions& options) {
+    uint32_t probes = 0;
+    if (options.agent) probes |= ArcProbeProcesses | ArcProbeConfig | ArcProbeCredentials | ArcProbeEvents | ArcProbeLogs;
+    if (options.agent && ctx.network.enabled) probes |= ArcProbeConnectivity;
+    if (options.extensions) probes |= ArcProbeExtensions;
+
+    ArcProbeSlots slots;
+    ArcScanResult result;
+
+    auto t0 = std::chrono::steady_clock::now();
+    result.timings = RunProbes(ctx, probes, slots, options.maxWorkers);
+    auto t1 = std::chrono::steady_clock::now();
+
+    result.components = slots.Merge();
+    ApplyRules(ctx, result.components);
+    result.wallMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    result.cancelled = ctx.Cancelled();
+    return result;
+}
+
+ArcComponentList RunAgentCheck(ArcScanContext& ctx) {
+    ArcScanOptions options;
+    return RunScan(ctx, options).components;
+}
+
+ArcComponentList RunExtensionsScan(ArcScanContext& ctx) {
+    ArcScanOptions options;
+    options.agent = false;
+    options.extensions = true;
+    return RunScan(ctx, options).components;
+}
@@ -0,0 +1,106 @@
+// ArcScan.h - Moteur de verification Azure Arc, independant de l'interface
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ArcConnectivity.h"
+#include "ArcPlatform.h"
+#include "ArcProcessIndex.h"
+#include "ArcResult.h"
+#include "ArcScheduler.h"
+#include "ArcTokens.h"
+
+class ArcResultCache;
+class ArcContentCache;
+class ArcLogMatcher;
+class ArcRuleSet;
+class ArcResourceSampler;
+
+// Contexte d'une passe: plateforme + emplacements de l'agent a inspecter
+struct ArcScanContext {
+    IArcPlatform& platform;
+    ArcAgentLayout layout;
+    size_t ioWorkers = 4;       // Parcours de repertoires paralleles a l'interieur d'une sonde
+    std::wstring stateDir;      // Etat conserve entre deux passes (signet du journal, ...)
+    ArcExpiryThresholds expiry; // Seuils d'alerte des jetons et certificats
+    ArcResultCache* cache = nullptr;    // Optionnel: fichiers inchanges servis sans relecture, enregistre apres chaque passe
+    ArcContentCache* content = nullptr; // Optionnel (parc): resultats partages entre fichiers de meme contenu
+    std::shared_ptr<const ArcLogMatcher> logSignatures;    // Signatures d'echec des journaux (nullptr = jeu par defaut)
+    std::shared_ptr<const ArcRuleSet> rules;                // Regles de sante appliquees apres fusion (nullptr = verdicts des sondes)
+    ArcNetworkOptions network;  // Sondes de connectivite (desactivees hors ligne)
+    const ArcCancelToken* cancel = nullptr;     // Optionnel: annulation cooperative de la passe
+    ArcProgress* progress = nullptr;            // Optionnel: une unite par sonde, partagee par ses extensions
+    ArcResourceSampler* sampler = nullptr;      // Optionnel: suit les PID trouves par la sonde des processus, alertes de fuite et de CPU
+
+    explicit ArcScanContext(IArcPlatform& p) : platform(p), layout(p.DefaultLayout()), stateDir(p.TempDirectory()) {}
+
+    bool Cancelled() const { return IsCancelled(cancel); }
+};
+
+// ======================== Probes ========================
+void ReadArcConfig(ArcScanContext& ctx, ArcComponentList& out);
+void CheckArcProcesses(ArcScanContext& ctx, const ArcProcessIndex& processes, ArcComponentList& out);
+void CheckArcProcesses(ArcScanContext& ctx, ArcComponentList& out);  // Construit son propre instantane
+void EnumerateExtensions(ArcScanContext& ctx, ArcComponentList& out);
+void QueryArcEventLog(ArcScanContext& ctx, ArcComponentList& out);
+void CheckCredentialExpiry(ArcScanContext& ctx, ArcComponentList& out);   // Jetons et certificats, du plus urgent au moins urgent
+void AnalyzeAgentLogs(ArcScanContext& ctx, ArcComponentList& out);        // Signatures d'echec, de la plus grave a la moins grave
+void CheckConnectivity(ArcScanContext& ctx, ArcComponentList& out);       // Un resultat par point de terminaison, avec latences
+
+// Digest du journal d'evenements (ArcEventDigest) conserve entre deux passes
+std::wstring EventDigestPath(const ArcScanContext& ctx);
+
+// ======================== Scans ========================
+struct ArcScanOptions {
+    bool agent = true;          // Processus, configuration, connectivite (si ctx.network.enabled), jetons et certificats, journaux, journal d'evenements
+    bool extensions = false;
+    size_t maxWorkers = 4;
+};
+
+struct ArcScanResult {
+    ArcComponentList components;                // Ordre fixe des sondes, independant de l'ordonnancement
+    std::vector<ArcProbeTiming> timings;
+    double wallMs = 0.0;
+    bool cancelled = false;     // Resultats partiels: a ne pas publier comme etat de l'agent
+};
+
+// Sondes independantes lancees en parallele, resultats fusionnes une fois toutes terminees
+ArcScanResult RunScan(ArcScanContext& ctx, const ArcScanOptions& options);
+
+// Sondes adressables individuellement (mode surveillance: reevaluation partielle)
+enum ArcProbe : uint32_t {
+    ArcProbeProcesses   = 1u << 0,
+    ArcProbeConfig      = 1u << 1,
+    ArcProbeEvents      = 1u << 2,
+    ArcProbeExtensions  = 1u << 3,
+    ArcProbeCredentials = 1u << 4,
+    ArcProbeLogs        = 1u << 5,
+    ArcProbeConnectivity = 1u << 6,
+    ArcProbeAll         = 0x7Fu
+};
+
+struct ArcProbeSlots {
+    ArcComponentList processes;
+    ArcComponentList config;
+    ArcComponentList connectivity;
+    ArcComponentList credentials;
+    ArcComponentList events;
+    ArcComponentList logs;
+    ArcComponentList extensions;
+
+    ArcComponentList Merge() const;
+};
+
+// Applique ctx.rules a une liste fusionnee (sans effet si aucune regle)
+void ApplyRules(const ArcScanContext& ctx, ArcComponentList& list);
+
+// Reevalue uniquement les sondes du masque; les autres emplacements sont conserves tels quels.
+// Passe annulee: le cache n'est pas enregistre (les entrees non revues seraient abandonnees).
+std::vector<ArcProbeTiming> RunProbes(ArcScanContext& ctx, uint32_t probes, ArcProbeSlots& slots, size_t maxWorkers);
+
+ArcComponentList RunAgentCheck(ArcScanContext& ctx);
+ArcComponentList RunExtensionsScan(ArcScanContext& ctx);
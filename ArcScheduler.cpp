@@ -0,0 +1,170 @@
+// ArcScheduler.cpp - Graphe de taches borne pour executer les sondes en parallele
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#include "ArcScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "ArcTrace.h"
+
+ArcTaskGraph::TaskId ArcTaskGraph::Add(const std::wstring& name, std::function<void()> fn, const std::vector<TaskId>& deps) {
+    TaskId id = tasks_.size();
+    Task task;
+    task.name = name;
+    task.fn = std::move(fn);
+    for (TaskId dep : deps) {
+        if (dep >= id) continue; // Les dependances doivent exister: pas de cycle possible
+        tasks_[dep].dependents.push_back(id);
+        task.pendingDeps++;
+    }
+    tasks_.push_back(std::move(task));
+    return id;
+}
+
+// Part d'avancement de la tache en cours sur ce thread, non encore transmise
+struct ProgressSlice {
+    ArcProgress* progress = nullptr;
+    uint64_t parts = 0;
+};
+static thread_local ProgressSlice t_slice;
+
+void ArcTaskGraph::Run(size_t maxWorkers, const ArcCancelToken* cancel, ArcProgress* progress) {
+    if (tasks_.empty()) return;
+
+    // Graphe imbrique: la part de la tache appelante est repartie, le total reste inchange
+    uint64_t budget = 0;
+    if (progress && t_slice.progress == progress) {
+        budget = t_slice.parts;
+        t_slice.parts = 0;
+    } else if (progress) {
+        progress->AddTotal(tasks_.size());
+        budget = tasks_.size() * ArcProgress::kUnit;
+    }
+    auto share = [&](TaskId id) { return budget / tasks_.size() + (id < budget % tasks_.size() ? 1 : 0); };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<TaskId> ready;
+    size_t remaining = tasks_.size();
+
+    for (TaskId id = 0; id < tasks_.size(); id++) {
+        if (tasks_[id].pendingDeps == 0) ready.push_back(id);
+    }
+
+    auto worker = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            cv.wait(lock, [&] { return !ready.empty() || remaining == 0; });
+            if (ready.empty()) return;
+
+            TaskId id = ready.front();
+            ready.pop_front();
+            Task& task = tasks_[id];
+            lock.unlock();
+
+            auto t0 = std::chrono::steady_clock::now();
+            bool failed = false;
+            const bool cancelled = IsCancelled(cancel);
+            const ProgressSlice outer = t_slice;
+            t_slice = { progress, progress ? share(id) : 0 };
+            if (!cancelled) {
+                try {
+                    ArcTraceScope scope(kTraceTask, task.name);
+                    task.fn();
+                } catch (...) {
+                    failed = true;
+                }
+            }
+            auto t1 = std::chrono::steady_clock::now();
+            if (progress) progress->AdvanceFraction(t_slice.parts);    // Reste non reparti
+            t_slice = outer;
+
+            lock.lock();
+            task.wallMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+            task.failed = failed;
+            task.cancelled = cancelled;
+            for (TaskId dep : task.dependents) {
+                if (--tasks_[dep].pendingDeps == 0) ready.push_back(dep);
+            }
+            remaining--;
+            cv.notify_all();
+        }
+    };
+
+    size_t workers = std::max<size_t>(1, std::min(maxWorkers, tasks_.size()));
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (size_t i = 1; i < workers; i++) pool.emplace_back(worker);
+    worker(); // Le thread appelant participe
+    for (auto& t : pool) t.join();
+}
+
+std::vector<ArcProbeTiming> ArcTaskGraph::Timings() const {
+    std::vector<ArcProbeTiming> timings;
+    timings.reserve(tasks_.size());
+    for (const auto& task : tasks_) {
+        ArcProbeTiming t;
+        t.probe = task.name;
+        t.wallMs = task.wallMs;
+        t.failed = task.failed;
+        t.cancelled = task.cancelled;
+        timings.push_back(t);
+    }
+    return timings;
+}
+
+void ArcParallelFor(size_t count, size_t maxWorkers, const std::function<void(size_t)>& body, const ArcCancelToken* cancel) {
+    if (count == 0) return;
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<size_t> items;
+    };
+
+    const size_t workers = std::max<size_t>(1, std::min(maxWorkers, count));
+    std::vector<WorkQueue> queues(workers);
+    for (size_t i = 0; i < count; i++) queues[i * workers / count].items.push_back(i);
+
+    // Proprietaire: avant de sa file (ordre croissant). Voleur: arriere de la file d'un autre.
+    auto next = [&](size_t self, size_t& item) {
+        {
+            std::lock_guard<std::mutex> lock(queues[self].mutex);
+            if (!queues[self].items.empty()) {
+                item = queues[self].items.front();
+                queues[self].items.pop_front();
+                return true;
+            }
+        }
+        for (size_t k = 1; k < workers; k++) {
+            WorkQueue& victim = queues[(self + k) % workers];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.items.empty()) {
+                item = victim.items.back();
+                victim.items.pop_back();
+                return true;
+            }
+        }
+        return false;   // Aucun element n'est ajoute en cours de route: toutes les files sont vides
+    };
+
+    auto worker = [&](size_t self) {
+        size_t item = 0;
+        while (!IsCancelled(cancel) && next(self, item)) {
+            try {
+                body(item);
+            } catch (...) {
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (size_t i = 1; i < workers; i++) pool.emplace_back(worker, i);
+    worker(0); // Le thread appelant participe
+    for (auto& t : pool) t.join();
+}
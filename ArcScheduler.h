@@ -0,0 +1,110 @@
+// ArcScheduler.h - Graphe de taches borne pour executer les sondes en parallele
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+struct ArcProbeTiming {
+    std::wstring probe;
+    double wallMs = 0.0;
+    bool failed = false;      // exception levee par la sonde
+    bool cancelled = false;   // non executee: passe annulee avant son demarrage
+};
+
+// ======================== Cancellation & Progress ========================
+// Annulation cooperative: les sondes testent le jeton a leurs points de reprise naturels
+// (tache, fichier, bloc lu, tour de boucle reseau) et rendent un resultat partiel.
+class ArcCancelToken {
+public:
+    void Cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+    void Reset() { cancelled_.store(false, std::memory_order_relaxed); }
+    bool Cancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> cancelled_{ false };
+};
+
+inline bool IsCancelled(const ArcCancelToken* token) { return token && token->Cancelled(); }
+
+// Avancement determine: unites terminees sur total connu, fixe des le lancement (une unite par
+// tache du graphe de plus haut niveau, par hote, ...). Un graphe imbrique dans une tache (les
+// extensions dans la sonde Extensions) se partage l'unite de cette tache au lieu d'augmenter
+// le total: l'avancement ne recule jamais. onChange est appele depuis les threads de travail.
+class ArcProgress {
+public:
+    static constexpr uint64_t kUnit = 1u << 16;     // Fractions d'unite des taches imbriquees
+
+    explicit ArcProgress(std::function<void()> onChange = nullptr) : onChange_(std::move(onChange)) {}
+
+    void AddTotal(uint64_t n) { total_.fetch_add(n, std::memory_order_relaxed); Notify(); }
+    void Advance(uint64_t n = 1) { AdvanceFraction(n * kUnit); }
+    void AdvanceFraction(uint64_t parts) {
+        if (!parts) return;
+        done_.fetch_add(parts, std::memory_order_relaxed);
+        Notify();
+    }
+    void Reset() { done_.store(0); total_.store(0); }
+
+    uint64_t Done() const { return done_.load(std::memory_order_relaxed) / kUnit; }
+    uint64_t Total() const { return total_.load(std::memory_order_relaxed); }
+
+    // 0 a 1; 0 tant qu'aucun total n'est connu
+    double Fraction() const {
+        const uint64_t total = Total();
+        return total ? std::min(1.0, double(done_.load(std::memory_order_relaxed)) / (double(total) * kUnit)) : 0.0;
+    }
+
+private:
+    void Notify() { if (onChange_) onChange_(); }
+
+    std::atomic<uint64_t> done_{ 0 };       // En fractions d'unite
+    std::atomic<uint64_t> total_{ 0 };
+    std::function<void()> onChange_;
+};
+
+// ======================== Task Graph ========================
+// Chaque tache s'execute une seule fois, apres toutes ses dependances.
+// Les taches independantes sont reparties sur au plus maxWorkers threads.
+class ArcTaskGraph {
+public:
+    using TaskId = size_t;
+
+    TaskId Add(const std::wstring& name, std::function<void()> fn, const std::vector<TaskId>& deps = {});
+
+    // Bloque jusqu'a la fin de toutes les taches. Une tache en echec ne bloque pas
+    // ses dependantes: elles s'executent avec un resultat partiel. Apres annulation, les
+    // taches non demarrees sont sautees. progress: une unite par tache; appele depuis une tache
+    // d'un graphe de meme avancement, les taches se partagent l'unite de celle-ci.
+    void Run(size_t maxWorkers, const ArcCancelToken* cancel = nullptr, ArcProgress* progress = nullptr);
+
+    // Chronometrage par tache, dans l'ordre d'ajout (deterministe)
+    std::vector<ArcProbeTiming> Timings() const;
+
+    size_t size() const { return tasks_.size(); }
+
+private:
+    struct Task {
+        std::wstring name;
+        std::function<void()> fn;
+        std::vector<TaskId> dependents;
+        size_t pendingDeps = 0;
+        double wallMs = 0.0;
+        bool failed = false;
+        bool cancelled = false;
+    };
+    std::vector<Task> tasks_;
+};
+
+// Boucle parallele a vol de travail pour un grand nombre d'elements independants (ex: hotes).
+// Chaque thread part d'un bloc contigu d'indices et, une fois sa file videe, vole les
+// derniers indices des autres files: les elements lents n'immobilisent pas les autres threads.
+// Une exception levee par body est ignoree et n'interrompt pas les autres elements.
+// Apres annulation, plus aucun element n'est distribue.
+void ArcParallelFor(size_t count, size_t maxWorkers, const std::function<void(size_t)>& body, const ArcCancelToken* cancel = nullptr);
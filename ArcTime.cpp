@@ -0,0 +1,161 @@
+// ArcTime.cpp - Horodatages UTC (secondes depuis 1970) sans dependance a la locale
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#include "ArcTime.h"
+
+#include <chrono>
+#include <cwchar>
+
+// Aucune allocation: les analyseurs travaillent sur des vues, en UTF-8 comme en UTF-16.
+
+// Jours depuis 1970-01-01 pour une date du calendrier gregorien (algorithme de H. Hinnant)
+static int64_t DaysFromCivil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+static void CivilFromDays(int64_t z, int64_t& y, unsigned& m, unsigned& d) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = static_cast<int64_t>(yoe) + era * 400 + (m <= 2);
+}
+
+// Lit exactement 'count' chiffres
+template <typename CharT>
+static bool Digits(std::basic_string_view<CharT> text, size_t& pos, size_t count, unsigned& value) {
+    if (pos + count > text.size()) return false;
+    value = 0;
+    for (size_t i = 0; i < count; i++) {
+        CharT c = text[pos + i];
+        if (c < '0' || c > '9') return false;
+        value = value * 10 + static_cast<unsigned>(c - '0');
+    }
+    pos += count;
+    return true;
+}
+
+// Zone finale: 'Z', "+hh:mm", "+hhmm", "-hh" (absente = UTC)
+template <typename CharT>
+static bool ZoneOffset(std::basic_string_view<CharT> text, size_t& pos, int64_t& offset) {
+    offset = 0;
+    if (pos >= text.size()) return true;
+    CharT zone = text[pos++];
+    if (zone == 'Z' || zone == 'z') return true;
+    if (zone != '+' && zone != '-') return false;
+    unsigned oh, om = 0;
+    if (!Digits(text, pos, 2, oh)) return false;
+    if (pos < text.size() && text[pos] == ':') pos++;
+    if (pos < text.size() && !Digits(text, pos, 2, om)) return false;
+    offset = (static_cast<int64_t>(oh) * 3600 + om * 60) * (zone == '+' ? 1 : -1);
+    return true;
+}
+
+static int64_t ToUtc(unsigned year, unsigned month, unsigned day, unsigned hour, unsigned minute, unsigned second, int64_t offset) {
+    return DaysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offset;
+}
+
+template <typename CharT>
+static bool ParseUtc(std::basic_string_view<CharT> text, int64_t& utc) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '"')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '"')) text.remove_suffix(1);
+    if (text.empty()) return false;
+
+    // Epoch numerique
+    size_t digits = 0;
+    while (digits < text.size() && text[digits] >= '0' && text[digits] <= '9') digits++;
+    if (digits == text.size()) {
+        if (text.size() > 18) return false;
+        int64_t value = 0;
+        for (CharT c : text) value = value * 10 + (c - '0');
+        utc = value > 100000000000LL ? value / 1000 : value;
+        return true;
+    }
+
+    size_t pos = 0;
+    unsigned year, month, day, hour = 0, minute = 0, second = 0;
+    if (!Digits(text, pos, 4, year) || pos >= text.size() || text[pos++] != '-') return false;
+    if (!Digits(text, pos, 2, month) || pos >= text.size() || text[pos++] != '-') return false;
+    if (!Digits(text, pos, 2, day)) return false;
+    if (month < 1 || month > 12 || day < 1 || day > 31) return false;
+
+    int64_t offset = 0;
+    if (pos < text.size() && (text[pos] == 'T' || text[pos] == 't' || text[pos] == ' ')) {
+        pos++;
+        if (!Digits(text, pos, 2, hour) || pos >= text.size() || text[pos++] != ':') return false;
+        if (!Digits(text, pos, 2, minute)) return false;
+        if (pos < text.size() && text[pos] == ':') {
+            pos++;
+            if (!Digits(text, pos, 2, second)) return false;
+        }
+        if (pos < text.size() && (text[pos] == '.' || text[pos] == ',')) {
+            pos++;
+            while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') pos++;  // Fraction ignoree
+        }
+        if (hour > 23 || minute > 59 || second > 60) return false;
+        if (!ZoneOffset(text, pos, offset)) return false;
+    }
+    if (pos != text.size()) return false;
+
+    utc = ToUtc(year, month, day, hour, minute, second, offset);
+    return true;
+}
+
+bool ParseUtcTimestamp(std::wstring_view text, int64_t& utc) {
+    return ParseUtc(text, utc);
+}
+
+bool ParseUtcTimestamp(std::string_view text, int64_t& utc) {
+    return ParseUtc(text, utc);
+}
+
+bool ParseAsn1Time(std::string_view text, bool generalized, int64_t& utc) {
+    size_t pos = 0;
+    unsigned year, month, day, hour, minute, second = 0;
+    if (generalized) {
+        if (!Digits(text, pos, 4, year)) return false;
+    } else {
+        // RFC 5280: YY >= 50 -> 19YY, sinon 20YY
+        if (!Digits(text, pos, 2, year)) return false;
+        year += year >= 50 ? 1900 : 2000;
+    }
+    if (!Digits(text, pos, 2, month) || !Digits(text, pos, 2, day)) return false;
+    if (!Digits(text, pos, 2, hour) || !Digits(text, pos, 2, minute)) return false;
+    if (pos < text.size() && text[pos] >= '0' && text[pos] <= '9' && !Digits(text, pos, 2, second)) return false;
+    if (generalized && pos < text.size() && (text[pos] == '.' || text[pos] == ',')) {
+        pos++;
+        while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') pos++;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) return false;
+
+    int64_t offset = 0;
+    if (!ZoneOffset(text, pos, offset) || pos != text.size()) return false;
+    utc = ToUtc(year, month, day, hour, minute, second, offset);
+    return true;
+}
+
+std::wstring FormatUtc(int64_t utc) {
+    int64_t days = utc >= 0 ? utc / 86400 : (utc - 86399) / 86400;
+    int64_t secs = utc - days * 86400;
+    int64_t y;
+    unsigned m, d;
+    CivilFromDays(days, y, m, d);
+
+    wchar_t buf[32];
+    swprintf(buf, 32, L"%04lld-%02u-%02uT%02u:%02u:%02uZ", static_cast<long long>(y), m, d,
+        static_cast<unsigned>(secs / 3600), static_cast<unsigned>(secs / 60 % 60), static_cast<unsigned>(secs % 60));
+    return buf;
+}
+
+int64_t NowUtc() {
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,21 @@
+// ArcTime.h - Horodatages UTC (secondes depuis 1970) sans dependance a la locale
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Accepte un epoch en secondes (ou millisecondes au-dela de 10^11) et l'ISO-8601
+// "2025-06-01T12:00:00[.fff][Z|+hh:mm|-hh:mm]" (separateur 'T' ou espace, sans zone = UTC)
+bool ParseUtcTimestamp(std::wstring_view text, int64_t& utc);
+bool ParseUtcTimestamp(std::string_view text, int64_t& utc);
+
+// UTCTime "YYMMDDHHMM[SS]Z" ou GeneralizedTime "YYYYMMDDHHMM[SS][.fff]Z" (validite X.509)
+bool ParseAsn1Time(std::string_view text, bool generalized, int64_t& utc);
+
+// "2025-06-01T12:00:00Z"
+std::wstring FormatUtc(int64_t utc);
+
+int64_t NowUtc();
@@ -0,0 +1,333 @@
+// ArcTokens.cpp - Expiration des jetons et certificats de l'agent
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#include "ArcTokens.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "ArcCache.h"
+#include "ArcContent.h"
+#include "ArcFile.h"
+#include "ArcJson.h"
+#include "ArcScheduler.h"
+#include "ArcText.h"
+#include "ArcTime.h"
+
+static constexpr size_t kMaxDepth = 3;                 // Magasin/<identite>/<version>/fichier
+static constexpr uint64_t kMaxFileSize = 4u << 20;     // Au-dela: ni jeton ni certificat
+
+// ======================== DER ========================
+static bool DerHeader(const uint8_t*& p, const uint8_t* end, uint8_t& tag, size_t& length) {
+    if (end - p < 2) return false;
+    tag = *p++;
+    size_t len = *p++;
+    if (len & 0x80) {
+        size_t bytes = len & 0x7F;
+        if (bytes == 0 || bytes > 4 || static_cast<size_t>(end - p) < bytes) return false;
+        len = 0;
+        while (bytes--) len = (len << 8) | *p++;
+    }
+    if (len > static_cast<size_t>(end - p)) return false;
+    length = len;
+    return true;
+}
+
+static bool DerSkip(const uint8_t*& p, const uint8_t* end, uint8_t expected) {
+    uint8_t tag;
+    size_t len;
+    if (!DerHeader(p, end, tag, len) || tag != expected) return false;
+    p += len;
+    return true;
+}
+
+// Certificate ::= SEQUENCE { tbsCertificate SEQUENCE { [0] version OPTIONAL, serialNumber,
+//                            signature, issuer, validity SEQUENCE { notBefore, notAfter }, ... } ... }
+bool CertificateNotAfter(std::string_view der, int64_t& utc) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(der.data());
+    const uint8_t* end = p + der.size();
+    uint8_t tag;
+    size_t len;
+
+    if (!DerHeader(p, end, tag, len) || tag != 0x30) return false;
+    end = p + len;
+    if (!DerHeader(p, end, tag, len) || tag != 0x30) return false;
+    end = p + len;
+
+    if (p < end && *p == 0xA0 && !DerSkip(p, end, 0xA0)) return false;
+    if (!DerSkip(p, end, 0x02) || !DerSkip(p, end, 0x30) || !DerSkip(p, end, 0x30)) return false;
+
+    if (!DerHeader(p, end, tag, len) || tag != 0x30) return false;
+    end = p + len;
+    if (!DerHeader(p, end, tag, len)) return false;     // notBefore
+    p += len;
+    if (!DerHeader(p, end, tag, len) || (tag != 0x17 && tag != 0x18)) return false;
+    return ParseAsn1Time(std::string_view(reinterpret_cast<const char*>(p), len), tag == 0x18, utc);
+}
+
+// ======================== Base64 ========================
+// Alphabets standard et URL; blancs ignores, decodage arrete au premier caractere invalide
+static void DecodeBase64(std::string_view text, std::string& out) {
+    out.clear();
+    uint32_t acc = 0;
+    int bits = 0;
+    for (char c : text) {
+        int v;
+        if (c >= 'A' && c <= 'Z') v = c - 'A';
+        else if (c >= 'a' && c <= 'z') v = c - 'a' + 26;
+        else if (c >= '0' && c <= '9') v = c - '0' + 52;
+        else if (c == '+' || c == '-') v = 62;
+        else if (c == '/' || c == '_') v = 63;
+        else if (c == '\r' || c == '\n' || c == ' ' || c == '\t') continue;
+        else break;
+        acc = (acc << 6) | static_cast<uint32_t>(v);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out += static_cast<char>((acc >> bits) & 0xFF);
+        }
+    }
+}
+
+// ======================== Content Parsers ========================
+namespace {
+
+// Cles connues a la racine, sous un objet ou dans un tableau (caches de jetons)
+constexpr size_t kExpiryKeyCount = 6;
+const char* const kExpiryKeys[kExpiryKeyCount] = { "expiresOn", "expires_on", "expiresOnUtc", "notAfter", "expiry", "exp" };
+
+// Origine de la date; l'indice est ce qui est conserve dans le cache
+const wchar_t* const kSources[] = { L"", L"expiresOn", L"expires_on", L"expiresOnUtc", L"notAfter", L"expiry", L"exp", L"exp (JWT)" };
+const wchar_t* const kSourceNotAfter = kSources[4];
+const wchar_t* const kSourceJwt = kSources[7];
+
+enum class Content { Unknown, Json, Jwt, Pem, Der };
+
+struct FileScan {
+    Content content = Content::Unknown;
+    ArcCredentialKind kind = ArcCredentialKind::Token;
+    const wchar_t* source = kSources[0];
+    int64_t expiresUtc = 0;
+    bool recognized = false;
+
+    // Plus proche expiration du fichier
+    void Found(const wchar_t* from, int64_t utc) {
+        if (expiresUtc == 0 || utc < expiresUtc) {
+            expiresUtc = utc;
+            source = from;
+        }
+    }
+};
+
+const std::vector<std::string_view>& ExpiryPaths() {
+    static const std::vector<std::string> storage = [] {
+        std::vector<std::string> paths;
+        for (const char* prefix : { "", "*.", "[].", "*.*.", "*.[]." }) {
+            for (const char* key : kExpiryKeys) paths.push_back(std::string(prefix) + key);
+        }
+        return paths;
+    }();
+    static const std::vector<std::string_view> views(storage.begin(), storage.end());
+    return views;
+}
+
+Content Sniff(std::string_view head) {
+    size_t i = 0;
+    while (i < head.size() && (head[i] == ' ' || head[i] == '\t' || head[i] == '\r' || head[i] == '\n')) i++;
+    if (i >= head.size()) return Content::Unknown;
+    head.remove_prefix(i);
+    if (head[0] == '{' || head[0] == '[') return Content::Json;
+    if (head.compare(0, 3, "eyJ") == 0) return Content::Jwt;
+    if (head.compare(0, 10, "-----BEGIN") == 0) return Content::Pem;
+    if (static_cast<uint8_t>(head[0]) == 0x30 && head.size() > 1 && (static_cast<uint8_t>(head[1]) & 0x80)) return Content::Der;
+    return Content::Unknown;
+}
+
+void ScanJwt(std::string_view text, std::string& scratch, FileScan& scan) {
+    size_t first = text.find('.');
+    if (first == std::string_view::npos) return;
+    size_t second = text.find('.', first + 1);
+    if (second == std::string_view::npos) return;
+
+    scan.recognized = true;
+    DecodeBase64(text.substr(first + 1, second - first - 1), scratch);
+    static const std::vector<std::string_view> paths = { "exp" };
+    JsonStreamExtractor extractor(paths);
+    extractor.Feed(scratch, [&](size_t, std::string_view raw, JsonType, bool) {
+        int64_t utc;
+        if (ParseUtcTimestamp(raw, utc)) scan.Found(kSourceJwt, utc);
+    });
+}
+
+void ScanPem(std::string_view text, std::string& scratch, FileScan& scan) {
+    static constexpr std::string_view kBegin = "-----BEGIN CERTIFICATE-----";
+    static constexpr std::string_view kEnd = "-----END CERTIFICATE-----";
+    size_t pos = 0;
+    while ((pos = text.find(kBegin, pos)) != std::string_view::npos) {
+        pos += kBegin.size();
+        size_t stop = text.find(kEnd, pos);
+        if (stop == std::string_view::npos) break;
+        scan.recognized = true;
+        DecodeBase64(text.substr(pos, stop - pos), scratch);
+        int64_t utc;
+        if (CertificateNotAfter(scratch, utc)) scan.Found(kSourceNotAfter, utc);
+        pos = stop + kEnd.size();
+    }
+}
+
+// Analyse en un seul passage; le tampon de decodage est reutilise d'un fichier a l'autre
+// sur le meme thread
+void ScanBytes(const ArcFileBytes& file, FileScan& scan) {
+    thread_local std::string scratch;
+    thread_local JsonStreamExtractor json(ExpiryPaths());
+
+    // DER avant toute detection d'encodage (binaire); le reste est du texte UTF-8 ou UTF-16
+    scan.content = Sniff(file.Raw());
+    if (scan.content != Content::Der) scan.content = Sniff(file.Utf8());
+    const std::string_view text = file.Utf8();
+
+    switch (scan.content) {
+        case Content::Json:
+            json.Reset();
+            json.Feed(text, [&](size_t field, std::string_view raw, JsonType type, bool) {
+                if (type != JsonType::String && type != JsonType::Number) return;
+                int64_t utc;
+                if (ParseUtcTimestamp(raw, utc) && utc > 0) scan.Found(kSources[1 + field % kExpiryKeyCount], utc);
+            });
+            scan.recognized = scan.expiresUtc != 0;
+            break;
+        case Content::Jwt:
+            ScanJwt(text, scratch, scan);
+            break;
+        case Content::Pem:
+            scan.kind = ArcCredentialKind::Certificate;
+            ScanPem(text, scratch, scan);
+            break;
+        case Content::Der:
+            scan.kind = ArcCredentialKind::Certificate;
+            scan.recognized = true;
+            if (int64_t utc; CertificateNotAfter(file.Raw(), utc)) scan.Found(kSourceNotAfter, utc);
+            break;
+        default:
+            break;
+    }
+}
+
+void CollectFiles(IArcPlatform& platform, const std::wstring& dir, size_t depth, std::vector<std::wstring>& files) {
+    std::vector<ArcDirEntry> entries;
+    if (!platform.ListDirectory(dir, entries)) return;
+    for (const auto& e : entries) {
+        if (e.isDirectory) {
+            if (depth + 1 < kMaxDepth) CollectFiles(platform, platform.Join(dir, e.name), depth + 1, files);
+        } else if (e.size > 0 && e.size <= kMaxFileSize && !EndsWithNoCase(e.name, L".key")) {
+            files.push_back(platform.Join(dir, e.name));
+        }
+    }
+}
+
+bool IsEncryptedContainer(const std::wstring& path) {
+    return EndsWithNoCase(path, L".pfx") || EndsWithNoCase(path, L".p12");
+}
+
+std::string EncodeScan(const FileScan& scan) {
+    size_t source = std::find(std::begin(kSources), std::end(kSources), scan.source) - std::begin(kSources);
+    ArcCacheWriter w;
+    w.Int(scan.recognized).Int(static_cast<int64_t>(scan.kind)).Int(static_cast<int64_t>(source)).Int(scan.expiresUtc);
+    return w.Take();
+}
+
+bool DecodeScan(std::string_view data, FileScan& scan) {
+    ArcCacheReader r(data);
+    scan.recognized = r.Int() != 0;
+    scan.kind = r.Int() ? ArcCredentialKind::Certificate : ArcCredentialKind::Token;
+    const int64_t source = r.Int();
+    scan.expiresUtc = r.Int();
+    if (!r.ok() || source < 0 || static_cast<size_t>(source) >= std::size(kSources)) return false;
+    scan.source = kSources[source];
+    return true;
+}
+
+// Fichier projete; contenu deja analyse (autre hote du parc): resultat partage sans analyse
+void ScanFile(IArcPlatform& platform, const std::wstring& path, ArcContentCache* content, FileScan& scan) {
+    ArcFileBytes file;
+    if (!file.Open(platform, path)) return;
+    if (!content) return ScanBytes(file, scan);
+
+    const ArcContentKey key = ArcContentCache::Key(ArcCacheKind::Credential, file.Raw());
+    std::string_view shared;
+    if (content->Lookup(key, shared) && DecodeScan(shared, scan)) return;
+    ScanBytes(file, scan);
+    content->Store(key, EncodeScan(scan));
+}
+
+}
+
+// ======================== Inventory ========================
+std::vector<ArcCredentialExpiry> FindCredentialExpiries(IArcPlatform& platform, const std::vector<std::wstring>& stores, size_t maxWorkers,
+    ArcResultCache* cache, ArcContentCache* content) {
+    std::vector<std::wstring> files;
+    for (const auto& store : stores) {
+        if (!store.empty()) CollectFiles(platform, store, 0, files);
+    }
+
+    std::vector<FileScan> scans(files.size());
+    ArcParallelFor(files.size(), maxWorkers, [&](size_t i) {
+        if (IsEncryptedContainer(files[i])) {
+            scans[i].kind = ArcCredentialKind::Certificate;
+            scans[i].recognized = true;
+            return;
+        }
+        // Fichier inchange: resultat de la passe precedente, sans ouverture (y compris "non reconnu")
+        ArcFileStamp stamp;
+        const bool cacheable = cache && platform.StatFile(files[i], stamp);
+        std::string_view cached;
+        if (cacheable && cache->Lookup(ArcCacheKind::Credential, files[i], stamp, cached) && DecodeScan(cached, scans[i])) return;
+
+        scans[i] = FileScan();
+        ScanFile(platform, files[i], content, scans[i]);
+        if (cacheable) cache->Store(ArcCacheKind::Credential, files[i], stamp, EncodeScan(scans[i]));
+    });
+
+    std::vector<ArcCredentialExpiry> found;
+    for (size_t i = 0; i < files.size(); i++) {
+        if (!scans[i].recognized) continue;
+        ArcCredentialExpiry c;
+        c.path = std::move(files[i]);
+        c.kind = scans[i].kind;
+        c.source = scans[i].source;
+        c.expiresUtc = scans[i].expiresUtc;
+        c.encrypted = IsEncryptedContainer(c.path);
+        found.push_back(std::move(c));
+    }
+    return found;
+}
+
+// ======================== Urgency ========================
+ArcExpiryState ClassifyExpiry(const ArcCredentialExpiry& credential, int64_t nowUtc, const ArcExpiryThresholds& thresholds) {
+    if (credential.encrypted) return ArcExpiryState::Encrypted;
+    if (credential.expiresUtc == 0) return ArcExpiryState::Unknown;
+    const int64_t remaining = credential.expiresUtc - nowUtc;
+    if (remaining <= 0) return ArcExpiryState::Expired;
+    if (remaining < thresholds.criticalSeconds) return ArcExpiryState::Critical;
+    if (remaining < thresholds.warnSeconds) return ArcExpiryState::Expiring;
+    return ArcExpiryState::Valid;
+}
+
+void SortByUrgency(std::vector<ArcCredentialExpiry>& credentials, int64_t nowUtc, const ArcExpiryThresholds& thresholds) {
+    std::sort(credentials.begin(), credentials.end(), [&](const ArcCredentialExpiry& a, const ArcCredentialExpiry& b) {
+        ArcExpiryState sa = ClassifyExpiry(a, nowUtc, thresholds);
+        ArcExpiryState sb = ClassifyExpiry(b, nowUtc, thresholds);
+        if (sa != sb) return sa < sb;
+        if (a.expiresUtc != b.expiresUtc) return a.expiresUtc < b.expiresUtc;
+        return a.path < b.path;
+    });
+}
+
+std::wstring FormatLifetime(int64_t seconds) {
+    if (seconds < 0) seconds = -seconds;
+    const int64_t days = seconds / 86400;
+    const int64_t hours = seconds / 3600 % 24;
+    if (days > 0) return std::to_wstring(days) + L" j " + std::to_wstring(hours) + L" h";
+    if (hours > 0) return std::to_wstring(hours) + L" h " + std::to_wstring(seconds / 60 % 60) + L" min";
+    return std::to_wstring(seconds / 60) + L" min";
+}
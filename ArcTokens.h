@@ -0,0 +1,58 @@
+// ArcTokens.h - Expiration des jetons et certificats de l'agent
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Parcourt les magasins de jetons (Tokens) et de certificats (Certs) et extrait une date
+// d'expiration de chaque fichier reconnu, d'apres son contenu:
+//   JSON  - expiresOn / expires_on / expiresOnUtc / notAfter / expiry / exp (ISO-8601 ou epoch)
+//   JWT   - champ "exp" de la charge utile
+//   PEM   - notAfter du certificat le plus proche de l'expiration (chaine complete)
+//   DER   - notAfter (.cer / .crt binaires)
+// Les conteneurs chiffres (.pfx / .p12) sont signales sans date et sans etre inspectes.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ArcPlatform.h"
+
+struct ArcExpiryThresholds {
+    int64_t warnSeconds = 7 * 86400;        // En deca: avertissement
+    int64_t criticalSeconds = 86400;        // En deca: erreur
+};
+
+enum class ArcCredentialKind { Token, Certificate };
+
+// Ordre de gravite decroissant (tri par urgence). Encrypted: conteneur chiffre, aucune date a
+// classer (ni alerte ni "date illisible")
+enum class ArcExpiryState { Expired, Critical, Unknown, Expiring, Valid, Encrypted };
+
+struct ArcCredentialExpiry {
+    std::wstring path;
+    ArcCredentialKind kind = ArcCredentialKind::Token;
+    const wchar_t* source = L"";            // Champ ou structure d'ou provient la date
+    int64_t expiresUtc = 0;                 // 0 = fichier reconnu mais date illisible
+    bool encrypted = false;                 // Conteneur chiffre (.pfx / .p12), non inspecte
+};
+
+class ArcResultCache;
+class ArcContentCache;
+
+// Magasins parcourus recursivement (profondeur bornee), fichiers projetes et analyses en parallele.
+// Les fichiers sans date d'expiration reconnaissable sont ignores. Avec un cache, seuls les
+// fichiers modifies depuis la passe precedente sont relus; avec un cache de contenu, un
+// fichier identique a un fichier deja analyse (autre hote) est lu mais pas reanalyse.
+std::vector<ArcCredentialExpiry> FindCredentialExpiries(IArcPlatform& platform, const std::vector<std::wstring>& stores, size_t maxWorkers,
+    ArcResultCache* cache = nullptr, ArcContentCache* content = nullptr);
+
+ArcExpiryState ClassifyExpiry(const ArcCredentialExpiry& credential, int64_t nowUtc, const ArcExpiryThresholds& thresholds);
+
+// Du plus urgent au moins urgent: etat, puis date d'expiration, puis chemin
+void SortByUrgency(std::vector<ArcCredentialExpiry>& credentials, int64_t nowUtc, const ArcExpiryThresholds& thresholds);
+
+// "3 j 4 h", "45 min" (valeur absolue)
+std::wstring FormatLifetime(int64_t seconds);
+
+// notAfter d'un certificat X.509 encode en DER
+bool CertificateNotAfter(std::string_view der, int64_t& utc);
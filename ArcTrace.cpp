@@ -0,0 +1,373 @@
+// ArcTrace.cpp - Instrumentation: intervalles chronometres, compteurs d'E/S et trace Chrome / Perfetto
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#include "ArcTrace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+#include "ArcText.h"
+
+namespace {
+
+// ======================== Storage ========================
+constexpr uint64_t kMaxEvents = 1u << 20;
+constexpr size_t kCounters = static_cast<size_t>(ArcCounter::Count);
+
+struct TraceEvent {
+    const char* category;
+    std::string name;
+    std::string detail;
+    int64_t startNs;
+    int64_t durationNs;
+};
+
+// Tampon propre a un thread; conserve apres la fin du thread (threads de passe ephemeres)
+struct ThreadBuffer {
+    uint32_t thread = 0;
+    std::mutex mutex;           // Sans contention: seul le thread proprietaire ecrit
+    std::vector<TraceEvent> events;
+};
+
+struct CounterSample {
+    int64_t timeNs = 0;
+    uint64_t values[kCounters] = {};
+};
+
+struct TraceState {
+    std::atomic<bool> enabled{ false };
+    std::atomic<int64_t> originNs{ 0 };
+    std::atomic<uint64_t> counters[kCounters] = {};
+    std::atomic<uint64_t> recorded{ 0 };
+    std::atomic<uint64_t> dropped{ 0 };
+
+    std::mutex mutex;           // buffers, samples
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::vector<CounterSample> samples;
+};
+
+TraceState& State() {
+    static TraceState state;
+    return state;
+}
+
+thread_local ThreadBuffer* t_buffer = nullptr;
+
+ThreadBuffer& LocalBuffer() {
+    if (!t_buffer) {
+        TraceState& state = State();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.buffers.push_back(std::make_unique<ThreadBuffer>());
+        t_buffer = state.buffers.back().get();
+        t_buffer->thread = static_cast<uint32_t>(state.buffers.size());
+    }
+    return *t_buffer;
+}
+
+int64_t SteadyNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t NowNs() {
+    return SteadyNs() - State().originNs.load(std::memory_order_relaxed);
+}
+
+void SampleCounters(int64_t timeNs) {
+    TraceState& state = State();
+    CounterSample sample;
+    sample.timeNs = timeNs;
+    for (size_t i = 0; i < kCounters; i++) sample.values[i] = state.counters[i].load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.samples.push_back(sample);
+}
+
+// Microsecondes avec trois decimales (precision du format)
+void AppendMicros(std::string& out, int64_t ns) {
+    out += std::to_string(ns / 1000);
+    char frac[8];
+    snprintf(frac, sizeof(frac), ".%03d", static_cast<int>(ns % 1000));
+    out += frac;
+}
+
+} // namespace
+
+// ======================== Control ========================
+void EnableTrace(bool enabled) {
+    if (enabled && !State().enabled.load()) ResetTrace();
+    State().enabled.store(enabled);
+}
+
+bool TraceEnabled() {
+    return State().enabled.load(std::memory_order_relaxed);
+}
+
+void ResetTrace() {
+    TraceState& state = State();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    for (auto& buffer : state.buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->events.clear();
+    }
+    state.samples.clear();
+    for (auto& counter : state.counters) counter.store(0);
+    state.recorded.store(0);
+    state.dropped.store(0);
+    state.originNs.store(SteadyNs());
+}
+
+void CountTrace(ArcCounter counter, uint64_t amount) {
+    if (!TraceEnabled()) return;
+    State().counters[static_cast<size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+}
+
+uint64_t TraceCounter(ArcCounter counter) {
+    return State().counters[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+}
+
+const char* TraceCounterName(ArcCounter counter) {
+    switch (counter) {
+        case ArcCounter::FilesOpened: return "Fichiers ouverts";
+        case ArcCounter::BytesRead: return "Octets lus";
+        case ArcCounter::BytesMapped: return "Octets projetes";
+        case ArcCounter::FilesStatted: return "Fichiers interroges";
+        case ArcCounter::DirectoriesListed: return "Repertoires listes";
+        case ArcCounter::EventsRendered: return "Evenements rendus";
+        case ArcCounter::ProcessesEnumerated: return "Processus enumeres";
+        case ArcCounter::Count: break;
+    }
+    return "";
+}
+
+uint64_t TraceDropped() {
+    return State().dropped.load();
+}
+
+// ======================== Scope ========================
+ArcTraceScope::ArcTraceScope(const char* category, std::wstring_view name, std::wstring_view detail)
+    : category_(category), name_(name), detail_(detail) {
+    if (TraceEnabled()) startNs_ = NowNs();
+}
+
+ArcTraceScope::~ArcTraceScope() {
+    if (startNs_ < 0 || !TraceEnabled()) return;
+    const int64_t end = NowNs();
+    TraceState& state = State();
+    if (state.recorded.fetch_add(1, std::memory_order_relaxed) >= kMaxEvents) {
+        state.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    ThreadBuffer& buffer = LocalBuffer();
+    {
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        buffer.events.push_back({ category_, ToUtf8(name_), ToUtf8(detail_), startNs_, end - startNs_ });
+    }
+    if (strcmp(category_, kTraceTask) == 0) SampleCounters(end);
+}
+
+// ======================== Results ========================
+std::vector<ArcTraceStat> TraceSummary() {
+    std::map<std::pair<std::string, std::string>, ArcTraceStat> totals;
+    TraceState& state = State();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    for (auto& buffer : state.buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        for (const auto& e : buffer->events) {
+            ArcTraceStat& stat = totals[{ e.category, e.name }];
+            const double ms = e.durationNs / 1e6;
+            stat.calls++;
+            stat.totalMs += ms;
+            stat.maxMs = std::max(stat.maxMs, ms);
+        }
+    }
+
+    std::vector<ArcTraceStat> summary;
+    summary.reserve(totals.size());
+    for (auto& kv : totals) {
+        kv.second.category = kv.first.first;
+        kv.second.name = kv.first.second;
+        summary.push_back(std::move(kv.second));
+    }
+    std::sort(summary.begin(), summary.end(), [](const ArcTraceStat& a, const ArcTraceStat& b) { return a.totalMs > b.totalMs; });
+    return summary;
+}
+
+std::vector<ArcTraceSpan> TraceSlowest(const char* category, size_t count) {
+    std::vector<ArcTraceSpan> spans;
+    TraceState& state = State();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    for (auto& buffer : state.buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        for (const auto& e : buffer->events) {
+            if (strcmp(e.category, category) != 0) continue;
+            spans.push_back({ e.name, e.detail, e.durationNs / 1e6, buffer->thread });
+        }
+    }
+    const size_t keep = std::min(count, spans.size());
+    std::partial_sort(spans.begin(), spans.begin() + keep, spans.end(),
+        [](const ArcTraceSpan& a, const ArcTraceSpan& b) { return a.ms > b.ms; });
+    spans.resize(keep);
+    return spans;
+}
+
+bool WriteChromeTrace(const std::wstring& path) {
+    std::ofstream file(std::filesystem::path(path), std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+
+    TraceState& state = State();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    std::string b = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&] {
+        if (!first) b += ",\n";
+        first = false;
+    };
+
+    for (auto& buffer : state.buffers) {
+        separator();
+        b += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" + std::to_string(buffer->thread)
+            + ",\"args\":{\"name\":\"thread " + std::to_string(buffer->thread) + "\"}}";
+
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        for (const auto& e : buffer->events) {
+            separator();
+            b += "{\"ph\":\"X\",\"pid\":1,\"tid\":" + std::to_string(buffer->thread) + ",\"cat\":";
+            AppendJsonString(b, e.category);
+            b += ",\"name\":";
+            AppendJsonString(b, e.name);
+            b += ",\"ts\":";
+            AppendMicros(b, e.startNs);
+            b += ",\"dur\":";
+            AppendMicros(b, e.durationNs);
+            if (!e.detail.empty()) {
+                b += ",\"args\":{\"detail\":";
+                AppendJsonString(b, e.detail);
+                b += '}';
+            }
+            b += '}';
+            if (b.size() >= (1u << 20)) {
+                file.write(b.data(), static_cast<std::streamsize>(b.size()));
+                b.clear();
+            }
+        }
+    }
+
+    // Echantillons de compteurs, plus un dernier a l'instant de l'ecriture
+    std::vector<CounterSample> samples = state.samples;
+    CounterSample last;
+    last.timeNs = NowNs();
+    for (size_t i = 0; i < kCounters; i++) last.values[i] = state.counters[i].load();
+    samples.push_back(last);
+    for (const auto& s : samples) {
+        for (size_t i = 0; i < kCounters; i++) {
+            separator();
+            b += "{\"ph\":\"C\",\"pid\":1,\"name\":";
+            AppendJsonString(b, TraceCounterName(static_cast<ArcCounter>(i)));
+            b += ",\"ts\":";
+            AppendMicros(b, s.timeNs);
+            b += ",\"args\":{\"valeur\":" + std::to_string(s.values[i]) + "}}";
+        }
+    }
+    b += "\n]}\n";
+    file.write(b.data(), static_cast<std::streamsize>(b.size()));
+    return static_cast<bool>(file);
+}
+
+// ======================== Traced Platform ========================
+namespace {
+
+class TracedPlatform : public IArcPlatform {
+public:
+    explicit TracedPlatform(std::unique_ptr<IArcPlatform> inner) : inner_(std::move(inner)) {}
+
+    const wchar_t* Name() const override { return inner_->Name(); }
+    wchar_t PathSeparator() const override { return inner_->PathSeparator(); }
+    ArcAgentLayout DefaultLayout() const override { return inner_->DefaultLayout(); }
+    std::wstring TempDirectory() const override { return inner_->TempDirectory(); }
+
+    bool SnapshotProcesses(std::vector<ArcProcessEntry>& out) override {
+        ArcTraceScope scope(kTraceIo, L"SnapshotProcesses");
+        const bool ok = inner_->SnapshotProcesses(out);
+        CountTrace(ArcCounter::ProcessesEnumerated, out.size());
+        return ok;
+    }
+
+    std::wstring GetProcessPath(uint32_t pid) override {
+        ArcTraceScope scope(kTraceIo, L"GetProcessPath");
+        return inner_->GetProcessPath(pid);
+    }
+
+    bool SampleProcess(uint32_t pid, ArcProcessSample& out) override {
+        ArcTraceScope scope(kTraceIo, L"SampleProcess");
+        return inner_->SampleProcess(pid, out);
+    }
+
+    bool ListDirectory(const std::wstring& dir, std::vector<ArcDirEntry>& out) override {
+        ArcTraceScope scope(kTraceIo, L"ListDirectory", dir);
+        CountTrace(ArcCounter::DirectoriesListed);
+        return inner_->ListDirectory(dir, out);
+    }
+
+    // L'intervalle couvre aussi le traitement des blocs par l'appelant
+    bool ReadFileChunks(const std::wstring& path, const std::function<bool(std::string_view)>& sink, uint64_t offset) override {
+        ArcTraceScope scope(kTraceIo, L"ReadFileChunks", path);
+        CountTrace(ArcCounter::FilesOpened);
+        return inner_->ReadFileChunks(path, [&sink](std::string_view chunk) {
+            CountTrace(ArcCounter::BytesRead, chunk.size());
+            return sink(chunk);
+        }, offset);
+    }
+
+    bool StatFile(const std::wstring& path, ArcFileStamp& out) override {
+        ArcTraceScope scope(kTraceIo, L"StatFile", path);
+        CountTrace(ArcCounter::FilesStatted);
+        return inner_->StatFile(path, out);
+    }
+
+    std::unique_ptr<IArcMappedFile> MapFile(const std::wstring& path) override {
+        ArcTraceScope scope(kTraceIo, L"MapFile", path);
+        std::unique_ptr<IArcMappedFile> file = inner_->MapFile(path);
+        if (file) {
+            CountTrace(ArcCounter::FilesOpened);
+            CountTrace(ArcCounter::BytesMapped, file->Bytes().size());
+        }
+        return file;
+    }
+
+    bool ReadEvents(std::wstring& bookmark, const std::function<void(const ArcEventRecord&)>& sink) override {
+        ArcTraceScope scope(kTraceIo, L"ReadEvents");
+        return inner_->ReadEvents(bookmark, [&sink](const ArcEventRecord& record) {
+            CountTrace(ArcCounter::EventsRendered);
+            sink(record);
+        });
+    }
+
+    std::unique_ptr<IArcChangeWatcher> CreateWatcher(const std::vector<ArcWatchTarget>& targets, uint32_t eventTag) override {
+        return inner_->CreateWatcher(targets, eventTag);
+    }
+
+    std::unique_ptr<IArcNetLoop> CreateNetLoop() override { return inner_->CreateNetLoop(); }
+
+    std::vector<ArcNetAddress> DnsServers() override {
+        ArcTraceScope scope(kTraceIo, L"DnsServers");
+        return inner_->DnsServers();
+    }
+
+    std::wstring HostsFile() const override { return inner_->HostsFile(); }
+
+private:
+    std::unique_ptr<IArcPlatform> inner_;
+};
+
+} // namespace
+
+std::unique_ptr<IArcPlatform> CreateTracedPlatform(std::unique_ptr<IArcPlatform> inner) {
+    return std::make_unique<TracedPlatform>(std::move(inner));
+}
@@ -0,0 +1,92 @@
+// ArcTrace.h - Instrumentation: intervalles chronometres, compteurs d'E/S et trace Chrome / Perfetto
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Desactivee par defaut: un intervalle ou un compteur coute alors un seul test atomique.
+// Activee, chaque thread enregistre ses intervalles dans son propre tampon (aucune contention
+// entre sondes); la trace est lue une fois la passe terminee.
+//
+// Les appels d'E/S sont instrumentes par une plateforme intermediaire (CreateTracedPlatform)
+// qui enveloppe la plateforme native: les backends et les sondes restent inchanges.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ArcPlatform.h"
+
+// Categories d'intervalles
+constexpr const char* kTracePass = "passe";     // RunProbes
+constexpr const char* kTraceTask = "tache";     // Tache d'ArcTaskGraph (sonde, extension, ...)
+constexpr const char* kTraceHost = "hote";      // Hote d'une analyse de parc
+constexpr const char* kTraceIo = "e/s";         // Appel a IArcPlatform
+
+enum class ArcCounter {
+    FilesOpened,            // ReadFileChunks et MapFile
+    BytesRead,              // Octets transmis par ReadFileChunks
+    BytesMapped,            // Taille des fichiers projetes
+    FilesStatted,
+    DirectoriesListed,
+    EventsRendered,
+    ProcessesEnumerated,
+    Count
+};
+
+void EnableTrace(bool enabled);
+bool TraceEnabled();
+
+// Oublie les intervalles et remet les compteurs a zero (origine des temps: maintenant)
+void ResetTrace();
+
+void CountTrace(ArcCounter counter, uint64_t amount = 1);
+uint64_t TraceCounter(ArcCounter counter);
+const char* TraceCounterName(ArcCounter counter);
+
+// Intervalle enregistre a la destruction. Les vues doivent rester valides jusque-la.
+class ArcTraceScope {
+public:
+    ArcTraceScope(const char* category, std::wstring_view name, std::wstring_view detail = {});
+    ~ArcTraceScope();
+
+    ArcTraceScope(const ArcTraceScope&) = delete;
+    ArcTraceScope& operator=(const ArcTraceScope&) = delete;
+
+private:
+    const char* category_;
+    std::wstring_view name_;
+    std::wstring_view detail_;
+    int64_t startNs_ = -1;      // -1: trace inactive a l'ouverture
+};
+
+// ======================== Results ========================
+// Cumul par (categorie, nom), du plus couteux au moins couteux
+struct ArcTraceStat {
+    std::string category;
+    std::string name;           // UTF-8
+    uint64_t calls = 0;
+    double totalMs = 0.0;
+    double maxMs = 0.0;
+};
+std::vector<ArcTraceStat> TraceSummary();
+
+// Intervalles individuels les plus longs d'une categorie (chemin du fichier en detail)
+struct ArcTraceSpan {
+    std::string name;
+    std::string detail;
+    double ms = 0.0;
+    uint32_t thread = 0;
+};
+std::vector<ArcTraceSpan> TraceSlowest(const char* category, size_t count);
+
+// Au-dela de 1 048 576 intervalles, les suivants sont abandonnes (compteurs toujours exacts)
+uint64_t TraceDropped();
+
+// Format "Trace Event" (chrome://tracing, ui.perfetto.dev): intervalles "X", compteurs "C"
+// echantillonnes a la fin de chaque tache, noms des threads
+bool WriteChromeTrace(const std::wstring& path);
+
+// ======================== Traced Platform ========================
+// Chronometre et compte chaque appel d'E/S avant de le deleguer a 'inner'
+std::unique_ptr<IArcPlatform> CreateTracedPlatform(std::unique_ptr<IArcPlatform> inner);
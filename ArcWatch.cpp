@@ -0,0 +1,113 @@
+// ArcWatch.cpp - Mode surveillance: reevaluation incrementale sur notification
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#include "ArcWatch.h"
+
+#include <chrono>
+
+#include "ArcLog.h"
+
+ArcMonitor::ArcMonitor(ArcScanContext& ctx, const ArcMonitorOptions& options)
+    : ctx_(ctx), options_(options) {}
+
+std::vector<ArcWatchTarget> ArcMonitor::BuildTargets() const {
+    const IArcPlatform& p = ctx_.platform;
+    const std::wstring sep(1, p.PathSeparator());
+    std::vector<ArcWatchTarget> targets;
+
+    // agentconfig.json: repertoire parent, filtre sur le nom du fichier
+    ArcWatchTarget config;
+    config.directory = p.ParentDirectory(ctx_.layout.configFile);
+    config.mustContain = ctx_.layout.configFile.substr(config.directory.size());
+    if (!config.mustContain.empty() && config.mustContain[0] == p.PathSeparator()) config.mustContain.erase(0, 1);
+    config.tag = ArcProbeConfig | ArcProbeConnectivity;     // Points de terminaison et proxy
+    targets.push_back(config);
+
+    for (const std::wstring* store : { &ctx_.layout.tokensDir, &ctx_.layout.certsDir }) {
+        ArcWatchTarget credentials;
+        credentials.directory = *store;
+        credentials.recursive = true;
+        credentials.tag = ArcProbeCredentials;
+        targets.push_back(credentials);
+    }
+
+    if (options_.extensions) {
+        // Plugins\*\status (et Plugins\*\<version>\status): seuls les fichiers de statut comptent
+        ArcWatchTarget plugins;
+        plugins.directory = ctx_.layout.pluginsDir;
+        plugins.recursive = true;
+        plugins.mustContain = sep + L"status" + sep;
+        plugins.tag = ArcProbeExtensions;
+        targets.push_back(plugins);
+    }
+    return targets;
+}
+
+bool ArcMonitor::Run(const UpdateCallback& onUpdate) {
+    watcher_ = ctx_.platform.CreateWatcher(BuildTargets(), ArcProbeEvents);
+    if (!watcher_) return false;
+    active_.store(watcher_.get());
+    if (stopRequested_.load()) watcher_->Wake();
+
+    ArcProbeSlots slots;
+    const uint32_t all = ArcProbeProcesses | ArcProbeConfig | ArcProbeCredentials | ArcProbeEvents | ArcProbeLogs
+        | (options_.extensions ? static_cast<uint32_t>(ArcProbeExtensions) : 0u)
+        | (ctx_.network.enabled ? static_cast<uint32_t>(ArcProbeConnectivity) : 0u);
+
+    auto evaluate = [&](uint32_t probes) {
+        ArcScanResult result;
+        auto t0 = std::chrono::steady_clock::now();
+        result.timings = RunProbes(ctx_, probes, slots, options_.maxWorkers);
+        auto t1 = std::chrono::steady_clock::now();
+        result.components = slots.Merge();
+        ApplyRules(ctx_, result.components);
+        result.wallMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        onUpdate(result, probes);
+    };
+
+    evaluate(all);
+    Log(L"Surveillance demarree");
+
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point nextProcessCheck = Clock::now() + std::chrono::milliseconds(options_.processIntervalMs);
+
+    for (;;) {
+        auto now = Clock::now();
+        uint32_t timeout = 0;
+        if (nextProcessCheck > now) {
+            timeout = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(nextProcessCheck - now).count());
+        }
+
+        uint32_t changed = watcher_->Wait(timeout);
+        if (changed & kArcWatchStopped) break;
+
+        // Rafale: on regroupe les notifications jusqu'a un silence de debounceMs
+        if (changed) {
+            for (;;) {
+                uint32_t more = watcher_->Wait(options_.debounceMs);
+                if (more == 0) break;
+                changed |= more;
+                if (more & kArcWatchStopped) break;
+            }
+            if (changed & kArcWatchStopped) break;
+        }
+
+        if (Clock::now() >= nextProcessCheck) {
+            // L'expiration avance sans modification de fichier; les journaux s'allongent en continu
+            changed |= ArcProbeProcesses | ArcProbeCredentials | ArcProbeLogs;
+            nextProcessCheck = Clock::now() + std::chrono::milliseconds(options_.processIntervalMs);
+        }
+
+        changed &= all;
+        if (changed) evaluate(changed);
+    }
+
+    active_.store(nullptr);
+    Log(L"Surveillance arretee");
+    return true;
+}
+
+void ArcMonitor::Stop() {
+    stopRequested_.store(true);
+    if (IArcChangeWatcher* w = active_.load()) w->Wake();
+}
@@ -0,0 +1,43 @@
+// ArcWatch.h - Mode surveillance: reevaluation incrementale sur notification
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Config/Tokens, status des extensions et canal d'evenements declenchent uniquement
+// les sondes concernees. Aucun sondage periodique des fichiers.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "ArcScan.h"
+
+struct ArcMonitorOptions {
+    uint32_t processIntervalMs = 60000;  // Les processus n'ont pas de notification: instantane periodique
+    uint32_t debounceMs = 250;           // Regroupe les rafales d'ecritures
+    size_t maxWorkers = 4;
+    bool extensions = true;
+};
+
+class ArcMonitor {
+public:
+    // Appele apres l'evaluation initiale (changedProbes = ArcProbeAll) puis a chaque reevaluation
+    using UpdateCallback = std::function<void(const ArcScanResult& result, uint32_t changedProbes)>;
+
+    ArcMonitor(ArcScanContext& ctx, const ArcMonitorOptions& options);
+
+    // Bloque jusqu'a Stop(). false si aucune notification n'a pu etre mise en place.
+    bool Run(const UpdateCallback& onUpdate);
+
+    // Peut etre appele depuis un autre thread ou un gestionnaire de signal
+    void Stop();
+
+private:
+    std::vector<ArcWatchTarget> BuildTargets() const;
+
+    ArcScanContext& ctx_;
+    ArcMonitorOptions options_;
+    std::unique_ptr<IArcChangeWatcher> watcher_;
+    std::atomic<IArcChangeWatcher*> active_{ nullptr };
+    std::atomic<bool> stopRequested_{ false };
+};
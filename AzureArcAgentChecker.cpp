@@ -1,6 +1,6 @@
 // AzureArcAgentChecker.cpp - Verificateur d'agent Azure Arc
 // (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
-// Verifie etat agent Azure Arc, expiration tokens, extensions installees
+// Interface Win32 au-dessus du moteur ArcScan (processus, configuration, extensions)
 
 #define UNICODE
 #define _UNICODE
@@ -9,35 +9,20 @@
 
 #include <windows.h>
 #include <commctrl.h>
-#include <psapi.h>
-#include <tlhelp32.h>
-#include <winevt.h>
+#include <atomic>
 #include <string>
 #include <vector>
-#include <fstream>
-#include <sstream>
 #include <thread>
-#include <mutex>
 #include <memory>
-#include <chrono>
-#include <iomanip>
 
-#pragma comment(lib, "comctl32.lib")
-#pragma comment(lib, "psapi.lib")
-#pragma comment(lib, "wevtapi.lib")
-#pragma comment(lib, "advapi32.lib")
+#include "ArcCache.h"
+#include "ArcExport.h"
+#include "ArcLog.h"
+#include "ArcScan.h"
+#include "ArcScheduler.h"
+#include "ArcTime.h"
 
-// ======================== RAII AutoHandle ========================
-class AutoHandle {
-    HANDLE h;
-public:
-    explicit AutoHandle(HANDLE handle = INVALID_HANDLE_VALUE) : h(handle) {}
-    ~AutoHandle() { if (h != INVALID_HANDLE_VALUE && h != NULL) CloseHandle(h); }
-    operator HANDLE() const { return h; }
-    HANDLE* operator&() { return &h; }
-    AutoHandle(const AutoHandle&) = delete;
-    AutoHandle& operator=(const AutoHandle&) = delete;
-};
+#pragma comment(lib, "comctl32.lib")
 
 // ======================== Globals ========================
 HWND g_hMainWnd = NULL;
@@ -47,41 +32,30 @@ HWND g_hBtnCheckAgent = NULL;
 HWND g_hBtnListExtensions = NULL;
 HWND g_hBtnExport = NULL;
 HWND g_hProgressBar = NULL;
+HWND g_hBtnCancel = NULL;
 
-std::mutex g_logMutex;
-std::wstring g_logFilePath;
-bool g_scanning = false;
+std::unique_ptr<IArcPlatform> g_platform;
 
-enum class StatusLevel { OK, WARNING, ERROR_LEVEL };
+// Partage par les scans successifs (un seul a la fois, cf. ScanController)
+ArcResultCache g_cache;
 
-struct ArcComponentInfo {
-    std::wstring component;
-    std::wstring status;
-    std::wstring version;
-    std::wstring expiration;
-    std::wstring details;
-    std::wstring alerts;
-    StatusLevel level;
-};
+// Resultats affiches: instantane immuable, remplace uniquement par le thread UI.
+// La ListView (LVS_OWNERDATA) lit directement dedans via LVN_GETDISPINFO.
+using ArcResultSnapshot = std::shared_ptr<const ArcComponentList>;
+ArcResultSnapshot g_snapshot = std::make_shared<const ArcComponentList>();
 
-std::vector<ArcComponentInfo> g_components;
+// Fin de scan: le thread de travail poste le resultat, le thread UI le publie
+constexpr UINT WM_APP_SCAN_DONE = WM_APP + 1;
+// Avancement: au plus un message en attente, le thread UI relit les compteurs
+constexpr UINT WM_APP_SCAN_PROGRESS = WM_APP + 2;
 
-// ======================== Logging ========================
-void InitLog() {
-    wchar_t tempPath[MAX_PATH];
-    GetTempPathW(MAX_PATH, tempPath);
-    g_logFilePath = std::wstring(tempPath) + L"WinTools_AzureArcAgentChecker_log.txt";
+struct ArcScanDone {
+    ArcResultSnapshot components;
+    std::wstring summary;
+    bool cancelled = false;     // Resultat partiel: l'instantane affiche est conserve
+};
 
-    std::lock_guard<std::mutex> lock(g_logMutex);
-    std::wofstream log(g_logFilePath, std::ios::app);
-    log << L"\n========== AzureArcAgentChecker - " << std::chrono::system_clock::now().time_since_epoch().count() << L" ==========\n";
-}
-
-void Log(const std::wstring& msg) {
-    std::lock_guard<std::mutex> lock(g_logMutex);
-    std::wofstream log(g_logFilePath, std::ios::app);
-    log << msg << L"\n";
-}
+enum class ScanKind { Agent, Extensions };
 
 // ======================== Utilities ========================
 std::wstring GetCurrentTimeStamp() {
@@ -103,303 +77,21 @@ void ShowProgress(bool show) {
     if (g_hProgressBar) {
         ShowWindow(g_hProgressBar, show ? SW_SHOW : SW_HIDE);
         if (show) {
-            SendMessageW(g_hProgressBar, PBM_SETMARQUEE, TRUE, 0);
-        }
-    }
-}
-
-void EnableButtons(bool enable) {
-    EnableWindow(g_hBtnCheckAgent, enable);
-    EnableWindow(g_hBtnListExtensions, enable);
-    EnableWindow(g_hBtnExport, enable);
-}
-
-// ======================== Simple JSON Parser ========================
-std::wstring ExtractJsonValue(const std::wstring& json, const std::wstring& key) {
-    // Simple extraction: find "key":"value" or "key":value
-    std::wstring searchKey = L"\"" + key + L"\":";
-    size_t pos = json.find(searchKey);
-    if (pos == std::wstring::npos) return L"";
-
-    pos += searchKey.length();
-    while (pos < json.length() && (json[pos] == L' ' || json[pos] == L'\t')) pos++;
-
-    if (pos >= json.length()) return L"";
-
-    bool isString = (json[pos] == L'\"');
-    if (isString) pos++; // Skip opening quote
-
-    std::wstring value;
-    while (pos < json.length()) {
-        if (isString && json[pos] == L'\"') break;
-        if (!isString && (json[pos] == L',' || json[pos] == L'}' || json[pos] == L'\n')) break;
-        value += json[pos++];
-    }
-
-    return value;
-}
-
-std::wstring ReadFileToString(const std::wstring& path) {
-    std::wifstream file(path, std::ios::binary);
-    if (!file) return L"";
-
-    std::wstringstream buffer;
-    buffer << file.rdbuf();
-    return buffer.str();
-}
-
-// ======================== Process Detection ========================
-bool IsProcessRunning(const std::wstring& processName, DWORD* pidOut = nullptr) {
-    AutoHandle snap(CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0));
-    if (snap == INVALID_HANDLE_VALUE) return false;
-
-    PROCESSENTRY32W pe32;
-    pe32.dwSize = sizeof(pe32);
-
-    if (Process32FirstW(snap, &pe32)) {
-        do {
-            if (_wcsicmp(pe32.szExeFile, processName.c_str()) == 0) {
-                if (pidOut) *pidOut = pe32.th32ProcessID;
-                return true;
-            }
-        } while (Process32NextW(snap, &pe32));
-    }
-
-    return false;
-}
-
-std::wstring GetProcessPath(DWORD pid) {
-    AutoHandle hProc(OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid));
-    if (hProc == NULL) return L"";
-
-    wchar_t path[MAX_PATH];
-    DWORD size = MAX_PATH;
-    if (QueryFullProcessImageNameW(hProc, 0, path, &size)) {
-        return path;
-    }
-    return L"";
-}
-
-// ======================== Azure Arc Configuration ========================
-ArcComponentInfo ReadArcConfig() {
-    ArcComponentInfo info;
-    info.component = L"Configuration Agent";
-
-    std::wstring configPath = L"C:\\ProgramData\\AzureConnectedMachineAgent\\Config\\agentconfig.json";
-    std::wstring jsonContent = ReadFileToString(configPath);
-
-    if (jsonContent.empty()) {
-        info.status = L"Non trouve";
-        info.level = StatusLevel::ERROR_LEVEL;
-        info.alerts = L"Fichier config manquant";
-        return info;
-    }
-
-    info.status = L"Configuration trouvee";
-    info.level = StatusLevel::OK;
-
-    // Extract key values
-    std::wstring resourceId = ExtractJsonValue(jsonContent, L"resourceId");
-    std::wstring location = ExtractJsonValue(jsonContent, L"location");
-    std::wstring tenantId = ExtractJsonValue(jsonContent, L"tenantId");
-
-    if (!resourceId.empty()) {
-        info.details = L"Resource: " + resourceId;
-        if (!location.empty()) info.details += L" | Region: " + location;
-        if (!tenantId.empty()) info.details += L" | Tenant: " + tenantId.substr(0, 8) + L"...";
-    }
-
-    // Check token expiration (metadata service)
-    std::wstring metadataPath = L"C:\\ProgramData\\AzureConnectedMachineAgent\\Tokens\\metadata.json";
-    std::wstring metadataContent = ReadFileToString(metadataPath);
-
-    if (!metadataContent.empty()) {
-        std::wstring expiresOn = ExtractJsonValue(metadataContent, L"expiresOn");
-        if (!expiresOn.empty()) {
-            info.expiration = expiresOn;
-            // Simple check: if expiration looks like a number (Unix timestamp)
-            if (!expiresOn.empty() && iswdigit(expiresOn[0])) {
-                try {
-                    long long expireTime = std::stoll(expiresOn);
-                    long long currentTime = std::chrono::duration_cast<std::chrono::seconds>(
-                        std::chrono::system_clock::now().time_since_epoch()).count();
-
-                    if (expireTime < currentTime) {
-                        info.alerts = L"TOKEN EXPIRE!";
-                        info.level = StatusLevel::ERROR_LEVEL;
-                    } else if (expireTime - currentTime < 86400) { // < 24h
-                        info.alerts = L"Token expire bientot";
-                        info.level = StatusLevel::WARNING;
-                    }
-                } catch (...) {}
-            }
+            SendMessageW(g_hProgressBar, PBM_SETRANGE32, 0, 1);
+            SendMessageW(g_hProgressBar, PBM_SETPOS, 0, 0);
         }
     }
-
-    return info;
 }
 
-// ======================== Process Checks ========================
-void CheckArcProcesses() {
-    // Check himds.exe
-    DWORD pid = 0;
-    if (IsProcessRunning(L"himds.exe", &pid)) {
-        ArcComponentInfo info;
-        info.component = L"Service HIMDS";
-        info.status = L"En cours d'execution";
-        info.level = StatusLevel::OK;
-        info.details = L"PID: " + std::to_wstring(pid);
-
-        std::wstring path = GetProcessPath(pid);
-        if (!path.empty()) {
-            info.version = path;
-        }
-
-        g_components.push_back(info);
-    } else {
-        ArcComponentInfo info;
-        info.component = L"Service HIMDS";
-        info.status = L"Non actif";
-        info.level = StatusLevel::ERROR_LEVEL;
-        info.alerts = L"Processus non demarre";
-        g_components.push_back(info);
-    }
-
-    // Check azcmagent.exe
-    pid = 0;
-    if (IsProcessRunning(L"azcmagent.exe", &pid)) {
-        ArcComponentInfo info;
-        info.component = L"Agent Azure Arc";
-        info.status = L"En cours d'execution";
-        info.level = StatusLevel::OK;
-        info.details = L"PID: " + std::to_wstring(pid);
-
-        std::wstring path = GetProcessPath(pid);
-        if (!path.empty()) {
-            info.version = path;
-        }
-
-        g_components.push_back(info);
-    } else {
-        ArcComponentInfo info;
-        info.component = L"Agent Azure Arc";
-        info.status = L"Non actif";
-        info.level = StatusLevel::WARNING;
-        info.alerts = L"Processus non demarre";
-        g_components.push_back(info);
-    }
-}
-
-// ======================== Extensions Enumeration ========================
-void EnumerateExtensions() {
-    std::wstring pluginsPath = L"C:\\Packages\\Plugins";
-
-    WIN32_FIND_DATAW findData;
-    AutoHandle hFind(FindFirstFileW((pluginsPath + L"\\Microsoft.Azure.*").c_str(), &findData));
-
-    if (hFind == INVALID_HANDLE_VALUE) {
-        ArcComponentInfo info;
-        info.component = L"Extensions Azure";
-        info.status = L"Aucune trouvee";
-        info.level = StatusLevel::WARNING;
-        info.alerts = L"Dossier Plugins vide ou absent";
-        g_components.push_back(info);
-        return;
-    }
-
-    int extCount = 0;
-    do {
-        if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
-            if (wcscmp(findData.cFileName, L".") != 0 && wcscmp(findData.cFileName, L"..") != 0) {
-                ArcComponentInfo info;
-                info.component = L"Extension";
-                info.status = L"Installee";
-                info.level = StatusLevel::OK;
-                info.details = findData.cFileName;
-
-                // Try to read version from status file
-                std::wstring statusPath = pluginsPath + L"\\" + findData.cFileName + L"\\status\\*.status";
-                WIN32_FIND_DATAW statusFind;
-                AutoHandle hStatusFind(FindFirstFileW(statusPath.c_str(), &statusFind));
-                if (hStatusFind != INVALID_HANDLE_VALUE) {
-                    info.version = L"Status present";
-                }
-
-                g_components.push_back(info);
-                extCount++;
-            }
-        }
-    } while (FindNextFileW(hFind, &findData));
-
-    if (extCount == 0) {
-        ArcComponentInfo info;
-        info.component = L"Extensions Azure";
-        info.status = L"Aucune trouvee";
-        info.level = StatusLevel::WARNING;
-        g_components.push_back(info);
-    }
-}
-
-// ======================== Event Log Query ========================
-void QueryArcEventLog() {
-    const wchar_t* channelPath = L"Microsoft-AzureArc-Agent/Operational";
-    const wchar_t* query = L"*[System[Provider[@Name='Microsoft-AzureArc-Agent'] and (Level=1 or Level=2 or Level=3)]]";
-
-    EVT_HANDLE hResults = EvtQuery(NULL, channelPath, query, EvtQueryChannelPath | EvtQueryReverseDirection);
-    if (!hResults) {
-        Log(L"Impossible d'interroger Event Log Azure Arc (peut ne pas exister)");
-        return;
-    }
-
-    EVT_HANDLE events[10];
-    DWORD returned = 0;
-
-    if (EvtNext(hResults, 10, events, INFINITE, 0, &returned)) {
-        for (DWORD i = 0; i < returned && i < 3; i++) { // Limit to 3 recent events
-            DWORD bufferUsed = 0;
-            DWORD propertyCount = 0;
-
-            if (!EvtRender(NULL, events[i], EvtRenderEventXml, 0, NULL, &bufferUsed, &propertyCount)) {
-                if (GetLastError() == ERROR_INSUFFICIENT_BUFFER) {
-                    std::vector<wchar_t> buffer(bufferUsed / sizeof(wchar_t) + 1);
-                    if (EvtRender(NULL, events[i], EvtRenderEventXml, bufferUsed, buffer.data(), &bufferUsed, &propertyCount)) {
-                        std::wstring eventXml(buffer.data());
-
-                        // Extract basic info (simplified)
-                        size_t levelPos = eventXml.find(L"Level>");
-                        if (levelPos != std::wstring::npos) {
-                            ArcComponentInfo info;
-                            info.component = L"Event Log";
-                            info.status = L"Event recent";
-                            info.level = StatusLevel::WARNING;
-
-                            if (eventXml.find(L"Level>1") != std::wstring::npos) {
-                                info.alerts = L"Erreur critique detectee";
-                                info.level = StatusLevel::ERROR_LEVEL;
-                            } else if (eventXml.find(L"Level>2") != std::wstring::npos) {
-                                info.alerts = L"Erreur detectee";
-                            } else {
-                                info.alerts = L"Avertissement detecte";
-                            }
-
-                            info.details = L"Event recents dans le journal";
-                            g_components.push_back(info);
-                            break; // Only add one summary entry
-                        }
-                    }
-                }
-            }
-
-            EvtClose(events[i]);
-        }
-    }
-
-    EvtClose(hResults);
+// Les boutons de scan restent actifs pendant un scan: un clic met la demande en file
+void SetScanningButtons(bool scanning) {
+    EnableWindow(g_hBtnExport, !scanning);
+    EnableWindow(g_hBtnCancel, scanning);
 }
 
 // ======================== ListView Management ========================
 void InitListView() {
-    ListView_DeleteAllItems(g_hListView);
+    ListView_SetItemCountEx(g_hListView, 0, 0);
 
     // Remove old columns
     while (ListView_DeleteColumn(g_hListView, 0));
@@ -428,81 +120,179 @@ void InitListView() {
     ListView_InsertColumn(g_hListView, 5, &lvc);
 }
 
-void UpdateListView() {
-    ListView_DeleteAllItems(g_hListView);
-
-    int idx = 0;
-    for (const auto& comp : g_components) {
-        LVITEMW lvi = { 0 };
-        lvi.mask = LVIF_TEXT;
-        lvi.iItem = idx;
-
-        lvi.iSubItem = 0;
-        lvi.pszText = const_cast<LPWSTR>(comp.component.c_str());
-        ListView_InsertItem(g_hListView, &lvi);
-
-        ListView_SetItemText(g_hListView, idx, 1, const_cast<LPWSTR>(comp.status.c_str()));
-        ListView_SetItemText(g_hListView, idx, 2, const_cast<LPWSTR>(comp.version.c_str()));
-        ListView_SetItemText(g_hListView, idx, 3, const_cast<LPWSTR>(comp.expiration.c_str()));
-        ListView_SetItemText(g_hListView, idx, 4, const_cast<LPWSTR>(comp.details.c_str()));
-        ListView_SetItemText(g_hListView, idx, 5, const_cast<LPWSTR>(comp.alerts.c_str()));
+// Publication d'un nouvel instantane: O(lignes visibles), aucune copie de chaine dans le controle
+void UpdateListView(ArcResultSnapshot snapshot) {
+    g_snapshot = std::move(snapshot);
+    ListView_SetItemCountEx(g_hListView, static_cast<int>(g_snapshot->size()), LVSICF_NOSCROLL);
+    InvalidateRect(g_hListView, NULL, FALSE);
+}
 
-        idx++;
+void OnGetDispInfo(NMLVDISPINFOW* info) {
+    LVITEMW& item = info->item;
+    if (!(item.mask & LVIF_TEXT) || item.iItem < 0 || static_cast<size_t>(item.iItem) >= g_snapshot->size()) return;
+
+    const ArcComponentList& list = *g_snapshot;
+    const ArcComponentInfo& comp = list[item.iItem];
+    const wchar_t* text = nullptr;
+    switch (item.iSubItem) {
+        case 0: text = ArcStrText(comp.component).c_str(); break;
+        case 1: text = ArcStrText(comp.status).c_str(); break;
+        case 2: text = ArcStrText(comp.version).c_str(); break;
+        case 3:
+            // Seule colonne calculee: formatee dans le tampon fourni par le controle
+            if (comp.expiresUtc && item.pszText && item.cchTextMax > 0) {
+                wcsncpy_s(item.pszText, item.cchTextMax, FormatUtc(comp.expiresUtc).c_str(), _TRUNCATE);
+            } else if (item.pszText && item.cchTextMax > 0) {
+                item.pszText[0] = L'\0';
+            }
+            return;
+        case 4: text = list.DetailsCStr(comp); break;
+        case 5: text = list.AlertsCStr(comp); break;
+        default: return;
     }
+    // Pointeur vers l'instantane courant (table d'internement ou arene): valide tant que
+    // le thread UI ne l'a pas remplace
+    item.pszText = const_cast<LPWSTR>(text);
 }
 
 // ======================== Scanning Operations ========================
-void PerformAgentCheck() {
-    g_scanning = true;
-    EnableButtons(false);
-    ShowProgress(true);
-    SetStatus(L"Verification de l'agent Azure Arc en cours...");
+// Execute sur un thread de travail: aucun acces aux controles, le resultat est poste au thread UI
+void PostScanResult(ArcComponentList components, std::wstring summary, bool cancelled) {
+    auto* done = new ArcScanDone{ std::make_shared<const ArcComponentList>(std::move(components)), std::move(summary), cancelled };
+    if (!PostMessageW(g_hMainWnd, WM_APP_SCAN_DONE, 0, reinterpret_cast<LPARAM>(done))) delete done;
+}
 
-    g_components.clear();
+void PerformScan(ScanKind kind, const ArcCancelToken* cancel, ArcProgress* progress) {
+    ArcScanContext ctx(*g_platform);
+    ctx.cache = &g_cache;
+    ctx.cancel = cancel;
+    ctx.progress = progress;
+    ArcScanOptions options;
+    options.agent = kind == ScanKind::Agent;
+    options.extensions = kind == ScanKind::Extensions;
+    ArcScanResult result = RunScan(ctx, options);
+
+    const std::wstring ms = std::to_wstring(static_cast<long long>(result.wallMs)) + L" ms";
+    std::wstring summary;
+    if (result.cancelled) summary = L"Analyse annulee apres " + ms + L" - resultats precedents conserves";
+    else if (kind == ScanKind::Agent) summary = L"Verification terminee - " + std::to_wstring(result.components.size()) + L" composants analyses en " + ms;
+    else summary = L"Enumeration terminee - " + std::to_wstring(result.components.size()) + L" extensions trouvees";
+    PostScanResult(std::move(result.components), std::move(summary), result.cancelled);
+}
 
-    // Check processes
-    CheckArcProcesses();
+// Thread UI uniquement. Un seul scan a la fois; une demande recue pendant un scan est mise
+// en attente (la plus recente remplace la precedente) et demarre a la fin du scan courant.
+// Le thread de travail n'est jamais detache: l'arret annule puis attend sa fin.
+class ScanController {
+public:
+    ScanController() : progress_([this] { OnProgress(); }) {}
+
+    void Request(ScanKind kind) {
+        if (running_) {
+            pending_ = kind;
+            hasPending_ = true;
+            SetStatus(L"Scan en attente de la fin de l'analyse en cours");
+            return;
+        }
+        Start(kind);
+    }
 
-    // Read configuration
-    ArcComponentInfo config = ReadArcConfig();
-    g_components.push_back(config);
+    void Cancel() {
+        hasPending_ = false;
+        if (running_) {
+            cancel_.Cancel();
+            SetStatus(L"Annulation en cours...");
+        }
+    }
 
-    // Query event log
-    QueryArcEventLog();
+    void OnProgress() {
+        // Thread de travail: un seul message en vol, les autres avancements sont fusionnes
+        if (!progressPosted_.exchange(true)) {
+            if (!PostMessageW(g_hMainWnd, WM_APP_SCAN_PROGRESS, 0, 0)) progressPosted_ = false;
+        }
+    }
 
-    UpdateListView();
+    void ShowProgressState() {
+        progressPosted_ = false;
+        if (!running_) return;
+        const uint64_t total = progress_.Total();
+        const uint64_t done = progress_.Done();
+        // Pour mille: les fractions des taches imbriquees (extensions) font avancer la barre
+        SendMessageW(g_hProgressBar, PBM_SETRANGE32, 0, 1000);
+        SendMessageW(g_hProgressBar, PBM_SETPOS, static_cast<WPARAM>(progress_.Fraction() * 1000.0), 0);
+        if (!cancel_.Cancelled()) SetProgressText(done, total);
+    }
 
-    ShowProgress(false);
-    EnableButtons(true);
-    SetStatus(L"Verification terminee - " + std::to_wstring(g_components.size()) + L" composants analyses");
-    g_scanning = false;
-}
+    void OnDone(ArcScanDone* done) {
+        std::unique_ptr<ArcScanDone> owned(done);
+        Join();
+        if (!owned->cancelled) UpdateListView(std::move(owned->components));
+        SetStatus(owned->summary);
+        if (hasPending_) {
+            hasPending_ = false;
+            Start(pending_);
+            return;
+        }
+        ShowProgress(false);
+        SetScanningButtons(false);
+    }
 
-void PerformExtensionsScan() {
-    g_scanning = true;
-    EnableButtons(false);
-    ShowProgress(true);
-    SetStatus(L"Enumeration des extensions Azure Arc...");
+    // WM_DESTROY: annule, attend le thread, puis libere les resultats postes non traites
+    void Shutdown() {
+        hasPending_ = false;
+        cancel_.Cancel();
+        Join();
+        MSG msg;
+        while (PeekMessageW(&msg, g_hMainWnd, WM_APP_SCAN_DONE, WM_APP_SCAN_DONE, PM_REMOVE)) {
+            delete reinterpret_cast<ArcScanDone*>(msg.lParam);
+        }
+    }
 
-    g_components.clear();
-    EnumerateExtensions();
+private:
+    void Start(ScanKind kind) {
+        cancel_.Reset();
+        progress_.Reset();
+        progressPosted_ = false;
+        running_ = true;
+        kind_ = kind;
+        SetScanningButtons(true);
+        ShowProgress(true);
+        SetProgressText(0, 0);
+        worker_ = std::thread(PerformScan, kind, &cancel_, &progress_);
+    }
 
-    UpdateListView();
+    void Join() {
+        if (worker_.joinable()) worker_.join();
+        running_ = false;
+    }
 
-    ShowProgress(false);
-    EnableButtons(true);
-    SetStatus(L"Enumeration terminee - " + std::to_wstring(g_components.size()) + L" extensions trouvees");
-    g_scanning = false;
-}
+    void SetProgressText(uint64_t done, uint64_t total) {
+        std::wstring text = kind_ == ScanKind::Agent ? L"Verification de l'agent Azure Arc en cours..." : L"Enumeration des extensions Azure Arc...";
+        if (total) text += L" (" + std::to_wstring(done) + L"/" + std::to_wstring(total) + L")";
+        // Sans journalisation: un message par avancement saturerait le journal
+        SendMessageW(g_hStatusBar, SB_SETTEXTW, 0, (LPARAM)text.c_str());
+    }
+
+    std::thread worker_;
+    ArcCancelToken cancel_;
+    ArcProgress progress_;
+    std::atomic<bool> progressPosted_{ false };
+    bool running_ = false;
+    ScanKind kind_ = ScanKind::Agent;
+    bool hasPending_ = false;
+    ScanKind pending_ = ScanKind::Agent;
+};
+
+ScanController g_scans;
 
-// ======================== Export CSV ========================
-void ExportToCSV() {
+// ======================== Export ========================
+void ExportResults() {
     wchar_t filename[MAX_PATH] = L"AzureArcAgent_Report.csv";
 
     OPENFILENAMEW ofn = { 0 };
     ofn.lStructSize = sizeof(ofn);
     ofn.hwndOwner = g_hMainWnd;
-    ofn.lpstrFilter = L"Fichiers CSV (*.csv)\0*.csv\0Tous les fichiers (*.*)\0*.*\0";
+    ofn.lpstrFilter = L"Fichiers CSV (*.csv)\0*.csv\0JSON Lines (*.jsonl)\0*.jsonl\0Binaire en colonnes (*.arcb)\0*.arcb\0Tous les fichiers (*.*)\0*.*\0";
     ofn.lpstrFile = filename;
     ofn.nMaxFile = MAX_PATH;
     ofn.Flags = OFN_OVERWRITEPROMPT;
@@ -510,44 +300,40 @@ void ExportToCSV() {
 
     if (!GetSaveFileNameW(&ofn)) return;
 
-    std::wofstream csv(filename, std::ios::binary);
-    if (!csv) {
-        MessageBoxW(g_hMainWnd, L"Impossible de creer le fichier CSV", L"Erreur", MB_ICONERROR);
+    ArcExportFormat format = ExportFormatFromPath(filename);
+    if (ofn.nFilterIndex == 2) format = ArcExportFormat::JsonLines;
+    else if (ofn.nFilterIndex == 3) format = ArcExportFormat::Columnar;
+
+    std::unique_ptr<IArcResultWriter> writer = CreateResultWriter(format, filename);
+    if (!writer) {
+        MessageBoxW(g_hMainWnd, L"Impossible de creer le fichier d'export", L"Erreur", MB_ICONERROR);
         return;
     }
 
-    // UTF-8 BOM
-    unsigned char bom[] = { 0xEF, 0xBB, 0xBF };
-    csv.write(reinterpret_cast<wchar_t*>(bom), sizeof(bom) / sizeof(wchar_t));
-
-    csv << L"Composant,Etat,Version/Chemin,Expiration Token,Details,Alertes\n";
-
-    for (const auto& comp : g_components) {
-        csv << L"\"" << comp.component << L"\",";
-        csv << L"\"" << comp.status << L"\",";
-        csv << L"\"" << comp.version << L"\",";
-        csv << L"\"" << comp.expiration << L"\",";
-        csv << L"\"" << comp.details << L"\",";
-        csv << L"\"" << comp.alerts << L"\"\n";
+    const ArcResultSnapshot snapshot = g_snapshot;
+    for (const auto& comp : *snapshot) writer->Write(L"", *snapshot, comp);
+    if (!writer->Finish()) {
+        MessageBoxW(g_hMainWnd, L"Ecriture du fichier d'export incomplete", L"Erreur", MB_ICONERROR);
+        return;
     }
 
-    csv.close();
-
     std::wstring msg = L"Rapport exporte vers:\n" + std::wstring(filename);
     MessageBoxW(g_hMainWnd, msg.c_str(), L"Export reussi", MB_ICONINFORMATION);
-    SetStatus(L"Export CSV termine");
+    SetStatus(L"Export termine");
 }
 
 // ======================== Window Procedure ========================
 LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
     switch (msg) {
         case WM_CREATE: {
-            InitLog();
+            g_platform = CreateNativePlatform();
+            InitLog(g_platform->TempDirectory());
+            g_cache.Open(*g_platform, g_platform->TempDirectory() + L"WinTools_AzureArcAgentChecker_results.cache");
 
             // ListView
             g_hListView = CreateWindowExW(
                 0, WC_LISTVIEWW, L"",
-                WS_CHILD | WS_VISIBLE | WS_BORDER | LVS_REPORT | LVS_SINGLESEL,
+                WS_CHILD | WS_VISIBLE | WS_BORDER | LVS_REPORT | LVS_SINGLESEL | LVS_OWNERDATA,
                 10, 10, 960, 400,
                 hwnd, (HMENU)1, GetModuleHandle(NULL), NULL
             );
@@ -570,16 +356,23 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             );
 
             g_hBtnExport = CreateWindowExW(
-                0, L"BUTTON", L"Exporter CSV",
+                0, L"BUTTON", L"Exporter",
                 WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
                 330, 420, 150, 30,
                 hwnd, (HMENU)4, GetModuleHandle(NULL), NULL
             );
 
+            g_hBtnCancel = CreateWindowExW(
+                0, L"BUTTON", L"Annuler",
+                WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON | WS_DISABLED,
+                700, 420, 100, 30,
+                hwnd, (HMENU)7, GetModuleHandle(NULL), NULL
+            );
+
             // Progress bar
             g_hProgressBar = CreateWindowExW(
                 0, PROGRESS_CLASSW, NULL,
-                WS_CHILD | PBS_MARQUEE,
+                WS_CHILD | PBS_SMOOTH,
                 490, 425, 200, 20,
                 hwnd, (HMENU)5, GetModuleHandle(NULL), NULL
             );
@@ -600,20 +393,40 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             int wmId = LOWORD(wParam);
             switch (wmId) {
                 case 2: // Check Agent
-                    std::thread(PerformAgentCheck).detach();
+                    g_scans.Request(ScanKind::Agent);
                     break;
 
                 case 3: // List Extensions
-                    std::thread(PerformExtensionsScan).detach();
+                    g_scans.Request(ScanKind::Extensions);
                     break;
 
                 case 4: // Export
-                    ExportToCSV();
+                    ExportResults();
                     break;
+
+                case 7: // Cancel
+                    g_scans.Cancel();
+                    break;
+            }
+            break;
+        }
+
+        case WM_NOTIFY: {
+            NMHDR* hdr = reinterpret_cast<NMHDR*>(lParam);
+            if (hdr->hwndFrom == g_hListView && hdr->code == LVN_GETDISPINFOW) {
+                OnGetDispInfo(reinterpret_cast<NMLVDISPINFOW*>(lParam));
             }
             break;
         }
 
+        case WM_APP_SCAN_DONE:
+            g_scans.OnDone(reinterpret_cast<ArcScanDone*>(lParam));
+            break;
+
+        case WM_APP_SCAN_PROGRESS:
+            g_scans.ShowProgressState();
+            break;
+
         case WM_SIZE: {
             RECT rc;
             GetClientRect(hwnd, &rc);
@@ -623,12 +436,14 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             SetWindowPos(g_hBtnListExtensions, NULL, 170, rc.bottom - 80, 150, 30, SWP_NOZORDER);
             SetWindowPos(g_hBtnExport, NULL, 330, rc.bottom - 80, 150, 30, SWP_NOZORDER);
             SetWindowPos(g_hProgressBar, NULL, 490, rc.bottom - 75, 200, 20, SWP_NOZORDER);
+            SetWindowPos(g_hBtnCancel, NULL, 700, rc.bottom - 80, 100, 30, SWP_NOZORDER);
 
             SendMessageW(g_hStatusBar, WM_SIZE, 0, 0);
             break;
         }
 
         case WM_DESTROY:
+            g_scans.Shutdown();
             PostQuitMessage(0);
             break;
 
@@ -0,0 +1,920 @@
+// ArcBench.cpp - Benchmarks des sondes sur arbres d'agent synthetiques, avec reference de non-regression
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Compilation: go.sh / go.bat bench (lie le moteur complet et la plateforme native)
+// Usage: ArcBench [--scales 1,4,16] [--runs N] [--jobs N] [--only CAS] [--fixtures DIR] [--keep]
+//                 [--baseline FICHIER] [--save-baseline FICHIER] [--tolerance PCT]
+//
+// Pour chaque echelle, un arbre d'agent est genere (ArcFixtures) puis chaque cas est execute
+// --runs fois: meilleur temps, debit et pic memoire (croissance du pic de la memoire residente
+// pendant le cas). Les resultats des sondes sont verifies contre les valeurs attendues de
+// l'arbre: un resultat faux fait echouer l'execution au meme titre qu'une regression.
+//
+// Fichier de reference (texte, une mesure par ligne, '#' = commentaire):
+//   <cas> <echelle> <ms> <pic Ko>
+// Une mesure regresse si elle depasse la reference de plus de --tolerance pour cent (20 par
+// defaut) et d'un plancher absolu (0,5 ms, 1 Mo) qui absorbe le bruit des petites valeurs.
+// La reference depend de la machine: l'enregistrer (--save-baseline) sur la machine de
+// compilation du parc, puis comparer chaque nouvelle version a celle-ci (--baseline).
+// Code de sortie: 0 succes, 1 regression ou resultat faux, 64 ligne de commande invalide.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#elif defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include "../ArcCache.h"
+#include "../ArcConnectivity.h"
+#include "../ArcExport.h"
+#include "../ArcFleet.h"
+#include "../ArcHistory.h"
+#include "../ArcJson.h"
+#include "../ArcLogScan.h"
+#include "../ArcMetrics.h"
+#include "../ArcRules.h"
+#include "../ArcSampler.h"
+#include "../ArcScan.h"
+#include "../ArcText.h"
+#include "../ArcTime.h"
+#include "ArcFixtures.h"
+#include "ArcLoopback.h"
+
+namespace {
+
+// ======================== Memory ========================
+// Octets residents: courant et pic depuis la derniere remise a zero. Linux: VmHWM remis au
+// niveau courant via /proc/self/clear_refs. Windows: le pic du processus ne se remet pas a
+// zero; les cas etant executes par echelle croissante, la croissance reste comparable.
+uint64_t ResidentBytes(bool peak) {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters = { sizeof(counters) };
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return peak ? counters.PeakWorkingSetSize : counters.WorkingSetSize;
+#else
+    std::ifstream status("/proc/self/status");
+    const char* key = peak ? "VmHWM:" : "VmRSS:";
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, strlen(key), key) == 0) return std::strtoull(line.c_str() + strlen(key), nullptr, 10) * 1024;
+    }
+    return 0;
+#endif
+}
+
+// Le tas libere par le cas precedent est rendu au systeme: sa reutilisation masquerait la croissance
+void ResetPeakMemory() {
+#ifndef _WIN32
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+    std::ofstream clear("/proc/self/clear_refs");
+    clear << "5";
+#endif
+}
+
+// ======================== Cases ========================
+struct BenchVolume {
+    double amount = 0.0;        // Unites traitees par execution (debit = amount / s)
+    const char* unit = "Mo";
+};
+
+struct BenchCase {
+    const char* name;
+    std::function<BenchVolume()> run;
+    std::function<std::string()> verify;    // Vide = resultat conforme, sinon description de l'ecart
+    std::function<void()> setup = {};       // Preparation non mesuree (document en memoire, cache amorce)
+};
+
+struct BenchMeasure {
+    std::string name;
+    unsigned scale = 0;
+    double bestMs = 0.0;
+    uint64_t peakBytes = 0;
+    BenchVolume volume;
+};
+
+double Megabytes(uint64_t bytes) { return bytes / (1024.0 * 1024.0); }
+
+BenchMeasure Measure(const BenchCase& c, unsigned scale, int runs) {
+    BenchMeasure m;
+    m.name = c.name;
+    m.scale = scale;
+    m.bestMs = 1e300;
+    if (c.setup) c.setup();
+    for (int r = 0; r < runs; r++) {
+        ResetPeakMemory();
+        const uint64_t before = ResidentBytes(false);
+        auto t0 = std::chrono::steady_clock::now();
+        m.volume = c.run();
+        auto t1 = std::chrono::steady_clock::now();
+        const uint64_t peak = ResidentBytes(true);
+        m.bestMs = std::min(m.bestMs, std::chrono::duration<double, std::milli>(t1 - t0).count());
+        if (peak > before) m.peakBytes = std::max(m.peakBytes, peak - before);
+    }
+    return m;
+}
+
+// Compilation et evaluation des regles, une condition par entree, sur une ligne de faits connus:
+// masques d'acceptation <,=,> de chaque operateur, colonnes numeriques et de texte, '&' entre
+// guillemets, nombres refuses. Vide = conforme, sinon la premiere entree en ecart.
+std::string CheckRuleTable() {
+    const int64_t now = 1767225600;
+    ArcComponentList facts;
+    ArcComponentInfo& fact = facts.Add(L"Extension", L"Proxy & DNS", StatusLevel::WARNING);
+    fact.version = ArcIntern(L"1.2.0");
+    fact.value = 10;
+    fact.subcode = 42;
+    fact.expiresUtc = now + 7200;
+    facts.SetDetails(fact, L"Handler A & B | Operation: Enable");
+
+    enum Outcome { Miss, Hit, Rejected };
+    static const struct { const char* condition; Outcome outcome; const wchar_t* error; } kTable[] = {
+        { "value < 10", Miss, nullptr },        { "value < 11", Hit, nullptr },
+        { "value <= 10", Hit, nullptr },        { "value <= 9", Miss, nullptr },
+        { "value = 10", Hit, nullptr },         { "value == 10", Hit, nullptr },
+        { "value = 9", Miss, nullptr },         { "value != 10", Miss, nullptr },
+        { "value != 9", Hit, nullptr },         { "value > 10", Miss, nullptr },
+        { "value > 9", Hit, nullptr },          { "value >= 10", Hit, nullptr },
+        { "value >= 11", Miss, nullptr },       { "value > -1.5", Hit, nullptr },
+        { "substatus.code = 42", Hit, nullptr }, { "substatus.code > 42", Miss, nullptr },
+        { "level = avertissement", Hit, nullptr }, { "level < erreur", Hit, nullptr },
+        { "level > ok", Hit, nullptr },         { "level = ok", Miss, nullptr },
+        { "lifetime < 2h", Miss, nullptr },     { "lifetime <= 2h", Hit, nullptr },
+        { "lifetime > 119m", Hit, nullptr },    { "lifetime < 1d", Hit, nullptr },
+        { "component = Extension", Hit, nullptr }, { "component != Extension", Miss, nullptr },
+        { "component = extension", Miss, nullptr }, { "component ~ EXTENS", Hit, nullptr },
+        { "component !~ extens", Miss, nullptr }, { "version = \"1.2.0\"", Hit, nullptr },
+        { "status = \"Proxy & DNS\"", Hit, nullptr }, { "details ~ \"A & B\"", Hit, nullptr },
+        { "details !~ \"A & B\"", Miss, nullptr }, { "alerts = \"\"", Hit, nullptr },
+        { "component = Extension & value = 10 & level = avertissement", Hit, nullptr },
+        { "component = Extension & value = 11", Miss, nullptr },
+        { "status = \"Proxy & DNS\" & value >= 10", Hit, nullptr },
+        { "value < nan", Rejected, L"nombre invalide" },
+        { "value > inf", Rejected, L"nombre invalide" },
+        { "lifetime < infh", Rejected, L"nombre invalide" },
+        { "substatus.code = 1e300", Rejected, L"nombre invalide" },
+        { "status = \"Proxy & DNS", Rejected, L"guillemet non ferme" },
+        { "status < Proxy", Rejected, L"non applicable" },
+        { "colour = red", Rejected, L"champ inconnu" },
+        { "value ~ 10", Rejected, L"comparaison invalide" },
+        { "value = 10 &", Rejected, L"comparaison attendue" },
+    };
+
+    for (size_t i = 0; i < std::size(kTable); i++) {
+        ArcRule rule;
+        rule.line = i + 1;
+        rule.level = StatusLevel::ERROR_LEVEL;
+        rule.condition = kTable[i].condition;
+        ArcRuleSet set;
+        std::wstring error;
+        const bool compiled = set.Compile({ rule }, error);
+        const std::string label = std::string("regle \"") + kTable[i].condition + "\": ";
+        if (kTable[i].outcome == Rejected) {
+            const std::wstring line = L"ligne " + std::to_wstring(i + 1) + L": ";
+            if (compiled) return label + "acceptee";
+            if (error.compare(0, line.size(), line) != 0 || error.find(kTable[i].error) == std::wstring::npos) return label + ToUtf8(error);
+            continue;
+        }
+        if (!compiled) return label + ToUtf8(error);
+        ArcComponentList list = facts;
+        const bool hit = set.Apply(list, now) == 1;
+        if (hit != (kTable[i].outcome == Hit) || (list[0].level == StatusLevel::ERROR_LEVEL) != hit) {
+            return label + (hit ? "satisfaite" : "non satisfaite");
+        }
+    }
+
+    // Premiere regle satisfaite, dans l'ordre du fichier
+    std::vector<ArcRule> ordered(3);
+    const char* const conditions[] = { "value > 100", "value = 10", "value >= 10" };
+    const StatusLevel levels[] = { StatusLevel::WARNING, StatusLevel::ERROR_LEVEL, StatusLevel::OK };
+    for (size_t k = 0; k < ordered.size(); k++) {
+        ordered[k] = { levels[k], L"Regle " + std::to_wstring(k), conditions[k], k + 1 };
+    }
+    ArcRuleSet set;
+    std::wstring error;
+    ArcComponentList list = facts;
+    if (!set.Compile(ordered, error) || set.Apply(list, now) != 1 || list[0].level != StatusLevel::ERROR_LEVEL || list.Alerts(list[0]) != L"Regle 1") {
+        return "regles: ordre d'application";
+    }
+    return std::string();
+}
+
+std::vector<BenchCase> MakeCases(ArcScanContext& ctx, const ArcFixtureExpect& expect, unsigned scale, size_t jobs) {
+    std::vector<BenchCase> cases;
+    const std::wstring statePath = ctx.platform.Join(ctx.stateDir, L"arcbench.cache");
+
+    // Etat partage par les executions d'un meme cas (resultat de la derniere, verifie ensuite)
+    auto list = std::make_shared<ArcComponentList>();
+    auto report = std::make_shared<ArcLogReport>();
+    auto text = std::make_shared<std::string>();
+    auto hits = std::make_shared<size_t>(0);
+
+    cases.push_back({ "config", [&ctx, &expect, list] {
+        list->clear();
+        ReadArcConfig(ctx, *list);
+        return BenchVolume{ Megabytes(expect.configBytes), "Mo" };
+    }, [list] {
+        if (list->size() != 1 || list->Details((*list)[0]).find(L"srv01") == std::wstring_view::npos) return std::string("configuration non lue");
+        return std::string();
+    } });
+
+    // Extraction JSON seule, document deja en memoire: projection en un passage et flux par blocs de 64 Ko
+    auto load = [&ctx, text] {
+        text->clear();
+        ctx.platform.ReadFileChunks(ctx.layout.configFile, [&](std::string_view chunk) { text->append(chunk); return true; });
+    };
+    auto found = std::make_shared<size_t>(0);
+    cases.push_back({ "json.scan", [text, found] {
+        static const JsonPathScannerA scanner({ "properties.resourceId", "properties.location", "properties.tenantId" });
+        std::vector<JsonValueA> fields;
+        scanner.Scan(*text, fields);
+        *found = std::count_if(fields.begin(), fields.end(), [](const JsonValueA& v) { return v.found(); });
+        return BenchVolume{ Megabytes(text->size()), "Mo" };
+    }, [found] { return *found == 3 ? std::string() : "3 valeurs attendues, " + std::to_string(*found) + " extraites"; }, load });
+
+    cases.push_back({ "json.stream", [text, found] {
+        JsonStreamExtractor extractor({ "properties.resourceId", "properties.location", "properties.tenantId" });
+        *found = 0;
+        for (size_t pos = 0; pos < text->size(); pos += 65536) {
+            extractor.Feed(std::string_view(*text).substr(pos, 65536), [&](size_t, std::string_view, JsonType, bool) { (*found)++; });
+        }
+        return BenchVolume{ Megabytes(text->size()), "Mo" };
+    }, [found] { return *found == 3 ? std::string() : "3 valeurs attendues, " + std::to_string(*found) + " extraites"; }, load });
+
+    cases.push_back({ "extensions", [&ctx, &expect, list] {
+        list->clear();
+        EnumerateExtensions(ctx, *list);
+        return BenchVolume{ double(expect.extensions), "ext" };
+    }, [&expect, list] {
+        if (list->size() != expect.extensions) {
+            return std::to_string(expect.extensions) + " extensions attendues, " + std::to_string(list->size()) + " trouvees";
+        }
+        return std::string();
+    } });
+
+    cases.push_back({ "credentials", [&ctx, &expect, list] {
+        list->clear();
+        CheckCredentialExpiry(ctx, *list);
+        return BenchVolume{ double(expect.credentials), "fich" };
+    }, [&expect, list] {
+        size_t dated = 0;
+        for (const auto& row : *list) dated += row.expiresUtc != 0;
+        if (dated != expect.credentials) return std::to_string(expect.credentials) + " jetons dates attendus, " + std::to_string(dated) + " lus";
+        return std::string();
+    } });
+
+    cases.push_back({ "logs", [&ctx, &expect, report] {
+        static const ArcLogMatcher matcher(DefaultLogSignatures());
+        *report = AnalyzeLogs(ctx.platform, FindAgentLogs(ctx.platform, ctx.layout), matcher, ctx.ioWorkers);
+        return BenchVolume{ Megabytes(expect.logBytes), "Mo" };
+    }, [&expect, report] {
+        static const ArcLogMatcher matcher(DefaultLogSignatures());
+        uint64_t tokens = 0, timeouts = 0;
+        for (const auto& f : report->findings) {
+            if (matcher.Label(f.label) == L"Renouvellement du jeton en echec") tokens = f.lines;
+            if (matcher.Label(f.label) == L"Delai de connexion depasse") timeouts = f.lines;
+        }
+        if (report->files != expect.logFiles || report->totalBytes != expect.logBytes) return std::string("journaux incomplets");
+        if (tokens != expect.tokenFailureLines || timeouts != expect.timeoutLines) {
+            return "lignes en echec: " + std::to_string(tokens) + "/" + std::to_string(expect.tokenFailureLines) + " jeton, "
+                + std::to_string(timeouts) + "/" + std::to_string(expect.timeoutLines) + " delai";
+        }
+        return std::string();
+    } });
+
+    // Export: 20 000 lignes par unite d'echelle, details de longueur variable
+    auto rows = std::make_shared<ArcComponentList>();
+    const size_t rowCount = 20000 * size_t(scale);
+    rows->reserve(rowCount);
+    for (size_t i = 0; i < rowCount; i++) {
+        ArcComponentInfo& row = rows->Add(i % 3 ? L"Token" : L"Microsoft.Azure.Bench.Handler" + std::to_wstring(i % 64),
+            i % 5 ? L"Valide" : L"Expire bientot", i % 5 ? StatusLevel::OK : StatusLevel::WARNING);
+        row.expiresUtc = 1748779200 + int64_t(i) * 60;
+        rows->SetDetails(row, L"Resource: /subscriptions/0000/resourceGroups/rg-" + std::to_wstring(i) + L" | \"quote\", virgule");
+    }
+    for (ArcExportFormat format : { ArcExportFormat::Csv, ArcExportFormat::JsonLines, ArcExportFormat::Columnar }) {
+        static const char* const kNames[] = { "export.csv", "export.jsonl", "export.arcb" };
+        const std::wstring path = ctx.platform.Join(ctx.stateDir, L"arcbench.export");
+        auto ok = std::make_shared<bool>(false);
+        cases.push_back({ kNames[static_cast<int>(format)], [format, path, rows, ok] {
+            auto writer = CreateResultWriter(format, path);
+            if (writer) {
+                for (const auto& row : *rows) writer->Write(L"srv01", *rows, row);
+                *ok = writer->Finish();
+            }
+            return BenchVolume{ double(rows->size()), "lig" };
+        }, [&ctx, format, path, rows, ok] {
+            if (!*ok) return std::string("ecriture en echec");
+            if (format != ArcExportFormat::Columnar) return std::string();
+            // Relecture du .arcb: chaque ligne doit revenir identique, dans l'ordre
+            std::string bytes;
+            ctx.platform.ReadFileChunks(path, [&bytes](std::string_view chunk) { bytes.append(chunk); return true; });
+            size_t index = 0;
+            size_t mismatches = 0;
+            const bool complete = ReadColumnarExport(bytes, [&](const ArcColumnarRow& r) {
+                if (index >= rows->size()) {
+                    mismatches++;
+                    return;
+                }
+                const ArcComponentInfo& row = (*rows)[index++];
+                mismatches += r.host != "srv01" || r.component != ToUtf8(ArcStrText(row.component)) || r.status != ToUtf8(ArcStrText(row.status)) ||
+                    r.level != row.level || r.expiresUtc != row.expiresUtc || r.version != ToUtf8(ArcStrText(row.version)) ||
+                    r.details != ToUtf8(rows->Details(row)) || r.alerts != ToUtf8(rows->Alerts(row));
+            });
+            if (!complete) return "arcb: decodage en echec apres " + std::to_string(index) + " lignes";
+            if (index != rows->size() || mismatches) {
+                return "arcb: " + std::to_string(index) + " lignes relues sur " + std::to_string(rows->size()) + ", " + std::to_string(mismatches) + " differente(s)";
+            }
+            if (ReadColumnarExport(std::string_view(bytes).substr(0, bytes.size() - 1), [](const ArcColumnarRow&) {})) {
+                return std::string("arcb: fichier tronque accepte");
+            }
+            return std::string();
+        } });
+    }
+
+    // Regles de sante: 50 regles (jetons, versions et codes d'extension, texte libre) evaluees
+    // sur 1 000 hotes de 64 lignes par unite d'echelle, copie de la liste comprise
+    auto host = std::make_shared<ArcComponentList>();
+    for (size_t i = 0; i < 64; i++) {
+        const bool token = i % 2 == 0;
+        ArcComponentInfo& row = host->Add(token ? L"Token" : L"Extension", token ? L"Valide" : L"Succes",
+            i % 7 ? StatusLevel::OK : StatusLevel::ERROR_LEVEL);
+        row.expiresUtc = token ? NowUtc() + int64_t(i) * 3600 + 1800 : 0;
+        row.version = ArcIntern(L"1." + std::to_wstring(i % 30) + L".0");
+        row.value = int64_t(i % 40);
+        host->SetDetails(row, L"Microsoft.Azure.Bench.Handler" + std::to_wstring(i % 10) + L" | Operation: Enable");
+    }
+    std::vector<ArcRule> definitions;
+    for (int k = 0; k < 50; k++) {
+        ArcRule rule;
+        rule.line = size_t(k) + 1;
+        rule.level = k % 2 ? StatusLevel::WARNING : StatusLevel::ERROR_LEVEL;
+        rule.alert = L"Regle " + std::to_wstring(k);
+        if (k < 10) rule.condition = "component = Token & lifetime < " + std::to_string(k + 1) + "h";
+        else if (k < 40) rule.condition = "component = Extension & version = \"1." + std::to_string(k - 10) + ".0\" & value >= " + std::to_string(k - 10);
+        else rule.condition = "component = Extension & details ~ Handler" + std::to_string(k - 40) + " & level = erreur";
+        definitions.push_back(std::move(rule));
+    }
+    auto rules = std::make_shared<ArcRuleSet>();
+    std::wstring ruleError;
+    const bool compiled = rules->Compile(definitions, ruleError);
+    auto applied = std::make_shared<size_t>(0);
+    const size_t hosts = 1000 * size_t(scale);
+    cases.push_back({ "rules", [host, rules, applied, hosts] {
+        size_t total = 0;
+        for (size_t h = 0; h < hosts; h++) {
+            ArcComponentList list = *host;
+            total += rules->Apply(list, NowUtc());
+        }
+        *applied = total;
+        return BenchVolume{ double(hosts), "hotes" };
+    }, [compiled, applied, hosts] {
+        // Jetons 0 a 8 (moins de 10 h), 22 extensions dont la valeur atteint la version, 49 (erreur)
+        const size_t expected = 5 + 22 + 1;
+        if (!compiled) return std::string("regles invalides");
+        const std::string table = CheckRuleTable();
+        if (!table.empty()) return table;
+        return *applied == expected * hosts ? std::string() : "regles: " + std::to_string(*applied / hosts) + " lignes par hote, " + std::to_string(expected) + " attendues";
+    } });
+
+    // Historique: 3 ans et 4 mois de passes (toutes les 6 h, puis toutes les 5 min sur les 40
+    // derniers jours), compacte a la derniere. Attendu, au bord exact de chaque limite:
+    //   - retention (3 ans): la passe a now - 1095 j est la premiere conservee
+    //   - jours 40 a 30: une passe par heure, plus celle qui change d'etat hors de l'heure pile
+    //   - 30 derniers jours: toutes les passes (now - 30 j compris)
+    // Relu ensuite depuis le fichier, puis altere (octet inverse, troncature, en-tete).
+    const std::wstring historyPath = ctx.platform.Join(ctx.stateDir, L"arcbench.history");
+    const int64_t historyNow = 1767225600;          // 2026-01-01 00:00 UTC, heure pile
+    const int64_t kDay = 86400;
+    auto historyLive = std::make_shared<ArcHistory>();
+    cases.push_back({ "history", [&ctx, historyPath, historyNow, kDay, historyLive, scale] {
+        std::error_code ec;
+        std::filesystem::remove(std::filesystem::path(historyPath), ec);
+        *historyLive = ArcHistory();
+        ArcHistory& history = *historyLive;
+        ArcHistoryPolicy policy;
+        policy.compactSeconds = 30 * kDay;          // Compactage a l'ajout sans reecrire le fichier chaque jour simule
+        history.Open(ctx.platform, historyPath, policy);
+
+        ArcComponentList components;
+        for (size_t c = 0; c < 16 * size_t(scale); c++) {
+            ArcComponentInfo& row = components.Add(L"Composant " + std::to_wstring(c), L"Valide", StatusLevel::OK);
+            row.expiresUtc = historyNow + int64_t(c) * kDay;
+        }
+        std::vector<ArcProbeTiming> timings(4);
+        for (size_t t = 0; t < timings.size(); t++) timings[t].probe = L"Sonde " + std::to_wstring(t);
+
+        const int64_t changeAt = historyNow - 35 * kDay + 25 * 60;       // Zone eclaircie, hors heure pile
+        const int64_t restoreAt = historyNow - 10 * kDay;                 // Pleine resolution
+        size_t appended = 0;
+        auto append = [&](int64_t t) {
+            components[0].status = ArcIntern(t >= changeAt && t < restoreAt ? L"Expire" : L"Valide");
+            components[0].level = t >= changeAt && t < restoreAt ? StatusLevel::ERROR_LEVEL : StatusLevel::OK;
+            for (size_t k = 0; k < timings.size(); k++) timings[k].wallMs = double((appended * 7 + k * 13) % 50) / 2.0;
+            const ArcHistory::EventCounts events = { appended / 1000, appended / 100, appended / 10 };
+            history.Append(t, 1, components, timings, events);
+            appended++;
+        };
+        for (int64_t t = historyNow - 1200 * kDay; t < historyNow - 40 * kDay; t += 6 * 3600) append(t);
+        for (int64_t t = historyNow - 40 * kDay; t <= historyNow; t += 300) append(t);
+        history.Compact(historyNow);
+        return BenchVolume{ double(appended), "passes" };
+    }, [&ctx, historyPath, historyNow, kDay, historyLive] {
+        const ArcHistory& live = *historyLive;
+        const size_t expected = (4640 - 420) + (240 + 1) + (30 * 288 + 1);
+        if (live.Runs() != expected) return "historique: " + std::to_string(live.Runs()) + " passes apres compactage, " + std::to_string(expected) + " attendues";
+        if (live.FirstUtc() != historyNow - 1095 * kDay || live.LastUtc() != historyNow) return std::string("historique: bornes de retention");
+        const std::vector<ArcStatusChange> changes = live.StatusChanges(0);
+        if (changes.size() != 2 || changes[0].timeUtc != historyNow - 35 * kDay + 25 * 60 || changes[0].to != L"Expire" ||
+            changes[1].timeUtc != historyNow - 10 * kDay || changes[1].to != L"Valide") {
+            return "historique: " + std::to_string(changes.size()) + " changement(s) d'etat, 2 attendus";
+        }
+
+        // Relecture: memes passes, changements, cumuls et latences que le modele en memoire
+        ArcHistory reread;
+        if (!reread.Open(ctx.platform, historyPath)) return std::string("historique: relecture refusee");
+        const std::vector<ArcStatusChange> again = reread.StatusChanges(0);
+        const std::vector<ArcLatencyStats> latLive = live.LatencyPercentiles(0), latReread = reread.LatencyPercentiles(0);
+        bool same = reread.Runs() == live.Runs() && reread.FirstUtc() == live.FirstUtc() && reread.LastUtc() == live.LastUtc() &&
+            reread.EventsSince(0) == live.EventsSince(0) && again.size() == changes.size() && latReread.size() == latLive.size();
+        for (size_t i = 0; same && i < again.size(); i++) same = again[i].timeUtc == changes[i].timeUtc && again[i].to == changes[i].to;
+        for (size_t i = 0; same && i < latLive.size(); i++) same = latReread[i].samples == latLive[i].samples && latReread[i].p90Ms == latLive[i].p90Ms;
+        if (!same) return std::string("historique: relecture differente du modele ecrit");
+
+        // Trames alterees: la passe en cause et la suite sont ignorees (controle FNV), puis
+        // le prochain ajout reecrit un fichier sain
+        std::string bytes;
+        ctx.platform.ReadFileChunks(historyPath, [&bytes](std::string_view chunk) { bytes.append(chunk); return true; });
+        const std::wstring damagedPath = historyPath + L".damaged";
+        auto reopen = [&](const std::string& content, ArcHistory& out) {
+            std::ofstream(std::filesystem::path(damagedPath), std::ios::binary | std::ios::trunc) << content;
+            return out.Open(ctx.platform, damagedPath);
+        };
+        ArcHistory damaged;
+        std::string flipped = bytes;
+        flipped[flipped.size() / 2] ^= 0x5A;
+        if (!reopen(flipped, damaged) || damaged.Runs() == 0 || damaged.Runs() >= live.Runs()) {
+            return "historique: octet altere, " + std::to_string(damaged.Runs()) + " passes relues";
+        }
+        ArcComponentList one;
+        one.Add(L"Composant 0", L"Valide", StatusLevel::OK);
+        ArcHistory repaired;
+        if (!damaged.Append(historyNow + 300, 1, one, {}, ArcHistory::EventCounts{}) || !repaired.Open(ctx.platform, damagedPath) ||
+            repaired.Runs() != damaged.Runs() || repaired.LastUtc() != historyNow + 300 || repaired.FileBytes() != damaged.FileBytes()) {
+            return std::string("historique: fichier non repare apres ajout");
+        }
+        ArcHistory torn;
+        if (!reopen(bytes.substr(0, bytes.size() - 1), torn) || torn.Runs() != live.Runs() - 1) return std::string("historique: derniere trame tronquee acceptee");
+        std::string lastFlipped = bytes;
+        lastFlipped.back() ^= 0x01;
+        if (!reopen(lastFlipped, torn) || torn.Runs() != live.Runs() - 1) return std::string("historique: controle de la derniere trame ignore");
+        std::string header = bytes;
+        header[0] = 'X';
+        if (reopen(header, torn)) return std::string("historique: en-tete invalide accepte");
+        std::error_code ec;
+        std::filesystem::remove(std::filesystem::path(damagedPath), ec);
+        return std::string();
+    } });
+
+    // Instantane des metriques publie a chaque passe: cout paye par le thread de la passe
+    auto metricsServer = std::make_shared<ArcMetricsServer>(ctx.platform);
+    auto metricsBytes = std::make_shared<std::array<size_t, 2>>();
+    const size_t snapshots = 1000 * size_t(scale);
+    cases.push_back({ "metrics", [host, metricsServer, metricsBytes, snapshots] {
+        std::vector<ArcProbeTiming> timings(8);
+        for (size_t t = 0; t < timings.size(); t++) {
+            timings[t].probe = L"Sonde " + std::to_wstring(t);
+            timings[t].wallMs = 1.5 * double(t + 1);
+        }
+        ArcEventDigest events;
+        events.levels = { 0, 3, 12, 40, 0 };
+        for (size_t n = 0; n < snapshots; n++) {
+            auto snapshot = BuildMetricsSnapshot(*host, timings, 42.0, &events, NowUtc());
+            *metricsBytes = { snapshot->prometheus.size(), snapshot->json.size() };
+            metricsServer->Publish(std::move(snapshot));
+        }
+        return BenchVolume{ double(snapshots), "instantanes" };
+    }, [metricsBytes] {
+        return (*metricsBytes)[0] && (*metricsBytes)[1] ? std::string() : std::string("metriques: instantane vide");
+    } });
+
+    // Connectivite contre le repondeur de boucle locale (ArcLoopback), serveur DNS impose comme
+    // par --dns: une issue de la boucle de sondes par point de terminaison, en direct puis a
+    // travers le proxy. Le delai par etape (250 ms) borne la duree des deux cas "delai depasse".
+    auto responder = std::make_shared<ArcLoopbackResponder>();
+    auto responderUp = std::make_shared<bool>(false);
+    auto netResults = std::make_shared<std::vector<ArcEndpointStatus>>();
+    const std::wstring noHosts = ctx.platform.Join(ctx.stateDir, L"arcbench.hosts");
+    cases.push_back({ "connectivity", [&ctx, responder, responderUp, netResults, noHosts] {
+        netResults->clear();
+        if (!*responderUp) return BenchVolume{ 0.0, "points" };
+        ArcNetworkOptions options;
+        options.timeoutMs = 250;
+        options.nameservers = { { 0x7F000001, responder->dnsPort } };
+        options.hostsFile = noHosts;
+        auto endpoint = [](const char* host, uint16_t port) {
+            ArcEndpoint e;
+            e.host = host;
+            e.port = port;
+            return e;
+        };
+        const std::vector<ArcEndpoint> direct = {
+            endpoint("ok.arc.test", responder->helloPort), endpoint("nx.arc.test", responder->helloPort),
+            endpoint("ok.arc.test", responder->refusedPort), endpoint("ok.arc.test", responder->alertPort),
+            endpoint("silent.arc.test", responder->helloPort), endpoint("ok.arc.test", responder->mutePort)
+        };
+        const std::vector<ArcEndpoint> tunneled = { endpoint("ok.arc.test", 443), endpoint("deny.arc.test", 443) };
+        ArcProxySettings proxy;
+        *netResults = ProbeEndpoints(ctx.platform, direct, proxy, options);
+        proxy.host = "proxy.arc.test";
+        proxy.port = responder->proxyPort;
+        for (auto& status : ProbeEndpoints(ctx.platform, tunneled, proxy, options)) netResults->push_back(std::move(status));
+        return BenchVolume{ double(netResults->size()), "points" };
+    }, [responder, responderUp, netResults] {
+        struct Expected {
+            ArcNetStage stage;
+            const wchar_t* error;
+            bool viaProxy;
+        };
+        static const Expected kExpected[] = {
+            { ArcNetStage::Done, L"", false },
+            { ArcNetStage::Dns, L"NXDOMAIN", false },
+            { ArcNetStage::Tcp, L"Connexion refusee", false },
+            { ArcNetStage::Tls, L"Alerte TLS handshake_failure", false },
+            { ArcNetStage::Dns, L"Delai depasse", false },
+            { ArcNetStage::Tls, L"Delai depasse", false },
+            { ArcNetStage::Done, L"", true },
+            { ArcNetStage::Proxy, L"HTTP 407", true },
+        };
+        if (!*responderUp) return std::string("connectivite: repondeur local indisponible");
+        if (netResults->size() != std::size(kExpected)) return std::string("connectivite: resultats incomplets");
+        for (size_t i = 0; i < std::size(kExpected); i++) {
+            const ArcEndpointStatus& s = (*netResults)[i];
+            const Expected& e = kExpected[i];
+            if (s.failedAt != e.stage || s.error.find(e.error) == std::wstring::npos || s.viaProxy != e.viaProxy ||
+                (e.stage == ArcNetStage::Done && s.address.ipv4 != 0x7F000001)) {
+                return "connectivite: " + s.endpoint.host + ":" + std::to_string(s.endpoint.port) + " -> etape " +
+                    std::to_string(static_cast<int>(s.failedAt)) + " \"" + ToUtf8(s.error) + "\"";
+            }
+        }
+        // Formats construits par le moteur, vus du serveur
+        auto seen = [](const std::vector<std::string>& list, const char* value) {
+            return std::find(list.begin(), list.end(), value) != list.end();
+        };
+        const std::vector<std::string> names = responder->DnsNames();
+        const std::vector<std::string> sni = responder->SniNames();
+        const std::vector<std::string> targets = responder->ConnectTargets();
+        if (responder->Malformed()) return std::to_string(responder->Malformed()) + " requete(s) DNS / ClientHello / CONNECT malformee(s)";
+        if (!seen(names, "nx.arc.test") || !seen(names, "silent.arc.test") || !seen(names, "proxy.arc.test")) return std::string("connectivite: requetes DNS manquantes");
+        if (!seen(sni, "ok.arc.test")) return std::string("connectivite: SNI absent du ClientHello");
+        if (!seen(targets, "ok.arc.test:443") || !seen(targets, "deny.arc.test:443")) return std::string("connectivite: CONNECT manquant");
+        return std::string();
+    }, [responder, responderUp] {
+        if (!*responderUp) *responderUp = responder->Start();
+    } });
+
+    // Index des processus sur 20 000 entrees par unite d'echelle, noms tronques comme le champ comm
+    // de /proc/<pid>/stat (gc_extension_service -> gc_extension_se): chaque processus surveille
+    // doit etre trouve, avec ses gestionnaires, et les leurres au nom plus court ignores
+    const size_t processCount = 20000 * size_t(scale);
+    auto processTable = std::make_shared<std::vector<ArcProcessEntry>>();
+    auto processIndex = std::make_shared<ArcProcessIndex>();
+    auto processHits = std::make_shared<size_t>(0);
+    constexpr size_t kHandlers = 6;
+    // Disposition d'artefacts sans processus: liste reelle de la plateforme (himds, gc_linux_service, ...)
+    const std::vector<ArcWatchedProcess> watchedProcesses = ctx.platform.DefaultLayout().processes;
+    cases.push_back({ "processes", [watchedProcesses, processTable, processIndex, processHits] {
+        processIndex->Build(*processTable);
+        size_t hits = 0;
+        for (const auto& watched : watchedProcesses) hits += processIndex->Find(watched.image).size();
+        *processHits = hits;
+        return BenchVolume{ double(processTable->size()), "processus" };
+    }, [&ctx, watchedProcesses, processIndex, processHits, kHandlers] {
+        if (*processHits != watchedProcesses.size()) {
+            return "processus: " + std::to_string(*processHits) + " instances trouvees, " + std::to_string(watchedProcesses.size()) + " attendues";
+        }
+        ArcScanContext local(ctx.platform);     // Disposition par defaut: memes processus surveilles
+        ArcComponentList rows;
+        CheckArcProcesses(local, *processIndex, rows);
+        if (rows.size() != watchedProcesses.size()) return "processus: " + std::to_string(rows.size()) + " lignes";
+        for (size_t i = 0; i < rows.size(); i++) {
+            const ArcWatchedProcess& watched = watchedProcesses[i];
+            if (ArcStrText(rows[i].component) != watched.component || ArcStrText(rows[i].status) != L"En cours d'execution") {
+                return "processus: " + ToUtf8(watched.image) + " " + ToUtf8(ArcStrText(rows[i].status));
+            }
+            const std::wstring handlers = L"Gestionnaires d'extensions: " + std::to_wstring(kHandlers);
+            if (watched.hostsHandlers && rows.Details(rows[i]).find(handlers) == std::wstring_view::npos) {
+                return "processus: " + ToUtf8(watched.image) + " " + ToUtf8(std::wstring(rows.Details(rows[i])));
+            }
+        }
+        return std::string();
+    }, [watchedProcesses, processTable, processCount, kHandlers] {
+        if (processTable->empty()) *processTable = GenerateProcessTable(watchedProcesses, processCount, kHandlers);
+    } });
+
+    // Echantillonnage des ressources: 16 processus reels, 100 releves et lectures par unite d'echelle
+    auto sampler = std::make_shared<ArcResourceSampler>(ctx.platform);
+    auto sampledPids = std::make_shared<std::vector<uint32_t>>();
+    auto sampledOk = std::make_shared<size_t>(0);
+    const size_t ticks = 100 * size_t(scale);
+    cases.push_back({ "sampler", [sampler, sampledPids, sampledOk, ticks] {
+        size_t ok = 0;
+        for (size_t t = 0; t < ticks; t++) {
+            sampler->SampleNow();
+            ArcResourceStatus status;
+            for (uint32_t pid : *sampledPids) ok += sampler->Status(pid, status);
+        }
+        *sampledOk = ok;
+        return BenchVolume{ double(ticks * sampledPids->size()), "releves" };
+    }, [sampledPids, sampledOk] {
+        return !sampledPids->empty() && *sampledOk ? std::string() : std::string("sampler: aucun processus suivi");
+    }, [&ctx, sampler, sampledPids] {
+        std::vector<ArcProcessEntry> entries;
+        ctx.platform.SnapshotProcesses(entries);
+        sampledPids->clear();
+        for (size_t i = 0; i < entries.size() && sampledPids->size() < 16; i++) sampledPids->push_back(entries[i].pid);
+        sampler->Track(*sampledPids);
+    } });
+
+    // Parc de 16 hotes identiques par unite d'echelle (journaux reduits): sans puis avec deduplication
+    // par contenu. Memes resultats attendus; avec deduplication, seul le premier hote est analyse.
+    const std::wstring fleetDir = ctx.platform.Join(ctx.stateDir, L"fleet");
+    const size_t fleetHosts = 16 * size_t(scale);
+    auto fleetReady = std::make_shared<bool>(false);
+    auto prepareFleet = [fleetDir, fleetHosts, fleetReady, &ctx] {
+        if (*fleetReady) return;
+        ArcFixtureSpec hostSpec;
+        hostSpec.logBytes = 256u << 10;
+        hostSpec.extensionLogBytes = 64u << 10;
+        ArcFixtureExpect hostExpect;
+        bool ok = true;
+        for (size_t h = 0; h < fleetHosts; h++) ok &= GenerateAgentTree(ctx.platform.Join(fleetDir, L"hote" + std::to_wstring(h)), hostSpec, hostExpect);
+        *fleetReady = ok;
+    };
+    auto fleetRows = std::make_shared<std::array<size_t, 2>>();
+    auto fleetHitRate = std::make_shared<double>(0.0);
+    for (const bool dedup : { false, true }) {
+        cases.push_back({ dedup ? "fleet.dedup" : "fleet", [&ctx, fleetDir, fleetHosts, fleetRows, fleetHitRate, jobs, dedup] {
+            ArcFleetOptions options;
+            options.maxWorkers = jobs;
+            options.dedup = dedup;
+            const ArcFleetReport report = RunFleetScan(ctx.platform, fleetDir, options);
+            size_t rows = 0;
+            for (const auto& host : report.hosts) rows += host.components.size();
+            (*fleetRows)[dedup] = rows;
+            if (dedup) *fleetHitRate = report.dedupLookups ? double(report.dedupHits) / report.dedupLookups : 0.0;
+            return BenchVolume{ double(fleetHosts), "hotes" };
+        }, [fleetReady, fleetRows, fleetHitRate, fleetHosts, dedup] {
+            if (!*fleetReady) return std::string("parc: generation impossible");
+            if (!(*fleetRows)[dedup]) return std::string("parc: aucun composant");
+            if (!dedup) return std::string();
+            if ((*fleetRows)[0] && (*fleetRows)[0] != (*fleetRows)[1]) {
+                return "parc: " + std::to_string((*fleetRows)[1]) + " lignes avec deduplication, " + std::to_string((*fleetRows)[0]) + " sans";
+            }
+            const double expected = double(fleetHosts - 1) / fleetHosts;
+            return *fleetHitRate + 1e-9 >= expected ? std::string() : "parc: deduplication " + std::to_string(*fleetHitRate) + ", attendu " + std::to_string(expected);
+        }, prepareFleet });
+    }
+
+    // Passe complete hors processus, journal d'evenements et reseau: sans cache, puis cache chaud
+    const uint32_t probes = ArcProbeConfig | ArcProbeCredentials | ArcProbeLogs | ArcProbeExtensions;
+    auto slots = std::make_shared<ArcProbeSlots>();
+    cases.push_back({ "scan", [&ctx, &expect, probes, slots, jobs] {
+        ctx.cache = nullptr;
+        RunProbes(ctx, probes, *slots, jobs);
+        return BenchVolume{ Megabytes(expect.configBytes + expect.statusBytes + expect.logBytes), "Mo" };
+    }, [&expect, slots] {
+        const size_t rowsExpected = 1 + expect.credentials + expect.extensions;
+        const size_t rowsFound = slots->config.size() + slots->credentials.size() + slots->extensions.size();
+        return rowsFound == rowsExpected ? std::string() : std::string("passe incomplete");
+    } });
+
+    auto cache = std::make_shared<ArcResultCache>();
+    cases.push_back({ "scan.cache", [&ctx, &expect, probes, slots, jobs, cache, hits] {
+        ctx.cache = cache.get();
+        const size_t before = cache->Hits();
+        RunProbes(ctx, probes, *slots, jobs);
+        *hits = cache->Hits() - before;
+        ctx.cache = nullptr;
+        return BenchVolume{ Megabytes(expect.configBytes + expect.statusBytes + expect.logBytes), "Mo" };
+    }, [&expect, hits] {
+        const size_t entries = 1 + expect.credentials + expect.extensions;
+        return *hits >= entries ? std::string() : "cache: " + std::to_string(*hits) + " succes pour " + std::to_string(entries) + " fichiers";
+    }, [&ctx, probes, slots, jobs, cache, statePath] {
+        cache->Open(ctx.platform, statePath);
+        ctx.cache = cache.get();
+        RunProbes(ctx, probes, *slots, jobs);
+        ctx.cache = nullptr;
+    } });
+    return cases;
+}
+
+// ======================== Baseline ========================
+using Baseline = std::map<std::pair<std::string, unsigned>, std::pair<double, uint64_t>>;
+
+bool LoadBaseline(const std::string& path, Baseline& out) {
+    std::ifstream file(std::filesystem::u8path(path));
+    if (!file) return false;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        std::string name;
+        unsigned scale = 0;
+        double ms = 0.0;
+        uint64_t peakKb = 0;
+        if (fields >> name >> scale >> ms >> peakKb) out[{ name, scale }] = { ms, peakKb * 1024 };
+    }
+    return true;
+}
+
+bool SaveBaseline(const std::string& path, const std::vector<BenchMeasure>& measures) {
+    std::ofstream file(std::filesystem::u8path(path), std::ios::trunc);
+    file << "# ArcBench - reference: cas echelle ms pic_Ko\n";
+    for (const auto& m : measures) {
+        char line[160];
+        snprintf(line, sizeof(line), "%s %u %.3f %llu\n", m.name.c_str(), m.scale, m.bestMs,
+            static_cast<unsigned long long>(m.peakBytes / 1024));
+        file << line;
+    }
+    return static_cast<bool>(file);
+}
+
+// Nombre de regressions, detaillees sur la sortie standard
+size_t CompareBaseline(const Baseline& baseline, const std::vector<BenchMeasure>& measures, double tolerance) {
+    size_t regressions = 0;
+    for (const auto& m : measures) {
+        auto it = baseline.find({ m.name, m.scale });
+        if (it == baseline.end()) {
+            printf("  %-14s x%-3u absent de la reference\n", m.name.c_str(), m.scale);
+            continue;
+        }
+        const double refMs = it->second.first;
+        const uint64_t refPeak = it->second.second;
+        if (m.bestMs > refMs * (1.0 + tolerance) && m.bestMs - refMs > 0.5) {
+            printf("  REGRESSION %-14s x%-3u temps %.3f ms (reference %.3f ms, %+.0f%%)\n", m.name.c_str(), m.scale, m.bestMs, refMs,
+                (m.bestMs / refMs - 1.0) * 100.0);
+            regressions++;
+        }
+        if (m.peakBytes > refPeak * (1.0 + tolerance) && m.peakBytes - refPeak > (1u << 20)) {
+            printf("  REGRESSION %-14s x%-3u memoire %.1f Mo (reference %.1f Mo)\n", m.name.c_str(), m.scale, Megabytes(m.peakBytes),
+                Megabytes(refPeak));
+            regressions++;
+        }
+    }
+    return regressions;
+}
+
+// ======================== Command Line ========================
+void Usage() {
+    printf("Usage: ArcBench [--scales 1,4,16] [--runs N] [--jobs N] [--only CAS] [--fixtures DIR] [--keep]\n");
+    printf("                [--baseline FICHIER] [--save-baseline FICHIER] [--tolerance PCT]\n");
+    printf("  --scales      Echelles des arbres generes (x1: 8 extensions x 3 versions x 4 statuts, 32 jetons, 8 Mo de journaux)\n");
+    printf("  --only        Cas dont le nom commence par CAS (config, json, extensions, credentials, logs, export, history, connectivity, scan)\n");
+    printf("  --fixtures    Repertoire des arbres generes (defaut: repertoire temporaire), supprime sauf --keep\n");
+    printf("  --baseline    Compare a la reference; code 1 en cas de regression\n");
+    printf("  --tolerance   Ecart tolere avant regression, en pour cent (defaut 20)\n");
+}
+
+bool ParseScales(const char* text, std::vector<unsigned>& out) {
+    out.clear();
+    std::istringstream list(text);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        const unsigned long value = std::strtoul(item.c_str(), nullptr, 10);
+        if (value == 0 || value > 1024) return false;
+        out.push_back(static_cast<unsigned>(value));
+    }
+    return !out.empty();
+}
+
+ArcFixtureSpec SpecForScale(unsigned scale) {
+    ArcFixtureSpec spec;
+    spec.configBytes = uint64_t(scale) * (64u << 10);
+    spec.tokens = size_t(scale) * 32;
+    spec.plugins = size_t(scale) * 8;
+    spec.logBytes = uint64_t(scale) * (8u << 20);
+    spec.extensionLogBytes = uint64_t(scale) * (512u << 10);
+    return spec;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<unsigned> scales = { 1, 4, 16 };
+    int runs = 5;
+    size_t jobs = 4;
+    std::string only, baselinePath, savePath;
+    std::wstring fixturesDir;
+    bool keep = false;
+    double tolerance = 0.20;
+
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--scales") == 0 && hasValue) {
+            if (!ParseScales(argv[++i], scales)) { Usage(); return 64; }
+        } else if (strcmp(argv[i], "--runs") == 0 && hasValue) {
+            runs = std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--jobs") == 0 && hasValue) {
+            jobs = static_cast<size_t>(std::max(1, atoi(argv[++i])));
+        } else if (strcmp(argv[i], "--only") == 0 && hasValue) {
+            only = argv[++i];
+        } else if (strcmp(argv[i], "--fixtures") == 0 && hasValue) {
+            fixturesDir = FromUtf8(argv[++i]);
+        } else if (strcmp(argv[i], "--keep") == 0) {
+            keep = true;
+        } else if (strcmp(argv[i], "--baseline") == 0 && hasValue) {
+            baselinePath = argv[++i];
+        } else if (strcmp(argv[i], "--save-baseline") == 0 && hasValue) {
+            savePath = argv[++i];
+        } else if (strcmp(argv[i], "--tolerance") == 0 && hasValue) {
+            tolerance = atof(argv[++i]) / 100.0;
+            if (tolerance < 0.0) { Usage(); return 64; }
+        } else {
+            Usage();
+            return 64;
+        }
+    }
+
+    Baseline baseline;
+    if (!baselinePath.empty() && !LoadBaseline(baselinePath, baseline)) {
+        printf("Reference illisible: %s\n", baselinePath.c_str());
+        return 64;
+    }
+
+    std::unique_ptr<IArcPlatform> platform = CreateNativePlatform();
+    if (fixturesDir.empty()) fixturesDir = platform->Join(platform->TempDirectory(), L"arcbench");
+
+    std::vector<BenchMeasure> measures;
+    size_t failures = 0;
+    for (unsigned scale : scales) {
+        const std::wstring root = platform->Join(fixturesDir, L"x" + std::to_wstring(scale));
+        const ArcFixtureSpec spec = SpecForScale(scale);
+        ArcFixtureExpect expect;
+        auto g0 = std::chrono::steady_clock::now();
+        if (!GenerateAgentTree(root, spec, expect)) {
+            printf("Generation impossible: %s\n", ToUtf8(root).c_str());
+            return 1;
+        }
+        const double genMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - g0).count();
+        printf("== x%u: %zu ext x %zu versions x %zu statuts, %zu jetons, %.1f Mo de journaux (genere en %.0f ms)\n", scale,
+            spec.plugins, spec.versions, spec.statusFiles, spec.tokens, Megabytes(expect.logBytes), genMs);
+
+        ArcScanContext ctx(*platform);
+        ctx.layout = ArtifactLayout(*platform, root);
+        ctx.stateDir = root;
+        ctx.ioWorkers = jobs;
+        ctx.network.enabled = false;
+
+        for (const BenchCase& c : MakeCases(ctx, expect, scale, jobs)) {
+            if (!only.empty() && strncmp(c.name, only.c_str(), only.size()) != 0) continue;
+            const BenchMeasure m = Measure(c, scale, runs);
+            const std::string error = c.verify();
+            printf("%-14s x%-3u %10.3f ms %11.1f %s/s   pic %7.1f Mo%s%s\n", m.name.c_str(), scale, m.bestMs,
+                m.volume.amount / (m.bestMs / 1000.0), m.volume.unit, Megabytes(m.peakBytes),
+                error.empty() ? "" : "   ERREUR: ", error.c_str());
+            failures += !error.empty();
+            measures.push_back(m);
+        }
+        if (!keep) RemoveAgentTree(root);
+    }
+    if (!keep) {
+        std::error_code ec;
+        std::filesystem::remove(std::filesystem::path(fixturesDir), ec);
+    }
+
+    if (!savePath.empty()) {
+        if (!SaveBaseline(savePath, measures)) {
+            printf("Impossible d'ecrire la reference: %s\n", savePath.c_str());
+            return 1;
+        }
+        printf("Reference enregistree: %s\n", savePath.c_str());
+    }
+
+    size_t regressions = 0;
+    if (!baselinePath.empty()) {
+        printf("Comparaison a %s (tolerance %.0f%%)\n", baselinePath.c_str(), tolerance * 100.0);
+        regressions = CompareBaseline(baseline, measures, tolerance);
+        printf("%zu regression(s)\n", regressions);
+    }
+    if (failures) printf("%zu cas en erreur\n", failures);
+    return regressions || failures ? 1 : 0;
+}
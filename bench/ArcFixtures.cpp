@@ -0,0 +1,257 @@
+// ArcFixtures.cpp - Generation d'arbres d'agent synthetiques pour les benchmarks
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#include "ArcFixtures.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+
+#include "../ArcText.h"
+#include "../ArcTime.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// ======================== Helpers ========================
+// xorshift64: deterministe et identique sur toutes les plateformes
+class FixtureRandom {
+public:
+    uint64_t Next() {
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 7;
+        state_ ^= state_ << 17;
+        return state_;
+    }
+    size_t Below(size_t n) { return static_cast<size_t>(Next() % n); }
+
+private:
+    uint64_t state_ = 0x9E3779B97F4A7C15ull;
+};
+
+bool WriteFile(const fs::path& path, std::string_view content) {
+    std::error_code ec;
+    fs::create_directories(path.parent_path(), ec);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(content.data(), static_cast<std::streamsize>(content.size()));
+    return static_cast<bool>(file);
+}
+
+std::string Base64Url(std::string_view bytes) {
+    static const char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+    std::string out;
+    size_t i = 0;
+    for (; i + 2 < bytes.size(); i += 3) {
+        const uint32_t v = (uint8_t(bytes[i]) << 16) | (uint8_t(bytes[i + 1]) << 8) | uint8_t(bytes[i + 2]);
+        out += kAlphabet[v >> 18];
+        out += kAlphabet[(v >> 12) & 63];
+        out += kAlphabet[(v >> 6) & 63];
+        out += kAlphabet[v & 63];
+    }
+    if (i < bytes.size()) {
+        uint32_t v = uint8_t(bytes[i]) << 16;
+        if (i + 1 < bytes.size()) v |= uint8_t(bytes[i + 1]) << 8;
+        out += kAlphabet[v >> 18];
+        out += kAlphabet[(v >> 12) & 63];
+        if (i + 1 < bytes.size()) out += kAlphabet[(v >> 6) & 63];
+    }
+    return out;
+}
+
+std::string Iso(int64_t utc) {
+    return ToUtf8(FormatUtc(utc));
+}
+
+const int64_t kBaseUtc = 1748779200;    // 2025-06-01T12:00:00Z
+
+// ======================== Config ========================
+std::string MakeConfig(uint64_t targetBytes) {
+    std::string doc = "{\"extensions\":[";
+    for (size_t n = 0; doc.size() < targetBytes; n++) {
+        if (n) doc += ',';
+        doc += "{\"name\":\"ext" + std::to_string(n) + "\",\"settings\":{\"endpoint\":\"https://contoso.example/"
+             + std::to_string(n) + "\",\"note\":\"valeur \\\"quotee\\\" et {accolades}\"}}";
+    }
+    doc += "],\"properties\":{\"resourceId\":\"/subscriptions/0000/resourceGroups/rg/providers/Microsoft.HybridCompute/machines/srv01\","
+           "\"location\":\"westeurope\",\"tenantId\":\"72f988bf-86f1-41af-91ab-2d7cd011db47\",\"cloud\":\"AzureCloud\"}}";
+    return doc;
+}
+
+// ======================== Tokens ========================
+std::string MakeToken(size_t i, int64_t expiresUtc) {
+    switch (i % 3) {
+        case 0:
+            return "{\"resource\":\"https://management.azure.com\",\"tokenType\":\"Bearer\",\"expiresOn\":\""
+                + Iso(expiresUtc) + "\",\"accessToken\":\"" + std::string(1024, 'x') + "\"}";
+        case 1: {
+            const std::string header = Base64Url("{\"alg\":\"RS256\",\"typ\":\"JWT\"}");
+            const std::string payload = Base64Url("{\"aud\":\"https://management.azure.com\",\"iss\":\"https://sts.windows.net/\","
+                "\"exp\":" + std::to_string(expiresUtc) + "}");
+            return header + "." + payload + "." + Base64Url(std::string(256, '\x5A'));
+        }
+        default:
+            return "{\"expires_on\":" + std::to_string(expiresUtc) + ",\"token_type\":\"Bearer\"}";
+    }
+}
+
+// ======================== Extension Status ========================
+std::string MakeStatus(const std::string& handler, size_t sequence, uint64_t targetBytes, FixtureRandom& random) {
+    static const char* const kStates[] = { "success", "success", "success", "transitioning", "warning", "error" };
+    const char* state = kStates[random.Below(6)];
+    std::string message;
+    while (message.size() + 384 < targetBytes) message += "Ligne de trace \\\"handler\\\" ok\\n";
+    return "[{\"version\":1.0,\"timestampUTC\":\"" + Iso(kBaseUtc + static_cast<int64_t>(sequence) * 60) + "\",\"status\":{\"name\":\""
+        + handler + "\",\"operation\":\"Enable\",\"status\":\"" + state + "\",\"code\":" + std::to_string(sequence)
+        + ",\"formattedMessage\":{\"lang\":\"en-US\",\"message\":\"" + message
+        + "\"},\"substatus\":[{\"name\":\"StdOut\",\"status\":\"success\",\"code\":0},{\"name\":\"StdErr\",\"status\":\""
+        + (state[0] == 'e' ? "error" : "success") + "\",\"code\":52}]}}]";
+}
+
+// ======================== Logs ========================
+// Lignes ordinaires, 1 sur 97 en echec de jeton, 1 sur 211 en delai depasse
+struct LogWriter {
+    uint64_t tokenFailures = 0;
+    uint64_t timeouts = 0;
+
+    bool Write(const fs::path& path, uint64_t targetBytes, int64_t startUtc, FixtureRandom& random) {
+        std::error_code ec;
+        fs::create_directories(path.parent_path(), ec);
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        static const char* const kLines[] = {
+            " INFO [himds] Heartbeat sent to https://gbl.his.arc.azure.com status=200 latency=",
+            " DEBUG [himds] Refreshing instance metadata cache entries=",
+            " INFO [azcmagent] Extension manager poll completed, pending operations=",
+            " INFO [himds] Identity endpoint request served pid=",
+        };
+        std::string buffer;
+        buffer.reserve(1u << 20);
+        uint64_t written = 0;
+        uint64_t line = 0;
+        std::string stamp;
+        while (written < targetBytes) {
+            if (line % 8 == 0) stamp = Iso(startUtc + static_cast<int64_t>(line / 8));
+            std::string text = stamp;
+            if (line % 97 == 13) {
+                text += " ERROR [himds] failed to refresh token: AADSTS700024 Client assertion is not within its valid time range";
+                tokenFailures++;
+            } else if (line % 211 == 7) {
+                text += " WARN [azcmagent] Post \"https://agentserviceapi.guestconfiguration.azure.com\": context deadline exceeded";
+                timeouts++;
+            } else {
+                text += kLines[random.Below(4)] + std::to_string(random.Below(100000));
+            }
+            text += '\n';
+            buffer += text;
+            written += text.size();
+            line++;
+            if (buffer.size() >= (1u << 20)) {
+                file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                buffer.clear();
+            }
+        }
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        return static_cast<bool>(file);
+    }
+};
+
+} // namespace
+
+// ======================== Tree ========================
+bool GenerateAgentTree(const std::wstring& root, const ArcFixtureSpec& spec, ArcFixtureExpect& expect) {
+    RemoveAgentTree(root);
+    expect = ArcFixtureExpect();
+    FixtureRandom random;
+    const fs::path base(root);
+    bool ok = true;
+
+    const std::string config = MakeConfig(spec.configBytes);
+    ok &= WriteFile(base / "Config" / "agentconfig.json", config);
+    expect.configBytes = config.size();
+
+    for (size_t i = 0; i < spec.tokens; i++) {
+        // Echeances etalees de -2 a +60 jours autour de la date de reference
+        const int64_t expires = kBaseUtc + (static_cast<int64_t>(random.Below(62 * 24)) - 48) * 3600;
+        static const char* const kSuffix[] = { ".json", ".jwt", ".epoch.json" };
+        ok &= WriteFile(base / "Tokens" / (std::to_string(i) + kSuffix[i % 3]), MakeToken(i, expires));
+        expect.credentials++;
+    }
+    std::error_code ec;
+    fs::create_directories(base / "Certs", ec);
+
+    for (size_t p = 0; p < spec.plugins; p++) {
+        const std::string handler = "Microsoft.Azure.Bench.Handler" + std::to_string(p);
+        for (size_t v = 0; v < spec.versions; v++) {
+            const std::string version = "1." + std::to_string(v) + "." + std::to_string(p % 7);
+            for (size_t s = 0; s < spec.statusFiles; s++) {
+                const std::string status = MakeStatus(handler, s, spec.statusBytes, random);
+                ok &= WriteFile(base / "Plugins" / handler / version / "status" / (std::to_string(s) + ".status"), status);
+                if (v + 1 == spec.versions && s + 1 == spec.statusFiles) expect.statusBytes += status.size();
+            }
+        }
+        expect.extensions++;
+    }
+
+    // Journal courant et rotations de meme taille, du plus ancien au plus recent
+    LogWriter logs;
+    const size_t logParts = spec.logRotations + 1;
+    for (size_t r = 0; r < logParts; r++) {
+        const std::string name = r == 0 ? "himds.log" : "himds.log." + std::to_string(r);
+        ok &= logs.Write(base / "Log" / name, spec.logBytes / logParts, kBaseUtc - static_cast<int64_t>(r) * 86400, random);
+        expect.logFiles++;
+    }
+    for (size_t p = 0; p < spec.plugins && spec.extensionLogBytes; p++) {
+        const std::string handler = "Microsoft.Azure.Bench.Handler" + std::to_string(p);
+        ok &= logs.Write(base / "extension_logs" / handler / "CommandExecution.log", spec.extensionLogBytes / spec.plugins, kBaseUtc, random);
+        expect.logFiles++;
+    }
+    expect.tokenFailureLines = logs.tokenFailures;
+    expect.timeoutLines = logs.timeouts;
+    for (const auto& entry : fs::recursive_directory_iterator(base / "Log", ec)) {
+        if (entry.is_regular_file()) expect.logBytes += entry.file_size();
+    }
+    for (const auto& entry : fs::recursive_directory_iterator(base / "extension_logs", ec)) {
+        if (entry.is_regular_file()) expect.logBytes += entry.file_size();
+    }
+    return ok;
+}
+
+void RemoveAgentTree(const std::wstring& root) {
+    std::error_code ec;
+    fs::remove_all(fs::path(root), ec);
+}
+
+// ======================== Processes ========================
+std::vector<ArcProcessEntry> GenerateProcessTable(const std::vector<ArcWatchedProcess>& watched, size_t processes, size_t handlers) {
+    constexpr size_t kComm = 15;
+    std::vector<ArcProcessEntry> table;
+    table.reserve(processes + watched.size() * (handlers + 2));
+    uint32_t next = 1000000;
+    auto add = [&](uint32_t parent, std::wstring name) {
+        ArcProcessEntry entry;
+        entry.pid = next++;
+        entry.parentPid = parent;
+        entry.name = std::move(name);
+        table.push_back(std::move(entry));
+        return table.back().pid;
+    };
+
+    const uint32_t init = add(0, L"systemd");
+    for (const auto& w : watched) {
+        // Leurre: prefixe plus court que comm, ne doit pas etre pris pour le service
+        if (w.image.size() > kComm) add(init, w.image.substr(0, kComm - 1));
+        const uint32_t pid = add(init, w.image.substr(0, kComm));
+        for (size_t h = 0; w.hostsHandlers && h < handlers; h++) add(pid, L"enable.sh");
+    }
+    // Processus sans rapport, fils d'init ou les uns des autres (jamais d'un processus surveille)
+    FixtureRandom random;
+    const size_t unrelated = table.size();
+    while (table.size() < processes) {
+        static const wchar_t* const kNames[] = { L"kworker/", L"sshd", L"bash", L"containerd-shim", L"python3" };
+        const size_t pick = random.Below(std::size(kNames));
+        const size_t parent = random.Below(table.size() - unrelated + 1);
+        add(parent ? table[unrelated + parent - 1].pid : init, kNames[pick] + (pick ? std::wstring() : std::to_wstring(table.size())));
+    }
+    return table;
+}
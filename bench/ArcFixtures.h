@@ -0,0 +1,54 @@
+// ArcFixtures.h - Generation d'arbres d'agent synthetiques pour les benchmarks
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Disposition d'artefacts de parc (voir ArtifactLayout), lisible sur toutes les plateformes:
+//   Config/agentconfig.json                      configuration gonflee d'un bloc d'extensions
+//   Tokens/<i>.json | <i>.jwt | <i>.epoch.json   metadonnees de jetons (ISO-8601, JWT, epoch)
+//   Plugins/<nom>/<version>/status/<N>.status    N extensions x M versions x K statuts
+//   Log/himds.log (+ rotations .log.N)           journaux horodates, lignes d'echec dispersees
+//   extension_logs/<nom>/CommandExecution.log
+// Table de processus synthetique (voir GenerateProcessTable), sans fichier.
+// Le contenu est deterministe (generateur a graine fixe): deux generations de meme
+// specification produisent les memes octets, et les valeurs attendues sont connues.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../ArcPlatform.h"
+
+struct ArcFixtureSpec {
+    uint64_t configBytes = 64u << 10;
+    size_t tokens = 32;
+    size_t plugins = 8;
+    size_t versions = 3;            // Par extension
+    size_t statusFiles = 4;         // Par version
+    uint64_t statusBytes = 4u << 10;
+    uint64_t logBytes = 16u << 20;  // Total des journaux de l'agent
+    size_t logRotations = 2;        // himds.log.1 ... (en plus de himds.log)
+    uint64_t extensionLogBytes = 1u << 20;
+};
+
+// Valeurs attendues des sondes sur l'arbre genere (verification de non-regression fonctionnelle)
+struct ArcFixtureExpect {
+    size_t extensions = 0;
+    size_t credentials = 0;
+    size_t logFiles = 0;
+    uint64_t logBytes = 0;
+    uint64_t tokenFailureLines = 0;     // "Renouvellement du jeton en echec"
+    uint64_t timeoutLines = 0;          // "Delai de connexion depasse"
+    uint64_t configBytes = 0;
+    uint64_t statusBytes = 0;           // Statuts courants (<N>.status le plus recent de chaque extension)
+};
+
+// Remplace le contenu de 'root'. Faux si un fichier n'a pas pu etre ecrit.
+bool GenerateAgentTree(const std::wstring& root, const ArcFixtureSpec& spec, ArcFixtureExpect& expect);
+
+// Supprime l'arbre (ignore les erreurs)
+void RemoveAgentTree(const std::wstring& root);
+
+// Instantane facon /proc: processus surveilles sous le nom tronque du champ comm (15 caracteres),
+// 'handlers' fils par processus hebergeant des gestionnaires, leurres au nom voisin, puis
+// processus sans rapport jusqu'a 'processes' entrees. PID a partir de 1000000 (inexistants).
+std::vector<ArcProcessEntry> GenerateProcessTable(const std::vector<ArcWatchedProcess>& watched, size_t processes, size_t handlers);
@@ -0,0 +1,348 @@
+// ArcLoopback.cpp - Repondeur de boucle locale (127.0.0.1) pour la sonde de connectivite
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+
+#include "ArcLoopback.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+using SockLen = int;
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+using SockLen = socklen_t;
+#endif
+
+namespace {
+
+// ======================== Sockets ========================
+void CloseSocket(intptr_t s) {
+    if (s < 0) return;
+#ifdef _WIN32
+    closesocket(static_cast<SOCKET>(s));
+#else
+    close(static_cast<int>(s));
+#endif
+}
+
+// Socket lie a 127.0.0.1 sur un port ephemere; TCP: en ecoute si listen
+intptr_t OpenLoopback(int type, bool listen, uint16_t& port) {
+#ifdef _WIN32
+    const SOCKET raw = socket(AF_INET, type, 0);
+    if (raw == INVALID_SOCKET) return -1;
+    const intptr_t s = static_cast<intptr_t>(raw);
+#else
+    const intptr_t s = socket(AF_INET, type, 0);
+    if (s < 0) return -1;
+#endif
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    SockLen len = sizeof(addr);
+    if (bind(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        getsockname(s, reinterpret_cast<sockaddr*>(&addr), &len) != 0 ||
+        (listen && ::listen(s, 16) != 0)) {
+        CloseSocket(s);
+        return -1;
+    }
+    port = ntohs(addr.sin_port);
+    return s;
+}
+
+uint16_t U16(std::string_view s, size_t pos) {
+    return static_cast<uint16_t>((static_cast<uint8_t>(s[pos]) << 8) | static_cast<uint8_t>(s[pos + 1]));
+}
+
+void PutU16(std::string& out, size_t v) {
+    out += static_cast<char>((v >> 8) & 0xFF);
+    out += static_cast<char>(v & 0xFF);
+}
+
+bool StartsWith(std::string_view s, std::string_view prefix) { return s.substr(0, prefix.size()) == prefix; }
+
+// ======================== Wire Formats ========================
+// Nom de la question (sans compression, comme le construit la sonde); pos sur QTYPE en sortie
+bool ReadQuestionName(std::string_view msg, size_t& pos, std::string& name) {
+    name.clear();
+    while (pos < msg.size()) {
+        const uint8_t len = static_cast<uint8_t>(msg[pos++]);
+        if (len == 0) return !name.empty();
+        if (len > 63 || pos + len > msg.size()) return false;
+        if (!name.empty()) name += '.';
+        name.append(msg.substr(pos, len));
+        pos += len;
+    }
+    return false;
+}
+
+// SNI du ClientHello; false si l'enregistrement ou le message est malforme
+bool ParseClientHello(std::string_view record, std::string& sni, bool& keyShare) {
+    sni.clear();
+    keyShare = false;
+    if (record.size() < 9 || record[0] != 0x16 || record[5] != 0x01) return false;
+    const size_t bodyLen = (static_cast<size_t>(static_cast<uint8_t>(record[6])) << 16) | U16(record, 7);
+    if (bodyLen + 4 != U16(record, 3)) return false;
+    std::string_view hello = record.substr(9, bodyLen);
+    if (hello.size() < 35 || U16(hello, 0) != 0x0303) return false;
+
+    size_t pos = 34;
+    pos += 1 + static_cast<uint8_t>(hello[pos]);                     // legacy_session_id
+    if (pos + 2 > hello.size()) return false;
+    const size_t suites = U16(hello, pos);
+    if (suites == 0 || suites % 2) return false;
+    pos += 2 + suites;
+    if (pos + 1 > hello.size()) return false;
+    pos += 1 + static_cast<uint8_t>(hello[pos]);                     // compression
+    if (pos + 2 > hello.size() || pos + 2 + U16(hello, pos) != hello.size()) return false;
+    pos += 2;
+
+    while (pos + 4 <= hello.size()) {
+        const uint16_t type = U16(hello, pos);
+        const size_t len = U16(hello, pos + 2);
+        pos += 4;
+        if (pos + len > hello.size()) return false;
+        const std::string_view ext = hello.substr(pos, len);
+        if (type == 0x0000) {
+            // server_name_list: une entree host_name
+            if (ext.size() < 5 || U16(ext, 0) + 2u != ext.size() || ext[2] != 0 || U16(ext, 3) + 5u != ext.size()) return false;
+            sni.assign(ext.substr(5));
+        } else if (type == 0x0033) {
+            keyShare = ext.size() >= 38 && U16(ext, 2) == 0x001D && U16(ext, 4) == 32;
+        }
+        pos += len;
+    }
+    return pos == hello.size();
+}
+
+std::string ServerHello() {
+    std::string body("\x03\x03", 2);
+    body.append(32, '\x5A');                            // random
+    body += '\0';                                       // legacy_session_id vide
+    body.append("\x13\x01\x00", 3);                     // TLS_AES_128_GCM_SHA256, sans compression
+    PutU16(body, 6);
+    body.append("\x00\x2B\x00\x02\x03\x04", 6);         // supported_versions: TLS 1.3
+
+    std::string handshake(1, '\x02');
+    handshake += '\0';
+    PutU16(handshake, body.size());
+    handshake += body;
+    std::string record("\x16\x03\x03", 3);
+    PutU16(record, handshake.size());
+    return record + handshake;
+}
+
+} // namespace
+
+// ======================== Responder ========================
+ArcLoopbackResponder::~ArcLoopbackResponder() { Stop(); }
+
+bool ArcLoopbackResponder::Start() {
+#ifdef _WIN32
+    WSADATA data;
+    if (!winsock_ && WSAStartup(MAKEWORD(2, 2), &data) != 0) return false;
+    winsock_ = true;
+#endif
+    udp_ = OpenLoopback(SOCK_DGRAM, false, dnsPort);
+    const std::pair<Role, uint16_t*> roles[] = {
+        { Role::Hello, &helloPort }, { Role::Alert, &alertPort }, { Role::Mute, &mutePort }, { Role::Proxy, &proxyPort }
+    };
+    bool ok = udp_ >= 0;
+    for (const auto& r : roles) {
+        const intptr_t s = OpenLoopback(SOCK_STREAM, true, *r.second);
+        ok &= s >= 0;
+        if (s >= 0) listeners_.push_back({ s, r.first });
+    }
+    // Port attribue puis libere: plus rien n'y ecoute
+    const intptr_t closed = OpenLoopback(SOCK_STREAM, false, refusedPort);
+    ok &= closed >= 0;
+    CloseSocket(closed);
+    if (!ok) {
+        Stop();
+        return false;
+    }
+    stop_ = false;
+    thread_ = std::thread([this] { Run(); });
+    return true;
+}
+
+void ArcLoopbackResponder::Stop() {
+    stop_ = true;
+    if (thread_.joinable()) thread_.join();
+    CloseSocket(udp_);
+    udp_ = -1;
+    for (const auto& l : listeners_) CloseSocket(l.first);
+    listeners_.clear();
+    for (const auto& c : connections_) CloseSocket(c.socket);
+    connections_.clear();
+#ifdef _WIN32
+    if (winsock_) WSACleanup();
+#endif
+    winsock_ = false;
+}
+
+std::vector<std::string> ArcLoopbackResponder::DnsNames() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dnsNames_;
+}
+
+std::vector<std::string> ArcLoopbackResponder::SniNames() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sniNames_;
+}
+
+std::vector<std::string> ArcLoopbackResponder::ConnectTargets() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return connectTargets_;
+}
+
+void ArcLoopbackResponder::Run() {
+    while (!stop_) {
+        fd_set read;
+        FD_ZERO(&read);
+        intptr_t top = udp_;
+        auto add = [&read, &top](intptr_t s) {
+            FD_SET(s, &read);
+            top = std::max(top, s);
+        };
+        add(udp_);
+        for (const auto& l : listeners_) add(l.first);
+        for (const auto& c : connections_) add(c.socket);
+
+        // Tranches de 50 ms: Stop() n'attend jamais plus
+        timeval wait = { 0, 50000 };
+        if (select(static_cast<int>(top + 1), &read, nullptr, nullptr, &wait) <= 0) continue;
+
+        if (FD_ISSET(udp_, &read)) OnDatagram();
+        for (const auto& l : listeners_) {
+            if (!FD_ISSET(l.first, &read)) continue;
+            Connection c;
+            c.socket = static_cast<intptr_t>(accept(l.first, nullptr, nullptr));
+            c.role = l.second;
+            if (c.socket >= 0) connections_.push_back(std::move(c));
+        }
+        for (auto& c : connections_) {
+            if (FD_ISSET(c.socket, &read)) OnData(c);
+        }
+        connections_.erase(std::remove_if(connections_.begin(), connections_.end(), [](const Connection& c) {
+            if (c.done) CloseSocket(c.socket);
+            return c.done;
+        }), connections_.end());
+    }
+}
+
+// ---- DNS ----
+void ArcLoopbackResponder::OnDatagram() {
+    char buffer[1500];
+    sockaddr_in from = {};
+    SockLen fromLen = sizeof(from);
+    const int n = static_cast<int>(recvfrom(udp_, buffer, sizeof(buffer), 0, reinterpret_cast<sockaddr*>(&from), &fromLen));
+    if (n <= 0) return;
+    const std::string_view query(buffer, static_cast<size_t>(n));
+
+    // Requete recursive standard, une question A/IN
+    size_t pos = 12;
+    std::string name;
+    if (query.size() < 12 || (query[2] & 0x80) || !(query[2] & 0x01) || U16(query, 4) != 1 || U16(query, 6) || U16(query, 8) ||
+        U16(query, 10) || !ReadQuestionName(query, pos, name) || pos + 4 != query.size() || U16(query, pos) != 1 || U16(query, pos + 2) != 1) {
+        malformed_++;
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dnsNames_.push_back(name);
+    }
+    if (StartsWith(name, "silent.")) return;
+
+    const bool nx = StartsWith(name, "nx.");
+    std::string answer(query.substr(0, 2));
+    PutU16(answer, 0x8180 | (nx ? 3 : 0));              // QR RD RA, NXDOMAIN le cas echeant
+    PutU16(answer, 1);
+    PutU16(answer, nx ? 0 : 2);
+    PutU16(answer, 0);
+    PutU16(answer, 0);
+    answer.append(query.substr(12));
+    if (!nx) {
+        // CNAME puis A: la sonde doit sauter l'enregistrement intermediaire
+        answer.append("\xC0\x0C\x00\x05\x00\x01\x00\x00\x00\x3C\x00\x08\x05" "alias\xC0\x0C", 20);
+        answer.append("\xC0\x0C\x00\x01\x00\x01\x00\x00\x00\x3C\x00\x04\x7F\x00\x00\x01", 16);
+    }
+    sendto(udp_, answer.data(), static_cast<int>(answer.size()), 0, reinterpret_cast<sockaddr*>(&from), fromLen);
+}
+
+// ---- TCP ----
+void ArcLoopbackResponder::Reply(Connection& c, const std::string& bytes) {
+    size_t sent = 0;
+    while (sent < bytes.size()) {
+        const int n = static_cast<int>(send(c.socket, bytes.data() + sent, static_cast<int>(bytes.size() - sent), 0));
+        if (n <= 0) {
+            c.done = true;
+            return;
+        }
+        sent += static_cast<size_t>(n);
+    }
+}
+
+bool ArcLoopbackResponder::OnClientHello(Connection& c) {
+    if (c.in.size() < 5 || c.in.size() < 5u + U16(c.in, 3)) return false;
+    std::string sni;
+    bool keyShare = false;
+    if (!ParseClientHello(std::string_view(c.in).substr(0, 5 + U16(c.in, 3)), sni, keyShare) || !keyShare) {
+        malformed_++;
+        c.done = true;
+        return true;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sniNames_.push_back(sni);
+    }
+    if (c.role == Role::Alert) Reply(c, std::string("\x15\x03\x03\x00\x02\x02\x28", 7));   // fatal, handshake_failure
+    else if (c.role != Role::Mute) Reply(c, ServerHello());
+    return true;
+}
+
+void ArcLoopbackResponder::OnData(Connection& c) {
+    char buffer[4096];
+    const int n = static_cast<int>(recv(c.socket, buffer, sizeof(buffer), 0));
+    if (n <= 0) {
+        c.done = true;
+        return;
+    }
+    if (c.in.size() < 16384) c.in.append(buffer, static_cast<size_t>(n));
+
+    if (c.role != Role::Proxy || c.tunneled) {
+        if (OnClientHello(c)) c.in.clear();
+        return;
+    }
+
+    const size_t end = c.in.find("\r\n\r\n");
+    if (end == std::string::npos) return;
+    // "CONNECT hote:port HTTP/1.1" puis "Host: hote:port"
+    const std::string request = c.in.substr(0, end);
+    c.in.erase(0, end + 4);
+    const size_t space = request.find(' ', 8);
+    if (!StartsWith(request, "CONNECT ") || space == std::string::npos) {
+        malformed_++;
+        c.done = true;
+        return;
+    }
+    const std::string target = request.substr(8, space - 8);
+    if (request.find("\r\nHost: " + target) == std::string::npos) malformed_++;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        connectTargets_.push_back(target);
+    }
+    if (StartsWith(target, "deny.")) {
+        Reply(c, "HTTP/1.1 407 Proxy Authentication Required\r\nProxy-Authenticate: Basic realm=\"arc\"\r\nContent-Length: 0\r\n\r\n");
+        return;
+    }
+    Reply(c, "HTTP/1.1 200 Connection established\r\n\r\n");
+    c.tunneled = true;
+}
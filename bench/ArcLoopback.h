@@ -0,0 +1,77 @@
+// ArcLoopback.h - Repondeur de boucle locale (127.0.0.1) pour la sonde de connectivite
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Un thread sert, sur des ports ephemeres, tous les cas que la boucle de sondes doit
+// distinguer. Le moteur y est dirige comme par --dns: ArcNetworkOptions::nameservers.
+//   DNS (UDP)   "nx.*" -> NXDOMAIN, "silent.*" -> aucune reponse (delai), sinon A 127.0.0.1
+//   hello       ClientHello verifie (SNI releve), ServerHello en retour
+//   alert       Alerte TLS fatale handshake_failure a la place du ServerHello
+//   mute        Connexion acceptee, aucune reponse (delai a l'etape TLS)
+//   proxy       CONNECT "deny.*" -> HTTP 407, sinon 200 puis comportement de hello
+//   refused     Port libere apres attribution: connexion refusee
+// Requetes DNS et ClientHello malformes sont comptes: le banc verifie ainsi les formats
+// construits par le moteur, pas seulement ses conclusions.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class ArcLoopbackResponder {
+public:
+    ArcLoopbackResponder() = default;
+    ~ArcLoopbackResponder();
+
+    ArcLoopbackResponder(const ArcLoopbackResponder&) = delete;
+    ArcLoopbackResponder& operator=(const ArcLoopbackResponder&) = delete;
+
+    // false si la pile reseau ou un port manque
+    bool Start();
+    void Stop();
+
+    uint16_t dnsPort = 0;
+    uint16_t helloPort = 0;
+    uint16_t alertPort = 0;
+    uint16_t mutePort = 0;
+    uint16_t proxyPort = 0;
+    uint16_t refusedPort = 0;
+
+    // Releves depuis Start(), lisibles depuis un autre thread
+    std::vector<std::string> DnsNames() const;
+    std::vector<std::string> SniNames() const;
+    std::vector<std::string> ConnectTargets() const;
+    size_t Malformed() const { return malformed_.load(); }
+
+private:
+    enum class Role { Hello, Alert, Mute, Proxy };
+
+    struct Connection {
+        intptr_t socket = -1;
+        Role role = Role::Hello;
+        std::string in;
+        bool tunneled = false;      // CONNECT accepte: la suite est un ClientHello
+        bool done = false;
+    };
+
+    void Run();
+    void OnDatagram();
+    void OnData(Connection& c);
+    bool OnClientHello(Connection& c);     // false: attendre la suite de l'enregistrement
+    void Reply(Connection& c, const std::string& bytes);
+
+    intptr_t udp_ = -1;
+    std::vector<std::pair<intptr_t, Role>> listeners_;
+    std::vector<Connection> connections_;
+    std::thread thread_;
+    std::atomic<bool> stop_{ false };
+    std::atomic<size_t> malformed_{ 0 };
+    bool winsock_ = false;
+
+    mutable std::mutex mutex_;
+    std::vector<std::string> dnsNames_;
+    std::vector<std::string> sniNames_;
+    std::vector<std::string> connectTargets_;
+};
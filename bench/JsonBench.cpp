@@ -0,0 +1,133 @@
+// JsonBench.cpp - Micro-benchmark extraction JSON (ancien extracteur vs ArcJson)
+// (c) 2025 Ayi NEDJIMI Consultants - Tous droits reserves
+// Compilation: cl /nologo /O2 /EHsc /std:c++17 /I.. JsonBench.cpp
+//          ou: g++ -std=c++17 -O2 -I.. JsonBench.cpp -o JsonBench
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../ArcJson.h"
+
+// ======================== Reference (ancienne implementation) ========================
+static std::wstring ExtractJsonValue(const std::wstring& json, const std::wstring& key) {
+    std::wstring searchKey = L"\"" + key + L"\":";
+    size_t pos = json.find(searchKey);
+    if (pos == std::wstring::npos) return L"";
+
+    pos += searchKey.length();
+    while (pos < json.length() && (json[pos] == L' ' || json[pos] == L'\t')) pos++;
+
+    if (pos >= json.length()) return L"";
+
+    bool isString = (json[pos] == L'\"');
+    if (isString) pos++;
+
+    std::wstring value;
+    while (pos < json.length()) {
+        if (isString && json[pos] == L'\"') break;
+        if (!isString && (json[pos] == L',' || json[pos] == L'}' || json[pos] == L'\n')) break;
+        value += json[pos++];
+    }
+
+    return value;
+}
+
+// ======================== Fixtures ========================
+// agentconfig.json gonfle: bloc volumineux avant les cles recherchees (cas le pire pour find)
+static std::wstring MakeConfig(size_t targetBytes) {
+    std::wstring doc = L"{\"extensions\":[";
+    for (size_t n = 0; doc.size() * sizeof(wchar_t) < targetBytes; n++) {
+        if (n) doc += L',';
+        doc += L"{\"name\":\"ext" + std::to_wstring(n) + L"\",\"settings\":{\"endpoint\":\"https://contoso.example/"
+             + std::to_wstring(n) + L"\",\"note\":\"valeur \\\"quotee\\\" et {accolades}\"}}";
+    }
+    doc += L"],\"properties\":{\"resourceId\":\"/subscriptions/0000/resourceGroups/rg/providers/Microsoft.HybridCompute/machines/srv01\","
+           L"\"location\":\"westeurope\",\"tenantId\":\"72f988bf-86f1-41af-91ab-2d7cd011db47\"}}";
+    return doc;
+}
+
+// Fichier .status d'extension avec un formattedMessage volumineux
+static std::wstring MakeStatus(size_t targetBytes) {
+    std::wstring msg;
+    while ((msg.size() + 256) * sizeof(wchar_t) < targetBytes) msg += L"Ligne de trace \\\"handler\\\" ok\\n";
+    return L"[{\"version\":1.0,\"timestampUTC\":\"2025-06-01T12:00:00Z\",\"status\":{\"name\":\"AzureMonitorWindowsAgent\","
+           L"\"operation\":\"Enable\",\"status\":\"success\",\"code\":0,\"formattedMessage\":{\"lang\":\"en-US\",\"message\":\""
+           + msg + L"\"},\"substatus\":[{\"name\":\"x\",\"status\":\"error\",\"code\":52}]}}]";
+}
+
+// ======================== Timing ========================
+template <typename Fn>
+static double BestOfMs(int runs, Fn&& fn) {
+    double best = 1e300;
+    for (int r = 0; r < runs; r++) {
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        auto t1 = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        if (ms < best) best = ms;
+    }
+    return best;
+}
+
+static void Report(const char* name, size_t bytes, double legacyMs, double scanMs, bool legacyCorrect) {
+    double mb = bytes / (1024.0 * 1024.0);
+    printf("%-28s %7.2f Mo | ancien %9.3f ms (%8.1f Mo/s)%s | ArcJson %9.3f ms (%8.1f Mo/s) | x%.1f\n",
+        name, mb, legacyMs, mb / (legacyMs / 1000.0), legacyCorrect ? "" : " [valeurs fausses]",
+        scanMs, mb / (scanMs / 1000.0), legacyMs / scanMs);
+}
+
+int main() {
+    const int runs = 7;
+    volatile size_t sink = 0;
+
+    for (size_t size : { size_t(1) << 20, size_t(4) << 20, size_t(16) << 20 }) {
+        // --- agentconfig.json: 3 cles ---
+        std::wstring config = MakeConfig(size);
+        double legacy = BestOfMs(runs, [&] {
+            sink += ExtractJsonValue(config, L"resourceId").size();
+            sink += ExtractJsonValue(config, L"location").size();
+            sink += ExtractJsonValue(config, L"tenantId").size();
+        });
+        JsonPathScannerW configScanner({ L"properties.resourceId", L"properties.location", L"properties.tenantId" });
+        std::vector<JsonValueW> out;
+        double scan = BestOfMs(runs, [&] {
+            configScanner.Scan(config, out);
+            for (auto& v : out) sink += v.raw.size();
+        });
+        bool same = JsonString(out[0]) == ExtractJsonValue(config, L"resourceId")
+                 && JsonString(out[1]) == ExtractJsonValue(config, L"location");
+        Report("agentconfig.json (3 cles)", config.size() * sizeof(wchar_t), legacy, scan, same);
+
+        // --- .status: 5 champs ---
+        std::wstring status = MakeStatus(size);
+        legacy = BestOfMs(runs, [&] {
+            sink += ExtractJsonValue(status, L"name").size();
+            sink += ExtractJsonValue(status, L"status").size();
+            sink += ExtractJsonValue(status, L"code").size();
+            sink += ExtractJsonValue(status, L"timestampUTC").size();
+            sink += ExtractJsonValue(status, L"formattedMessage").size();
+        });
+        JsonPathScannerW statusScanner({ L"[].status.name", L"[].status.status", L"[].status.code",
+            L"[].timestampUTC", L"[].status.substatus.[].code" });
+        scan = BestOfMs(runs, [&] {
+            statusScanner.Scan(status, out);
+            for (auto& v : out) sink += v.raw.size();
+        });
+        same = JsonString(out[1]) == ExtractJsonValue(status, L"status")
+            && JsonString(out[2]) == ExtractJsonValue(status, L"code");
+        Report(".status (5 champs)", status.size() * sizeof(wchar_t), legacy, scan, same);
+    }
+
+    // Verification de coherence sur le document de configuration
+    std::wstring config = MakeConfig(1 << 16);
+    JsonPathScannerW check({ L"properties.resourceId" });
+    std::vector<JsonValueW> out;
+    check.Scan(config, out);
+    if (JsonString(out[0]) != ExtractJsonValue(config, L"resourceId")) {
+        printf("ERREUR: resultats divergents\n");
+        return 1;
+    }
+    return sink == 0 ? 1 : 0;
+}
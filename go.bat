@@ -1,5 +1,6 @@
 @echo off
 REM go.bat - Compilation et execution de AzureArcAgentChecker
+REM Usage: go.bat [bench [options ArcBench: --baseline F, --save-baseline F, --scales 1,4,16, ...]]
 REM (c) 2025 Ayi NEDJIMI Consultants
 
 echo ========================================
@@ -8,9 +9,11 @@ echo (c) Ayi NEDJIMI Consultants
 echo ========================================
 echo.
 
-set SRC=AzureArcAgentChecker.cpp
+set CORE=ArcScan.cpp ArcResult.cpp ArcTime.cpp ArcTokens.cpp ArcCache.cpp ArcContent.cpp ArcFile.cpp ArcLogScan.cpp ArcConnectivity.cpp ArcExtensions.cpp ArcEvents.cpp ArcFleet.cpp ArcExport.cpp ArcScheduler.cpp ArcProcessIndex.cpp ArcWatch.cpp ArcLog.cpp ArcTrace.cpp ArcHistory.cpp ArcRules.cpp ArcSampler.cpp ArcMetrics.cpp ArcPlatformWin.cpp
+set SRC=AzureArcAgentChecker.cpp %CORE%
 set EXE=AzureArcAgentChecker.exe
-set LIBS=comctl32.lib psapi.lib wevtapi.lib advapi32.lib user32.lib gdi32.lib shell32.lib
+set CLI=arccheck.exe
+set LIBS=comctl32.lib psapi.lib wevtapi.lib advapi32.lib user32.lib gdi32.lib shell32.lib ws2_32.lib iphlpapi.lib
 
 REM Recherche du compilateur
 where cl.exe >nul 2>&1
@@ -22,8 +25,10 @@ if %errorlevel% neq 0 (
     exit /b 1
 )
 
+if /i "%1"=="bench" goto bench
+
 echo [1/3] Compilation en cours...
-cl.exe /nologo /W3 /O2 /EHsc /D_UNICODE /DUNICODE %SRC% /Fe:%EXE% /link %LIBS%
+cl.exe /nologo /W3 /O2 /EHsc /std:c++17 /D_UNICODE /DUNICODE %SRC% /Fe:%EXE% /link %LIBS%
 
 if %errorlevel% neq 0 (
     echo.
@@ -32,6 +37,15 @@ if %errorlevel% neq 0 (
     exit /b 1
 )
 
+cl.exe /nologo /W3 /O2 /EHsc /std:c++17 /D_UNICODE /DUNICODE ArcCli.cpp %CORE% /Fe:%CLI% /link %LIBS%
+
+if %errorlevel% neq 0 (
+    echo.
+    echo [ERREUR] Echec de la compilation (CLI)
+    pause
+    exit /b 1
+)
+
 echo.
 echo [2/3] Nettoyage des fichiers intermediaires...
 if exist *.obj del *.obj
@@ -56,3 +70,25 @@ if exist %EXE% (
     pause
     exit /b 1
 )
+
+exit /b 0
+
+:bench
+echo [1/2] Compilation des benchmarks...
+cl.exe /nologo /W3 /O2 /EHsc /std:c++17 /I. bench\JsonBench.cpp /Fe:JsonBench.exe
+if %errorlevel% neq 0 (
+    echo [ERREUR] Echec de la compilation des benchmarks
+    exit /b 1
+)
+cl.exe /nologo /W3 /O2 /EHsc /std:c++17 /D_UNICODE /DUNICODE /I. bench\ArcBench.cpp bench\ArcFixtures.cpp bench\ArcLoopback.cpp %CORE% /Fe:ArcBench.exe /link %LIBS%
+if %errorlevel% neq 0 (
+    echo [ERREUR] Echec de la compilation du banc des sondes
+    exit /b 1
+)
+if exist *.obj del *.obj
+
+echo [2/2] Execution...
+JsonBench.exe
+if %errorlevel% neq 0 exit /b %errorlevel%
+ArcBench.exe %2 %3 %4 %5 %6 %7 %8 %9
+exit /b %errorlevel%
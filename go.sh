@@ -0,0 +1,32 @@
+#!/bin/sh
+# go.sh - Compilation du verificateur Azure Arc en ligne de commande (Linux)
+# (c) 2025 Ayi NEDJIMI Consultants
+# Usage: ./go.sh [bench [options ArcBench: --baseline F, --save-baseline F, --scales 1,4,16, ...]]
+
+set -e
+cd "$(dirname "$0")"
+
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:-"-std=c++17 -O2 -Wall -Wextra"}
+CORE="ArcScan.cpp ArcResult.cpp ArcTime.cpp ArcTokens.cpp ArcCache.cpp ArcContent.cpp ArcFile.cpp ArcLogScan.cpp ArcConnectivity.cpp ArcExtensions.cpp ArcEvents.cpp ArcFleet.cpp ArcExport.cpp ArcScheduler.cpp ArcProcessIndex.cpp ArcWatch.cpp ArcLog.cpp ArcTrace.cpp ArcHistory.cpp ArcRules.cpp ArcSampler.cpp ArcMetrics.cpp ArcPlatformLinux.cpp"
+OUT=${OUT:-build}
+
+mkdir -p "$OUT"
+
+echo "[1/3] Compilation de arccheck..."
+$CXX $CXXFLAGS ArcCli.cpp $CORE -o "$OUT/arccheck" -pthread
+
+echo "[2/3] Compilation des benchmarks..."
+$CXX $CXXFLAGS -I. bench/JsonBench.cpp -o "$OUT/JsonBench"
+
+echo "[3/3] Compilation du banc des sondes..."
+$CXX $CXXFLAGS -I. bench/ArcBench.cpp bench/ArcFixtures.cpp bench/ArcLoopback.cpp $CORE -o "$OUT/ArcBench" -pthread
+
+if [ "$1" = "bench" ]; then
+    shift
+    echo "Execution des benchmarks..."
+    "$OUT/JsonBench"
+    "$OUT/ArcBench" "$@"
+fi
+
+echo "Termine: $OUT/arccheck"